@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""Compare two nuansa_bench JSON reports and flag regressions.
+
+    nuansa_bench --benchmark_out=baseline.json --benchmark_out_format=json
+    ... make a change, rebuild ...
+    nuansa_bench --benchmark_out=current.json --benchmark_out_format=json
+    benchmarks/compare.py baseline.json current.json --threshold 0.05
+
+With --benchmark_repetitions the median of each benchmark is compared,
+otherwise its single run. Exits with 1 when any benchmark got slower by
+more than the threshold, so it can gate a CI job.
+"""
+
+import argparse
+import json
+import sys
+
+NANOSECONDS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path, metric):
+    with open(path, encoding="utf-8") as file:
+        report = json.load(file)
+
+    runs = {}
+    medians = {}
+    for entry in report.get("benchmarks", []):
+        if entry.get("error_occurred"):
+            continue
+        # Times are in each benchmark's own unit
+        value = entry[metric] * NANOSECONDS[entry.get("time_unit", "ns")]
+        if entry.get("run_type") == "aggregate":
+            if entry.get("aggregate_name") == "median":
+                medians[entry["run_name"]] = value
+        else:
+            # Repetitions share a run_name; the first one stands in when there is no median
+            runs.setdefault(entry.get("run_name", entry["name"]), value)
+    runs.update(medians)
+    return runs
+
+
+def format_time(nanoseconds):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if nanoseconds >= scale:
+            return f"{nanoseconds / scale:.2f}{unit}"
+    return f"{nanoseconds:.1f}ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative slowdown that counts as a regression (default 0.05)")
+    parser.add_argument("--metric", choices=("cpu_time", "real_time"), default="cpu_time")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline, args.metric)
+    current = load(args.current, args.metric)
+
+    width = max((len(name) for name in baseline.keys() | current.keys()), default=10)
+    print(f"{'benchmark':<{width}}  {'baseline':>10}  {'current':>10}  {'change':>8}")
+
+    regressions = []
+    for name in sorted(baseline.keys() | current.keys()):
+        if name not in current:
+            print(f"{name:<{width}}  {format_time(baseline[name]):>10}  {'-':>10}  {'removed':>8}")
+            continue
+        if name not in baseline:
+            print(f"{name:<{width}}  {'-':>10}  {format_time(current[name]):>10}  {'new':>8}")
+            continue
+
+        change = (current[name] - baseline[name]) / baseline[name] if baseline[name] else 0.0
+        marker = ""
+        if change > args.threshold:
+            marker = "  SLOWER"
+            regressions.append(name)
+        elif change < -args.threshold:
+            marker = "  faster"
+        print(f"{name:<{width}}  {format_time(baseline[name]):>10}  {format_time(current[name]):>10}  "
+              f"{change:>+8.1%}{marker}")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) slower than the baseline by more than {args.threshold:.0%}",
+              file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
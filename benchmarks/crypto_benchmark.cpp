@@ -0,0 +1,43 @@
+#include "nuansa/utils/pch.h"
+
+#include <benchmark/benchmark.h>
+#include "nuansa/services/token/token_service.h"
+#include "nuansa/utils/crypto/crypto_util.h"
+
+namespace nuansa::services::token {
+    class TokenServiceBenchmark {
+    public:
+        static std::string CreateSignature(const TokenService &service, const std::string &data) {
+            return service.CreateSignature(data);
+        }
+    };
+}
+
+namespace {
+    using nuansa::services::token::TokenService;
+    using nuansa::services::token::TokenServiceBenchmark;
+
+    // token_id:expiry:user_id, as built by TokenService::CreateTokenData
+    void BM_TokenCreateSignature(benchmark::State &state) {
+        const TokenService service("benchmark-secret-key-with-a-realistic-length-0123456789");
+        const std::string data = std::string(static_cast<size_t>(state.range(0)), 'k') + ":1734403600:user42";
+        for (auto _: state) {
+            auto signature = TokenServiceBenchmark::CreateSignature(service, data);
+            benchmark::DoNotOptimize(signature);
+        }
+    }
+
+    // Access and refresh token ids
+    BENCHMARK(BM_TokenCreateSignature)->Arg(32)->Arg(64);
+
+    void BM_GenerateSHA256Hash(benchmark::State &state) {
+        const std::string content(static_cast<size_t>(state.range(0)), 'a');
+        for (auto _: state) {
+            auto hash = nuansa::utils::crypto::CryptoUtil::GenerateSHA256Hash(content);
+            benchmark::DoNotOptimize(hash);
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * content.size()));
+    }
+
+    BENCHMARK(BM_GenerateSHA256Hash)->RangeMultiplier(8)->Range(16, 64 << 10);
+}
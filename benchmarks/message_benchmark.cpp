@@ -0,0 +1,67 @@
+#include "nuansa/utils/pch.h"
+
+#include <benchmark/benchmark.h>
+#include "nuansa/messages/base_message.h"
+
+namespace {
+    // Frames shaped like what clients send, see README "Test Client"
+    const std::string LOGIN_FRAME = R"({"head":{"ver":"1.0","msg_type":"login","msg_id":"4f1c2a9e-login-0001",)"
+            R"("corr_id":"4f1c2a9e-login-0001","sender":"user42","timestamp":1734400000},)"
+            R"("username":"user42","password":"Correct-Horse-Battery-9"})";
+
+    const std::string CHAT_FRAME = R"({"head":{"ver":"1.0","msg_type":"new","msg_id":"4f1c2a9e-chat-0002",)"
+            R"("corr_id":"4f1c2a9e-chat-0002","sender":"user42","timestamp":1734400001,"priority":1,)"
+            R"("content_type":"application/json","encoding":"UTF-8","content_length":78},)"
+            R"("type":"new","content":"Morning @user7 and @user13, the deploy is done; please check the dashboards."})";
+
+    const std::string REGISTER_FRAME = R"({"head":{"ver":"1.0","msg_type":"register","msg_id":"4f1c2a9e-reg-0003",)"
+            R"("corr_id":"4f1c2a9e-reg-0003","timestamp":1734400002,"custom_headers":{"client":"web","build":"1.4.2"}},)"
+            R"("body":{"username":"user42","email":"user42@example.com","password":"Correct-Horse-Battery-9",)"
+            R"("authProvider":0}})";
+
+    void BM_JsonParse(benchmark::State &state, const std::string &frame) {
+        for (auto _: state) {
+            auto json = nlohmann::json::parse(frame);
+            benchmark::DoNotOptimize(json);
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * frame.size()));
+    }
+
+    BENCHMARK_CAPTURE(BM_JsonParse, login, LOGIN_FRAME);
+    BENCHMARK_CAPTURE(BM_JsonParse, chat, CHAT_FRAME);
+    BENCHMARK_CAPTURE(BM_JsonParse, register, REGISTER_FRAME);
+
+    void BM_MessageHeaderFromJson(benchmark::State &state, const std::string &frame) {
+        const auto json = nlohmann::json::parse(frame);
+        const auto &header = json[MESSAGE_HEADER];
+        for (auto _: state) {
+            auto parsed = nuansa::messages::MessageHeader::FromJson(header);
+            benchmark::DoNotOptimize(parsed);
+        }
+    }
+
+    BENCHMARK_CAPTURE(BM_MessageHeaderFromJson, chat, CHAT_FRAME);
+    BENCHMARK_CAPTURE(BM_MessageHeaderFromJson, register, REGISTER_FRAME);
+
+    void BM_MessageHeaderToJson(benchmark::State &state) {
+        const auto header = nuansa::messages::MessageHeader::FromJson(
+            nlohmann::json::parse(REGISTER_FRAME)[MESSAGE_HEADER]);
+        for (auto _: state) {
+            auto json = header.ToJson();
+            benchmark::DoNotOptimize(json);
+        }
+    }
+
+    BENCHMARK(BM_MessageHeaderToJson);
+
+    void BM_MessageHeaderToJsonString(benchmark::State &state) {
+        const auto header = nuansa::messages::MessageHeader::FromJson(
+            nlohmann::json::parse(REGISTER_FRAME)[MESSAGE_HEADER]);
+        for (auto _: state) {
+            auto text = header.ToJsonString();
+            benchmark::DoNotOptimize(text);
+        }
+    }
+
+    BENCHMARK(BM_MessageHeaderToJsonString);
+}
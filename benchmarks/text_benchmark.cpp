@@ -0,0 +1,90 @@
+#include "nuansa/utils/pch.h"
+
+#include <benchmark/benchmark.h>
+#include "nuansa/handler/websocket_handler.h"
+#include "nuansa/utils/random_generator.h"
+#include "nuansa/utils/validation.h"
+
+namespace {
+    // The std::regex versions ValidateEmail and ExtractMentions replaced, kept as a baseline
+    bool RegexValidateEmail(const std::string &email) {
+        const std::regex emailRegex(R"([a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,})");
+        return std::regex_match(email, emailRegex);
+    }
+
+    std::vector<std::string> RegexExtractMentions(const std::string &content) {
+        std::vector<std::string> mentions;
+        const std::regex mentionPattern("@(\\w+)");
+        for (auto it = std::sregex_iterator(content.begin(), content.end(), mentionPattern);
+             it != std::sregex_iterator(); ++it) {
+            mentions.push_back((*it)[1].str());
+        }
+        return mentions;
+    }
+
+    const std::string TWO_MENTIONS = "Morning @user7 and @user13, the deploy is done; please check the dashboards.";
+
+    const std::string LONG_MESSAGE = [] {
+        std::string content;
+        for (int i = 0; i < 40; ++i) {
+            content += "line " + std::to_string(i) + " of the incident notes, cc @oncall" + std::to_string(i % 4) + ". ";
+        }
+        return content;
+    }();
+
+    void BM_ValidateEmail(benchmark::State &state, const std::string &email) {
+        for (auto _: state) {
+            auto valid = nuansa::utils::Validation::ValidateEmail(email);
+            benchmark::DoNotOptimize(valid);
+        }
+    }
+
+    BENCHMARK_CAPTURE(BM_ValidateEmail, valid, std::string("first.last+tag@mail.example.co.id"));
+    BENCHMARK_CAPTURE(BM_ValidateEmail, invalid, std::string("first.last.example.com"));
+    BENCHMARK_CAPTURE(BM_ValidateEmail, long_local_part, std::string(200, 'a') + "@example.com");
+
+    void BM_ValidateEmailRegex(benchmark::State &state, const std::string &email) {
+        for (auto _: state) {
+            auto valid = RegexValidateEmail(email);
+            benchmark::DoNotOptimize(valid);
+        }
+    }
+
+    BENCHMARK_CAPTURE(BM_ValidateEmailRegex, valid, std::string("first.last+tag@mail.example.co.id"));
+    BENCHMARK_CAPTURE(BM_ValidateEmailRegex, invalid, std::string("first.last.example.com"));
+
+    void BM_ExtractMentions(benchmark::State &state, const std::string &content) {
+        for (auto _: state) {
+            auto mentions = nuansa::handler::WebSocketHandler::ExtractMentions(content);
+            benchmark::DoNotOptimize(mentions);
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * content.size()));
+    }
+
+    BENCHMARK_CAPTURE(BM_ExtractMentions, none,
+                      std::string("The deploy finished without errors, dashboards look normal again."));
+    BENCHMARK_CAPTURE(BM_ExtractMentions, two, TWO_MENTIONS);
+    BENCHMARK_CAPTURE(BM_ExtractMentions, long_message, LONG_MESSAGE);
+
+    void BM_ExtractMentionsRegex(benchmark::State &state, const std::string &content) {
+        for (auto _: state) {
+            auto mentions = RegexExtractMentions(content);
+            benchmark::DoNotOptimize(mentions);
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * content.size()));
+    }
+
+    BENCHMARK_CAPTURE(BM_ExtractMentionsRegex, two, TWO_MENTIONS);
+    BENCHMARK_CAPTURE(BM_ExtractMentionsRegex, long_message, LONG_MESSAGE);
+
+    void BM_GenerateString(benchmark::State &state) {
+        const auto length = static_cast<size_t>(state.range(0));
+        for (auto _: state) {
+            auto value = nuansa::utils::RandomGenerator::GenerateString(length);
+            benchmark::DoNotOptimize(value);
+        }
+    }
+
+    // Access and refresh token ids
+    BENCHMARK(BM_GenerateString)->Arg(32)->Arg(64);
+}
@@ -20,11 +20,44 @@ namespace nuansa::config {
 
 		const ServerConfig &GetServerConfig() const { return serverConfig_; }
 		const DatabaseConfig &GetDatabaseConfig() const { return databaseConfig_; }
+		const SecurityConfig &GetSecurityConfig() const { return securityConfig_; }
+		const CircuitBreakerConfig &GetCircuitBreakerConfig() const { return circuitBreakerConfig_; }
+		const LoadSheddingConfig &GetLoadSheddingConfig() const { return loadSheddingConfig_; }
+		const RateLimitConfig &GetRateLimitConfig() const { return rateLimitConfig_; }
+		const LoggingConfig &GetLoggingConfig() const { return loggingConfig_; }
+		const MetricsConfig &GetMetricsConfig() const { return metricsConfig_; }
+		const TracingConfig &GetTracingConfig() const { return tracingConfig_; }
+		const MentionsConfig &GetMentionsConfig() const { return mentionsConfig_; }
+		const PresenceConfig &GetPresenceConfig() const { return presenceConfig_; }
+		const TypingConfig &GetTypingConfig() const { return typingConfig_; }
+		const ShutdownConfig &GetShutdownConfig() const { return shutdownConfig_; }
 
 		void SetDatabaseConfig(const DatabaseConfig &config);
 
 		void SetServerConfig(const ServerConfig &config);
 
+		void SetSecurityConfig(const SecurityConfig &config);
+
+		void SetCircuitBreakerConfig(const CircuitBreakerConfig &config);
+
+		void SetLoadSheddingConfig(const LoadSheddingConfig &config);
+
+		void SetRateLimitConfig(const RateLimitConfig &config);
+
+		void SetLoggingConfig(const LoggingConfig &config);
+
+		void SetMetricsConfig(const MetricsConfig &config);
+
+		void SetTracingConfig(const TracingConfig &config);
+
+		void SetMentionsConfig(const MentionsConfig &config);
+
+		void SetPresenceConfig(const PresenceConfig &config);
+
+		void SetTypingConfig(const TypingConfig &config);
+
+		void SetShutdownConfig(const ShutdownConfig &config);
+
 		// Other Getters as needed
 		const YAML::Node &GetRawConfig() const { return config_; }
 
@@ -35,6 +68,30 @@ namespace nuansa::config {
 
 		void LoadDatabaseConfig(const YAML::Node &config);
 
+		void LoadSecurityConfig(const YAML::Node &config);
+
+		void LoadCircuitBreakerConfig(const YAML::Node &config);
+
+		static CircuitBreakerPolicy LoadCircuitBreakerPolicy(const YAML::Node &node, CircuitBreakerPolicy policy);
+
+		void LoadLoadSheddingConfig(const YAML::Node &config);
+
+		void LoadRateLimitConfig(const YAML::Node &config);
+
+		void LoadLoggingConfig(const YAML::Node &config);
+
+		void LoadMetricsConfig(const YAML::Node &config);
+
+		void LoadTracingConfig(const YAML::Node &config);
+
+		void LoadMentionsConfig(const YAML::Node &config);
+
+		void LoadPresenceConfig(const YAML::Node &config);
+
+		void LoadTypingConfig(const YAML::Node &config);
+
+		void LoadShutdownConfig(const YAML::Node &config);
+
 		static std::string ResolveEnvironmentVariable(const std::string &value);
 
 		void LoadEnvironmentFile();
@@ -43,6 +100,17 @@ namespace nuansa::config {
 
 		ServerConfig serverConfig_;
 		DatabaseConfig databaseConfig_;
+		SecurityConfig securityConfig_;
+		CircuitBreakerConfig circuitBreakerConfig_;
+		LoadSheddingConfig loadSheddingConfig_;
+		RateLimitConfig rateLimitConfig_;
+		LoggingConfig loggingConfig_;
+		MetricsConfig metricsConfig_;
+		TracingConfig tracingConfig_;
+		MentionsConfig mentionsConfig_;
+		PresenceConfig presenceConfig_;
+		TypingConfig typingConfig_;
+		ShutdownConfig shutdownConfig_;
 
 		// Raw Configuration
 		YAML::Node config_;
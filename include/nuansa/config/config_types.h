@@ -13,6 +13,9 @@ namespace nuansa::config {
 		std::string host;
 		std::string logLevel;
 		std::string logPath;
+		std::string ioMode{"shared"}; // "per_core" gives each IO thread its own io_context and SO_REUSEPORT acceptor
+		size_t ioThreads{0}; // 0 uses the hardware threads
+		bool pinIoThreads{false}; // per_core only: bind IO thread i to CPU i (Linux)
 		std::string jwtSecret;
 		std::string githubClientId;
 		std::string githubClientSecret;
@@ -26,23 +29,131 @@ namespace nuansa::config {
 		std::string googleRedirectUri;
 		std::string googleTokenInfoUrl;
 		std::string googleUserInfoUrl;
+		std::string googleJwksUrl{"https://www.googleapis.com/oauth2/v3/certs"}; // Signing keys for local ID token checks
 	};
 
 	struct DatabaseConfig {
+		std::string backend{"postgres"}; // "memory" keeps users and tokens in process, no database needed
 		std::string host;
 		uint16_t port;
 		std::string database_name;
 		std::string username;
 		std::string password;
 		size_t pool_size;
+		uint64_t statement_timeout_ms{5000}; // Server-side cap on any single statement; 0 disables it
 		std::string connection_string;
 	};
 
-	struct CircuitBreakerConfig {
-		size_t failureThreshold{5};
+	struct CircuitBreakerPolicy {
+		size_t failureThreshold{5}; // Minimum failures in the window before the circuit may open
 		size_t successThreshold{2};
 		uint64_t resetTimeoutSeconds{60};
 		uint64_t timeoutSeconds{2};
+		double failureRateThreshold{0.5}; // Share of failed calls in the window that opens the circuit
+		uint64_t windowSeconds{30};
+	};
+
+	struct CircuitBreakerConfig {
+		CircuitBreakerPolicy defaults;
+		// Per dependency (primary_db, google, github); unset keys inherit from defaults
+		std::unordered_map<std::string, CircuitBreakerPolicy> dependencies;
+	};
+
+	struct SecurityConfig {
+		size_t kdfWorkers{0}; // 0 picks half of the hardware threads
+		size_t kdfQueueSize{256};
+		uint32_t kdfTargetMs{50}; // Startup calibration aims for this latency per password hash
+		uint32_t kdfMinLogN{14}; // scrypt cost floor (16 MiB per hash)
+		uint32_t kdfMaxLogN{17}; // scrypt cost ceiling (128 MiB per hash)
+		size_t oauthCacheSize{10000}; // Validated OAuth tokens remembered at once
+		uint32_t oauthCacheMaxTtlSeconds{300}; // Upper bound on reuse, even for long-lived provider tokens
+	};
+
+	struct LoadSheddingConfig {
+		size_t maxConnections{10000}; // Sessions beyond this are turned away right after the handshake
+		size_t initialLimit{20}; // Starting limit for concurrent database-bound requests
+		size_t minLimit{4};
+		size_t maxLimit{200};
+		double latencyTolerance{2.0}; // Latency growth over the baseline tolerated before the limit shrinks
+		double backoffRatio{0.9};
+	};
+
+	struct RateLimitConfig {
+		// Per connection, checked before a frame is parsed
+		double messagesPerSecond{20.0};
+		double messageBurst{40.0};
+		double bytesPerSecond{64.0 * 1024};
+		double byteBurst{256.0 * 1024};
+		// Login and registration attempts, shared across connections
+		double authPerIpPerMinute{30.0};
+		double authIpBurst{10.0};
+		double authPerUsernamePerMinute{10.0};
+		double authUsernameBurst{5.0};
+	};
+
+	// File output for ServerConfig::logPath
+	struct LoggingConfig {
+		bool fileEnabled{true};
+		std::string format{"text"}; // "text" or "json" (one object per line)
+		size_t bufferBytes{256 * 1024}; // Buffered in memory before a write to the file
+		uint64_t maxFileBytes{100 * 1024 * 1024}; // Rotate when the file would grow past this; 0 disables
+		uint32_t rotateIntervalSeconds{86400}; // Rotate files older than this; 0 disables
+		uint32_t fsyncIntervalMs{1000}; // Also synced on every rotation
+		size_t maxRotatedFiles{10}; // Oldest rotated segments beyond this are deleted
+		bool compressRotated{true}; // gzip rotated segments on a background thread
+	};
+
+	// Prometheus scrape endpoint, separate from the WebSocket port
+	struct MetricsConfig {
+		bool enabled{true};
+		std::string host{"127.0.0.1"};
+		uint16_t port{9100};
+	};
+
+	// Sampled request traces, exported as OTLP/JSON
+	struct TracingConfig {
+		bool enabled{false};
+		double sampleRate{0.01}; // Share of frames traced, 0 to 1
+		size_t bufferSize{8192}; // Spans waiting for export; more are dropped
+		uint32_t exportIntervalMs{1000};
+		std::string filePath{"logs/traces.jsonl"}; // One export request per line; empty disables
+		std::string collectorUrl; // e.g. http://localhost:4318/v1/traces; empty disables
+	};
+
+	// Mention notifications and the inbox that holds them for offline users
+	struct MentionsConfig {
+		size_t maxPerMessage{50}; // Distinct users notified per message; the rest are ignored
+		size_t excerptBytes{160}; // Message text kept with an inbox entry
+		size_t inboxLimit{100}; // Newest mentions delivered per user on login
+		size_t batchSize{256}; // Inbox entries written per statement
+		uint32_t flushIntervalMs{200}; // Longest an inbox entry waits for its batch
+		size_t deliveryThreads{2}; // Threads writing queued frames to online users
+		size_t deliveryQueueCapacity{4096}; // Connections waiting for a delivery thread
+	};
+
+	// Who-is-online updates, sent as a snapshot per scope and then coalesced deltas
+	struct PresenceConfig {
+		std::string defaultRoom{"lobby"}; // Joined by every user on login; empty makes presence opt-in
+		uint32_t windowMs{250}; // Changes within a window are sent as one delta per room or contact list
+		size_t maxRoomsPerUser{32};
+		size_t maxContacts{1000};
+		size_t deliveryThreads{1};
+		size_t deliveryQueueCapacity{4096};
+	};
+
+	struct TypingConfig {
+		uint32_t windowMs{1000}; // At most one typing indicator per user and room or peer per window
+		uint32_t timeoutMs{5000}; // Typing stops when no event arrives for this long
+		size_t maxRoomPeers{200}; // Larger rooms get no typing indicators
+		size_t deliveryThreads{1};
+		size_t deliveryQueueCapacity{4096};
+	};
+
+	struct ShutdownConfig {
+		uint32_t drainWindowMs{10000}; // Clients are told to reconnect a few at a time over this long
+		uint32_t closeGraceMs{5000}; // Then get this long to close before their sockets are shut down
+		uint32_t reconnectJitterMs{2000}; // Random delay up to this is added to each reconnect hint
+		uint32_t databaseTimeoutMs{5000}; // Longest wait for borrowed database connections to come back
 	};
 
 	// Main configuration structure
@@ -50,6 +161,16 @@ namespace nuansa::config {
 		ServerConfig server;
 		DatabaseConfig database;
 		CircuitBreakerConfig circuitBreaker;
+		SecurityConfig security;
+		LoadSheddingConfig loadShedding;
+		RateLimitConfig rateLimit;
+		LoggingConfig logging;
+		MetricsConfig metrics;
+		TracingConfig tracing;
+		MentionsConfig mentions;
+		PresenceConfig presence;
+		TypingConfig typing;
+		ShutdownConfig shutdown;
 	};
 }
 
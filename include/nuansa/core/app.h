@@ -17,8 +17,25 @@ namespace nuansa::core {
 
 	void InitializeLogging();
 
+	void InitializeCircuitBreakers();
+
+	void InitializeMetrics();
+
+	void InitializeTracing();
+
+	void InitializeLoadShedding();
+
 	void InitializeDatabase();
 
+	void InitializeMentions();
+
+	void InitializePresence();
+
+	void InitializeTyping();
+
+	// Drains sessions, flushes what the services still buffer and closes the database pool
+	void Shutdown();
+
 	void Run(const nuansa::utils::ProgramOptions &options);
 } // namespace App
 
@@ -0,0 +1,93 @@
+#ifndef NUANSA_CORE_LISTENER_H
+#define NUANSA_CORE_LISTENER_H
+
+#include "nuansa/utils/pch.h"
+
+namespace nuansa::core {
+    enum class IoMode {
+        Shared, // One io_context and one acceptor, run by every IO thread
+        PerCore // An io_context and an SO_REUSEPORT acceptor per IO thread
+    };
+
+    struct ListenerSettings {
+        std::string host{"0.0.0.0"};
+        uint16_t port{0}; // 0 picks a free port, see GetPort()
+        IoMode mode{IoMode::Shared};
+        size_t threads{0}; // 0 uses the hardware threads
+        bool pinThreads{false}; // PerCore only: bind IO thread i to the i-th CPU the process may run on
+    };
+
+    /**
+     * @brief Accepts TCP connections on IO threads, sharing one io_context or giving each thread its own
+     *
+     * In the shared mode every thread runs the same io_context, so accepts
+     * and handlers from all connections go through one completion queue.
+     * In the per-core mode each thread owns an io_context and its own
+     * acceptor on the same port with SO_REUSEPORT, so the kernel spreads
+     * connections across threads and nothing is handed between them. With
+     * pinning, each IO thread is bound to one CPU on Linux. Threads started
+     * from an IO thread inherit that binding, so long-lived ones such as the
+     * session threads should widen it again with
+     * PinCurrentThread(AllowedCpus()), or the scheduler can never move them.
+     *
+     * The accept handler runs on the thread that accepted the connection,
+     * with the socket bound to that thread's io_context.
+     *
+     * Usage example:
+     * @code
+     * Listener listener(ListenerSettings{.port = 9090, .mode = IoMode::PerCore, .pinThreads = true});
+     * listener.Start([](tcp::socket socket) { StartSession(std::move(socket)); });
+     * // ...
+     * listener.StopAccepting();
+     * listener.Stop();
+     * @endcode
+     */
+    class Listener {
+    public:
+        using AcceptHandler = std::function<void(boost::asio::ip::tcp::socket)>;
+
+        explicit Listener(ListenerSettings settings);
+
+        ~Listener();
+
+        Listener(const Listener &) = delete;
+
+        Listener &operator=(const Listener &) = delete;
+
+        // Binds and starts the IO threads; throws boost::system::system_error when the port is taken
+        void Start(AcceptHandler onAccept);
+
+        // Closes the acceptors; connections already accepted keep running. Safe from any thread
+        void StopAccepting();
+
+        // Stops the io_contexts and joins the IO threads
+        void Stop();
+
+        uint16_t GetPort() const;
+
+        // The first io_context, for work that is not tied to a connection such as signal handling
+        boost::asio::io_context &GetContext();
+
+        size_t ThreadCount() const;
+
+        // The CPUs the IO threads are pinned to, read from the affinity mask once; empty without pinning
+        const std::vector<int> &AllowedCpus() const { return allowedCpus_; }
+
+        // Binds the calling thread to the given CPUs (Linux only); empty leaves it as it is
+        static void PinCurrentThread(const std::vector<int> &cpus);
+
+    private:
+        struct Slot;
+
+        void Accept(Slot &slot);
+
+        ListenerSettings settings_;
+        size_t threadCount_;
+        AcceptHandler onAccept_;
+        std::vector<std::unique_ptr<Slot> > slots_;
+        std::vector<std::thread> threads_;
+        std::vector<int> allowedCpus_;
+    };
+}
+
+#endif //NUANSA_CORE_LISTENER_H
@@ -4,6 +4,9 @@
 #include "nuansa/utils/pch.h"
 #include "nuansa/database/db_connection_pool.h"
 #include "nuansa/utils/exception/database_exception.h"
+#include "nuansa/utils/exception/circuit_breaker_exception.h"
+#include "nuansa/utils/pattern/deadline_watchdog.h"
+#include "nuansa/utils/trace/tracer.h"
 
 namespace nuansa::database {
     // RAII wrapper for connection handling with retry support
@@ -41,6 +44,7 @@ namespace nuansa::database {
                         }
                     }
 
+                    utils::trace::Span span("db.query");
                     return func(*conn_);
 
                 } catch (const pqxx::broken_connection& e) {
@@ -78,6 +82,36 @@ namespace nuansa::database {
             throw std::runtime_error("Max retries exceeded");
         }
 
+        // Runs func once; if it is still running at the deadline the statement is cancelled on the server
+        template<typename F>
+        auto ExecuteWithDeadline(const std::chrono::steady_clock::time_point deadline, F &&func)
+            -> decltype(func(std::declval<pqxx::connection &>())) {
+            if (!conn_ || !conn_->is_open()) {
+                throw std::runtime_error("No valid connection");
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                throw utils::exception::CircuitBreakerTimeoutException("Deadline passed before the query started");
+            }
+
+            auto &conn = *conn_;
+            const auto armed = utils::pattern::DeadlineWatchdog::GetInstance().Arm(deadline, [&conn] {
+                // PQcancel: the backend aborts the statement and the blocked call returns with an error
+                conn.cancel_query();
+            });
+
+            utils::trace::Span span("db.query");
+            try {
+                return func(conn);
+            } catch (const pqxx::query_canceled &e) {
+                span.SetError();
+                if (!armed.Expired()) {
+                    throw;
+                }
+                LOG_WARNING << "Database query cancelled after exceeding its deadline: " << e.what();
+                throw utils::exception::CircuitBreakerTimeoutException("Database query exceeded its deadline");
+            }
+        }
+
     private:
         std::shared_ptr<pqxx::connection> conn_;
     };
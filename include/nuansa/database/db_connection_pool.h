@@ -29,12 +29,16 @@ namespace nuansa::database {
 
         void ReturnConnection(std::shared_ptr<pqxx::connection> conn);
 
-        void Shutdown();
+        // Refuses new acquires, waits up to timeout for borrowed connections to come back and closes them all;
+        // false when some were still borrowed at the deadline
+        bool Shutdown(std::chrono::milliseconds timeout = DEFAULT_TIMEOUT);
 
         bool IsInitialized() const;
 
-        // Add circuit breaker configuration
-        utils::pattern::CircuitBreaker &GetCircuitBreaker() { return circuitBreaker_; }
+        // The primary database breaker, shared with the services that use the pool
+        utils::pattern::CircuitBreaker &GetCircuitBreaker() {
+            return utils::pattern::CircuitBreakerRegistry::GetInstance().Get(utils::pattern::breakers::PRIMARY_DB);
+        }
 
         ConnectionPool(const ConnectionPool &) = delete;
 
@@ -58,13 +62,17 @@ namespace nuansa::database {
         bool initialized_ = false;
         RetryConfig retryConfig_;
 
-        utils::pattern::CircuitBreaker circuitBreaker_;
-
         std::shared_ptr<pqxx::connection> CreateConnection();
 
         std::shared_ptr<pqxx::connection> GetFallbackConnection();
 
         void SetFallbackConnectionString(const std::string &connectionString);
+
+        // Closes the idle connections and forgets the borrowed ones; called with mutex_ held
+        void CloseConnections();
+
+        // Publishes pool occupancy; called with mutex_ held
+        void UpdateGauges() const;
     };
 } // namespace nuansa::database
 
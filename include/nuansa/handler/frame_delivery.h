@@ -0,0 +1,52 @@
+#ifndef NUANSA_HANDLER_FRAME_DELIVERY_H
+#define NUANSA_HANDLER_FRAME_DELIVERY_H
+
+#include "nuansa/utils/pch.h"
+#include "nuansa/handler/websocket_client.h"
+#include "nuansa/utils/pattern/worker_pool.h"
+
+namespace nuansa::handler {
+    /**
+     * @brief Writes frames produced on one thread to connections owned by others
+     *
+     * A frame is queued on the recipient's connection; the first frame of an
+     * idle queue schedules one task on a small pool that drains it, so the
+     * producer never blocks on a slow socket. When the pool is not started,
+     * stopped or full, the producer drains the queue itself.
+     *
+     * Usage example:
+     * @code
+     * FrameDelivery delivery;
+     * delivery.Start(WorkerPoolSettings{.name = "presence-delivery", .threadCount = 1});
+     * auto frame = std::make_shared<const std::string>(json.dump());
+     * for (const auto &client: audience) {
+     *     delivery.Deliver(client, frame);
+     * }
+     * @endcode
+     */
+    class FrameDelivery {
+    public:
+        FrameDelivery() = default;
+
+        FrameDelivery(const FrameDelivery &) = delete;
+
+        FrameDelivery &operator=(const FrameDelivery &) = delete;
+
+        // Startup only
+        void Start(const utils::pattern::WorkerPoolSettings &settings);
+
+        // Drains what was scheduled; later frames are written by their producer
+        void Shutdown();
+
+        // False when the client's queue was full or its connection failed
+        bool Deliver(const std::shared_ptr<WebSocketClient> &client, std::shared_ptr<const std::string> frame);
+
+        // Drains a queue that QueueFrame answered with NeedsFlush, for callers that queue under their own lock
+        void Schedule(const std::shared_ptr<WebSocketClient> &client);
+
+    private:
+        std::unique_ptr<utils::pattern::WorkerPool> pool_;
+    };
+} // namespace nuansa::handler
+
+#endif // NUANSA_HANDLER_FRAME_DELIVERY_H
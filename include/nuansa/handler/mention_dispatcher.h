@@ -0,0 +1,124 @@
+#ifndef NUANSA_HANDLER_MENTION_DISPATCHER_H
+#define NUANSA_HANDLER_MENTION_DISPATCHER_H
+
+#include <condition_variable>
+#include <thread>
+
+#include "nuansa/utils/pch.h"
+#include "nuansa/handler/frame_delivery.h"
+#include "nuansa/handler/websocket_client.h"
+#include "nuansa/handler/websocket_server.h"
+#include "nuansa/messages/message_types.h"
+#include "nuansa/services/chat/imention_inbox.h"
+#include "nuansa/services/user/iuser_service.h"
+
+namespace nuansa::handler {
+    struct MentionDispatcherSettings {
+        size_t maxPerMessage{50}; // Distinct recipients per message; the rest are ignored.
+        size_t excerptBytes{160}; // Message text stored with an inbox entry.
+        size_t inboxLimit{100}; // Newest inbox entries kept per user and sent on login.
+        size_t batchSize{256}; // Inbox entries per write; a full batch is written right away.
+        std::chrono::milliseconds flushInterval{200}; // Longest an inbox entry waits for its batch.
+        size_t deliveryThreads{2}; // Threads writing queued frames to online users.
+        size_t deliveryQueueCapacity{4096}; // Connections waiting for a delivery thread.
+        services::chat::IMentionInbox *inbox{nullptr}; // Defaults to the storage registry's inbox.
+        services::user::IUserService *users{nullptr}; // Defaults to the storage registry's users.
+    };
+
+    struct MentionDispatchResult {
+        size_t online{0}; // Queued on a connection
+        size_t offline{0}; // Buffered for the inbox
+        size_t dropped{0}; // Send queue or inbox buffer full
+    };
+
+    /**
+     * @brief Delivers mention notifications without blocking the sender's session
+     *
+     * A message's mentions are deduplicated, capped and resolved against the
+     * client registry in one lookup. Online recipients share one serialized
+     * frame that is queued on their connection and written by a small
+     * delivery pool, so a slow reader never stalls the sender. Offline
+     * recipients get a compact inbox entry (sender, message id, excerpt)
+     * that is buffered and written in batches by a background thread. The
+     * writer checks each recipient against the user store first, so an
+     * "@word" that names nobody is never stored, and the store keeps only
+     * the newest inboxLimit entries per user. On login the whole inbox
+     * arrives as a single mention_inbox frame.
+     *
+     * Until Configure is called everything happens on the calling thread:
+     * frames are written inline and inbox entries are stored immediately.
+     *
+     * Usage example:
+     * @code
+     * MentionDispatcher::GetInstance().Configure(MentionDispatcherSettings{.batchSize = 512});
+     *
+     * // Session thread, after a message was accepted
+     * MentionDispatcher::GetInstance().Dispatch(message, *websocketServer);
+     *
+     * // After login, once the client is registered
+     * MentionDispatcher::GetInstance().DeliverInbox(client);
+     * @endcode
+     */
+    class MentionDispatcher {
+    public:
+        static MentionDispatcher &GetInstance();
+
+        MentionDispatcher() = default;
+
+        ~MentionDispatcher();
+
+        MentionDispatcher(const MentionDispatcher &) = delete;
+
+        MentionDispatcher &operator=(const MentionDispatcher &) = delete;
+
+        // Startup only; starts the delivery pool and the inbox writer
+        void Configure(const MentionDispatcherSettings &settings);
+
+        // Writes buffered inbox entries and stops the background threads
+        void Shutdown();
+
+        MentionDispatchResult Dispatch(const messages::Message &message, const WebSocketServer &registry);
+
+        // Sends the user's waiting mentions in one frame and clears them; returns how many were sent
+        size_t DeliverInbox(const std::shared_ptr<WebSocketClient> &client);
+
+        // Writes buffered inbox entries on the calling thread; returns how many were stored
+        size_t FlushInbox();
+
+        size_t PendingInboxEntries() const;
+
+        // Mentions worth notifying: sorted, unique, without the sender, at most maxRecipients
+        static std::vector<std::string_view> ResolveRecipients(const messages::Message &message,
+                                                               size_t maxRecipients);
+
+        // Leading bytes of content, cut back to a UTF-8 character boundary
+        static std::string_view Excerpt(std::string_view content, size_t maxBytes);
+
+        static std::string BuildInboxMessage(const std::vector<services::chat::InboxMention> &mentions);
+
+    private:
+        // Buffers entries for the writer thread; returns how many were dropped because the buffer is full
+        size_t BufferInbox(std::vector<services::chat::InboxMention> &&mentions);
+
+        // Writes the entries whose recipient is a user; returns how many were stored
+        size_t StoreInbox(const std::vector<services::chat::InboxMention> &mentions) const;
+
+        services::chat::IMentionInbox &Inbox() const;
+
+        services::user::IUserService &Users() const;
+
+        void Run();
+
+        MentionDispatcherSettings settings_;
+        FrameDelivery delivery_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable wake_;
+        std::vector<services::chat::InboxMention> pending_;
+        bool running_{false};
+        bool stopping_{false};
+        std::thread thread_;
+    };
+} // namespace nuansa::handler
+
+#endif // NUANSA_HANDLER_MENTION_DISPATCHER_H
@@ -0,0 +1,168 @@
+#ifndef NUANSA_HANDLER_PRESENCE_SERVICE_H
+#define NUANSA_HANDLER_PRESENCE_SERVICE_H
+
+#include <condition_variable>
+#include <thread>
+#include <unordered_set>
+
+#include "nuansa/utils/pch.h"
+#include "nuansa/handler/frame_delivery.h"
+#include "nuansa/handler/websocket_client.h"
+
+namespace nuansa::handler {
+    struct PresenceSettings {
+        std::string defaultRoom{"lobby"}; // Joined by everyone on login; empty leaves presence opt-in.
+        std::chrono::milliseconds window{250}; // Changes within a window go out as one delta per scope.
+        size_t maxRoomsPerUser{32};
+        size_t maxContacts{1000};
+        size_t deliveryThreads{1};
+        size_t deliveryQueueCapacity{4096};
+    };
+
+    /**
+     * @brief Tells clients who is online, scoped to their rooms and contact lists
+     *
+     * A scope is either a room, whose members see each other, or one user's
+     * contact list, which only that user sees. Subscribing to a scope queues
+     * a presence_snapshot with the scope's version; after that only
+     * presence_delta frames follow, each with the next version. Changes are
+     * coalesced per window, so a user who drops and reconnects within it
+     * produces nothing, and each delta is serialized once for the whole
+     * audience instead of once per change and recipient.
+     *
+     * Snapshots and deltas for a client go through the same connection
+     * queue, so a client applies deltas whose version is greater than its
+     * snapshot's and never sees one out of order.
+     *
+     * Usage example:
+     * @code
+     * auto &presence = PresenceService::GetInstance();
+     * presence.Configure(PresenceSettings{.window = std::chrono::milliseconds(500)});
+     *
+     * presence.Connect(client);                      // snapshot of the default room
+     * presence.JoinRooms(client, {"dev", "ops"});    // snapshots of both rooms
+     * presence.SetContacts(client, {"bob", "carol"}); // snapshot of the contact list
+     * presence.Disconnect(client);                   // others see it in the next delta
+     * @endcode
+     */
+    class PresenceService {
+    public:
+        static PresenceService &GetInstance();
+
+        PresenceService() = default;
+
+        ~PresenceService();
+
+        PresenceService(const PresenceService &) = delete;
+
+        PresenceService &operator=(const PresenceService &) = delete;
+
+        // Startup only; starts the delta thread and the delivery pool
+        void Configure(const PresenceSettings &settings);
+
+        // Publishes pending deltas and stops the background threads
+        void Shutdown();
+
+        // Marks the user online on this connection and joins the default room; a newer login replaces an older one
+        void Connect(const std::shared_ptr<WebSocketClient> &client);
+
+        // Marks the user offline and leaves every scope; ignored unless client is the user's current connection
+        void Disconnect(const std::shared_ptr<WebSocketClient> &client);
+
+        // Returns the rooms actually joined; invalid names and those past maxRoomsPerUser are skipped
+        std::vector<std::string> JoinRooms(const std::shared_ptr<WebSocketClient> &client,
+                                           const std::vector<std::string> &rooms);
+
+        void LeaveRooms(const std::shared_ptr<WebSocketClient> &client, const std::vector<std::string> &rooms);
+
+        // Replaces the user's contact list, truncated to maxContacts
+        void SetContacts(const std::shared_ptr<WebSocketClient> &client, const std::vector<std::string> &contacts);
+
+        // Queues a fresh snapshot of every scope the user is subscribed to
+        void SendSnapshots(const std::shared_ptr<WebSocketClient> &client);
+
+        // Publishes the deltas accumulated since the last call; returns how many frames were queued
+        size_t Flush();
+
+        bool IsOnline(const std::string &username) const;
+
+        // The user's current connection, or null when offline
+        std::shared_ptr<WebSocketClient> FindClient(const std::string &username) const;
+
+        // Connections of the room's other members; nullopt unless username is a member and at most maxPeers others are
+        std::optional<std::vector<std::shared_ptr<WebSocketClient> > > RoomPeers(const std::string &room,
+                                                                                const std::string &username,
+                                                                                size_t maxPeers) const;
+
+        static bool IsValidRoomName(std::string_view room);
+
+    private:
+        // A user's state as of the last delta, kept for users that changed since
+        using PendingChanges = std::unordered_map<std::string, bool>;
+
+        struct Room {
+            uint64_t version{0};
+            std::unordered_set<std::string> members;
+            PendingChanges pending;
+        };
+
+        struct ContactList {
+            uint64_t version{0};
+            std::unordered_set<std::string> contacts;
+            PendingChanges pending;
+        };
+
+        // Clients whose queue needs a delivery thread once mutex_ is released
+        using Flushes = std::vector<std::shared_ptr<WebSocketClient> >;
+
+        // The helpers below expect mutex_ to be held
+        bool IsCurrent(const std::shared_ptr<WebSocketClient> &client) const;
+
+        void NotifyWatchers(const std::string &username, bool online);
+
+        bool JoinRoom(const std::string &username, const std::string &room);
+
+        void LeaveRoom(const std::string &username, const std::string &room);
+
+        void ClearContacts(const std::string &username);
+
+        // Queued while mutex_ is held so no delta published after the snapshot can overtake it
+        void QueueSnapshot(const std::shared_ptr<WebSocketClient> &client, std::shared_ptr<const std::string> frame,
+                           Flushes &flushes);
+
+        void QueueRoomSnapshot(const std::shared_ptr<WebSocketClient> &client, const std::string &room,
+                               Flushes &flushes);
+
+        void QueueContactSnapshot(const std::shared_ptr<WebSocketClient> &client, Flushes &flushes);
+
+        void Schedule(const Flushes &flushes);
+
+        static std::shared_ptr<const std::string> BuildSnapshot(std::string_view scope, uint64_t version,
+                                                                const std::vector<std::string_view> &online);
+
+        static std::shared_ptr<const std::string> BuildDelta(std::string_view scope, uint64_t version,
+                                                             const std::vector<std::string_view> &online,
+                                                             const std::vector<std::string_view> &offline);
+
+        void Run();
+
+        PresenceSettings settings_;
+        FrameDelivery delivery_;
+
+        std::mutex flushMutex_; // Keeps deltas of one scope in version order
+        mutable std::mutex mutex_;
+        std::unordered_map<std::string, std::shared_ptr<WebSocketClient> > clients_; // Online users
+        std::unordered_map<std::string, Room> rooms_;
+        std::unordered_map<std::string, std::unordered_set<std::string> > roomsByUser_;
+        std::unordered_map<std::string, ContactList> contactLists_; // By owner
+        std::unordered_map<std::string, std::unordered_set<std::string> > watchers_; // Contact list owners by contact
+        std::unordered_set<std::string> dirtyRooms_;
+        std::unordered_set<std::string> dirtyContactLists_;
+
+        std::condition_variable wake_;
+        bool stopping_{false};
+        std::thread thread_;
+    };
+} // namespace nuansa::handler
+
+#endif // NUANSA_HANDLER_PRESENCE_SERVICE_H
@@ -0,0 +1,78 @@
+#ifndef NUANSA_HANDLER_SESSION_DRAINER_H
+#define NUANSA_HANDLER_SESSION_DRAINER_H
+
+#include <condition_variable>
+#include <unordered_set>
+
+#include "nuansa/utils/pch.h"
+#include "nuansa/handler/websocket_client.h"
+
+namespace nuansa::handler {
+    struct DrainSettings {
+        std::chrono::milliseconds window{10000}; // Reconnect hints are spread evenly over this long.
+        std::chrono::milliseconds grace{5000}; // After the window, how long clients get to close before being cut off.
+        std::chrono::milliseconds reconnectJitter{2000}; // Clients are told to wait a random delay up to this.
+        size_t deliveryThreads{2}; // Threads writing hints, so a slow client doesn't hold up the others.
+    };
+
+    /**
+     * @brief Closes every session gradually when the server stops
+     *
+     * Sessions register for their lifetime. Drain turns new sessions away
+     * and sends each open one a reconnect frame carrying a randomized
+     * retryAfterMs, staggered over the window, so clients reconnect to the
+     * remaining instances a few at a time instead of all at once. The hint
+     * is queued behind the frames already waiting for the client, so those
+     * are written first.
+     *
+     * A hinted client is expected to close its end. A session that reads
+     * another frame first closes with going_away itself. Clients still
+     * connected when the grace period ends have their sockets shut down.
+     *
+     * Usage example:
+     * @code
+     * // Session thread
+     * auto &drainer = SessionDrainer::GetInstance();
+     * drainer.Register(client);
+     * while (!client->CloseRequested()) { ... }
+     * drainer.Unregister(client);
+     *
+     * // On SIGTERM, once the acceptor is closed
+     * const auto remaining = drainer.Drain(DrainSettings{.window = std::chrono::seconds(30)});
+     * @endcode
+     */
+    class SessionDrainer {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static SessionDrainer &GetInstance();
+
+        SessionDrainer() = default;
+
+        SessionDrainer(const SessionDrainer &) = delete;
+
+        SessionDrainer &operator=(const SessionDrainer &) = delete;
+
+        // Once draining, the client is asked to close right away
+        void Register(const std::shared_ptr<WebSocketClient> &client);
+
+        void Unregister(const std::shared_ptr<WebSocketClient> &client);
+
+        bool IsDraining() const;
+
+        size_t ActiveSessions() const;
+
+        // Blocks until every session ended or was cut off; returns how many outlived even that
+        size_t Drain(const DrainSettings &settings);
+
+        static std::string BuildReconnectMessage(std::chrono::milliseconds retryAfter);
+
+    private:
+        mutable std::mutex mutex_;
+        std::condition_variable ended_;
+        std::unordered_set<std::shared_ptr<WebSocketClient> > sessions_;
+        bool draining_{false};
+    };
+} // namespace nuansa::handler
+
+#endif // NUANSA_HANDLER_SESSION_DRAINER_H
@@ -0,0 +1,125 @@
+#ifndef NUANSA_HANDLER_TYPING_SERVICE_H
+#define NUANSA_HANDLER_TYPING_SERVICE_H
+
+#include <condition_variable>
+#include <thread>
+
+#include "nuansa/utils/pch.h"
+#include "nuansa/handler/frame_delivery.h"
+#include "nuansa/handler/presence_service.h"
+#include "nuansa/handler/websocket_client.h"
+
+namespace nuansa::handler {
+    struct TypingSettings {
+        std::chrono::milliseconds window{1000}; // At most one indicator per user and room or peer per window.
+        std::chrono::milliseconds timeout{5000}; // A user who stops sending typing events stops typing.
+        size_t maxRoomPeers{200}; // Larger rooms get no typing indicators.
+        size_t deliveryThreads{1};
+        size_t deliveryQueueCapacity{4096};
+        PresenceService *presence{nullptr}; // Defaults to PresenceService::GetInstance().
+    };
+
+    // One typing event: exactly one of room and recipient is set
+    struct TypingEvent {
+        std::string room;
+        std::string recipient;
+        bool typing{false};
+    };
+
+    enum class TypingResult {
+        Sent, // Queued for the room's other members or the recipient
+        Held, // Within the window; the latest state goes out when it ends
+        Duplicate, // Same state as already sent
+        Rejected // No such room membership or recipient, or the room is too large
+    };
+
+    /**
+     * @brief Lossy fast path for typing indicators
+     *
+     * Clients send a typing event on every keystroke. The session loop
+     * picks these frames out before the message is parsed into a JSON
+     * document, logged or traced, and hands them here. Each (user, room or
+     * peer) pair keeps the last state sent: repeats are dropped, the first
+     * change is sent right away, and further changes within the window are
+     * held so only the latest goes out when it ends. The indicator frame is
+     * written by hand, serialized once for all of the room's other members,
+     * and dropped for any recipient whose send queue is full. Nothing is
+     * stored.
+     *
+     * Room membership and connections come from PresenceService.
+     *
+     * Usage example:
+     * @code
+     * TypingService::GetInstance().Configure(TypingSettings{.window = std::chrono::milliseconds(500)});
+     *
+     * // Session thread, for each frame of an authenticated client
+     * if (const auto event = TypingService::ParseFrame(frame)) {
+     *     TypingService::GetInstance().Publish(client, *event);
+     * }
+     * @endcode
+     */
+    class TypingService {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static TypingService &GetInstance();
+
+        TypingService() = default;
+
+        ~TypingService();
+
+        TypingService(const TypingService &) = delete;
+
+        TypingService &operator=(const TypingService &) = delete;
+
+        // Startup only; starts the thread sending held states and the delivery pool
+        void Configure(const TypingSettings &settings);
+
+        // Stops the background threads; held states are dropped
+        void Shutdown();
+
+        TypingResult Publish(const std::shared_ptr<WebSocketClient> &client, const TypingEvent &event,
+                             Clock::time_point now = Clock::now());
+
+        // Sends held states whose window ended and stops typing that timed out; returns how many were sent
+        size_t Flush(Clock::time_point now = Clock::now());
+
+        // Tells everyone the user was typing to that they stopped
+        void Disconnect(const std::string &username);
+
+        // nullopt unless frame is a JSON object whose type is "typing"; a malformed event has neither scope set
+        static std::optional<TypingEvent> ParseFrame(std::string_view frame);
+
+        static std::string BuildFrame(std::string_view username, std::string_view room, bool typing);
+
+    private:
+        struct Indicator {
+            bool sent{false}; // Last state the audience was told
+            bool latest{false}; // Last state the user reported
+            Clock::time_point sentAt;
+            Clock::time_point updatedAt;
+        };
+
+        // Indicators of one user, keyed by "room:<name>" or "user:<name>"
+        using Indicators = std::unordered_map<std::string, Indicator>;
+
+        // Queues the indicator's latest state; expects mutex_ to be held
+        bool Send(const std::string &username, const std::string &scope, Indicator &indicator,
+                  Clock::time_point now, std::vector<std::shared_ptr<WebSocketClient> > &flushes);
+
+        PresenceService &Presence() const;
+
+        void Run();
+
+        TypingSettings settings_;
+        FrameDelivery delivery_;
+
+        std::mutex mutex_;
+        std::unordered_map<std::string, Indicators> indicators_; // By user
+        std::condition_variable wake_;
+        bool stopping_{false};
+        std::thread thread_;
+    };
+} // namespace nuansa::handler
+
+#endif // NUANSA_HANDLER_TYPING_SERVICE_H
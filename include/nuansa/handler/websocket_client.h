@@ -4,6 +4,7 @@
 #include "nuansa/utils/pch.h"
 #include "nuansa/messages/message_types.h"
 #include "nuansa/services/auth/auth_status.h"
+#include "nuansa/utils/pattern/token_bucket.h"
 
 namespace nuansa::handler {
 	enum class ClientState {
@@ -13,13 +14,33 @@ namespace nuansa::handler {
 		Disconnected
 	};
 
+	// Inbound limits for one connection
+	struct ClientRateLimits {
+		utils::pattern::TokenBucketSettings messages{.ratePerSecond = 20, .burst = 40};
+		utils::pattern::TokenBucketSettings bytes{.ratePerSecond = 64 * 1024, .burst = 256 * 1024};
+	};
+
 	class WebSocketClient {
 	public:
-		WebSocketClient(std::string id, const std::shared_ptr<websocket::stream<tcp::socket> > &ws)
-			: authStatus(), ws(ws), clientId(std::move(id)), state() {
-			// Initialize any other members here
+		// Frames other sessions may have waiting for this client before new ones are dropped
+		static constexpr size_t OUTBOUND_QUEUE_LIMIT = 256;
+
+		enum class QueueResult {
+			Queued, // Joined frames that a flush already in progress will write
+			NeedsFlush, // The caller must arrange for FlushOutbound to run
+			Dropped // The queue was full or the connection failed
+		};
+
+		WebSocketClient(std::string id, const std::shared_ptr<websocket::stream<tcp::socket> > &ws,
+		                const ClientRateLimits &limits = ClientRateLimits{})
+			: authStatus(), ws(ws), clientId(std::move(id)), state(),
+			  messageBucket(limits.messages), byteBucket(limits.bytes) {
 		}
 
+		WebSocketClient(const WebSocketClient &) = delete;
+
+		WebSocketClient &operator=(const WebSocketClient &) = delete;
+
 		// Getters and setters
 		[[nodiscard]] std::shared_ptr<websocket::stream<tcp::socket> > GetWebSocket() const { return ws; }
 		void SetState(const ClientState newState) { state = newState; }
@@ -32,10 +53,42 @@ namespace nuansa::handler {
 		void SetAuthStatus(const nuansa::services::auth::AuthStatus status) { authStatus = status; }
 		void SetAuthToken(const std::string &token) { authToken = token; }
 
+		// Spends one message and the frame's bytes, or nothing when either is short; called by the session
+		// thread before the frame is parsed
+		[[nodiscard]] bool AllowFrame(const size_t bytes) {
+			const auto now = utils::pattern::TokenBucket::Clock::now();
+			const auto cost = static_cast<double>(bytes);
+			if (messageBucket.Available(now) < 1.0 || byteBucket.Available(now) < cost) {
+				return false;
+			}
+			return messageBucket.TryConsume(1.0, now) && byteBucket.TryConsume(cost, now);
+		}
+
+		// Writes one text frame; writers on other threads wait, so frames never interleave. Throws on failure.
+		void Write(std::string_view frame);
+
+		// Hands a frame to the connection without writing it on the calling thread
+		QueueResult QueueFrame(std::shared_ptr<const std::string> frame);
+
+		// Writes queued frames until none are left; returns how many were written
+		size_t FlushOutbound();
+
+		// Close handshake, serialized with writers. Throws on failure.
+		void Close(const websocket::close_reason &reason);
+
+		// Shuts the socket down so blocked reads and writes fail; for a peer that will not close
+		void Terminate();
+
+		// Asks the session to close after the frame it is reading; any thread
+		void RequestClose() { closeRequested.store(true, std::memory_order_relaxed); }
+
+		[[nodiscard]] bool CloseRequested() const { return closeRequested.load(std::memory_order_relaxed); }
+
 		// Public members (could be made private with getters/setters)
 		std::string username;
 		std::optional<std::string> authToken;
 		nuansa::services::auth::AuthStatus authStatus;
+		std::string remoteAddress;
 
 	private:
 		std::shared_ptr<websocket::stream<tcp::socket> > ws;
@@ -43,6 +96,17 @@ namespace nuansa::handler {
 
 
 		ClientState state;
+		utils::pattern::TokenBucket messageBucket;
+		utils::pattern::TokenBucket byteBucket;
+
+		std::mutex writeMutex;
+
+		std::mutex outboundMutex;
+		std::deque<std::shared_ptr<const std::string> > outbound;
+		bool flushing{false};
+		bool writeFailed{false};
+
+		std::atomic<bool> closeRequested{false};
 	};
 } // namespace nuansa::handler
 
@@ -25,9 +25,11 @@ namespace nuansa::handler {
                                    bool success,
                                    const std::string &details = "");
 
-        void SendTypingNotification(const std::string &username, bool isTyping,
-                                    const std::string &recipient = "") const;
+        // To the room's other members, or to recipient when room is empty; coalesced and lossy
+        static void SendTypingNotification(const std::shared_ptr<WebSocketClient> &client, bool isTyping,
+                                           const std::string &room, const std::string &recipient = "");
 
+        // Presence snapshots of the client's rooms and contacts, not every online user
         void SendOnlineUsersList(const std::shared_ptr<WebSocketClient> &client) const;
 
         bool IsUserOnline(const std::string &username) const;
@@ -41,7 +43,11 @@ namespace nuansa::handler {
         static void SendErrorMessage(const std::shared_ptr<WebSocketClient> &client, const std::string &errorMessage,
                                      const std::string &errorCode = "");
 
-        static std::vector<std::string> ExtractMentions(const std::string &content);
+        // Error frame for shed work; the client should wait retryAfter before trying again
+        static std::string BuildOverloadedMessage(std::chrono::milliseconds retryAfter);
+
+        // Views into content, valid as long as content is
+        static std::vector<std::string_view> ExtractMentions(std::string_view content);
 
         void NotifyMentionedUsers(const nuansa::messages::Message &msg) const;
 
@@ -1,26 +1,65 @@
 #ifndef NUANSA_WEBSOCKET_SERVER_H
 #define NUANSA_WEBSOCKET_SERVER_H
 
+#include <shared_mutex>
+
 #include "nuansa/utils/pch.h"
 #include "nuansa/handler/websocket_client.h"
 #include "nuansa/messages/message_types.h"
 
 namespace nuansa::handler {
+	/**
+	 * @brief Registry of authenticated connections, keyed by username
+	 *
+	 * Every session thread reads it (online checks, mention and broadcast
+	 * fan-out) while logins and disconnects write it, so lookups share a
+	 * reader/writer lock and hand out shared_ptrs that stay valid after the
+	 * lock is released. FindClients resolves a whole recipient list under a
+	 * single lock acquisition.
+	 *
+	 * Usage example:
+	 * @code
+	 * server->AddClient(client->username, client);
+	 * for (const auto &[name, recipient]: server->FindClients(mentions)) {
+	 *     recipient->QueueFrame(frame);
+	 * }
+	 * server->RemoveClient(client->username, client);
+	 * @endcode
+	 */
 	class WebSocketServer {
 	public:
 		WebSocketServer() = default;
 
-		void AddClient(const std::string &username, const WebSocketClient &client);
+		// Registers the client under username, replacing an older connection of the same user
+		void AddClient(const std::string &username, const std::shared_ptr<WebSocketClient> &client);
+
+		// Removes username only while it still maps to client, so a stale session can't drop a newer login
+		bool RemoveClient(const std::string &username, const std::shared_ptr<WebSocketClient> &client);
+
+		std::shared_ptr<WebSocketClient> FindClient(const std::string &username) const;
+
+		// Online clients among usernames; names that are not connected are left out
+		std::vector<std::pair<std::string_view, std::shared_ptr<WebSocketClient> > > FindClients(
+			const std::vector<std::string_view> &usernames) const;
 
-		void RemoveClient(const std::string &username);
+		bool IsOnline(const std::string &username) const;
+
+		size_t ClientCount() const;
+
+		std::vector<std::string> GetUsernames() const;
+
+		// Copy of the registry for fan-out without holding the lock while writing
+		std::vector<std::shared_ptr<WebSocketClient> > GetClients() const;
 
 		void BroadcastMessage(const std::string &message);
 
 		void StoreMessage(const nuansa::messages::Message &message);
 
-		// TODO: make private with accessors
-		std::map<std::string, WebSocketClient> clients;
 		std::map<std::string, nuansa::messages::Message> messages;
+
+	private:
+		mutable std::shared_mutex clientsMutex;
+		std::unordered_map<std::string, std::shared_ptr<WebSocketClient> > clients;
 	};
 } // namespace nuansa::handler
 
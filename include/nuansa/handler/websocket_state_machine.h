@@ -6,6 +6,12 @@
 #include "nuansa/handler/websocket_server.h"
 
 namespace nuansa::handler {
+	enum class AuthOutcome {
+		Succeeded,
+		Failed, // Refused or invalid; the request itself still completed
+		Overloaded // A dependency was saturated or unavailable
+	};
+
 	class WebSocketStateMachine {
 	public:
 		WebSocketStateMachine(std::shared_ptr<WebSocketClient> client, std::shared_ptr<WebSocketServer> server);
@@ -18,7 +24,7 @@ namespace nuansa::handler {
 
 		void TransitionTo(ClientState newState);
 
-		[[nodiscard]] bool HandleLogin(const nlohmann::json &msgData) const;
+		[[nodiscard]] AuthOutcome HandleLogin(const nlohmann::json &msgData) const;
 
 	private:
 		std::shared_ptr<WebSocketClient> client;
@@ -33,13 +39,13 @@ namespace nuansa::handler {
 		void HandleAuthenticatedState(const nlohmann::json &msgData);
 
 		// Message handlers
-		void HandleRegistration(const nlohmann::json &msgData) const;
+		AuthOutcome HandleRegistration(const nlohmann::json &msgData) const;
 
 		static void HandleAuth(const std::string &message);
 
 		static void HandleLogout();
 
-		static void HandleNewMessage(const nlohmann::json &msgData);
+		void HandleNewMessage(const nlohmann::json &msgData) const;
 
 		static void HandleEditMessage(const nlohmann::json &msgData);
 
@@ -49,8 +55,14 @@ namespace nuansa::handler {
 
 		static void HandlePluginMessage(const nlohmann::json &msgData);
 
+		// Joins rooms and/or replaces the contact list whose presence the client follows
+		void HandlePresenceSubscribe(const nlohmann::json &msgData) const;
+
+		void HandlePresenceUnsubscribe(const nlohmann::json &msgData) const;
+
 		// Helper methods
-		static void AddAuthenticatedClient();
+		// Registers the client for delivery and presence, and sends the mentions it missed while offline
+		void AddAuthenticatedClient() const;
 
 		static void SendAuthRequiredMessage();
 
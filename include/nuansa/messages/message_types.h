@@ -32,7 +32,10 @@ namespace nuansa::messages {
         Logout, // New
         AuthRequired, // New
         Plugin, // New
-        Register
+        Register,
+        PresenceSubscribe,
+        PresenceUnsubscribe,
+        Typing
     };
 
     inline std::string MessageTypeToString(const MessageType messageType) {
@@ -46,6 +49,9 @@ namespace nuansa::messages {
             case MessageType::Logout: return "logout";
             case MessageType::AuthRequired: return "auth_required";
             case MessageType::Plugin: return "plugin";
+            case MessageType::PresenceSubscribe: return "presence_subscribe";
+            case MessageType::PresenceUnsubscribe: return "presence_unsubscribe";
+            case MessageType::Typing: return "typing";
             default: return "unknown";
         }
     }
@@ -59,7 +65,10 @@ namespace nuansa::messages {
                                  {MessageType::Logout, "logout"},
                                  {MessageType::AuthRequired, "auth_required"},
                                  {MessageType::Plugin, "plugin"},
-                                 {MessageType::Register, "register"}
+                                 {MessageType::Register, "register"},
+                                 {MessageType::PresenceSubscribe, "presence_subscribe"},
+                                 {MessageType::PresenceUnsubscribe, "presence_unsubscribe"},
+                                 {MessageType::Typing, "typing"}
                                  });
 }
 
@@ -42,14 +42,19 @@ namespace nuansa::services::auth {
 
 
 	struct AuthResponse final : public nuansa::messages::BaseMessage {
-		AuthResponse(const bool success, std::string token, std::string message)
-			: success_(success), token_(std::move(token)), message_(std::move(message)) {
+		AuthResponse(const bool success, std::string token, std::string message, const bool overloaded = false)
+			: success_(success), token_(std::move(token)), message_(std::move(message)), overloaded_(overloaded) {
 		}
 
 		[[nodiscard]] bool IsSuccess() const {
 			return success_;
 		}
 
+		// Failed because a dependency was saturated or down, not because of the request
+		[[nodiscard]] bool IsOverloaded() const {
+			return overloaded_;
+		}
+
 		[[nodiscard]] std::string GetToken() const {
 			return token_;
 		}
@@ -76,6 +81,7 @@ namespace nuansa::services::auth {
 		bool success_;
 		std::string token_;
 		std::string message_;
+		bool overloaded_;
 	};
 }
 
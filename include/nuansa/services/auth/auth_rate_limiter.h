@@ -0,0 +1,37 @@
+#ifndef NUANSA_SERVICES_AUTH_AUTH_RATE_LIMITER_H
+#define NUANSA_SERVICES_AUTH_AUTH_RATE_LIMITER_H
+
+#include "nuansa/utils/pch.h"
+#include "nuansa/utils/pattern/token_bucket.h"
+
+namespace nuansa::services::auth {
+	struct AuthRateLimiterSettings {
+		utils::pattern::TokenBucketSettings perIp{.ratePerSecond = 0.5, .burst = 10};
+		utils::pattern::TokenBucketSettings perUsername{.ratePerSecond = 10.0 / 60, .burst = 5};
+	};
+
+	// Throttles login and registration attempts by client address and by target username,
+	// across all connections, so no single client can keep the password KDF and database busy
+	class AuthRateLimiter {
+	public:
+		// Settings come from the rate_limit configuration section
+		static AuthRateLimiter &GetInstance();
+
+		explicit AuthRateLimiter(const AuthRateLimiterSettings &settings);
+
+		AuthRateLimiter(const AuthRateLimiter &) = delete;
+
+		AuthRateLimiter &operator=(const AuthRateLimiter &) = delete;
+
+		// Spends one attempt from each bucket; an empty username (OAuth) is only limited by address
+		bool Allow(const std::string &address, const std::string &username);
+
+		size_t TrackedKeys() const;
+
+	private:
+		utils::pattern::TokenBucketTable byAddress_;
+		utils::pattern::TokenBucketTable byUsername_;
+	};
+}
+
+#endif //NUANSA_SERVICES_AUTH_AUTH_RATE_LIMITER_H
@@ -7,7 +7,12 @@
 #include "nuansa/services/auth/register_message.h"
 #include "nuansa/services/auth/auth_types.h"
 #include "nuansa/utils/http_client.h"
+#include "nuansa/services/auth/google_id_token_verifier.h"
 #include "nuansa/services/token/token_service.h"
+#include "nuansa/utils/pattern/striped_lock.h"
+#include "nuansa/utils/pattern/single_flight.h"
+#include "nuansa/utils/pattern/circuit_breaker.h"
+#include "nuansa/utils/cache/lru_cache.h"
 
 namespace nuansa::services::auth {
 	class AuthService {
@@ -31,13 +36,15 @@ namespace nuansa::services::auth {
 			std::string email;     // User's email
 			std::string username;  // User's name/username
 			std::string picture;   // Profile picture URL
+			int64_t expiresAt{0};  // Provider token expiry (Unix seconds), 0 if unknown
 		};
 
 	private:
 
 		std::unique_ptr<nuansa::services::token::TokenService> tokenService_;
 		std::unordered_map<std::string, std::string> userCredentials; // username -> password hash
-		std::timed_mutex authMutex;
+		// Serializes registration per username/email; unrelated identities proceed in parallel
+		utils::pattern::StripedLock identityLocks_{64};
 		std::random_device rd;
 		std::mt19937 gen;
 
@@ -45,12 +52,27 @@ namespace nuansa::services::auth {
 		bool ValidateGitHubTokenClaims(const nlohmann::json& tokenInfo);
 		bool VerifyGitHubScopes(const std::vector<std::string>& headers);
 
+		// Authenticate and Register without the latency metrics around them
+		AuthResponse AuthenticateUser(const AuthRequest& request);
+		AuthResponse RegisterUser(const RegisterRequest& request);
+
 		// OAuth methods
 		AuthResponse HandleOAuthRegistration(const RegisterRequest& request);
 		AuthResponse HandleCustomRegistration(const RegisterRequest& request);
 		
+		// Cached and coalesced front for the provider-specific validators below
+		std::optional<OAuthUserInfo> ValidateOAuthToken(AuthProvider provider, const OAuthCredentials& credentials);
+		std::chrono::milliseconds OAuthCacheTtl(const OAuthUserInfo& userInfo) const;
+
 		// OAuth provider-specific methods
 		std::optional<OAuthUserInfo> ValidateGoogleToken(const OAuthCredentials& credentials);
+		std::optional<OAuthUserInfo> ValidateGoogleIdToken(const std::string& idToken);
+
+		// Runs a provider request through that provider's circuit breaker; 4xx answers don't count as failures.
+		// The request is handed the breaker's timeout and must pass it on to the HTTP client.
+		static utils::HttpClient::Response CallProvider(
+			utils::pattern::CircuitBreaker& breaker,
+			const std::function<utils::HttpClient::Response(std::chrono::milliseconds)>& request);
 		std::optional<OAuthUserInfo> ValidateGitHubToken(const OAuthCredentials& credentials);
 		
 		// Google
@@ -72,7 +94,16 @@ namespace nuansa::services::auth {
 		std::string GITHUB_USER_EMAILS_URL;
 
 		std::unique_ptr<utils::HttpClient> httpClient;
+		// Null when Google sign-in isn't configured; declared after httpClient, which it uses
+		std::unique_ptr<GoogleIdTokenVerifier> googleIdTokenVerifier_;
+
+		utils::pattern::CircuitBreaker& googleBreaker_;
+		utils::pattern::CircuitBreaker& githubBreaker_;
 
+		// Keyed by provider and SHA-256 of the ID token or access token, never the raw secret; GitHub
+		// authorization codes are single use and bypass both
+		utils::cache::LruCache<std::string, OAuthUserInfo> oauthCache_;
+		utils::pattern::SingleFlight<std::string, std::optional<OAuthUserInfo> > oauthFlights_;
 		
 	};
 }
@@ -0,0 +1,92 @@
+#ifndef NUANSA_SERVICES_AUTH_GOOGLE_ID_TOKEN_VERIFIER_H
+#define NUANSA_SERVICES_AUTH_GOOGLE_ID_TOKEN_VERIFIER_H
+
+#include "nuansa/utils/pch.h"
+
+#include <openssl/evp.h>
+
+#include "nuansa/utils/http_client.h"
+
+namespace nuansa::services::auth {
+	struct GoogleIdTokenVerifierSettings {
+		std::string jwksUrl;
+		std::chrono::seconds defaultMaxAge{std::chrono::hours(1)}; // Used when the JWKS response has no max-age.
+		std::chrono::seconds minRefreshInterval{std::chrono::seconds(60)}; // Also rate-limits unknown-kid refreshes.
+		std::chrono::seconds retryInterval{std::chrono::seconds(30)}; // After a failed fetch.
+		std::chrono::milliseconds fetchTimeout{std::chrono::seconds(5)};
+	};
+
+	/**
+	 * @brief Verifies Google ID tokens (RS256 JWTs) against a cached JWKS
+	 *
+	 * The signing keys are fetched by a background thread as soon as the
+	 * verifier is created, and refreshed shortly before the Cache-Control
+	 * max-age of the last response runs out, so Verify itself never touches
+	 * the network. A token
+	 * signed with a kid that isn't cached yet fails and wakes the refresher,
+	 * which picks up rotated keys for the next attempt.
+	 *
+	 * Only the header and signature are checked here; the caller validates the
+	 * returned claims (aud, iss, exp).
+	 *
+	 * Usage example:
+	 * @code
+	 * GoogleIdTokenVerifier verifier({.jwksUrl = config.googleJwksUrl}, httpClient);
+	 * if (auto claims = verifier.Verify(idToken)) {
+	 *     // check (*claims)["aud"], ["iss"], ["exp"]
+	 * }
+	 * @endcode
+	 */
+	class GoogleIdTokenVerifier {
+	public:
+		GoogleIdTokenVerifier(GoogleIdTokenVerifierSettings settings, utils::HttpClient &httpClient);
+
+		~GoogleIdTokenVerifier();
+
+		GoogleIdTokenVerifier(const GoogleIdTokenVerifier &) = delete;
+
+		GoogleIdTokenVerifier &operator=(const GoogleIdTokenVerifier &) = delete;
+
+		// Returns the payload claims when the signature checks out against a cached key
+		std::optional<nlohmann::json> Verify(const std::string &idToken);
+
+		// False until the first JWKS fetch has succeeded
+		bool HasKeys() const;
+
+		size_t KeyCount() const;
+
+		// Fetches the JWKS now on the calling thread; returns false if it could not be loaded
+		bool Refresh();
+
+		// Parses "Cache-Control: ..., max-age=N" out of raw response header lines
+		static std::optional<std::chrono::seconds> ParseMaxAge(const std::vector<std::string> &headers);
+
+	private:
+		using KeyMap = std::unordered_map<std::string, std::shared_ptr<EVP_PKEY> >;
+
+		// Returns how long the fetched keys may be used, or nullopt on failure
+		std::optional<std::chrono::seconds> FetchKeys();
+
+		void RefreshLoop();
+
+		void RequestRefresh();
+
+		std::shared_ptr<const KeyMap> Keys() const;
+
+		static std::shared_ptr<EVP_PKEY> ParseRsaKey(const nlohmann::json &jwk);
+
+		GoogleIdTokenVerifierSettings settings_;
+		utils::HttpClient &httpClient_;
+
+		mutable std::mutex keysMutex_;
+		std::shared_ptr<const KeyMap> keys_;
+
+		std::mutex refreshMutex_;
+		std::condition_variable refreshCondition_;
+		bool refreshRequested_{false};
+		bool stopping_{false};
+		std::thread refresher_;
+	};
+}
+
+#endif //NUANSA_SERVICES_AUTH_GOOGLE_ID_TOKEN_VERIFIER_H
@@ -0,0 +1,29 @@
+#ifndef NUANSA_SERVICES_CHAT_IMENTION_INBOX_H
+#define NUANSA_SERVICES_CHAT_IMENTION_INBOX_H
+
+#include "nuansa/utils/pch.h"
+
+namespace nuansa::services::chat {
+    // One mention waiting for a user who was offline when it was sent
+    struct InboxMention {
+        std::string recipient;
+        std::string messageId;
+        std::string sender;
+        std::string excerpt; // Start of the message, cut to mentions.excerpt_bytes
+        std::time_t timestamp{};
+    };
+
+    class IMentionInbox {
+    public:
+        virtual ~IMentionInbox() = default;
+
+        // Stores a batch in one round trip, keeping only each recipient's newest limit entries;
+        // false if nothing was stored. Recipients must already be known users
+        virtual bool Append(const std::vector<InboxMention>& mentions, size_t limit) = 0;
+
+        // Removes and returns the user's newest mentions, at most limit, oldest first
+        virtual std::vector<InboxMention> Take(const std::string& recipient, size_t limit) = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef NUANSA_SERVICES_CHAT_IN_MEMORY_MENTION_INBOX_H
+#define NUANSA_SERVICES_CHAT_IN_MEMORY_MENTION_INBOX_H
+
+#include "nuansa/utils/pch.h"
+#include "nuansa/services/chat/imention_inbox.h"
+#include "nuansa/utils/container/concurrent_hash_map.h"
+
+namespace nuansa::services::chat {
+    /**
+     * @brief Mention inbox kept in process memory, for the memory storage backend
+     *
+     * Each user's inbox is a deque capped at the limit passed to Append;
+     * once it is full the oldest mention is dropped, like the table's trim.
+     * At most maxRecipients users hold an inbox at a time; mentions for
+     * anyone else are dropped until some of them log in and take theirs.
+     *
+     * Usage example:
+     * @code
+     * InMemoryMentionInbox inbox;
+     * inbox.Append({{"bob", "m1", "alice", "hi @bob", now}}, 100);
+     * auto pending = inbox.Take("bob", 100); // one entry, inbox now empty
+     * @endcode
+     */
+    class InMemoryMentionInbox final : public IMentionInbox {
+    public:
+        explicit InMemoryMentionInbox(size_t maxRecipients = 100000) : maxRecipients_(maxRecipients) {
+        }
+
+        static InMemoryMentionInbox& GetInstance();
+
+        bool Append(const std::vector<InboxMention>& mentions, size_t limit) override;
+
+        std::vector<InboxMention> Take(const std::string& recipient, size_t limit) override;
+
+        // Mentions held across all users
+        size_t Size() const;
+
+        // Users with an inbox
+        size_t Recipients() const { return inboxes_.Size(); }
+
+        void Clear() { inboxes_.Clear(); }
+
+    private:
+        size_t maxRecipients_;
+        utils::container::ConcurrentHashMap<std::string, std::deque<InboxMention> > inboxes_;
+    };
+}
+
+#endif
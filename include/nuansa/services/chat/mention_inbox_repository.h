@@ -0,0 +1,23 @@
+#ifndef NUANSA_SERVICES_CHAT_MENTION_INBOX_REPOSITORY_H
+#define NUANSA_SERVICES_CHAT_MENTION_INBOX_REPOSITORY_H
+
+#include "nuansa/utils/pch.h"
+#include "nuansa/services/chat/imention_inbox.h"
+
+namespace nuansa::services::chat {
+    // Offline mentions in the mention_inbox table, one multi-row INSERT per batch plus one DELETE
+    // that trims the batch's recipients back to their newest entries
+    class MentionInboxRepository final : public IMentionInbox {
+    public:
+        static MentionInboxRepository& GetInstance();
+
+        bool Append(const std::vector<InboxMention>& mentions, size_t limit) override;
+
+        std::vector<InboxMention> Take(const std::string& recipient, size_t limit) override;
+
+    private:
+        MentionInboxRepository() = default;
+    };
+}
+
+#endif
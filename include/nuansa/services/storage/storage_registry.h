@@ -0,0 +1,62 @@
+#ifndef NUANSA_SERVICES_STORAGE_STORAGE_REGISTRY_H
+#define NUANSA_SERVICES_STORAGE_STORAGE_REGISTRY_H
+
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/services/user/iuser_service.h"
+#include "nuansa/services/token/itoken_repository.h"
+#include "nuansa/services/chat/imention_inbox.h"
+
+namespace nuansa::services::storage {
+    enum class StorageBackend {
+        Postgres,
+        InMemory
+    };
+
+    // "postgres" or "memory"; nullopt for anything else
+    std::optional<StorageBackend> ParseStorageBackend(std::string_view name);
+
+    std::string_view ToString(StorageBackend backend);
+
+    /**
+     * @brief Hands out the user, token and mention inbox stores of the configured backend
+     *
+     * Services ask the registry instead of naming UserService or
+     * TokenRepository, so the whole server can run on the in-memory
+     * backend for load tests and CI. The backend is chosen once at startup
+     * from database.backend; switching it while requests are in flight
+     * leaves them on whichever store they already picked.
+     *
+     * Usage example:
+     * @code
+     * StorageRegistry::GetInstance().Select(StorageBackend::InMemory);
+     * auto &users = StorageRegistry::GetInstance().Users();
+     * users.CreateUser(user);
+     * @endcode
+     */
+    class StorageRegistry {
+    public:
+        static StorageRegistry &GetInstance();
+
+        StorageRegistry(const StorageRegistry &) = delete;
+
+        StorageRegistry &operator=(const StorageRegistry &) = delete;
+
+        void Select(StorageBackend backend);
+
+        StorageBackend GetBackend() const { return backend_.load(std::memory_order_acquire); }
+
+        user::IUserService &Users() const;
+
+        token::ITokenRepository &Tokens() const;
+
+        chat::IMentionInbox &MentionInbox() const;
+
+    private:
+        StorageRegistry() = default;
+
+        std::atomic<StorageBackend> backend_{StorageBackend::Postgres};
+    };
+} // namespace nuansa::services::storage
+
+#endif // NUANSA_SERVICES_STORAGE_STORAGE_REGISTRY_H
@@ -0,0 +1,71 @@
+#ifndef NUANSA_SERVICES_TOKEN_IN_MEMORY_TOKEN_REPOSITORY_H
+#define NUANSA_SERVICES_TOKEN_IN_MEMORY_TOKEN_REPOSITORY_H
+
+#include "nuansa/utils/pch.h"
+#include "nuansa/services/token/itoken_repository.h"
+#include "nuansa/utils/container/concurrent_hash_map.h"
+
+namespace nuansa::services::token {
+    /**
+     * @brief Token store kept in process memory, for running without PostgreSQL
+     *
+     * Mirrors TokenRepository's answers (revoked and expired tokens are not
+     * active) but keeps tokens in a sharded hash map with a per-user index,
+     * so load tests and CI exercise the real lock contention of concurrent
+     * logins instead of a database round trip. Nothing survives a restart,
+     * and user ids are stored as given rather than resolved against users.
+     *
+     * Usage example:
+     * @code
+     * InMemoryTokenRepository tokens;
+     * tokens.SaveToken(token, "user42", "access");
+     * tokens.IsTokenActive(token.token_id); // true until expiry or revocation
+     * @endcode
+     */
+    class InMemoryTokenRepository final : public ITokenRepository {
+    public:
+        InMemoryTokenRepository() = default;
+
+        static InMemoryTokenRepository& GetInstance();
+
+        bool SaveToken(const TokenService::Token& token,
+                       const std::string& userId,
+                       const std::string& tokenType) override;
+
+        bool RevokeToken(const std::string& tokenId) override;
+        bool IsTokenRevoked(const std::string& tokenId) const override;
+        bool IsTokenActive(const std::string& tokenId) const override;
+
+        // Drops expired tokens outright, since nothing else would ever free them
+        bool CleanupExpiredTokens() override;
+
+        std::optional<std::string> GetUserIdFromToken(const std::string& tokenId) const override;
+        std::optional<std::time_t> GetTokenExpiry(const std::string& tokenId) const override;
+
+        std::vector<TokenService::Token> GetActiveTokensForUser(const std::string& userId) const override;
+        bool RevokeAllTokensForUser(const std::string& userId) override;
+
+        bool IsTokenValid(const std::string& tokenId) const override;
+        std::optional<TokenService::Token> GetToken(const std::string& tokenId) const override;
+
+        size_t Size() const { return tokens_.Size(); }
+
+        void Clear();
+
+    private:
+        struct StoredToken {
+            TokenService::Token token;
+            std::string userId;
+            std::string tokenType;
+            bool revoked{false};
+        };
+
+        static bool IsActive(const StoredToken& stored, std::time_t now);
+
+        utils::container::ConcurrentHashMap<std::string, StoredToken> tokens_;
+        // Token ids per user; may still list tokens that were cleaned up concurrently
+        utils::container::ConcurrentHashMap<std::string, std::vector<std::string> > tokensByUser_;
+    };
+}
+
+#endif
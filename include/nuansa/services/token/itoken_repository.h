@@ -0,0 +1,32 @@
+#ifndef NUANSA_SERVICES_TOKEN_ITOKEN_REPOSITORY_H
+#define NUANSA_SERVICES_TOKEN_ITOKEN_REPOSITORY_H
+
+#include "nuansa/utils/pch.h"
+#include "nuansa/services/token/token_service.h"
+
+namespace nuansa::services::token {
+    class ITokenRepository {
+    public:
+        virtual ~ITokenRepository() = default;
+
+        virtual bool SaveToken(const TokenService::Token& token,
+                               const std::string& userId,
+                               const std::string& tokenType) = 0;
+
+        virtual bool RevokeToken(const std::string& tokenId) = 0;
+        virtual bool IsTokenRevoked(const std::string& tokenId) const = 0;
+        virtual bool IsTokenActive(const std::string& tokenId) const = 0;
+        virtual bool CleanupExpiredTokens() = 0;
+
+        virtual std::optional<std::string> GetUserIdFromToken(const std::string& tokenId) const = 0;
+        virtual std::optional<std::time_t> GetTokenExpiry(const std::string& tokenId) const = 0;
+
+        virtual std::vector<TokenService::Token> GetActiveTokensForUser(const std::string& userId) const = 0;
+        virtual bool RevokeAllTokensForUser(const std::string& userId) = 0;
+
+        virtual bool IsTokenValid(const std::string& tokenId) const = 0;
+        virtual std::optional<TokenService::Token> GetToken(const std::string& tokenId) const = 0;
+    };
+}
+
+#endif
@@ -2,30 +2,30 @@
 #define NUANSA_SERVICES_TOKEN_TOKEN_REPOSITORY_H
 
 #include "nuansa/utils/pch.h"
-#include "nuansa/services/token/token_service.h"
+#include "nuansa/services/token/itoken_repository.h"
 
 namespace nuansa::services::token {
-    class TokenRepository {
+    class TokenRepository final : public ITokenRepository {
     public:
         static TokenRepository& GetInstance();
         
         bool SaveToken(const TokenService::Token& token, 
                       const std::string& userId,
-                      const std::string& tokenType);
+                      const std::string& tokenType) override;
         
-        bool RevokeToken(const std::string& tokenId);
-        bool IsTokenRevoked(const std::string& tokenId) const;
-        bool IsTokenActive(const std::string& tokenId) const;
-        bool CleanupExpiredTokens();
+        bool RevokeToken(const std::string& tokenId) override;
+        bool IsTokenRevoked(const std::string& tokenId) const override;
+        bool IsTokenActive(const std::string& tokenId) const override;
+        bool CleanupExpiredTokens() override;
         
-        std::optional<std::string> GetUserIdFromToken(const std::string& tokenId) const;
-        std::optional<std::time_t> GetTokenExpiry(const std::string& tokenId) const;
+        std::optional<std::string> GetUserIdFromToken(const std::string& tokenId) const override;
+        std::optional<std::time_t> GetTokenExpiry(const std::string& tokenId) const override;
         
-        std::vector<TokenService::Token> GetActiveTokensForUser(const std::string& userId) const;
-        bool RevokeAllTokensForUser(const std::string& userId);
+        std::vector<TokenService::Token> GetActiveTokensForUser(const std::string& userId) const override;
+        bool RevokeAllTokensForUser(const std::string& userId) override;
         
-        bool IsTokenValid(const std::string& tokenId) const;
-        std::optional<TokenService::Token> GetToken(const std::string& tokenId) const;
+        bool IsTokenValid(const std::string& tokenId) const override;
+        std::optional<TokenService::Token> GetToken(const std::string& tokenId) const override;
         
     private:
         TokenRepository() = default;
@@ -7,7 +7,8 @@
 #include "nuansa/utils/pch.h"
 
 namespace nuansa::services::token {
-    
+    class TokenServiceBenchmark;
+
     class TokenService {
     public:
         struct Token {
@@ -58,6 +59,9 @@ namespace nuansa::services::token {
         bool SaveNewToken(const Token& token, const std::string& username, const std::string& type);
 
     private:
+        // Times CreateSignature on its own, see benchmarks/
+        friend class TokenServiceBenchmark;
+
         const std::string secret_key_;
         std::random_device rd_;
         std::mt19937 gen_;
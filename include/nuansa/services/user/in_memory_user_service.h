@@ -0,0 +1,81 @@
+#ifndef NUANSA_SERVICES_USER_IN_MEMORY_USER_SERVICE_H
+#define NUANSA_SERVICES_USER_IN_MEMORY_USER_SERVICE_H
+
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/services/user/iuser_service.h"
+#include "nuansa/utils/container/concurrent_hash_map.h"
+#include "nuansa/utils/pattern/striped_lock.h"
+#include "nuansa/models/user.h"
+
+namespace nuansa::services::user {
+	/**
+	 * @brief User store kept in process memory, for running without PostgreSQL
+	 *
+	 * Users live in a sharded hash map keyed by username with a second map
+	 * from email to username. Reads take a shared shard lock only; writes
+	 * lock the affected usernames and emails on a striped lock so the
+	 * "username and email are unique" rule holds like the table's unique
+	 * constraints do. Passwords still go through PasswordHasher, so logins
+	 * cost what they cost in production. Nothing survives a restart.
+	 *
+	 * Usage example:
+	 * @code
+	 * InMemoryUserService users;
+	 * users.CreateUser(User{"user42", "user42@example.com", hash, "", ""});
+	 * users.IsEmailTaken("user42@example.com"); // true
+	 * @endcode
+	 */
+	class InMemoryUserService final : public IUserService {
+	public:
+		InMemoryUserService() = default;
+
+		static InMemoryUserService &GetInstance();
+
+		void Initialize() override;
+
+		std::optional<nuansa::models::User> GetUserByUsername(const std::string &username) const override;
+
+		std::optional<nuansa::models::User> GetUserByEmail(const std::string &email) override;
+
+		bool IsEmailTaken(const std::string &email) const override;
+
+		bool IsUsernameTaken(const std::string &username) const override;
+
+		bool CreateUser(const nuansa::models::User &user) override;
+
+		bool AuthenticateUser(const std::string &username, const std::string &password) override;
+
+		bool UpdateUserEmail(const std::string &username, const std::string &newEmail) override;
+
+		bool UpdateUserPassword(const std::string &username, const std::string &newPassword) override;
+
+		bool DeleteUser(const std::string &username) override;
+
+		// Accepts a username or an email, like UserService
+		bool UserExists(const std::string &username) const override;
+
+		size_t Size() const { return usersByUsername_.Size(); }
+
+		void Clear();
+
+	private:
+		using IdentityGuard = std::vector<std::unique_lock<std::mutex> >;
+
+		// Locks the username and its current email (plus newEmail, if any); nullopt once the user is gone
+		std::optional<std::pair<nuansa::models::User, IdentityGuard> > LockUser(const std::string &username,
+		                                                                       std::string_view newEmail = {});
+
+		// Replaces the user's hash only if it still equals expectedHash; used for rehash-on-login
+		bool ReplacePasswordHash(const std::string &username, const std::optional<std::string> &expectedHash,
+		                         const std::string &newHash);
+
+		utils::container::ConcurrentHashMap<std::string, nuansa::models::User> usersByUsername_;
+		utils::container::ConcurrentHashMap<std::string, std::string> usernamesByEmail_;
+
+		// Held by every write, over the username and each email it touches
+		mutable utils::pattern::StripedLock identityLocks_{256};
+	};
+} // namespace nuansa::services::user
+
+#endif // NUANSA_SERVICES_USER_IN_MEMORY_USER_SERVICE_H
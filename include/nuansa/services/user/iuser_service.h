@@ -28,6 +28,8 @@ namespace nuansa::services::user {
 
 		[[nodiscard]] virtual bool IsUsernameTaken(const std::string &username) const = 0;
 
+		// False when the user could not be created; throws CircuitBreakerOpenException or
+		// CircuitBreakerTimeoutException when the database was unavailable or too slow
 		virtual bool CreateUser(const nuansa::models::User &user) = 0;
 
 		[[nodiscard]] virtual bool UserExists(const std::string &username) const = 0;
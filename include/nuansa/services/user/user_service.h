@@ -5,19 +5,23 @@
 
 #include "nuansa/services/user/iuser_service.h"
 #include "nuansa/utils/pattern/circuit_breaker.h"
+#include "nuansa/utils/cache/lru_cache.h"
+#include "nuansa/utils/cache/counting_bloom_filter.h"
 #include "nuansa/models/user.h"
 
 namespace nuansa::services::user {
 	class UserService final : public IUserService {
 	public:
-		// TODO: use config and factory method to initialize circuit breaker
 		UserService()
-			: circuitBreaker_(utils::pattern::CircuitBreakerSettings{
-				.failureThreshold = 5,
-				.successThreshold = 3,
-				.resetTimeout = std::chrono::seconds(60),
-				.timeout = std::chrono::seconds(2)
-			}) {
+			: circuitBreaker_(utils::pattern::CircuitBreakerRegistry::GetInstance().Get(
+				  utils::pattern::breakers::PRIMARY_DB)),
+			  usersByUsername_(utils::cache::LruCacheSettings{
+				  .capacity = 10000,
+				  .shardCount = 16,
+				  .positiveTtl = std::chrono::minutes(5),
+				  .negativeTtl = std::chrono::seconds(5)
+			  }),
+			  usersByEmail_(usersByUsername_.GetSettings()) {
 		}
 
 		static UserService &GetInstance();
@@ -46,12 +50,66 @@ namespace nuansa::services::user {
 
 		bool UserExists(const std::string &username) const override;
 
+		// Rebuilds the username/email availability filters by streaming the users table
+		void LoadIdentityFilters();
+
 	private:
+		struct IdentityFilters {
+			explicit IdentityFilters(const utils::cache::CountingBloomFilterSettings &settings)
+				: usernames(settings), emails(settings) {
+			}
+
+			utils::cache::CountingBloomFilter usernames;
+			utils::cache::CountingBloomFilter emails;
+		};
+
+		enum class UserKey {
+			Username,
+			Email
+		};
+
 		std::shared_ptr<pqxx::connection> fallbackConnection_;
 
 		pqxx::connection *GetConnection() const;
 
-		utils::pattern::CircuitBreaker circuitBreaker_;
+		// Identity filter pre-check, false only when the value was never seen. Rows inserted by other
+		// instances or during a filter load can be missing, so only availability checks may trust a miss
+		bool MightHaveIdentity(UserKey key, const std::string &value) const;
+
+		// Cache-aware lookup; throws on database errors so callers keep their own error semantics
+		std::optional<nuansa::models::User> LookupUser(UserKey key, const std::string &value) const;
+
+		std::optional<nuansa::models::User> FetchUser(UserKey key, const std::string &value) const;
+
+		void CacheUser(const nuansa::models::User &user) const;
+
+		void InvalidateUser(const std::string &username, const std::string &email) const;
+
+		// Replaces the stored hash only if it still equals expectedHash; used for rehash-on-login
+		bool UpdatePasswordHash(const std::string &username, const std::string &expectedHash,
+		                        const std::string &newHash);
+
+		// Returns nullptr until the filters have been loaded
+		std::shared_ptr<IdentityFilters> GetIdentityFilters() const;
+
+		void AddIdentity(const std::string &username, const std::string &email);
+
+		void RemoveIdentity(const std::string &username, const std::string &email);
+
+		void ReplaceEmailIdentity(const std::string &oldEmail, const std::string &newEmail);
+
+		// Shared with ConnectionPool; trips on database failures only
+		utils::pattern::CircuitBreaker &circuitBreaker_;
+
+		// User rows keyed by username and by email, including short-lived "not found" entries
+		mutable utils::cache::LruCache<std::string, nuansa::models::User> usersByUsername_;
+		mutable utils::cache::LruCache<std::string, nuansa::models::User> usersByEmail_;
+		mutable std::atomic<uint64_t> cacheGeneration_{0};
+
+		// Published filters answer lookups; pending filters only collect inserts while a load is streaming
+		mutable std::mutex identityFilterMutex_;
+		std::shared_ptr<IdentityFilters> identityFilters_;
+		std::shared_ptr<IdentityFilters> pendingIdentityFilters_;
 	};
 } // namespace nuansa::services::user
 
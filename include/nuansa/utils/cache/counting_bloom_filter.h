@@ -0,0 +1,120 @@
+#ifndef NUANSA_UTILS_CACHE_COUNTING_BLOOM_FILTER_H
+#define NUANSA_UTILS_CACHE_COUNTING_BLOOM_FILTER_H
+
+#include <cmath>
+
+#include "nuansa/utils/pch.h"
+
+namespace nuansa::utils::cache {
+    struct CountingBloomFilterSettings {
+        size_t expectedItems{100000}; // Number of items the filter is sized for.
+        double falsePositiveRate{0.01}; // Target false positive rate at expectedItems.
+    };
+
+    /**
+     * @brief Thread-safe counting Bloom filter over strings
+     *
+     * Answers "definitely absent" or "possibly present". Each slot is an 8-bit
+     * saturating counter rather than a single bit, so items can be removed as
+     * long as they were previously added. A counter that saturates is never
+     * decremented again, which can only cause extra false positives.
+     *
+     * All operations are lock-free; concurrent Add/Remove/MightContain calls are
+     * safe, but the filter can't be resized after construction.
+     *
+     * Usage example:
+     * @code
+     * CountingBloomFilter usernames(CountingBloomFilterSettings{.expectedItems = 1'000'000});
+     * usernames.Add("alice");
+     * if (!usernames.MightContain(candidate)) {
+     *     return false; // Definitely free, no database round-trip needed
+     * }
+     * @endcode
+     */
+    class CountingBloomFilter {
+    public:
+        explicit CountingBloomFilter(const CountingBloomFilterSettings &settings = CountingBloomFilterSettings{})
+            : settings_{settings} {
+            const auto items = static_cast<double>(std::max<size_t>(1, settings_.expectedItems));
+            const auto rate = std::clamp(settings_.falsePositiveRate, 1e-9, 0.5);
+            const auto ln2 = std::log(2.0);
+
+            slotCount_ = std::max<size_t>(64, static_cast<size_t>(std::ceil(-items * std::log(rate) / (ln2 * ln2))));
+            hashCount_ = std::clamp<size_t>(
+                static_cast<size_t>(std::round(static_cast<double>(slotCount_) / items * ln2)), 1, 16);
+            slots_ = std::make_unique<std::atomic<uint8_t>[]>(slotCount_);
+        }
+
+        CountingBloomFilter(const CountingBloomFilter &) = delete;
+
+        CountingBloomFilter &operator=(const CountingBloomFilter &) = delete;
+
+        void Add(const std::string_view item) {
+            ForEachSlot(item, [](std::atomic<uint8_t> &slot) {
+                auto current = slot.load(std::memory_order_relaxed);
+                while (current != kSaturated &&
+                       !slot.compare_exchange_weak(current, current + 1, std::memory_order_relaxed)) {
+                }
+            });
+            itemCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Must only be called for items that were previously added
+        void Remove(const std::string_view item) {
+            ForEachSlot(item, [](std::atomic<uint8_t> &slot) {
+                auto current = slot.load(std::memory_order_relaxed);
+                while (current != 0 && current != kSaturated &&
+                       !slot.compare_exchange_weak(current, current - 1, std::memory_order_relaxed)) {
+                }
+            });
+            itemCount_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        bool MightContain(const std::string_view item) const {
+            const auto [h1, h2] = Hash(item);
+            for (size_t i = 0; i < hashCount_; ++i) {
+                if (slots_[(h1 + i * h2) % slotCount_].load(std::memory_order_relaxed) == 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        size_t ItemCount() const { return itemCount_.load(std::memory_order_relaxed); }
+
+        size_t SlotCount() const { return slotCount_; }
+
+        size_t HashCount() const { return hashCount_; }
+
+        const CountingBloomFilterSettings &GetSettings() const { return settings_; }
+
+    private:
+        static constexpr uint8_t kSaturated = std::numeric_limits<uint8_t>::max();
+
+        // Double hashing: slot i is h1 + i * h2, with h2 forced odd so probes never collapse
+        static std::pair<uint64_t, uint64_t> Hash(const std::string_view item) {
+            const uint64_t h1 = std::hash<std::string_view>{}(item);
+            uint64_t h2 = h1 + 0x9e3779b97f4a7c15ULL;
+            h2 = (h2 ^ (h2 >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            h2 = (h2 ^ (h2 >> 27)) * 0x94d049bb133111ebULL;
+            h2 ^= h2 >> 31;
+            return {h1, h2 | 1};
+        }
+
+        template<typename Fn>
+        void ForEachSlot(const std::string_view item, Fn &&fn) {
+            const auto [h1, h2] = Hash(item);
+            for (size_t i = 0; i < hashCount_; ++i) {
+                fn(slots_[(h1 + i * h2) % slotCount_]);
+            }
+        }
+
+        CountingBloomFilterSettings settings_;
+        size_t slotCount_{0};
+        size_t hashCount_{1};
+        std::unique_ptr<std::atomic<uint8_t>[]> slots_;
+        std::atomic<size_t> itemCount_{0};
+    };
+} // namespace nuansa::utils::cache
+
+#endif // NUANSA_UTILS_CACHE_COUNTING_BLOOM_FILTER_H
@@ -0,0 +1,160 @@
+#ifndef NUANSA_UTILS_CACHE_LRU_CACHE_H
+#define NUANSA_UTILS_CACHE_LRU_CACHE_H
+
+#include <list>
+
+#include "nuansa/utils/pch.h"
+
+namespace nuansa::utils::cache {
+    struct LruCacheSettings {
+        size_t capacity{10000}; // Maximum number of entries across all shards.
+        size_t shardCount{16}; // Number of independently locked shards.
+        std::chrono::milliseconds positiveTtl{std::chrono::minutes(5)}; // Lifetime of a cached value.
+        std::chrono::milliseconds negativeTtl{std::chrono::seconds(5)}; // Lifetime of a cached "not found".
+    };
+
+    /**
+     * @brief Bounded, sharded LRU cache with per-entry expiry and negative entries
+     *
+     * Keys are spread over a fixed number of shards, each guarded by its own
+     * mutex, so concurrent lookups on different keys rarely contend. Every
+     * entry carries an absolute expiry; expired entries are treated as misses
+     * and dropped lazily. A negative entry records that the key is known to be
+     * absent from the backing store and is usually given a much shorter TTL.
+     *
+     * Usage example:
+     * @code
+     * LruCache<std::string, User> cache;
+     * if (const auto cached = cache.Get(username); cached.hit) {
+     *     return cached.value; // std::nullopt for a negative entry
+     * }
+     * @endcode
+     */
+    template<typename Key, typename Value, typename Hash = std::hash<Key> >
+    class LruCache {
+    public:
+        struct Lookup {
+            bool hit{false}; // True for both positive and negative entries.
+            std::optional<Value> value; // Empty on a miss or a negative hit.
+        };
+
+        explicit LruCache(LruCacheSettings settings = LruCacheSettings{})
+            : settings_{settings},
+              shards_(std::max<size_t>(1, settings.shardCount)) {
+            const auto perShard = (std::max<size_t>(1, settings_.capacity) + shards_.size() - 1) / shards_.size();
+            for (auto &shard: shards_) {
+                shard.capacity = perShard;
+            }
+        }
+
+        LruCache(const LruCache &) = delete;
+
+        LruCache &operator=(const LruCache &) = delete;
+
+        Lookup Get(const Key &key) {
+            auto &shard = ShardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            const auto it = shard.index.find(key);
+            if (it == shard.index.end()) {
+                return {};
+            }
+
+            if (std::chrono::steady_clock::now() >= it->second->expiresAt) {
+                shard.entries.erase(it->second);
+                shard.index.erase(it);
+                return {};
+            }
+
+            // Move to the front to mark as most recently used
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            return {true, it->second->value};
+        }
+
+        void Put(const Key &key, const Value &value) {
+            Insert(key, value, settings_.positiveTtl);
+        }
+
+        void Put(const Key &key, const Value &value, const std::chrono::milliseconds ttl) {
+            Insert(key, value, ttl);
+        }
+
+        void PutNegative(const Key &key) {
+            Insert(key, std::nullopt, settings_.negativeTtl);
+        }
+
+        void Erase(const Key &key) {
+            auto &shard = ShardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            if (const auto it = shard.index.find(key); it != shard.index.end()) {
+                shard.entries.erase(it->second);
+                shard.index.erase(it);
+            }
+        }
+
+        void Clear() {
+            for (auto &shard: shards_) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                shard.entries.clear();
+                shard.index.clear();
+            }
+        }
+
+        size_t Size() const {
+            size_t total = 0;
+            for (auto &shard: shards_) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                total += shard.entries.size();
+            }
+            return total;
+        }
+
+        const LruCacheSettings &GetSettings() const { return settings_; }
+
+    private:
+        struct Entry {
+            Key key;
+            std::optional<Value> value;
+            std::chrono::steady_clock::time_point expiresAt;
+        };
+
+        struct Shard {
+            mutable std::mutex mutex;
+            std::list<Entry> entries; // Front is most recently used.
+            std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index;
+            size_t capacity{0};
+        };
+
+        Shard &ShardFor(const Key &key) {
+            return shards_[Hash{}(key) % shards_.size()];
+        }
+
+        void Insert(const Key &key, std::optional<Value> value, const std::chrono::milliseconds ttl) {
+            auto &shard = ShardFor(key);
+            const auto expiresAt = std::chrono::steady_clock::now() + ttl;
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            if (const auto it = shard.index.find(key); it != shard.index.end()) {
+                it->second->value = std::move(value);
+                it->second->expiresAt = expiresAt;
+                shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+                return;
+            }
+
+            shard.entries.push_front(Entry{key, std::move(value), expiresAt});
+            shard.index.emplace(key, shard.entries.begin());
+
+            // Evict the least recently used entry once the shard is over capacity
+            if (shard.entries.size() > shard.capacity) {
+                shard.index.erase(shard.entries.back().key);
+                shard.entries.pop_back();
+            }
+        }
+
+        LruCacheSettings settings_;
+        std::vector<Shard> shards_;
+    };
+} // namespace nuansa::utils::cache
+
+#endif // NUANSA_UTILS_CACHE_LRU_CACHE_H
@@ -0,0 +1,161 @@
+#ifndef NUANSA_UTILS_CONTAINER_CONCURRENT_HASH_MAP_H
+#define NUANSA_UTILS_CONTAINER_CONCURRENT_HASH_MAP_H
+
+#include <shared_mutex>
+
+#include "nuansa/utils/pch.h"
+
+namespace nuansa::utils::container {
+    /**
+     * @brief Unbounded hash map split into independently locked shards
+     *
+     * Each shard is an std::unordered_map behind a reader/writer lock, so
+     * lookups on any key run in parallel and writers only block the shard
+     * their key hashes to. Values are returned by copy; read-modify-write
+     * goes through Update so it happens under the shard's exclusive lock.
+     *
+     * Usage example:
+     * @code
+     * ConcurrentHashMap<std::string, User> users;
+     * if (!users.Insert(user.GetUsername(), user)) {
+     *     return false; // taken
+     * }
+     *
+     * ConcurrentHashMap<std::string, size_t> unread;
+     * unread.Upsert(username, [](size_t &count) { ++count; });
+     * @endcode
+     */
+    template<typename Key, typename Value, typename Hash = std::hash<Key> >
+    class ConcurrentHashMap {
+    public:
+        explicit ConcurrentHashMap(const size_t shardCount = 64)
+            : shards_(std::max<size_t>(1, shardCount)) {
+        }
+
+        ConcurrentHashMap(const ConcurrentHashMap &) = delete;
+
+        ConcurrentHashMap &operator=(const ConcurrentHashMap &) = delete;
+
+        std::optional<Value> Find(const Key &key) const {
+            const auto &shard = ShardFor(key);
+            std::shared_lock lock(shard.mutex);
+
+            const auto it = shard.entries.find(key);
+            if (it == shard.entries.end()) {
+                return std::nullopt;
+            }
+            return it->second;
+        }
+
+        bool Contains(const Key &key) const {
+            const auto &shard = ShardFor(key);
+            std::shared_lock lock(shard.mutex);
+            return shard.entries.contains(key);
+        }
+
+        // Returns false and leaves the stored value alone when the key is already present
+        bool Insert(const Key &key, Value value) {
+            auto &shard = ShardFor(key);
+            std::unique_lock lock(shard.mutex);
+            return shard.entries.try_emplace(key, std::move(value)).second;
+        }
+
+        void InsertOrAssign(const Key &key, Value value) {
+            auto &shard = ShardFor(key);
+            std::unique_lock lock(shard.mutex);
+            shard.entries.insert_or_assign(key, std::move(value));
+        }
+
+        // Runs updater(Value &) under the shard lock; false when the key is missing or the updater declined
+        template<typename Updater>
+        bool Update(const Key &key, Updater &&updater) {
+            auto &shard = ShardFor(key);
+            std::unique_lock lock(shard.mutex);
+
+            const auto it = shard.entries.find(key);
+            if (it == shard.entries.end()) {
+                return false;
+            }
+            return updater(it->second);
+        }
+
+        // Like Update, but default-constructs the value first when the key is missing
+        template<typename Updater>
+        void Upsert(const Key &key, Updater &&updater) {
+            auto &shard = ShardFor(key);
+            std::unique_lock lock(shard.mutex);
+            updater(shard.entries[key]);
+        }
+
+        std::optional<Value> Erase(const Key &key) {
+            auto &shard = ShardFor(key);
+            std::unique_lock lock(shard.mutex);
+
+            const auto it = shard.entries.find(key);
+            if (it == shard.entries.end()) {
+                return std::nullopt;
+            }
+            auto value = std::move(it->second);
+            shard.entries.erase(it);
+            return value;
+        }
+
+        // Removes every entry for which predicate(const Key &, const Value &) holds; returns how many
+        template<typename Predicate>
+        size_t EraseIf(Predicate &&predicate) {
+            size_t erased = 0;
+            for (auto &shard: shards_) {
+                std::unique_lock lock(shard.mutex);
+                erased += std::erase_if(shard.entries, [&](const auto &entry) {
+                    return predicate(entry.first, entry.second);
+                });
+            }
+            return erased;
+        }
+
+        // Visits shard by shard; entries changed concurrently in other shards may or may not be seen
+        template<typename Visitor>
+        void ForEach(Visitor &&visitor) const {
+            for (const auto &shard: shards_) {
+                std::shared_lock lock(shard.mutex);
+                for (const auto &[key, value]: shard.entries) {
+                    visitor(key, value);
+                }
+            }
+        }
+
+        size_t Size() const {
+            size_t total = 0;
+            for (const auto &shard: shards_) {
+                std::shared_lock lock(shard.mutex);
+                total += shard.entries.size();
+            }
+            return total;
+        }
+
+        void Clear() {
+            for (auto &shard: shards_) {
+                std::unique_lock lock(shard.mutex);
+                shard.entries.clear();
+            }
+        }
+
+    private:
+        struct Shard {
+            mutable std::shared_mutex mutex;
+            std::unordered_map<Key, Value, Hash> entries;
+        };
+
+        Shard &ShardFor(const Key &key) {
+            return shards_[Hash{}(key) % shards_.size()];
+        }
+
+        const Shard &ShardFor(const Key &key) const {
+            return shards_[Hash{}(key) % shards_.size()];
+        }
+
+        std::vector<Shard> shards_;
+    };
+} // namespace nuansa::utils::container
+
+#endif // NUANSA_UTILS_CONTAINER_CONCURRENT_HASH_MAP_H
@@ -21,7 +21,11 @@ namespace nuansa::utils::crypto {
 		static std::string HashPassword(const std::string &password, const std::string &salt);
 
 		static std::string Base64Encode(const std::string& input);
+		// Standard alphabet without '=' padding or line breaks (PHC hash strings)
+		static std::string Base64EncodeUnpadded(const std::string& input);
 		static std::string Base64Decode(const std::string& input);
+		// URL-safe alphabet, padding optional (JWT segments); throws on malformed input
+		static std::string Base64UrlDecode(const std::string& input);
 	};
 }
 
@@ -0,0 +1,100 @@
+#ifndef NUANSA_UTILS_CRYPTO_PASSWORD_HASHER_H
+#define NUANSA_UTILS_CRYPTO_PASSWORD_HASHER_H
+
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/utils/pattern/worker_pool.h"
+#include "nuansa/utils/exception/worker_pool_exception.h"
+
+namespace nuansa::utils::crypto {
+	struct ScryptParameters {
+		uint32_t logN{15}; // CPU/memory cost as log2(N); memory use is 128 * r * N bytes.
+		uint32_t r{8}; // Block size.
+		uint32_t p{1}; // Parallelization.
+	};
+
+	struct PasswordVerification {
+		bool matches{false};
+		bool needsRehash{false}; // Legacy format or weaker parameters than the current ones.
+	};
+
+	/**
+	 * @brief Hashes and verifies passwords on a dedicated, bounded worker pool
+	 *
+	 * New hashes use scrypt in a self-describing, PHC-style string:
+	 * @code
+	 * $scrypt$ln=15,r=8,p=1$<base64 salt>$<base64 key>
+	 * @endcode
+	 * The cost is calibrated once at startup so a single hash takes roughly
+	 * the configured target latency on this machine. Verification still
+	 * accepts the two legacy formats (hex SHA-256 of password + salt, and
+	 * "iterations$salt$hash" PBKDF2) and reports them as needing a rehash.
+	 *
+	 * All KDF work runs on the pool; when its queue is full, work is rejected
+	 * with WorkerPoolRejectedException so callers can answer "server busy".
+	 */
+	class PasswordHasher {
+	public:
+		static PasswordHasher &GetInstance();
+
+		PasswordHasher(const PasswordHasher &) = delete;
+
+		PasswordHasher &operator=(const PasswordHasher &) = delete;
+
+		// Blocks the caller until a worker has produced a new-format hash with a fresh salt
+		std::string Hash(const std::string &password);
+
+		// Blocks the caller until a worker has checked the password; salt is only used by legacy hashes
+		PasswordVerification Verify(const std::string &password, const std::string &salt,
+		                            const std::string &storedHash);
+
+		// Verifies on the pool and invokes handler(std::exception_ptr, PasswordVerification) on the given executor
+		template<typename Executor, typename Handler>
+		void AsyncVerify(std::string password, std::string salt, std::string storedHash,
+		                 Executor executor, Handler &&handler) {
+			auto completion = std::make_shared<std::decay_t<Handler> >(std::forward<Handler>(handler));
+
+			const bool admitted = pool_.TryPost(
+				[password = std::move(password), salt = std::move(salt), storedHash = std::move(storedHash),
+					parameters = parameters_, executor, completion] {
+					std::exception_ptr error;
+					PasswordVerification result;
+					try {
+						result = VerifyInline(password, salt, storedHash, parameters);
+					} catch (...) {
+						error = std::current_exception();
+					}
+					boost::asio::post(executor, [completion, error, result] { (*completion)(error, result); });
+				});
+
+			if (!admitted) {
+				boost::asio::post(executor, [completion] {
+					(*completion)(std::make_exception_ptr(
+						exception::WorkerPoolRejectedException("kdf queue is full")), PasswordVerification{});
+				});
+			}
+		}
+
+		void Shutdown();
+
+		const ScryptParameters &GetParameters() const { return parameters_; }
+
+		const pattern::WorkerPool &GetPool() const { return pool_; }
+
+	private:
+		PasswordHasher();
+
+		static ScryptParameters Calibrate();
+
+		static std::string HashInline(const std::string &password, const ScryptParameters &parameters);
+
+		static PasswordVerification VerifyInline(const std::string &password, const std::string &salt,
+		                                         const std::string &storedHash,
+		                                         const ScryptParameters &current);
+
+		ScryptParameters parameters_;
+		pattern::WorkerPool pool_;
+	};
+}
+
+#endif //NUANSA_UTILS_CRYPTO_PASSWORD_HASHER_H
@@ -0,0 +1,23 @@
+#ifndef NUANSA_UTILS_EXCEPTION_WORKER_POOL_EXCEPTION_H
+#define NUANSA_UTILS_EXCEPTION_WORKER_POOL_EXCEPTION_H
+
+#include "nuansa/utils/exception/exception.h"
+
+namespace nuansa::utils::exception {
+	class WorkerPoolException : public nuansa::utils::exception::Exception {
+	public:
+		explicit WorkerPoolException(const std::string &message)
+			: Exception(message) {
+		}
+	};
+
+	// Thrown when a task is refused because the queue is full or the pool is stopping
+	class WorkerPoolRejectedException final : public WorkerPoolException {
+	public:
+		explicit WorkerPoolRejectedException(const std::string &message)
+			: WorkerPoolException("Worker Pool Rejected: " + message) {
+		}
+	};
+}
+
+#endif //NUANSA_UTILS_EXCEPTION_WORKER_POOL_EXCEPTION_H
@@ -3,9 +3,42 @@
 
 #include <string>
 #include <vector>
+#include <future>
 #include <curl/curl.h>
 
+#include "nuansa/utils/pch.h"
+
 namespace nuansa::utils {
+    struct HttpClientSettings {
+        long maxConnectionsPerHost{32}; // Open connections per host; further requests wait for a free one.
+        long maxCachedConnections{64}; // Idle keep-alive connections kept for reuse.
+        long dnsCacheTimeoutSeconds{300}; // How long resolved addresses are reused.
+        std::chrono::milliseconds connectTimeout{std::chrono::seconds(5)};
+        std::chrono::milliseconds defaultTimeout{std::chrono::seconds(10)}; // Per-request deadline when none is given.
+    };
+
+    /**
+     * @brief Asynchronous HTTP client driven by curl_multi on its own io_context
+     *
+     * All transfers run on a single internal thread: libcurl reports which
+     * sockets it wants to wait on and the io_context watches them, so any
+     * number of requests can be in flight without a thread each. Connections
+     * and DNS lookups are cached by the multi handle and reused across
+     * requests, and every request carries its own deadline.
+     *
+     * The client is safe to share between threads. Completion callbacks run
+     * on the client's thread and should be short; the blocking Get/Post
+     * wrappers simply wait for the asynchronous result.
+     *
+     * Usage example:
+     * @code
+     * HttpClient client;
+     * client.AsyncGet(url, {"Accept: application/json"}, std::chrono::seconds(2),
+     *     [](HttpClient::Response response) {
+     *         // runs on the client's thread
+     *     });
+     * @endcode
+     */
     class HttpClient {
     public:
         struct Response {
@@ -14,29 +47,92 @@ namespace nuansa::utils {
             std::string error;
             long statusCode;
             std::vector<std::string> headers;
+            bool timedOut{false}; // The request timeout expired and curl aborted the transfer.
+        };
+
+        struct Request {
+            std::string method{"GET"};
+            std::string url;
+            std::string body;
+            std::vector<std::string> headers;
+            std::string username; // Basic auth, optional.
+            std::string password;
+            std::optional<std::chrono::milliseconds> timeout; // Defaults to HttpClientSettings::defaultTimeout.
         };
 
+        using Callback = std::function<void(Response)>;
+
         HttpClient();
+
+        explicit HttpClient(const HttpClientSettings &settings);
+
         ~HttpClient();
 
-        Response Get(const std::string& url, 
-                    const std::vector<std::string>& headers = {});
-        
-        Response Post(const std::string& url,
-                     const std::string& body,
-                     const std::vector<std::string>& headers = {},
-                     const std::string& username = "",
-                     const std::string& password = "");
-        
-        CURL* GetCurl() { return curl; }
+        HttpClient(const HttpClient &) = delete;
+
+        HttpClient &operator=(const HttpClient &) = delete;
+
+        // Starts the transfer and returns immediately; callback runs on the client's thread
+        void AsyncPerform(Request request, Callback callback);
+
+        void AsyncGet(const std::string &url, const std::vector<std::string> &headers,
+                      std::optional<std::chrono::milliseconds> timeout, Callback callback);
+
+        void AsyncPost(const std::string &url, const std::string &body, const std::vector<std::string> &headers,
+                       std::optional<std::chrono::milliseconds> timeout, Callback callback);
+
+        std::future<Response> Perform(Request request);
+
+        Response Get(const std::string &url,
+                     const std::vector<std::string> &headers = {},
+                     std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+        Response Post(const std::string &url,
+                      const std::string &body,
+                      const std::vector<std::string> &headers = {},
+                      const std::string &username = "",
+                      const std::string &password = "",
+                      std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+        const HttpClientSettings &GetSettings() const { return settings_; }
 
     private:
-        CURL* curl;
-        static size_t WriteCallback(void* contents, 
-                                  size_t size, 
-                                  size_t nmemb, 
-                                  std::string* userp);
+        struct Transfer;
+        struct Socket;
+
+        void StartTransfer(std::unique_ptr<Transfer> transfer);
+
+        void WatchSocket(const std::shared_ptr<Socket> &socket, curl_socket_t fd);
+
+        void OnSocketReady(const std::weak_ptr<Socket> &weakSocket, curl_socket_t fd, int direction,
+                           const boost::system::error_code &ec);
+
+        void OnTimeout(const boost::system::error_code &ec);
+
+        void CompleteFinishedTransfers();
+
+        void AbortAllTransfers();
+
+        static int SocketCallback(CURL *easy, curl_socket_t fd, int what, void *clientp, void *socketp);
+
+        static int TimerCallback(CURLM *multi, long timeoutMs, void *clientp);
+
+        static size_t WriteCallback(void *contents, size_t size, size_t nmemb, std::string *userp);
+
+        static size_t HeaderCallback(char *buffer, size_t size, size_t nitems, void *userdata);
+
+        HttpClientSettings settings_;
+        boost::asio::io_context ioc_;
+        boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_;
+        boost::asio::steady_timer timer_;
+        CURLM *multi_{nullptr};
+
+        // Only touched on the client's thread
+        std::unordered_map<curl_socket_t, std::shared_ptr<Socket> > sockets_;
+        std::unordered_map<CURL *, std::unique_ptr<Transfer> > transfers_;
+
+        std::thread thread_;
     };
 }
 
-#endif //NUANSA_UTILS_HTTP_CLIENT_H 
\ No newline at end of file
+#endif //NUANSA_UTILS_HTTP_CLIENT_H
@@ -0,0 +1,24 @@
+#ifndef NUANSA_UTILS_JSON_STRING_H
+#define NUANSA_UTILS_JSON_STRING_H
+
+#include "nuansa/utils/pch.h"
+
+namespace nuansa::utils {
+    /**
+     * @brief Appends text to out as a quoted, escaped JSON string
+     *
+     * For hot paths that write JSON by hand instead of building an
+     * nlohmann::json document. Bytes from 0x80 up are copied as they are,
+     * so text has to be UTF-8 already.
+     *
+     * Usage example:
+     * @code
+     * std::string frame = "{\"user\":";
+     * AppendJsonString(username, frame);
+     * frame += '}';
+     * @endcode
+     */
+    void AppendJsonString(std::string_view text, std::string &out);
+}
+
+#endif // NUANSA_UTILS_JSON_STRING_H
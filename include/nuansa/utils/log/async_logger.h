@@ -0,0 +1,245 @@
+#ifndef NUANSA_UTILS_LOG_ASYNC_LOGGER_H
+#define NUANSA_UTILS_LOG_ASYNC_LOGGER_H
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace nuansa::utils::log {
+    enum class Level : int {
+        Debug = 0,
+        Info = 1,
+        Warning = 2,
+        Error = 3
+    };
+
+    const char *LevelName(Level level);
+
+    // Parses "debug", "info", "warn"/"warning" or "error"; anything else is Info
+    Level ParseLevel(std::string_view name);
+
+    enum class LogFormat {
+        Text, // [timestamp] [level] [file:line function] message
+        Json // {"ts":...,"level":...,"file":...,"line":...,"func":...,"msg":...}
+    };
+
+    // One formatted statement. Fixed size so it can be copied into a ring slot without allocating.
+    struct LogRecord {
+        static constexpr size_t MAX_TEXT = 448;
+
+        std::chrono::system_clock::time_point time;
+        const char *file{""}; // __FILE__ and __func__ have static storage, so only pointers are kept
+        const char *function{""};
+        uint32_t line{0};
+        Level level{Level::Info};
+        uint16_t length{0};
+        bool truncated{false};
+        char text[MAX_TEXT];
+
+        std::string_view Text() const { return {text, length}; }
+    };
+
+    // Appends the record as one line, newline included
+    void FormatRecord(const LogRecord &record, LogFormat format, std::string &out);
+
+    // Destination for drained records; only ever called from one thread at a time
+    class LogSink {
+    public:
+        virtual ~LogSink() = default;
+
+        virtual void Write(const LogRecord &record) = 0;
+
+        virtual void Flush() {
+        }
+    };
+
+    // "[timestamp] [level] [file:line function] message" on stdout, the format the server always used
+    class ConsoleLogSink final : public LogSink {
+    public:
+        void Write(const LogRecord &record) override;
+
+        void Flush() override;
+
+    private:
+        std::string line_;
+    };
+
+    struct AsyncLoggerSettings {
+        std::chrono::milliseconds drainInterval{std::chrono::milliseconds(10)}; // How often the sink thread wakes up.
+    };
+
+    struct LogStats {
+        uint64_t written{0};
+        uint64_t dropped{0}; // Lost because the ring was full.
+        uint64_t truncated{0}; // Cut at LogRecord::MAX_TEXT.
+    };
+
+    /**
+     * @brief Logging backend that keeps formatting and I/O off the calling thread's critical path
+     *
+     * All threads share one bounded ring of fixed-size records, so memory
+     * does not grow with the number of session threads; LOG_* statements
+     * format into a stack buffer and copy it into a ring slot with one
+     * compare-and-swap, without taking a lock. One background thread drains
+     * the ring into the sinks. A full ring drops the record and counts it,
+     * so a burst of logging can never block a request; the drop count is
+     * reported through the sinks and GetStats().
+     *
+     * The instance is never destroyed, so singletons may log from their
+     * destructors. Shutdown() runs at exit: it drains what is buffered and
+     * switches to writing synchronously.
+     *
+     * Usage example:
+     * @code
+     * AsyncLogger::SetLevel(Level::Info);
+     * LOG_INFO << "Connection pool initialized with " << size << " connections";
+     * AsyncLogger::GetInstance().Flush();
+     * @endcode
+     */
+    class AsyncLogger {
+    public:
+        static AsyncLogger &GetInstance();
+
+        static bool IsEnabled(const Level level) {
+            return static_cast<int>(level) >= minLevel_.load(std::memory_order_relaxed);
+        }
+
+        static void SetLevel(Level level) {
+            minLevel_.store(static_cast<int>(level), std::memory_order_relaxed);
+        }
+
+        AsyncLogger(const AsyncLogger &) = delete;
+
+        AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+        // Records the ring holds, about 1.8 MB; more are dropped until the sink thread catches up
+        static constexpr size_t RING_CAPACITY = 4096;
+
+        void Configure(const AsyncLoggerSettings &settings);
+
+        void SetSinks(std::vector<std::shared_ptr<LogSink> > sinks);
+
+        void Submit(const LogRecord &record);
+
+        // Returns once everything submitted before the call has reached the sinks
+        void Flush();
+
+        void Shutdown();
+
+        LogStats GetStats() const;
+
+    private:
+        class Ring;
+
+        AsyncLogger();
+
+        void Run();
+
+        void Drain();
+
+        void WriteToSinks(const LogRecord &record);
+
+        inline static std::atomic<int> minLevel_{static_cast<int>(Level::Info)};
+
+        AsyncLoggerSettings settings_;
+
+        std::unique_ptr<Ring> ring_;
+
+        std::mutex sinksMutex_;
+        std::vector<std::shared_ptr<LogSink> > sinks_;
+
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable flushed_;
+        uint64_t flushRequested_{0};
+        uint64_t flushCompleted_{0};
+        bool stopping_{false};
+        std::atomic<bool> stopped_{false};
+        std::atomic<uint64_t> submitting_{0}; // Submit calls that may still push into the ring
+        std::thread thread_;
+
+        std::atomic<uint64_t> written_{0};
+        std::atomic<uint64_t> dropped_{0};
+        std::atomic<uint64_t> truncated_{0};
+        uint64_t reportedDrops_{0};
+    };
+
+    // Builds one record on the stack; submitted when the statement ends
+    class LogLine {
+    public:
+        LogLine(const Level level, const char *file, const uint32_t line, const char *function) {
+            record_.time = std::chrono::system_clock::now();
+            record_.file = file;
+            record_.function = function;
+            record_.line = line;
+            record_.level = level;
+        }
+
+        ~LogLine() {
+            AsyncLogger::GetInstance().Submit(record_);
+        }
+
+        LogLine(const LogLine &) = delete;
+
+        LogLine &operator=(const LogLine &) = delete;
+
+        LogLine &operator<<(const std::string_view text) {
+            Append(text.data(), text.size());
+            return *this;
+        }
+
+        LogLine &operator<<(const std::string &text) { return *this << std::string_view(text); }
+
+        LogLine &operator<<(const char *text) { return *this << std::string_view(text ? text : "(null)"); }
+
+        LogLine &operator<<(const char c) {
+            Append(&c, 1);
+            return *this;
+        }
+
+        LogLine &operator<<(const bool value) { return *this << (value ? '1' : '0'); }
+
+        template<typename T> requires std::is_arithmetic_v<T>
+        LogLine &operator<<(const T value) {
+            char buffer[32];
+            const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            Append(buffer, ec == std::errc() ? static_cast<size_t>(end - buffer) : 0);
+            return *this;
+        }
+
+        // Everything else that has a stream operator (error codes, thread ids, json, pointers...)
+        template<typename T> requires (!std::is_arithmetic_v<T> &&
+                                       !std::is_convertible_v<const T &, const char *> &&
+                                       requires(std::ostream &os, const T &value) { os << value; })
+        LogLine &operator<<(const T &value) {
+            std::ostringstream stream;
+            stream << value;
+            return *this << stream.view();
+        }
+
+    private:
+        void Append(const char *data, size_t size) {
+            const size_t room = LogRecord::MAX_TEXT - record_.length;
+            if (size > room) {
+                size = room;
+                record_.truncated = true;
+            }
+            std::memcpy(record_.text + record_.length, data, size);
+            record_.length = static_cast<uint16_t>(record_.length + size);
+        }
+
+        LogRecord record_;
+    };
+}
+
+#endif //NUANSA_UTILS_LOG_ASYNC_LOGGER_H
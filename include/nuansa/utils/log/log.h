@@ -5,9 +5,22 @@
 #ifndef NUANSA_UTILS_LOG_LOG_H
 #define NUANSA_UTILS_LOG_LOG_H
 
-#define LOG_ERROR BOOST_LOG_TRIVIAL(error) << "[" << __FILE__ << ":" << __LINE__ << " " << __func__ << "] "
-#define LOG_WARNING BOOST_LOG_TRIVIAL(warning) << "[" << __FILE__ << ":" << __LINE__ << " " << __func__ << "] "
-#define LOG_INFO BOOST_LOG_TRIVIAL(info) << "[" << __FILE__ << ":" << __LINE__ << " " << __func__ << "] "
-#define LOG_DEBUG BOOST_LOG_TRIVIAL(debug) << "[" << __FILE__ << ":" << __LINE__ << " " << __func__ << "] "
+#include "nuansa/utils/log/async_logger.h"
+
+// Statements below this level are compiled out (0 debug, 1 info, 2 warning, 3 error)
+#ifndef NUANSA_LOG_MIN_LEVEL
+#define NUANSA_LOG_MIN_LEVEL 0
+#endif
+
+// Nothing after the << is evaluated unless the level is compiled in and currently enabled
+#define NUANSA_LOG(level) \
+    if constexpr (static_cast<int>(level) < NUANSA_LOG_MIN_LEVEL) {} \
+    else if (!::nuansa::utils::log::AsyncLogger::IsEnabled(level)) {} \
+    else ::nuansa::utils::log::LogLine(level, __FILE__, __LINE__, __func__)
+
+#define LOG_ERROR NUANSA_LOG(::nuansa::utils::log::Level::Error)
+#define LOG_WARNING NUANSA_LOG(::nuansa::utils::log::Level::Warning)
+#define LOG_INFO NUANSA_LOG(::nuansa::utils::log::Level::Info)
+#define LOG_DEBUG NUANSA_LOG(::nuansa::utils::log::Level::Debug)
 
 #endif //NUANSA_UTILS_LOG_LOG_H
@@ -0,0 +1,123 @@
+#ifndef NUANSA_UTILS_LOG_ROTATING_FILE_SINK_H
+#define NUANSA_UTILS_LOG_ROTATING_FILE_SINK_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "nuansa/utils/log/async_logger.h"
+
+namespace nuansa::utils::log {
+    struct RotatingFileSinkSettings {
+        std::filesystem::path path;
+        LogFormat format{LogFormat::Text};
+        size_t bufferBytes{256 * 1024}; // Formatted lines kept in memory before one write(2).
+        uint64_t maxFileBytes{100 * 1024 * 1024}; // Rotate once the file reaches this size; 0 disables.
+        std::chrono::seconds rotateInterval{std::chrono::hours(24)}; // Rotate files older than this; 0 disables.
+        std::chrono::milliseconds fsyncInterval{std::chrono::seconds(1)}; // Longest time written data stays unsynced.
+        size_t maxRotatedFiles{10}; // Older segments are deleted.
+        bool compressRotated{true}; // gzip segments after rotation, off the logging thread.
+        // First wait before reopening a file that failed to open after rotation; doubles up to a minute.
+        std::chrono::milliseconds reopenBackoff{std::chrono::seconds(1)};
+    };
+
+    /**
+     * @brief Log sink that appends to a file with large buffered writes and rotates it
+     *
+     * Lines are formatted into an in-memory buffer that goes to the file in
+     * one write when it fills up or when the logger flushes at the end of a
+     * drain cycle. fsync only happens on rotation and at most once per
+     * fsyncInterval, so a slow disk never stalls the drain loop for long.
+     *
+     * A rotated file is renamed to "<path>.<YYYYmmdd-HHMMSS.mmm>" and, when
+     * enabled, compressed to "<name>.gz" by a background thread. Only the
+     * newest maxRotatedFiles segments are kept.
+     *
+     * When the file cannot be reopened after a rotation (disk full, directory
+     * gone), records are dropped and counted instead of buffered, and the
+     * reopen is retried with exponential backoff rather than on every write.
+     *
+     * Like every LogSink it is only called from the logger's sink thread.
+     *
+     * Usage example:
+     * @code
+     * auto sink = std::make_shared<RotatingFileSink>(RotatingFileSinkSettings{
+     *     .path = "logs/lentera.log",
+     *     .format = LogFormat::Json
+     * });
+     * AsyncLogger::GetInstance().SetSinks({std::make_shared<ConsoleLogSink>(), sink});
+     * @endcode
+     */
+    class RotatingFileSink final : public LogSink {
+    public:
+        // Throws std::runtime_error when the file cannot be opened
+        explicit RotatingFileSink(RotatingFileSinkSettings settings);
+
+        ~RotatingFileSink() override;
+
+        RotatingFileSink(const RotatingFileSink &) = delete;
+
+        RotatingFileSink &operator=(const RotatingFileSink &) = delete;
+
+        void Write(const LogRecord &record) override;
+
+        void Flush() override;
+
+        // Blocks until every rotated segment handed to the compressor is done; mostly for tests
+        void WaitForCompression();
+
+        uint64_t GetRotationCount() const { return rotations_; }
+
+        // Records lost while the file could not be opened
+        uint64_t GetDroppedCount() const { return dropped_; }
+
+    private:
+        using Clock = std::chrono::system_clock;
+
+        void Open();
+
+        // Reopens the file once the backoff has passed; false while it stays closed
+        bool EnsureOpen();
+
+        void WriteBuffer();
+
+        void Sync();
+
+        void Rotate();
+
+        std::filesystem::path NextRotatedPath() const;
+
+        void RunCompressor();
+
+        void Compress(const std::filesystem::path &segment) const;
+
+        void PruneRotated() const;
+
+        RotatingFileSinkSettings settings_;
+        std::string buffer_;
+        int fd_{-1};
+        uint64_t fileBytes_{0};
+        bool unsynced_{false};
+        Clock::time_point openedAt_;
+        Clock::time_point lastSync_;
+        uint64_t rotations_{0};
+        uint64_t dropped_{0};
+        uint64_t droppedReported_{0};
+        std::chrono::milliseconds reopenDelay_{0};
+        Clock::time_point nextReopen_;
+
+        std::mutex compressMutex_;
+        std::condition_variable compressWake_;
+        std::condition_variable compressIdle_;
+        std::deque<std::filesystem::path> pending_;
+        bool compressing_{false};
+        bool stopping_{false};
+        std::thread compressor_;
+    };
+}
+
+#endif //NUANSA_UTILS_LOG_ROTATING_FILE_SINK_H
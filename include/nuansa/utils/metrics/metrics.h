@@ -0,0 +1,203 @@
+#ifndef NUANSA_UTILS_METRICS_METRICS_H
+#define NUANSA_UTILS_METRICS_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace nuansa::utils::metrics {
+    // Label pairs in the order they are rendered, e.g. {{"type", "chat"}}
+    using Labels = std::vector<std::pair<std::string, std::string> >;
+
+    namespace detail {
+        // Writers spread over this many cache lines; a thread keeps the slot it was given first
+        constexpr size_t SHARDS = 16;
+
+        inline size_t ShardIndex() {
+            static std::atomic<size_t> next{0};
+            thread_local const size_t index = next.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+            return index;
+        }
+
+        struct alignas(64) PaddedCounter {
+            std::atomic<uint64_t> value{0};
+        };
+    }
+
+    // Monotonic count; Increment touches only the calling thread's shard
+    class Counter {
+    public:
+        void Increment(const uint64_t amount = 1) {
+            shards_[detail::ShardIndex()].value.fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        uint64_t Value() const {
+            uint64_t total = 0;
+            for (const auto &shard: shards_) {
+                total += shard.value.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+    private:
+        std::array<detail::PaddedCounter, detail::SHARDS> shards_{};
+    };
+
+    // Value that goes up and down, like open connections
+    class Gauge {
+    public:
+        void Set(const int64_t value) { value_.store(value, std::memory_order_relaxed); }
+
+        void Increment(const int64_t amount = 1) { value_.fetch_add(amount, std::memory_order_relaxed); }
+
+        void Decrement(const int64_t amount = 1) { value_.fetch_sub(amount, std::memory_order_relaxed); }
+
+        int64_t Value() const { return value_.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<int64_t> value_{0};
+    };
+
+    /**
+     * @brief Log-linear histogram of non-negative integer samples
+     *
+     * Every power of two is split into 8 linear sub-buckets, so a recorded
+     * value lands in a bucket at most 12.5% wider than itself, from 1 up to
+     * 2^40 (about 12 days in microseconds). Record is one relaxed add on the
+     * calling thread's shard; percentiles and exposition merge the shards.
+     *
+     * Usage example:
+     * @code
+     * auto &latency = MetricsRegistry::GetInstance().GetHistogram(
+     *     "nuansa_auth_duration_seconds", "Login latency", {{"operation", "login"}}, 1e-6);
+     * const ScopedTimer timer(latency);
+     * @endcode
+     */
+    class Histogram {
+    public:
+        static constexpr int SUB_BUCKET_BITS = 3;
+        static constexpr uint64_t SUB_BUCKETS = uint64_t{1} << SUB_BUCKET_BITS;
+        static constexpr int MAX_EXPONENT = 40;
+        static constexpr size_t BUCKETS = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+        // scale converts recorded units to exported ones, e.g. 1e-6 for microseconds exported as seconds
+        explicit Histogram(double scale = 1.0);
+
+        void Record(uint64_t value);
+
+        uint64_t Count() const;
+
+        uint64_t Sum() const;
+
+        // Upper bound of the bucket holding the q-th quantile (0 <= q <= 1), in recorded units
+        uint64_t Percentile(double q) const;
+
+        double Scale() const { return scale_; }
+
+        // Per-bucket counts merged over all shards
+        std::vector<uint64_t> Snapshot() const;
+
+        static size_t BucketIndex(uint64_t value);
+
+        // Exclusive upper bound of a bucket
+        static uint64_t BucketUpperBound(size_t index);
+
+    private:
+        struct alignas(64) Shard {
+            std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+            std::atomic<uint64_t> sum{0};
+        };
+
+        double scale_;
+        std::unique_ptr<Shard[]> shards_;
+    };
+
+    // Records the elapsed microseconds into a histogram when it goes out of scope
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Histogram &histogram)
+            : histogram_(histogram), start_(std::chrono::steady_clock::now()) {
+        }
+
+        ~ScopedTimer() {
+            histogram_.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start_).count()));
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        Histogram &histogram_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    enum class MetricType {
+        Counter,
+        Gauge,
+        Histogram
+    };
+
+    /**
+     * @brief Process-wide set of named metrics, rendered in the Prometheus text format
+     *
+     * Metrics are created on first lookup and live for the whole process,
+     * so callers look them up once and keep the reference; the lookup takes
+     * a lock, updating a metric never does. Values owned elsewhere (pool
+     * sizes, circuit breaker counts) are registered as callbacks that are
+     * read at scrape time.
+     */
+    class MetricsRegistry {
+    public:
+        static MetricsRegistry &GetInstance();
+
+        MetricsRegistry() = default;
+
+        MetricsRegistry(const MetricsRegistry &) = delete;
+
+        MetricsRegistry &operator=(const MetricsRegistry &) = delete;
+
+        // Throws std::invalid_argument when the name is already used by a metric of another type
+        Counter &GetCounter(const std::string &name, const std::string &help, const Labels &labels = {});
+
+        Gauge &GetGauge(const std::string &name, const std::string &help, const Labels &labels = {});
+
+        Histogram &GetHistogram(const std::string &name, const std::string &help, const Labels &labels = {},
+                                double scale = 1.0);
+
+        // type must be Counter or Gauge; registering the same series again replaces the callback.
+        // read runs under the registry lock at scrape time, so it must not look up metrics itself.
+        void RegisterCallback(const std::string &name, const std::string &help, MetricType type,
+                              const Labels &labels, std::function<double()> read);
+
+        std::string RenderPrometheus() const;
+
+    private:
+        struct Series {
+            std::unique_ptr<Counter> counter;
+            std::unique_ptr<Gauge> gauge;
+            std::unique_ptr<Histogram> histogram;
+            std::function<double()> callback;
+        };
+
+        struct Family {
+            std::string help;
+            MetricType type{MetricType::Counter};
+            std::map<std::string, Series> series; // By rendered label set
+        };
+
+        Series &FindSeries(const std::string &name, const std::string &help, MetricType type, const Labels &labels);
+
+        mutable std::mutex mutex_;
+        std::map<std::string, Family> families_;
+    };
+}
+
+#endif //NUANSA_UTILS_METRICS_METRICS_H
@@ -0,0 +1,57 @@
+#ifndef NUANSA_UTILS_METRICS_METRICS_SERVER_H
+#define NUANSA_UTILS_METRICS_METRICS_SERVER_H
+
+#include "nuansa/utils/pch.h"
+#include "nuansa/utils/metrics/metrics.h"
+
+namespace nuansa::utils::metrics {
+    struct MetricsServerSettings {
+        std::string host{"127.0.0.1"};
+        uint16_t port{9100}; // 0 picks a free port, see GetPort()
+    };
+
+    /**
+     * @brief Serves GET /metrics in the Prometheus text format on its own port
+     *
+     * Runs a single-threaded io_context on a background thread, so scrapes
+     * never compete with the WebSocket io threads for a slot. Each request
+     * gets a fresh rendering of the registry; anything but GET /metrics is
+     * answered with 404.
+     *
+     * Usage example:
+     * @code
+     * MetricsServer server(MetricsRegistry::GetInstance(), MetricsServerSettings{.port = 9100});
+     * server.Start();
+     * @endcode
+     */
+    class MetricsServer {
+    public:
+        MetricsServer(MetricsRegistry &registry, MetricsServerSettings settings);
+
+        ~MetricsServer();
+
+        MetricsServer(const MetricsServer &) = delete;
+
+        MetricsServer &operator=(const MetricsServer &) = delete;
+
+        // Binds and starts serving; throws boost::system::system_error when the port is taken
+        void Start();
+
+        void Stop();
+
+        uint16_t GetPort() const;
+
+    private:
+        class Session;
+
+        void Accept();
+
+        MetricsRegistry &registry_;
+        MetricsServerSettings settings_;
+        boost::asio::io_context ioc_;
+        boost::asio::ip::tcp::acceptor acceptor_;
+        std::thread thread_;
+    };
+}
+
+#endif //NUANSA_UTILS_METRICS_METRICS_SERVER_H
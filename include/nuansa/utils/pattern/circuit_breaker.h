@@ -1,15 +1,21 @@
 #ifndef NUANSA_UTILS_PATTERN_CIRCUIT_BREAKER_H
 #define NUANSA_UTILS_PATTERN_CIRCUIT_BREAKER_H
 
+#include <atomic>
+#include <shared_mutex>
+
 #include "nuansa/utils/pch.h"
 #include "nuansa/utils/exception/circuit_breaker_exception.h"
 
 namespace nuansa::utils::pattern {
     struct CircuitBreakerSettings {
-        size_t failureThreshold{5}; // Number of failures before opening the circuit.
-        size_t successThreshold{2}; // Number of consecutive successes to close the circuit breaker.
-        std::chrono::seconds resetTimeout{std::chrono::seconds(30)}; // Time to wait before attemting to recover.
+        size_t failureThreshold{5}; // Minimum failures inside the window before the circuit may open.
+        size_t successThreshold{2}; // Successful half-open probes needed to close the circuit again.
+        std::chrono::milliseconds resetTimeout{std::chrono::seconds(30)}; // Time to wait before attemting to recover.
         std::chrono::seconds timeout{std::chrono::seconds(10)}; // Operation timeout.
+        double failureRateThreshold{0.5}; // Share of failed calls inside the window that opens the circuit.
+        std::chrono::milliseconds window{std::chrono::seconds(30)}; // Sliding window the failure rate is taken over.
+        size_t bucketCount{10}; // Window resolution; each bucket covers window / bucketCount.
     };
 
     /**
@@ -19,9 +25,17 @@ namespace nuansa::utils::pattern {
      * systems by detecting failures and encapsulating the logic of preventing
      * a failure from constantly recurring.
      *
+     * The hot path takes no lock. State and the time of the last transition
+     * share one atomic word, so every transition is a single compare-and-swap.
+     * Outcomes are counted in a ring of time buckets, each packed into one
+     * atomic word, and the circuit opens when the failure rate over the sliding
+     * window crosses the threshold (with at least failureThreshold failures).
+     * After resetTimeout a limited number of probes is let through; enough
+     * successes close the circuit, any failure opens it again.
+     *
      * Usage example:
      * @code
-     * CircuitBreaker breaker;
+     * auto &breaker = CircuitBreakerRegistry::GetInstance().Get(breakers::GOOGLE);
      * try {
      *     auto result = breaker.Execute([](){ return makeHttpCall(); });
      * } catch (const CircuitBreakerOpenException& e) {
@@ -38,185 +52,437 @@ namespace nuansa::utils::pattern {
             // Half-open state, recovering. The circuit is half-open and requests are allowed with a limited number of requests.
         };
 
-        static CircuitBreaker &GetInstance() {
-            static CircuitBreaker instance;
-            return instance;
-        }
+        struct Metrics {
+            size_t totalCalls{0};
+            size_t successfulCalls{0};
+            size_t failedCalls{0};
+            size_t timeouts{0};
+            size_t rejectedCalls{0}; // Calls refused while open or out of half-open probes.
+            std::chrono::milliseconds averageResponseTime{0};
+            State state{State::CLOSED};
+            size_t windowSuccesses{0};
+            size_t windowFailures{0};
+        };
+
+        // The primary database breaker, shared by everything that talks to it
+        static CircuitBreaker &GetInstance();
 
-        bool IsInitialized() const {
-            return initialized_;
+        explicit CircuitBreaker(CircuitBreakerSettings settings = CircuitBreakerSettings{},
+                                std::string name = "default")
+            : name_{std::move(name)} {
+            ApplySettings(settings);
         }
 
+        CircuitBreaker(const CircuitBreaker &) = delete;
+
+        CircuitBreaker &operator=(const CircuitBreaker &) = delete;
+
         void Reset() {
-            std::lock_guard<std::mutex> lock(mutex_);
-            failureCount_ = 0;
-            successCount_ = 0;
-            state_ = State::CLOSED;
-            lastStateChange_ = std::chrono::steady_clock::now();
+            state_.store(PackState(State::CLOSED, NowMs()), std::memory_order_release);
+            ClearWindow();
         }
 
-        void Initialize(const CircuitBreakerSettings &settings = CircuitBreakerSettings{}) {
-            std::lock_guard<std::mutex> lock(mutex_);
+        const std::string &GetName() const { return name_; }
 
-            if (initialized_) {
-                return;
-            }
+        const CircuitBreakerSettings &GetSettings() const { return settings_; }
 
-            settings_ = settings;
-            initialized_ = true;
+        State GetState() const {
+            return StateOf(state_.load(std::memory_order_acquire));
         }
 
-        struct Metrics {
-            size_t totalCalls{0};
-            size_t successfulCalls{0};
-            size_t failedCalls{0};
-            size_t timeouts{0};
-            std::chrono::milliseconds averageResponseTime{0};
-        };
+        bool IsOpen() const {
+            return GetState() == State::OPEN;
+        }
 
-        const Metrics &GetMetrics() const {
-            std::lock_guard<std::mutex> lock(mutex_);
-            return metrics_;
+        /**
+         * @brief Asks for permission to call the dependency
+         *
+         * Moves an expired OPEN circuit to HALF_OPEN and hands out that state's
+         * probe slots. Every admitted call should end in RecordSuccess or
+         * RecordFailure; probes that never report are re-issued once
+         * resetTimeout has passed.
+         */
+        bool AllowRequest() {
+            uint64_t word = state_.load(std::memory_order_acquire);
+            while (true) {
+                const auto now = NowMs();
+                switch (StateOf(word)) {
+                    case State::CLOSED:
+                        return true;
+
+                    case State::OPEN:
+                        if (now - SinceOf(word) < ResetTimeoutMs()) {
+                            rejectedCalls_.fetch_add(1, std::memory_order_relaxed);
+                            return false;
+                        }
+                        if (Transition(word, State::HALF_OPEN, now)) {
+                            word = PackState(State::HALF_OPEN, now);
+                        }
+                        continue;
+
+                    case State::HALF_OPEN:
+                        if (halfOpenAdmitted_.fetch_add(1, std::memory_order_acq_rel) < settings_.successThreshold) {
+                            return true;
+                        }
+                        // Earlier probes never reported back; start a fresh round
+                        if (now - SinceOf(word) >= ResetTimeoutMs() &&
+                            Transition(word, State::HALF_OPEN, now)) {
+                            halfOpenAdmitted_.fetch_add(1, std::memory_order_acq_rel);
+                            return true;
+                        }
+                        rejectedCalls_.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                }
+            }
         }
 
-        bool IsOpen() const {
-            std::lock_guard<std::mutex> lock(mutex_);
-            return state_ == State::OPEN;
+        void RecordSuccess(const std::chrono::milliseconds responseTime = std::chrono::milliseconds::zero()) {
+            Count(true, responseTime);
+
+            uint64_t word = state_.load(std::memory_order_acquire);
+            if (StateOf(word) == State::HALF_OPEN &&
+                halfOpenSucceeded_.fetch_add(1, std::memory_order_acq_rel) + 1 >= settings_.successThreshold) {
+                Transition(word, State::CLOSED, NowMs());
+            }
         }
 
-        explicit CircuitBreaker(CircuitBreakerSettings settings = CircuitBreakerSettings{})
-            : settings_{std::move(settings)} {
+        // A failure that ran into the deadline; counted separately in the metrics
+        void RecordTimeout(const std::chrono::milliseconds responseTime = std::chrono::milliseconds::zero()) {
+            timeouts_.fetch_add(1, std::memory_order_relaxed);
+            RecordFailure(responseTime);
         }
 
-        template<typename Func>
-        auto Execute(Func &&func) ->
-            std::enable_if_t<!std::is_void_v<decltype(func())>,
-                decltype(func())> {
-            CheckState();
+        void RecordFailure(const std::chrono::milliseconds responseTime = std::chrono::milliseconds::zero()) {
+            Count(false, responseTime);
+
+            uint64_t word = state_.load(std::memory_order_acquire);
+            switch (StateOf(word)) {
+                case State::HALF_OPEN:
+                    Transition(word, State::OPEN, NowMs());
+                    break;
+                case State::CLOSED: {
+                    const auto [successes, failures] = Window();
+                    if (failures >= settings_.failureThreshold &&
+                        static_cast<double>(failures) >=
+                        settings_.failureRateThreshold * static_cast<double>(successes + failures)) {
+                        Transition(word, State::OPEN, NowMs());
+                    }
+                    break;
+                }
+                case State::OPEN:
+                    break;
+            }
+        }
 
-            if (state_ == State::OPEN) {
-                throw utils::exception::CircuitBreakerOpenException("Circuit breaker is OPEN");
+        template<typename Func>
+        auto Execute(Func &&func) -> decltype(func()) {
+            if (!AllowRequest()) {
+                throw utils::exception::CircuitBreakerOpenException("Circuit breaker '" + name_ + "' is OPEN");
             }
 
+            const auto start = std::chrono::steady_clock::now();
+            const auto elapsed = [start] {
+                return std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start);
+            };
+
             try {
-                auto result = std::forward<Func>(func)();
-                RecordSuccess();
-                return result;
+                if constexpr (std::is_void_v<decltype(func())>) {
+                    std::forward<Func>(func)();
+                    RecordSuccess(elapsed());
+                } else {
+                    auto result = std::forward<Func>(func)();
+                    RecordSuccess(elapsed());
+                    return result;
+                }
             } catch (const std::exception &e) {
-                RecordFailure();
+                RecordFailure(elapsed());
                 throw utils::exception::CircuitBreakerException(e.what());
             }
         }
 
+        /**
+         * @brief Runs func on the calling thread under a deadline of now + timeout
+         *
+         * func receives the deadline and has to enforce it itself, e.g. with
+         * ConnectionGuard::ExecuteWithDeadline or an HTTP request timeout, so
+         * that work past the deadline is really cancelled. A call that throws
+         * CircuitBreakerTimeoutException or returns after the deadline counts
+         * as a timeout; a late result is still returned since its side effects
+         * have already happened.
+         */
         template<typename Func>
-        auto Execute(Func &&func) ->
-            std::enable_if_t<std::is_void_v<decltype(func())>,
-                void> {
-            CheckState();
-
-            if (state_ == State::OPEN) {
-                throw utils::exception::CircuitBreakerOpenException("Circuit breaker is OPEN");
+        auto ExecuteWithTimeout(Func &&func) -> decltype(func(std::chrono::steady_clock::time_point{})) {
+            if (!AllowRequest()) {
+                throw utils::exception::CircuitBreakerOpenException("Circuit breaker '" + name_ + "' is OPEN");
             }
 
+            const auto start = std::chrono::steady_clock::now();
+            const auto deadline = start + settings_.timeout;
+            const auto settle = [&](const bool failed) {
+                const auto now = std::chrono::steady_clock::now();
+                const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start);
+                if (now > deadline) {
+                    RecordTimeout(elapsed);
+                } else if (failed) {
+                    RecordFailure(elapsed);
+                } else {
+                    RecordSuccess(elapsed);
+                }
+            };
+
             try {
-                std::forward<Func>(func)();
-                RecordSuccess();
+                if constexpr (std::is_void_v<decltype(func(deadline))>) {
+                    std::forward<Func>(func)(deadline);
+                    settle(false);
+                } else {
+                    auto result = std::forward<Func>(func)(deadline);
+                    settle(false);
+                    return result;
+                }
+            } catch (const utils::exception::CircuitBreakerTimeoutException &) {
+                RecordTimeout(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start));
+                throw;
             } catch (const std::exception &e) {
-                RecordFailure();
+                settle(true);
                 throw utils::exception::CircuitBreakerException(e.what());
             }
         }
 
-        void CheckState() {
-            std::lock_guard<std::mutex> lock(mutex_);
+        // A consistent-enough copy; each counter is read atomically
+        Metrics GetMetrics() const {
+            Metrics metrics;
+            metrics.successfulCalls = successfulCalls_.load(std::memory_order_relaxed);
+            metrics.failedCalls = failedCalls_.load(std::memory_order_relaxed);
+            metrics.totalCalls = metrics.successfulCalls + metrics.failedCalls;
+            metrics.timeouts = timeouts_.load(std::memory_order_relaxed);
+            metrics.rejectedCalls = rejectedCalls_.load(std::memory_order_relaxed);
+            if (metrics.totalCalls > 0) {
+                metrics.averageResponseTime = std::chrono::milliseconds(
+                    totalResponseMs_.load(std::memory_order_relaxed) / metrics.totalCalls);
+            }
+            metrics.state = GetState();
+            std::tie(metrics.windowSuccesses, metrics.windowFailures) = Window();
+            return metrics;
+        }
 
-            if (state_ == State::OPEN) {
-                if (const auto elapsed = std::chrono::steady_clock::now() - lastFailureTime_;
-                    elapsed >= settings_.resetTimeout) {
-                    state_ = State::HALF_OPEN;
-                    failureCount_ = 0;
-                    successCount_ = 0;
-                }
+    private:
+        // State word: low 2 bits state, the rest the steady-clock millisecond of the last transition
+        static constexpr uint64_t STATE_BITS = 2;
+        static constexpr uint64_t STATE_MASK = (uint64_t{1} << STATE_BITS) - 1;
+
+        // Bucket word: 24-bit bucket epoch, 20-bit failure count, 20-bit success count
+        static constexpr uint64_t COUNT_BITS = 20;
+        static constexpr uint64_t COUNT_MASK = (uint64_t{1} << COUNT_BITS) - 1;
+        static constexpr uint64_t EPOCH_MASK = (uint64_t{1} << 24) - 1;
+
+        // Constructor only: the hot path reads settings_ and buckets_ without a lock
+        void ApplySettings(const CircuitBreakerSettings &settings) {
+            settings_ = settings;
+            settings_.bucketCount = std::max<size_t>(1, settings_.bucketCount);
+            bucketWidthMs_ = std::max<int64_t>(
+                1, settings_.window.count() / static_cast<int64_t>(settings_.bucketCount));
+            buckets_ = std::make_unique<std::atomic<uint64_t>[]>(settings_.bucketCount);
+            Reset();
+        }
+
+        static int64_t NowMs() {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        static uint64_t PackState(const State state, const int64_t sinceMs) {
+            return (static_cast<uint64_t>(sinceMs) << STATE_BITS) | static_cast<uint64_t>(state);
+        }
+
+        static State StateOf(const uint64_t word) { return static_cast<State>(word & STATE_MASK); }
+
+        static int64_t SinceOf(const uint64_t word) { return static_cast<int64_t>(word >> STATE_BITS); }
+
+        static uint64_t PackBucket(const uint64_t epoch, const uint64_t successes, const uint64_t failures) {
+            return (epoch << (2 * COUNT_BITS)) | (failures << COUNT_BITS) | successes;
+        }
+
+        int64_t ResetTimeoutMs() const {
+            return settings_.resetTimeout.count();
+        }
+
+        uint64_t CurrentEpoch() const {
+            return static_cast<uint64_t>(NowMs() / bucketWidthMs_) & EPOCH_MASK;
+        }
+
+        // Only the thread whose CAS wins performs the side effects of a transition
+        bool Transition(uint64_t &expected, const State to, const int64_t nowMs) {
+            const State from = StateOf(expected);
+            if (!state_.compare_exchange_strong(expected, PackState(to, nowMs), std::memory_order_acq_rel)) {
+                return false;
             }
+
+            if (to == State::HALF_OPEN) {
+                halfOpenAdmitted_.store(0, std::memory_order_release);
+                halfOpenSucceeded_.store(0, std::memory_order_release);
+            } else if (to == State::CLOSED) {
+                // Failures from before the outage must not re-open the fresh circuit
+                ClearWindow();
+            }
+
+            if (to == State::OPEN) {
+                const auto [successes, failures] = Window();
+                LOG_WARNING << "Circuit breaker '" << name_ << "' opened (" << failures << " of "
+                        << successes + failures << " calls failed in the window)";
+            } else if (from != to) {
+                LOG_INFO << "Circuit breaker '" << name_ << "' is now "
+                        << (to == State::CLOSED ? "CLOSED" : "HALF_OPEN");
+            }
+            return true;
         }
 
-        void RecordSuccess() {
-            std::lock_guard<std::mutex> lock(mutex_);
+        void Count(const bool success, const std::chrono::milliseconds responseTime) {
+            (success ? successfulCalls_ : failedCalls_).fetch_add(1, std::memory_order_relaxed);
+            totalResponseMs_.fetch_add(static_cast<uint64_t>(responseTime.count()), std::memory_order_relaxed);
+
+            const uint64_t epoch = CurrentEpoch();
+            auto &bucket = buckets_[epoch % settings_.bucketCount];
+            uint64_t current = bucket.load(std::memory_order_relaxed);
+            while (true) {
+                // A bucket left over from an earlier lap of the ring starts again from zero
+                uint64_t successes = 0;
+                uint64_t failures = 0;
+                if ((current >> (2 * COUNT_BITS)) == epoch) {
+                    successes = current & COUNT_MASK;
+                    failures = (current >> COUNT_BITS) & COUNT_MASK;
+                }
+                if (success) {
+                    successes = std::min(successes + 1, COUNT_MASK);
+                } else {
+                    failures = std::min(failures + 1, COUNT_MASK);
+                }
 
-            if (state_ == State::HALF_OPEN) {
-                ++successCount_;
-                if (successCount_ >= settings_.successThreshold) {
-                    state_ = State::CLOSED;
-                    failureCount_ = 0;
-                    successCount_ = 0;
+                if (bucket.compare_exchange_weak(current, PackBucket(epoch, successes, failures),
+                                                 std::memory_order_relaxed)) {
+                    return;
                 }
             }
         }
 
-        void RecordFailure() {
-            std::lock_guard<std::mutex> lock(mutex_);
-
-            failureCount_++;
-            lastFailureTime_ = std::chrono::steady_clock::now();
+        std::pair<size_t, size_t> Window() const {
+            const uint64_t epoch = CurrentEpoch();
+            size_t successes = 0;
+            size_t failures = 0;
+            for (size_t i = 0; i < settings_.bucketCount; ++i) {
+                const uint64_t word = buckets_[i].load(std::memory_order_relaxed);
+                const uint64_t age = (epoch - (word >> (2 * COUNT_BITS))) & EPOCH_MASK;
+                if (age < settings_.bucketCount) {
+                    successes += word & COUNT_MASK;
+                    failures += (word >> COUNT_BITS) & COUNT_MASK;
+                }
+            }
+            return {successes, failures};
+        }
 
-            if (state_ == State::CLOSED && failureCount_ >= settings_.failureThreshold) {
-                state_ = State::OPEN;
-            } else if (state_ == State::HALF_OPEN) {
-                state_ = State::OPEN;
+        void ClearWindow() {
+            for (size_t i = 0; i < settings_.bucketCount; ++i) {
+                buckets_[i].store(0, std::memory_order_relaxed);
             }
         }
 
-        template<typename Func, typename... Args>
-        auto ExecuteWithTimeout(Func &&func, Args &&... args) {
-            std::promise<decltype(func(args...))> promise;
-            auto future = promise.get_future();
+        std::string name_;
+        CircuitBreakerSettings settings_;
+        int64_t bucketWidthMs_{1};
+        std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+
+        std::atomic<uint64_t> state_{0};
+        std::atomic<size_t> halfOpenAdmitted_{0};
+        std::atomic<size_t> halfOpenSucceeded_{0};
+
+        std::atomic<size_t> successfulCalls_{0};
+        std::atomic<size_t> failedCalls_{0};
+        std::atomic<size_t> timeouts_{0};
+        std::atomic<size_t> rejectedCalls_{0};
+        std::atomic<uint64_t> totalResponseMs_{0};
+    };
 
-            // Execute function in a separate thread
-            std::thread worker([&promise, func = std::forward<Func>(func),
-                    ... args = std::forward<Args>(args)]() mutable {
-                    try {
-                        promise.set_value(func(std::forward<Args>(args)...));
-                    } catch (...) {
-                        promise.set_exception(std::current_exception());
-                    }
-                });
+    // Names of the dependencies that get their own breaker
+    namespace breakers {
+        inline const std::string PRIMARY_DB = "primary_db";
+        inline const std::string GOOGLE = "google";
+        inline const std::string GITHUB = "github";
+    }
 
-            // Wait for the function to finish or timeout
-            if (future.wait_for(settings_.timeout) == std::future_status::timeout) {
-                worker.detach();
-                throw utils::exception::CircuitBreakerTimeoutException("Operation timed out");
-            }
+    /**
+     * @brief Named circuit breakers, one per downstream dependency
+     *
+     * Each dependency trips independently, so a GitHub outage doesn't block
+     * database logins. Breakers are created on first use from the configured
+     * defaults plus any per-name overrides and live for the whole process,
+     * so references returned by Get stay valid.
+     */
+    class CircuitBreakerRegistry {
+    public:
+        static CircuitBreakerRegistry &GetInstance() {
+            static CircuitBreakerRegistry instance;
+            return instance;
+        }
 
-            worker.join();
-            return future.get();
+        /**
+         * @brief Sets the settings for breakers created from now on
+         *
+         * Breakers that already exist keep theirs: callers may be inside them
+         * without a lock, so their window can't be swapped out. Call it at
+         * startup, before the first Get.
+         */
+        void Configure(const CircuitBreakerSettings &defaults,
+                       std::unordered_map<std::string, CircuitBreakerSettings> overrides = {}) {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            defaults_ = defaults;
+            overrides_ = std::move(overrides);
+            for (const auto &name: breakers_ | std::views::keys) {
+                LOG_WARNING << "Circuit breaker '" << name << "' is already in use and keeps its settings";
+            }
         }
 
-        void UpdateMetrics(const std::chrono::milliseconds responseTime, const bool success) {
-            std::lock_guard<std::mutex> lock(mutex_);
+        CircuitBreaker &Get(const std::string &name) {
+            {
+                std::shared_lock<std::shared_mutex> lock(mutex_);
+                if (const auto it = breakers_.find(name); it != breakers_.end()) {
+                    return *it->second;
+                }
+            }
 
-            metrics_.totalCalls++;
-            if (success) {
-                metrics_.successfulCalls++;
-            } else {
-                metrics_.failedCalls++;
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            auto &breaker = breakers_[name];
+            if (!breaker) {
+                breaker = std::make_unique<CircuitBreaker>(SettingsFor(name), name);
             }
+            return *breaker;
+        }
 
-            // Update average response time
-            const auto total = metrics_.averageResponseTime * (metrics_.totalCalls - 1);
-            metrics_.averageResponseTime = (total + responseTime) / metrics_.totalCalls;
+        std::vector<std::pair<std::string, CircuitBreaker::Metrics> > GetMetrics() const {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            std::vector<std::pair<std::string, CircuitBreaker::Metrics> > metrics;
+            metrics.reserve(breakers_.size());
+            for (const auto &[name, breaker]: breakers_) {
+                metrics.emplace_back(name, breaker->GetMetrics());
+            }
+            return metrics;
         }
 
     private:
-        State state_{State::CLOSED};
-        size_t failureCount_{0};
-        size_t successCount_{0};
-        std::chrono::steady_clock::time_point lastStateChange_;
-        bool initialized_{false};
-        CircuitBreakerSettings settings_;
-        Metrics metrics_;
-        std::chrono::steady_clock::time_point lastFailureTime_;
-        mutable std::mutex mutex_;
+        CircuitBreakerSettings SettingsFor(const std::string &name) const {
+            const auto it = overrides_.find(name);
+            return it != overrides_.end() ? it->second : defaults_;
+        }
+
+        mutable std::shared_mutex mutex_;
+        CircuitBreakerSettings defaults_;
+        std::unordered_map<std::string, CircuitBreakerSettings> overrides_;
+        std::unordered_map<std::string, std::unique_ptr<CircuitBreaker> > breakers_;
     };
+
+    inline CircuitBreaker &CircuitBreaker::GetInstance() {
+        return CircuitBreakerRegistry::GetInstance().Get(breakers::PRIMARY_DB);
+    }
 }
 
 #endif // NUANSA_UTILS_PATTERN_CIRCUIT_BREAKER_H
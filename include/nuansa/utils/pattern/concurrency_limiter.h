@@ -0,0 +1,192 @@
+#ifndef NUANSA_UTILS_PATTERN_CONCURRENCY_LIMITER_H
+#define NUANSA_UTILS_PATTERN_CONCURRENCY_LIMITER_H
+
+#include <atomic>
+#include <cmath>
+
+#include "nuansa/utils/pch.h"
+
+namespace nuansa::utils::pattern {
+    struct ConcurrencyLimiterSettings {
+        size_t initialLimit{20}; // Concurrent requests allowed before any latency was observed.
+        size_t minLimit{4}; // The limit never shrinks below this.
+        size_t maxLimit{200}; // Nor grows beyond this.
+        double latencyTolerance{2.0}; // Latency may rise this far above the baseline before the limit shrinks.
+        double backoffRatio{0.9}; // Multiplicative decrease when a request is dropped or times out.
+        double smoothing{0.2}; // How much of each new estimate is taken over.
+        size_t baselineSamples{100}; // Samples averaged into the baseline latency.
+    };
+
+    /**
+     * @brief Adaptive limit on in-flight requests to a slow dependency
+     *
+     * Gradient-style: the latency of each completed request is compared with
+     * a long-term baseline. While latency stays within latencyTolerance of the
+     * baseline the limit grows by about sqrt(limit); when it rises further the
+     * limit shrinks in proportion, and a dropped request cuts it by
+     * backoffRatio. Requests over the limit are refused at once so callers can
+     * answer "busy, retry after RetryAfter()" instead of queueing behind a
+     * dependency that is already saturated.
+     *
+     * Usage example:
+     * @code
+     * auto permit = ConcurrencyLimiter::GetInstance().TryAcquire();
+     * if (!permit) {
+     *     return RejectWithRetryAfter(ConcurrencyLimiter::GetInstance().RetryAfter());
+     * }
+     * RunQuery();
+     * permit->Success();
+     * @endcode
+     */
+    class ConcurrencyLimiter {
+    public:
+        class Permit {
+        public:
+            Permit(Permit &&other) noexcept
+                : limiter_(std::exchange(other.limiter_, nullptr)),
+                  started_(other.started_),
+                  inFlight_(other.inFlight_) {
+            }
+
+            Permit &operator=(Permit &&) = delete;
+
+            Permit(const Permit &) = delete;
+
+            Permit &operator=(const Permit &) = delete;
+
+            // Released without a sample, e.g. the request failed before reaching the dependency
+            ~Permit() {
+                if (limiter_) {
+                    limiter_->Release();
+                }
+            }
+
+            void Success() { Complete(false); }
+
+            // The dependency timed out or refused the request
+            void Dropped() { Complete(true); }
+
+        private:
+            friend class ConcurrencyLimiter;
+
+            Permit(ConcurrencyLimiter *limiter, const size_t inFlight)
+                : limiter_(limiter), started_(std::chrono::steady_clock::now()), inFlight_(inFlight) {
+            }
+
+            void Complete(const bool dropped) {
+                if (auto *limiter = std::exchange(limiter_, nullptr)) {
+                    limiter->Release();
+                    limiter->OnSample(std::chrono::steady_clock::now() - started_, inFlight_, dropped);
+                }
+            }
+
+            ConcurrencyLimiter *limiter_;
+            std::chrono::steady_clock::time_point started_;
+            size_t inFlight_;
+        };
+
+        // Guards the handlers that end up on the primary database
+        static ConcurrencyLimiter &GetInstance() {
+            static ConcurrencyLimiter instance(ConcurrencyLimiterSettings{}, "database");
+            return instance;
+        }
+
+        explicit ConcurrencyLimiter(const ConcurrencyLimiterSettings &settings = ConcurrencyLimiterSettings{},
+                                    std::string name = "default")
+            : name_(std::move(name)) {
+            ApplySettings(settings);
+        }
+
+        ConcurrencyLimiter(const ConcurrencyLimiter &) = delete;
+
+        ConcurrencyLimiter &operator=(const ConcurrencyLimiter &) = delete;
+
+        void ApplySettings(const ConcurrencyLimiterSettings &settings) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            settings_ = settings;
+            settings_.minLimit = std::max<size_t>(1, settings_.minLimit);
+            settings_.maxLimit = std::max(settings_.minLimit, settings_.maxLimit);
+            estimate_ = static_cast<double>(std::clamp(settings_.initialLimit, settings_.minLimit,
+                                                       settings_.maxLimit));
+            baselineMs_ = 0;
+            limit_.store(static_cast<size_t>(estimate_), std::memory_order_relaxed);
+        }
+
+        std::optional<Permit> TryAcquire() {
+            size_t inFlight = inFlight_.load(std::memory_order_relaxed);
+            do {
+                if (inFlight >= limit_.load(std::memory_order_relaxed)) {
+                    rejected_.fetch_add(1, std::memory_order_relaxed);
+                    return std::nullopt;
+                }
+            } while (!inFlight_.compare_exchange_weak(inFlight, inFlight + 1, std::memory_order_acq_rel));
+
+            return Permit(this, inFlight + 1);
+        }
+
+        /**
+         * @brief Feeds one completed request into the limit estimate
+         *
+         * Permits call this themselves; it is public for callers that time
+         * their work some other way.
+         */
+        void OnSample(const std::chrono::steady_clock::duration latency, const size_t inFlight, const bool dropped) {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (dropped) {
+                estimate_ *= settings_.backoffRatio;
+            } else {
+                const double sampleMs = std::max(
+                    0.001, std::chrono::duration<double, std::milli>(latency).count());
+                baselineMs_ = baselineMs_ == 0
+                                  ? sampleMs
+                                  : baselineMs_ + (sampleMs - baselineMs_) / static_cast<double>(
+                                        std::max<size_t>(1, settings_.baselineSamples));
+
+                // Without queueing pressure latency says nothing about the limit
+                if (static_cast<double>(inFlight) < estimate_ / 2) {
+                    return;
+                }
+
+                const double gradient = std::clamp(settings_.latencyTolerance * baselineMs_ / sampleMs, 0.5, 1.0);
+                const double target = estimate_ * gradient + std::sqrt(estimate_);
+                estimate_ += (target - estimate_) * settings_.smoothing;
+            }
+
+            estimate_ = std::clamp(estimate_, static_cast<double>(settings_.minLimit),
+                                   static_cast<double>(settings_.maxLimit));
+            limit_.store(static_cast<size_t>(estimate_), std::memory_order_relaxed);
+        }
+
+        // A hint for shed clients: roughly how long a request currently takes
+        std::chrono::milliseconds RetryAfter() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return std::clamp(std::chrono::milliseconds(static_cast<int64_t>(std::ceil(baselineMs_))),
+                              std::chrono::milliseconds(50), std::chrono::milliseconds(5000));
+        }
+
+        size_t Limit() const { return limit_.load(std::memory_order_relaxed); }
+
+        size_t InFlight() const { return inFlight_.load(std::memory_order_relaxed); }
+
+        size_t Rejected() const { return rejected_.load(std::memory_order_relaxed); }
+
+        const std::string &GetName() const { return name_; }
+
+    private:
+        void Release() {
+            inFlight_.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        std::string name_;
+        mutable std::mutex mutex_;
+        ConcurrencyLimiterSettings settings_;
+        double estimate_{0};
+        double baselineMs_{0};
+        std::atomic<size_t> limit_{0};
+        std::atomic<size_t> inFlight_{0};
+        std::atomic<size_t> rejected_{0};
+    };
+}
+
+#endif //NUANSA_UTILS_PATTERN_CONCURRENCY_LIMITER_H
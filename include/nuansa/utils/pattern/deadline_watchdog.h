@@ -0,0 +1,193 @@
+#ifndef NUANSA_UTILS_PATTERN_DEADLINE_WATCHDOG_H
+#define NUANSA_UTILS_PATTERN_DEADLINE_WATCHDOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+
+#include "nuansa/utils/pch.h"
+
+namespace nuansa::utils::pattern {
+    /**
+     * @brief One thread that fires cancellation callbacks when deadlines pass
+     *
+     * Blocking calls (a database query, a curl transfer) run on the caller's
+     * thread; the watchdog only holds their deadlines. When one expires its
+     * callback runs on the watchdog thread and is expected to make the call
+     * return early, e.g. by sending a cancel request to the database server.
+     *
+     * Arm() returns a registration that disarms on destruction. Disarming
+     * waits for a callback that is already running, so the callback may use
+     * resources the caller frees right after the call returns.
+     *
+     * Usage example:
+     * @code
+     * auto armed = DeadlineWatchdog::GetInstance().Arm(deadline, [&] { conn.cancel_query(); });
+     * txn.exec(query);
+     * if (armed.Expired()) {
+     *     // The query was cancelled because it ran past the deadline
+     * }
+     * @endcode
+     */
+    class DeadlineWatchdog {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        class Registration {
+        public:
+            Registration() = default;
+
+            Registration(Registration &&other) noexcept
+                : watchdog_(std::exchange(other.watchdog_, nullptr)),
+                  id_(other.id_),
+                  fired_(std::move(other.fired_)) {
+            }
+
+            Registration &operator=(Registration &&other) noexcept {
+                if (this != &other) {
+                    Disarm();
+                    watchdog_ = std::exchange(other.watchdog_, nullptr);
+                    id_ = other.id_;
+                    fired_ = std::move(other.fired_);
+                }
+                return *this;
+            }
+
+            Registration(const Registration &) = delete;
+
+            Registration &operator=(const Registration &) = delete;
+
+            ~Registration() { Disarm(); }
+
+            // True once the callback has started; stays true after disarming
+            bool Expired() const { return fired_ && fired_->load(std::memory_order_acquire); }
+
+            void Disarm() {
+                if (watchdog_) {
+                    std::exchange(watchdog_, nullptr)->Disarm(id_);
+                }
+            }
+
+        private:
+            friend class DeadlineWatchdog;
+
+            Registration(DeadlineWatchdog *watchdog, const uint64_t id, std::shared_ptr<std::atomic<bool> > fired)
+                : watchdog_(watchdog), id_(id), fired_(std::move(fired)) {
+            }
+
+            DeadlineWatchdog *watchdog_{nullptr};
+            uint64_t id_{0};
+            std::shared_ptr<std::atomic<bool> > fired_;
+        };
+
+        // Process-wide watchdog shared by the database and HTTP layers
+        static DeadlineWatchdog &GetInstance() {
+            static DeadlineWatchdog instance;
+            return instance;
+        }
+
+        DeadlineWatchdog() {
+            thread_ = std::thread([this] { Run(); });
+        }
+
+        ~DeadlineWatchdog() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            condition_.notify_all();
+            thread_.join();
+        }
+
+        DeadlineWatchdog(const DeadlineWatchdog &) = delete;
+
+        DeadlineWatchdog &operator=(const DeadlineWatchdog &) = delete;
+
+        [[nodiscard]] Registration Arm(const Clock::time_point deadline, std::function<void()> onExpire) {
+            auto fired = std::make_shared<std::atomic<bool> >(false);
+            uint64_t id;
+            bool earliest;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                id = ++nextId_;
+                const auto it = pending_.emplace(deadline, Entry{id, std::move(onExpire), fired});
+                index_.emplace(id, it);
+                earliest = it == pending_.begin();
+            }
+            if (earliest) {
+                condition_.notify_all();
+            }
+            return Registration(this, id, std::move(fired));
+        }
+
+        size_t Pending() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return pending_.size();
+        }
+
+    private:
+        struct Entry {
+            uint64_t id;
+            std::function<void()> onExpire;
+            std::shared_ptr<std::atomic<bool> > fired;
+        };
+
+        using Queue = std::multimap<Clock::time_point, Entry>;
+
+        void Disarm(const uint64_t id) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (const auto it = index_.find(id); it != index_.end()) {
+                pending_.erase(it->second);
+                index_.erase(it);
+                return;
+            }
+            // Already fired; make sure the callback is done before the caller moves on
+            callbackDone_.wait(lock, [&] { return running_ != id; });
+        }
+
+        void Run() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stopping_) {
+                if (pending_.empty()) {
+                    condition_.wait(lock);
+                    continue;
+                }
+
+                const auto next = pending_.begin();
+                if (Clock::now() < next->first) {
+                    condition_.wait_until(lock, next->first);
+                    continue;
+                }
+
+                auto entry = std::move(next->second);
+                index_.erase(entry.id);
+                pending_.erase(next);
+                running_ = entry.id;
+                entry.fired->store(true, std::memory_order_release);
+
+                lock.unlock();
+                try {
+                    entry.onExpire();
+                } catch (const std::exception &e) {
+                    LOG_WARNING << "Deadline callback failed: " << e.what();
+                }
+                lock.lock();
+
+                running_ = 0;
+                callbackDone_.notify_all();
+            }
+        }
+
+        mutable std::mutex mutex_;
+        std::condition_variable condition_;
+        std::condition_variable callbackDone_;
+        Queue pending_;
+        std::unordered_map<uint64_t, Queue::iterator> index_;
+        uint64_t nextId_{0};
+        uint64_t running_{0};
+        bool stopping_{false};
+        std::thread thread_;
+    };
+}
+
+#endif //NUANSA_UTILS_PATTERN_DEADLINE_WATCHDOG_H
@@ -0,0 +1,85 @@
+#ifndef NUANSA_UTILS_PATTERN_SINGLE_FLIGHT_H
+#define NUANSA_UTILS_PATTERN_SINGLE_FLIGHT_H
+
+#include "nuansa/utils/pch.h"
+
+namespace nuansa::utils::pattern {
+    /**
+     * @brief Coalesces concurrent calls for the same key into one execution
+     *
+     * The first caller for a key runs the function; callers arriving while it
+     * is still in flight wait for and share its result (or exception) instead
+     * of starting their own. Once the call finishes the key is forgotten, so
+     * the next caller runs the function again - pair it with a cache to keep
+     * results around.
+     *
+     * Usage example:
+     * @code
+     * SingleFlight<std::string, std::optional<UserInfo> > flights;
+     * auto info = flights.Do(tokenHash, [&] { return FetchFromProvider(token); });
+     * @endcode
+     */
+    template<typename Key, typename Value, typename Hash = std::hash<Key> >
+    class SingleFlight {
+    public:
+        SingleFlight() = default;
+
+        SingleFlight(const SingleFlight &) = delete;
+
+        SingleFlight &operator=(const SingleFlight &) = delete;
+
+        template<typename Function>
+        Value Do(const Key &key, Function &&function) {
+            std::promise<Value> promise;
+            std::shared_future<Value> inFlight;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (const auto it = calls_.find(key); it != calls_.end()) {
+                    inFlight = it->second;
+                    ++sharedCount_;
+                } else {
+                    calls_.emplace(key, promise.get_future().share());
+                }
+            }
+
+            // Wait outside the lock so other keys are not held up
+            if (inFlight.valid()) {
+                return inFlight.get();
+            }
+
+            try {
+                Value value = std::forward<Function>(function)();
+                promise.set_value(value);
+                Forget(key);
+                return value;
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+                Forget(key);
+                throw;
+            }
+        }
+
+        // Number of calls answered by another caller's in-flight execution
+        size_t SharedCount() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return sharedCount_;
+        }
+
+        size_t InFlight() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return calls_.size();
+        }
+
+    private:
+        void Forget(const Key &key) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            calls_.erase(key);
+        }
+
+        mutable std::mutex mutex_;
+        std::unordered_map<Key, std::shared_future<Value>, Hash> calls_;
+        size_t sharedCount_{0};
+    };
+} // namespace nuansa::utils::pattern
+
+#endif // NUANSA_UTILS_PATTERN_SINGLE_FLIGHT_H
@@ -0,0 +1,61 @@
+#ifndef NUANSA_UTILS_PATTERN_STRIPED_LOCK_H
+#define NUANSA_UTILS_PATTERN_STRIPED_LOCK_H
+
+#include "nuansa/utils/pch.h"
+
+namespace nuansa::utils::pattern {
+    /**
+     * @brief Fixed set of mutexes selected by key hash
+     *
+     * Serializes work on the same key (e.g. a username) without a single
+     * process-wide lock: unrelated keys almost always map to different
+     * stripes and proceed in parallel. Several keys can be locked at once;
+     * stripes are always taken in index order so callers can't deadlock.
+     *
+     * Usage example:
+     * @code
+     * StripedLock locks(64);
+     * {
+     *     auto guard = locks.Lock({username, email});
+     *     // check-then-insert for these identifiers
+     * }
+     * @endcode
+     */
+    class StripedLock {
+    public:
+        explicit StripedLock(const size_t stripeCount = 64)
+            : stripes_(std::max<size_t>(1, stripeCount)) {
+        }
+
+        StripedLock(const StripedLock &) = delete;
+
+        StripedLock &operator=(const StripedLock &) = delete;
+
+        [[nodiscard]] std::vector<std::unique_lock<std::mutex> > Lock(
+            const std::initializer_list<std::string_view> keys) {
+            std::vector<size_t> indexes;
+            indexes.reserve(keys.size());
+            for (const auto key: keys) {
+                indexes.push_back(std::hash<std::string_view>{}(key) % stripes_.size());
+            }
+
+            // Sorted and de-duplicated so two keys on the same stripe don't self-deadlock
+            std::ranges::sort(indexes);
+            indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+
+            std::vector<std::unique_lock<std::mutex> > guards;
+            guards.reserve(indexes.size());
+            for (const auto index: indexes) {
+                guards.emplace_back(stripes_[index]);
+            }
+            return guards;
+        }
+
+        size_t StripeCount() const { return stripes_.size(); }
+
+    private:
+        std::vector<std::mutex> stripes_;
+    };
+} // namespace nuansa::utils::pattern
+
+#endif // NUANSA_UTILS_PATTERN_STRIPED_LOCK_H
@@ -0,0 +1,157 @@
+#ifndef NUANSA_UTILS_PATTERN_TOKEN_BUCKET_H
+#define NUANSA_UTILS_PATTERN_TOKEN_BUCKET_H
+
+#include <functional>
+
+#include "nuansa/utils/pch.h"
+
+namespace nuansa::utils::pattern {
+    struct TokenBucketSettings {
+        double ratePerSecond{10.0}; // Sustained rate; tokens added per second.
+        double burst{20.0}; // Bucket capacity, i.e. how much may be spent at once after a quiet period.
+    };
+
+    /**
+     * @brief Token bucket with lazy refill
+     *
+     * Nothing runs in the background: tokens owed since the last call are
+     * added when the bucket is next consulted. Not synchronized; a bucket
+     * belongs to one session, or is guarded by its TokenBucketTable shard.
+     *
+     * Usage example:
+     * @code
+     * TokenBucket bucket(TokenBucketSettings{.ratePerSecond = 20, .burst = 40});
+     * if (!bucket.TryConsume()) {
+     *     // Over the limit, drop the frame
+     * }
+     * @endcode
+     */
+    class TokenBucket {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit TokenBucket(const TokenBucketSettings &settings = TokenBucketSettings{},
+                             const Clock::time_point now = Clock::now())
+            : settings_(settings), tokens_(settings.burst), updated_(now) {
+        }
+
+        bool TryConsume(const double cost = 1.0, const Clock::time_point now = Clock::now()) {
+            Refill(now);
+            if (tokens_ < cost) {
+                return false;
+            }
+            tokens_ -= cost;
+            return true;
+        }
+
+        double Available(const Clock::time_point now = Clock::now()) const {
+            if (now <= updated_) {
+                return tokens_;
+            }
+            const double elapsed = std::chrono::duration<double>(now - updated_).count();
+            return std::min(settings_.burst, tokens_ + elapsed * settings_.ratePerSecond);
+        }
+
+        // A full bucket behaves exactly like a freshly created one and can be dropped
+        bool IsFull(const Clock::time_point now = Clock::now()) const {
+            return Available(now) >= settings_.burst;
+        }
+
+        const TokenBucketSettings &GetSettings() const { return settings_; }
+
+    private:
+        void Refill(const Clock::time_point now) {
+            if (now > updated_) {
+                tokens_ = Available(now);
+                updated_ = now;
+            }
+        }
+
+        TokenBucketSettings settings_;
+        double tokens_;
+        Clock::time_point updated_;
+    };
+
+    struct TokenBucketTableSettings {
+        TokenBucketSettings bucket; // Applied to every key.
+        size_t shardCount{16}; // Independent locks; keys hash to a shard.
+        std::chrono::seconds compactionInterval{std::chrono::seconds(60)}; // How often a shard drops full buckets.
+    };
+
+    /**
+     * @brief Token buckets keyed by string (client IP, username), sharded by key hash
+     *
+     * Each shard has its own mutex, so lookups for different keys rarely
+     * contend. Buckets are created on first use; a shard periodically drops
+     * buckets that have refilled completely, since they carry no state, which
+     * keeps memory bounded by the keys active within the last burst / rate.
+     */
+    class TokenBucketTable {
+    public:
+        using Clock = TokenBucket::Clock;
+
+        explicit TokenBucketTable(const TokenBucketTableSettings &settings = TokenBucketTableSettings{})
+            : settings_(settings),
+              shards_(std::max<size_t>(1, settings.shardCount)) {
+        }
+
+        TokenBucketTable(const TokenBucketTable &) = delete;
+
+        TokenBucketTable &operator=(const TokenBucketTable &) = delete;
+
+        bool TryConsume(const std::string &key, const double cost = 1.0, const Clock::time_point now = Clock::now()) {
+            auto &shard = ShardFor(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            if (now - shard.compacted >= settings_.compactionInterval) {
+                Compact(shard, now);
+            }
+
+            auto it = shard.buckets.find(key);
+            if (it == shard.buckets.end()) {
+                it = shard.buckets.emplace(key, TokenBucket(settings_.bucket, now)).first;
+            }
+            return it->second.TryConsume(cost, now);
+        }
+
+        // Drops full buckets in every shard; normally left to the periodic pass
+        void Compact(const Clock::time_point now = Clock::now()) {
+            for (auto &shard: shards_) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                Compact(shard, now);
+            }
+        }
+
+        size_t Size() const {
+            size_t size = 0;
+            for (auto &shard: shards_) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                size += shard.buckets.size();
+            }
+            return size;
+        }
+
+        const TokenBucketTableSettings &GetSettings() const { return settings_; }
+
+    private:
+        struct Shard {
+            mutable std::mutex mutex;
+            std::unordered_map<std::string, TokenBucket> buckets;
+            Clock::time_point compacted{Clock::now()};
+        };
+
+        Shard &ShardFor(const std::string &key) {
+            return shards_[std::hash<std::string>{}(key) % shards_.size()];
+        }
+
+        static void Compact(Shard &shard, const Clock::time_point now) {
+            std::erase_if(shard.buckets, [now](const auto &entry) { return entry.second.IsFull(now); });
+            shard.compacted = now;
+        }
+
+        TokenBucketTableSettings settings_;
+        std::vector<Shard> shards_;
+    };
+}
+
+#endif //NUANSA_UTILS_PATTERN_TOKEN_BUCKET_H
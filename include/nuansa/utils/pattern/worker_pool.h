@@ -0,0 +1,87 @@
+#ifndef NUANSA_UTILS_PATTERN_WORKER_POOL_H
+#define NUANSA_UTILS_PATTERN_WORKER_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+
+#include "nuansa/utils/pch.h"
+#include "nuansa/utils/exception/worker_pool_exception.h"
+
+namespace nuansa::utils::pattern {
+    struct WorkerPoolSettings {
+        std::string name{"worker"}; // Used in log messages.
+        size_t threadCount{2}; // Fixed number of worker threads.
+        size_t queueCapacity{256}; // Pending tasks beyond this are rejected.
+    };
+
+    /**
+     * @brief Fixed-size thread pool with a bounded queue and admission control
+     *
+     * Intended for CPU-heavy work that must not run on I/O or session threads.
+     * The number of threads never grows; when the queue is full new work is
+     * rejected immediately instead of piling up, so callers can shed load
+     * early (e.g. answer "server busy").
+     *
+     * Usage example:
+     * @code
+     * WorkerPool pool(WorkerPoolSettings{.name = "kdf", .threadCount = 4});
+     * try {
+     *     auto hash = pool.Submit([&] { return Derive(password); }).get();
+     * } catch (const WorkerPoolRejectedException& e) {
+     *     // Queue full, ask the client to retry later
+     * }
+     * @endcode
+     */
+    class WorkerPool {
+    public:
+        explicit WorkerPool(const WorkerPoolSettings &settings);
+
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool &) = delete;
+
+        WorkerPool &operator=(const WorkerPool &) = delete;
+
+        // Queues a task; returns false if the queue is full or the pool is stopping
+        bool TryPost(std::function<void()> task);
+
+        // Queues a task and returns its future; throws WorkerPoolRejectedException if it can't be admitted
+        template<typename F>
+        auto Submit(F &&func) -> std::future<std::invoke_result_t<std::decay_t<F> > > {
+            using Result = std::invoke_result_t<std::decay_t<F> >;
+
+            // std::function needs a copyable target, so the task is shared
+            auto task = std::make_shared<std::packaged_task<Result()> >(std::forward<F>(func));
+            auto future = task->get_future();
+
+            if (!TryPost([task] { (*task)(); })) {
+                throw exception::WorkerPoolRejectedException(settings_.name + " queue is full");
+            }
+
+            return future;
+        }
+
+        // Stops admitting work, runs everything already queued and joins the threads
+        void Shutdown();
+
+        size_t QueueDepth() const;
+
+        size_t RejectedCount() const { return rejected_.load(std::memory_order_relaxed); }
+
+        const WorkerPoolSettings &GetSettings() const { return settings_; }
+
+    private:
+        void WorkerLoop();
+
+        WorkerPoolSettings settings_;
+        mutable std::mutex mutex_;
+        std::condition_variable condition_;
+        std::deque<std::function<void()> > queue_;
+        std::vector<std::thread> workers_;
+        bool stopping_{false};
+        std::atomic<size_t> rejected_{0};
+    };
+} // namespace nuansa::utils::pattern
+
+#endif // NUANSA_UTILS_PATTERN_WORKER_POOL_H
@@ -0,0 +1,33 @@
+#ifndef NUANSA_UTILS_TEXT_SCANNER_H
+#define NUANSA_UTILS_TEXT_SCANNER_H
+
+#include "nuansa/utils/pch.h"
+
+namespace nuansa::utils {
+    /**
+     * @brief Single-pass scanners for chat text, without std::regex
+     *
+     * Results are views into the scanned text and are only valid while
+     * that text is alive and unchanged.
+     *
+     * Usage example:
+     * @code
+     * const std::string content = "ping @alice and @bob_2!";
+     * for (const auto mention: TextScanner::FindMentions(content)) {
+     *     // "alice", then "bob_2"
+     * }
+     * @endcode
+     */
+    class TextScanner {
+    public:
+        // ASCII letters, digits and '_', like \w in the default locale
+        static constexpr bool IsWordChar(const char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        }
+
+        // Names following '@', same matches as the regex @(\w+); a bare '@' is skipped
+        static std::vector<std::string_view> FindMentions(std::string_view content);
+    };
+}
+
+#endif // NUANSA_UTILS_TEXT_SCANNER_H
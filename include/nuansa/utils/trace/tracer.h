@@ -0,0 +1,200 @@
+#ifndef NUANSA_UTILS_TRACE_TRACER_H
+#define NUANSA_UTILS_TRACE_TRACER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace nuansa::utils {
+    class HttpClient;
+}
+
+namespace nuansa::utils::trace {
+    // One finished span. Fixed size so it can sit in the lock-free buffer without allocating.
+    struct SpanData {
+        static constexpr size_t MAX_CORRELATION_ID = 64;
+
+        std::array<uint8_t, 16> traceId{};
+        uint64_t spanId{0};
+        uint64_t parentSpanId{0}; // 0 for the root
+        const char *name{""}; // Span names are string literals
+        int64_t startUnixNanos{0};
+        int64_t endUnixNanos{0};
+        bool root{false};
+        bool error{false};
+        uint8_t correlationIdLength{0};
+        char correlationId[MAX_CORRELATION_ID]{};
+
+        std::string_view CorrelationId() const { return {correlationId, correlationIdLength}; }
+    };
+
+    /**
+     * @brief Bounded multi-producer multi-consumer queue of finished spans
+     *
+     * Each slot carries a sequence number that tells producers and consumers
+     * whose turn it is, so pushing and popping are a compare-and-swap on the
+     * head or tail plus a copy. A full buffer refuses the span instead of
+     * waiting; tracing must never slow down the request it observes.
+     */
+    class SpanBuffer {
+    public:
+        // Rounded up to a power of two
+        explicit SpanBuffer(size_t capacity);
+
+        bool TryPush(const SpanData &span);
+
+        bool TryPop(SpanData &span);
+
+        size_t Capacity() const { return mask_ + 1; }
+
+    private:
+        struct Slot {
+            std::atomic<size_t> sequence{0};
+            SpanData span;
+        };
+
+        std::unique_ptr<Slot[]> slots_;
+        size_t mask_;
+        alignas(64) std::atomic<size_t> head_{0};
+        alignas(64) std::atomic<size_t> tail_{0};
+    };
+
+    // Span in the trace running on this thread; does nothing when there is none or it isn't sampled
+    class Span {
+    public:
+        explicit Span(const char *name);
+
+        ~Span();
+
+        Span(const Span &) = delete;
+
+        Span &operator=(const Span &) = delete;
+
+        void SetError() { data_.error = true; }
+
+        bool IsRecording() const { return recording_; }
+
+    private:
+        friend class TraceScope;
+
+        SpanData data_;
+        bool recording_{false};
+    };
+
+    /**
+     * @brief Starts a trace on the calling thread and is its root span
+     *
+     * The sampling decision is taken here, once per trace. Spans created on
+     * this thread while the scope is alive become its descendants; when it
+     * ends, every span of the trace has been handed to the Tracer. Opening a
+     * TraceScope inside another one just adds a child span.
+     *
+     * Usage example:
+     * @code
+     * TraceScope trace("websocket.frame");
+     * {
+     *     Span parse("parse");
+     *     json = nlohmann::json::parse(frame);
+     * }
+     * trace.SetCorrelationId(json["head"]["corr_id"].get<std::string>());
+     * @endcode
+     */
+    class TraceScope {
+    public:
+        explicit TraceScope(const char *name);
+
+        ~TraceScope();
+
+        TraceScope(const TraceScope &) = delete;
+
+        TraceScope &operator=(const TraceScope &) = delete;
+
+        // Stamped on every span of the trace that ends after this call; longer ids are cut
+        void SetCorrelationId(std::string_view correlationId);
+
+        void SetError() { span_->SetError(); }
+
+        bool IsSampled() const { return span_->IsRecording(); }
+
+    private:
+        bool owner_{false};
+        std::optional<Span> span_;
+    };
+
+    struct TracerSettings {
+        double sampleRate{0.0}; // Share of traces recorded, 0 to 1.
+        size_t bufferCapacity{8192}; // Finished spans waiting for export; more are dropped.
+        std::chrono::milliseconds exportInterval{std::chrono::seconds(1)};
+        std::string filePath; // OTLP/JSON, one export request per line. Empty disables.
+        std::string collectorUrl; // OTLP/HTTP JSON endpoint, e.g. http://localhost:4318/v1/traces. Empty disables.
+        std::string serviceName{"nuansa"};
+    };
+
+    /**
+     * @brief Collects sampled spans and exports them as OTLP-compatible JSON
+     *
+     * Spans are pushed into a SpanBuffer by the threads that end them and a
+     * background thread drains it every exportInterval, writing one
+     * ExportTraceServiceRequest per batch to a file and/or POSTing it to a
+     * collector. Until Configure is called nothing is sampled, so Span and
+     * TraceScope cost a thread-local read.
+     */
+    class Tracer {
+    public:
+        static Tracer &GetInstance();
+
+        ~Tracer();
+
+        Tracer(const Tracer &) = delete;
+
+        Tracer &operator=(const Tracer &) = delete;
+
+        // Starts the export thread. The span buffer is built by the first call and kept, since session threads
+        // push into it without a lock; later calls keep its capacity
+        void Configure(const TracerSettings &settings);
+
+        // Exports what is buffered and stops the export thread
+        void Shutdown();
+
+        // Runs one export cycle on the calling thread; returns the number of spans written, 0 when the batch
+        // was not accepted by the file or the collector
+        size_t ExportNow();
+
+        bool ShouldSample();
+
+        void Submit(const SpanData &span);
+
+        // OTLP/JSON ExportTraceServiceRequest for a batch of spans
+        static std::string ToOtlpJson(const std::vector<SpanData> &spans, std::string_view serviceName);
+
+        uint64_t GetDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+    private:
+        Tracer();
+
+        void Run();
+
+        TracerSettings settings_;
+        std::atomic<uint64_t> sampleThreshold_{0}; // Compared against a random 64-bit value
+        std::unique_ptr<SpanBuffer> ownedBuffer_;
+        std::atomic<SpanBuffer *> buffer_{nullptr}; // Set once, read by Submit without a lock
+        std::unique_ptr<HttpClient> httpClient_;
+        std::atomic<uint64_t> dropped_{0};
+
+        std::mutex exportMutex_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        bool stopping_{false};
+        std::thread thread_;
+    };
+}
+
+#endif //NUANSA_UTILS_TRACE_TRACER_H
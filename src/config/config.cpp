@@ -32,7 +32,17 @@ namespace nuansa::config {
 
             LoadServerConfig(config_);
             LoadDatabaseConfig(config_);
-
+            LoadSecurityConfig(config_);
+            LoadCircuitBreakerConfig(config_);
+            LoadLoadSheddingConfig(config_);
+            LoadRateLimitConfig(config_);
+            LoadLoggingConfig(config_);
+            LoadMetricsConfig(config_);
+            LoadTracingConfig(config_);
+            LoadMentionsConfig(config_);
+            LoadPresenceConfig(config_);
+            LoadTypingConfig(config_);
+            LoadShutdownConfig(config_);
 
             LOG_INFO << "Database configuration loaded successfully";
         } catch (const std::exception &e) {
@@ -90,6 +100,20 @@ namespace nuansa::config {
                 cfg.logPath = "logs/lentera.log"; // default value
             }
 
+            // Load and validate the IO thread layout
+            if (serverConfig["io_mode"]) {
+                cfg.ioMode = serverConfig["io_mode"].as<std::string>();
+                if (cfg.ioMode != "shared" && cfg.ioMode != "per_core") {
+                    throw std::runtime_error("Invalid io_mode. Must be one of: shared, per_core");
+                }
+            }
+            if (serverConfig["io_threads"]) {
+                cfg.ioThreads = serverConfig["io_threads"].as<size_t>();
+            }
+            if (serverConfig["pin_io_threads"]) {
+                cfg.pinIoThreads = serverConfig["pin_io_threads"].as<bool>();
+            }
+
             if (serverConfig["github"]) {
                 const auto& githubConfig = serverConfig["github"];
 
@@ -193,6 +217,14 @@ namespace nuansa::config {
                         throw std::runtime_error("Google user info url cannot be empty");
                     }
                 }
+
+                if (googleConfig["jwks_url"]) {
+                    const auto jwksUrl = googleConfig["jwks_url"].as<std::string>();
+                    cfg.googleJwksUrl = ResolveEnvironmentVariable(jwksUrl);
+                    if (cfg.googleJwksUrl.empty()) {
+                        throw std::runtime_error("Google JWKS url cannot be empty");
+                    }
+                }
             }
 
             if (serverConfig["jwt"]) {
@@ -222,6 +254,20 @@ namespace nuansa::config {
 
             DatabaseConfig cfg;
 
+            // Load and validate storage backend
+            if (dbConfig["backend"]) {
+                cfg.backend = dbConfig["backend"].as<std::string>();
+                if (cfg.backend != "postgres" && cfg.backend != "memory") {
+                    throw std::runtime_error("Database backend must be postgres or memory");
+                }
+            }
+
+            // The in-memory backend never connects, so the connection settings may be unset
+            if (cfg.backend == "memory") {
+                databaseConfig_ = cfg;
+                return;
+            }
+
             // Load and validate host
             if (dbConfig["host"]) {
                 const auto host = dbConfig["host"].as<std::string>();
@@ -272,6 +318,11 @@ namespace nuansa::config {
                 }
             }
 
+            // Load and validate statement timeout
+            if (dbConfig["statement_timeout_ms"]) {
+                cfg.statement_timeout_ms = dbConfig["statement_timeout_ms"].as<uint64_t>();
+            }
+
             // Store the validated config
             databaseConfig_ = cfg;
 
@@ -282,6 +333,529 @@ namespace nuansa::config {
         }
     }
 
+    void Config::LoadSecurityConfig(const YAML::Node &config) {
+        try {
+            // Optional section, defaults apply when it's missing
+            const YAML::Node &securityConfig = config["security"];
+            if (!securityConfig) {
+                return;
+            }
+
+            SecurityConfig cfg;
+
+            // Load and validate KDF worker count
+            if (securityConfig["kdf_workers"]) {
+                cfg.kdfWorkers = securityConfig["kdf_workers"].as<size_t>();
+            }
+
+            // Load and validate KDF queue size
+            if (securityConfig["kdf_queue_size"]) {
+                cfg.kdfQueueSize = securityConfig["kdf_queue_size"].as<size_t>();
+                if (cfg.kdfQueueSize < 1) {
+                    throw std::runtime_error("KDF queue size must be at least 1");
+                }
+            }
+
+            // Load and validate KDF calibration target
+            if (securityConfig["kdf_target_ms"]) {
+                cfg.kdfTargetMs = securityConfig["kdf_target_ms"].as<uint32_t>();
+                if (cfg.kdfTargetMs < 1) {
+                    throw std::runtime_error("KDF target latency must be at least 1ms");
+                }
+            }
+
+            // Load and validate KDF cost bounds
+            if (securityConfig["kdf_min_log_n"]) {
+                cfg.kdfMinLogN = securityConfig["kdf_min_log_n"].as<uint32_t>();
+            }
+
+            if (securityConfig["kdf_max_log_n"]) {
+                cfg.kdfMaxLogN = securityConfig["kdf_max_log_n"].as<uint32_t>();
+            }
+
+            if (cfg.kdfMinLogN < 10 || cfg.kdfMaxLogN > 24 || cfg.kdfMinLogN > cfg.kdfMaxLogN) {
+                throw std::runtime_error("KDF cost bounds must satisfy 10 <= kdf_min_log_n <= kdf_max_log_n <= 24");
+            }
+
+            // Load and validate OAuth token cache
+            if (securityConfig["oauth_cache_size"]) {
+                cfg.oauthCacheSize = securityConfig["oauth_cache_size"].as<size_t>();
+                if (cfg.oauthCacheSize < 1) {
+                    throw std::runtime_error("OAuth cache size must be at least 1");
+                }
+            }
+
+            if (securityConfig["oauth_cache_max_ttl_seconds"]) {
+                cfg.oauthCacheMaxTtlSeconds = securityConfig["oauth_cache_max_ttl_seconds"].as<uint32_t>();
+            }
+
+            // Store the validated config
+            securityConfig_ = cfg;
+        } catch (const YAML::Exception &e) {
+            throw std::runtime_error("Error parsing security configuration: " + std::string(e.what()));
+        }
+    }
+
+    void Config::LoadCircuitBreakerConfig(const YAML::Node &config) {
+        try {
+            // Optional section, defaults apply when it's missing
+            const YAML::Node &circuitBreakerConfig = config["circuit_breaker"];
+            if (!circuitBreakerConfig) {
+                return;
+            }
+
+            CircuitBreakerConfig cfg;
+
+            // Top-level keys are the defaults every dependency starts from
+            cfg.defaults = LoadCircuitBreakerPolicy(circuitBreakerConfig, CircuitBreakerPolicy{});
+
+            // Load and validate per-dependency overrides
+            if (const auto &dependencies = circuitBreakerConfig["dependencies"]) {
+                for (const auto &dependency: dependencies) {
+                    const auto name = dependency.first.as<std::string>();
+                    cfg.dependencies[name] = LoadCircuitBreakerPolicy(dependency.second, cfg.defaults);
+                }
+            }
+
+            // Store the validated config
+            circuitBreakerConfig_ = cfg;
+        } catch (const YAML::Exception &e) {
+            throw std::runtime_error("Error parsing circuit breaker configuration: " + std::string(e.what()));
+        }
+    }
+
+    CircuitBreakerPolicy Config::LoadCircuitBreakerPolicy(const YAML::Node &node, CircuitBreakerPolicy policy) {
+        // Load and validate thresholds
+        if (node["failure_threshold"]) {
+            policy.failureThreshold = node["failure_threshold"].as<size_t>();
+            if (policy.failureThreshold < 1) {
+                throw std::runtime_error("Circuit breaker failure threshold must be at least 1");
+            }
+        }
+
+        if (node["success_threshold"]) {
+            policy.successThreshold = node["success_threshold"].as<size_t>();
+            if (policy.successThreshold < 1) {
+                throw std::runtime_error("Circuit breaker success threshold must be at least 1");
+            }
+        }
+
+        if (node["failure_rate_threshold"]) {
+            policy.failureRateThreshold = node["failure_rate_threshold"].as<double>();
+            if (policy.failureRateThreshold <= 0.0 || policy.failureRateThreshold > 1.0) {
+                throw std::runtime_error("Circuit breaker failure rate threshold must be in (0, 1]");
+            }
+        }
+
+        // Load and validate timings
+        if (node["reset_timeout_seconds"]) {
+            policy.resetTimeoutSeconds = node["reset_timeout_seconds"].as<uint64_t>();
+        }
+
+        if (node["timeout_seconds"]) {
+            policy.timeoutSeconds = node["timeout_seconds"].as<uint64_t>();
+        }
+
+        if (node["window_seconds"]) {
+            policy.windowSeconds = node["window_seconds"].as<uint64_t>();
+            if (policy.windowSeconds < 1) {
+                throw std::runtime_error("Circuit breaker window must be at least 1 second");
+            }
+        }
+
+        return policy;
+    }
+
+    void Config::LoadLoadSheddingConfig(const YAML::Node &config) {
+        try {
+            // Optional section, defaults apply when it's missing
+            const YAML::Node &loadSheddingConfig = config["load_shedding"];
+            if (!loadSheddingConfig) {
+                return;
+            }
+
+            LoadSheddingConfig cfg;
+
+            // Load and validate connection cap
+            if (loadSheddingConfig["max_connections"]) {
+                cfg.maxConnections = loadSheddingConfig["max_connections"].as<size_t>();
+                if (cfg.maxConnections < 1) {
+                    throw std::runtime_error("Load shedding max connections must be at least 1");
+                }
+            }
+
+            // Load and validate concurrency limits
+            if (loadSheddingConfig["initial_limit"]) {
+                cfg.initialLimit = loadSheddingConfig["initial_limit"].as<size_t>();
+            }
+
+            if (loadSheddingConfig["min_limit"]) {
+                cfg.minLimit = loadSheddingConfig["min_limit"].as<size_t>();
+                if (cfg.minLimit < 1) {
+                    throw std::runtime_error("Load shedding min limit must be at least 1");
+                }
+            }
+
+            if (loadSheddingConfig["max_limit"]) {
+                cfg.maxLimit = loadSheddingConfig["max_limit"].as<size_t>();
+            }
+
+            if (cfg.minLimit > cfg.maxLimit || cfg.initialLimit < cfg.minLimit || cfg.initialLimit > cfg.maxLimit) {
+                throw std::runtime_error("Load shedding limits must satisfy min_limit <= initial_limit <= max_limit");
+            }
+
+            // Load and validate adaptation parameters
+            if (loadSheddingConfig["latency_tolerance"]) {
+                cfg.latencyTolerance = loadSheddingConfig["latency_tolerance"].as<double>();
+                if (cfg.latencyTolerance < 1.0) {
+                    throw std::runtime_error("Load shedding latency tolerance must be at least 1.0");
+                }
+            }
+
+            if (loadSheddingConfig["backoff_ratio"]) {
+                cfg.backoffRatio = loadSheddingConfig["backoff_ratio"].as<double>();
+                if (cfg.backoffRatio <= 0.0 || cfg.backoffRatio >= 1.0) {
+                    throw std::runtime_error("Load shedding backoff ratio must be between 0 and 1");
+                }
+            }
+
+            // Store the validated config
+            loadSheddingConfig_ = cfg;
+        } catch (const YAML::Exception &e) {
+            throw std::runtime_error("Error parsing load shedding configuration: " + std::string(e.what()));
+        }
+    }
+
+    void Config::LoadRateLimitConfig(const YAML::Node &config) {
+        try {
+            // Optional section, defaults apply when it's missing
+            const YAML::Node &rateLimitConfig = config["rate_limit"];
+            if (!rateLimitConfig) {
+                return;
+            }
+
+            RateLimitConfig cfg;
+
+            // Every key is a positive rate or bucket size
+            const auto loadPositive = [&rateLimitConfig](const char *key, double &value) {
+                if (rateLimitConfig[key]) {
+                    value = rateLimitConfig[key].as<double>();
+                    if (value <= 0.0) {
+                        throw std::runtime_error(std::string("Rate limit ") + key + " must be positive");
+                    }
+                }
+            };
+
+            // Load and validate per-connection limits
+            loadPositive("messages_per_second", cfg.messagesPerSecond);
+            loadPositive("message_burst", cfg.messageBurst);
+            loadPositive("bytes_per_second", cfg.bytesPerSecond);
+            loadPositive("byte_burst", cfg.byteBurst);
+
+            // Load and validate authentication limits
+            loadPositive("auth_per_ip_per_minute", cfg.authPerIpPerMinute);
+            loadPositive("auth_ip_burst", cfg.authIpBurst);
+            loadPositive("auth_per_username_per_minute", cfg.authPerUsernamePerMinute);
+            loadPositive("auth_username_burst", cfg.authUsernameBurst);
+
+            // Store the validated config
+            rateLimitConfig_ = cfg;
+        } catch (const YAML::Exception &e) {
+            throw std::runtime_error("Error parsing rate limit configuration: " + std::string(e.what()));
+        }
+    }
+
+    void Config::LoadLoggingConfig(const YAML::Node &config) {
+        try {
+            // Optional section, defaults apply when it's missing
+            const YAML::Node &loggingConfig = config["logging"];
+            if (!loggingConfig) {
+                return;
+            }
+
+            LoggingConfig cfg;
+
+            if (loggingConfig["file_enabled"]) {
+                cfg.fileEnabled = loggingConfig["file_enabled"].as<bool>();
+            }
+
+            // Load and validate output format
+            if (loggingConfig["format"]) {
+                cfg.format = loggingConfig["format"].as<std::string>();
+                if (cfg.format != "text" && cfg.format != "json") {
+                    throw std::runtime_error("Invalid log format. Must be one of: text, json");
+                }
+            }
+
+            // Load and validate buffering
+            if (loggingConfig["buffer_bytes"]) {
+                cfg.bufferBytes = loggingConfig["buffer_bytes"].as<size_t>();
+                if (cfg.bufferBytes < 4096) {
+                    throw std::runtime_error("Log buffer_bytes must be at least 4096");
+                }
+            }
+
+            if (loggingConfig["fsync_interval_ms"]) {
+                cfg.fsyncIntervalMs = loggingConfig["fsync_interval_ms"].as<uint32_t>();
+            }
+
+            // Load rotation; 0 turns a trigger off
+            if (loggingConfig["max_file_bytes"]) {
+                cfg.maxFileBytes = loggingConfig["max_file_bytes"].as<uint64_t>();
+            }
+
+            if (loggingConfig["rotate_interval_seconds"]) {
+                cfg.rotateIntervalSeconds = loggingConfig["rotate_interval_seconds"].as<uint32_t>();
+            }
+
+            if (loggingConfig["max_rotated_files"]) {
+                cfg.maxRotatedFiles = loggingConfig["max_rotated_files"].as<size_t>();
+            }
+
+            if (loggingConfig["compress_rotated"]) {
+                cfg.compressRotated = loggingConfig["compress_rotated"].as<bool>();
+            }
+
+            // Store the validated config
+            loggingConfig_ = cfg;
+        } catch (const YAML::Exception &e) {
+            throw std::runtime_error("Error parsing logging configuration: " + std::string(e.what()));
+        }
+    }
+
+    void Config::LoadMetricsConfig(const YAML::Node &config) {
+        try {
+            // Optional section, defaults apply when it's missing
+            const YAML::Node &metricsConfig = config["metrics"];
+            if (!metricsConfig) {
+                return;
+            }
+
+            MetricsConfig cfg;
+
+            if (metricsConfig["enabled"]) {
+                cfg.enabled = metricsConfig["enabled"].as<bool>();
+            }
+
+            // Load and validate host
+            if (metricsConfig["host"]) {
+                cfg.host = metricsConfig["host"].as<std::string>();
+                if (cfg.host.empty()) {
+                    throw std::runtime_error("Metrics host cannot be empty");
+                }
+            }
+
+            // Load and validate port
+            if (metricsConfig["port"]) {
+                cfg.port = metricsConfig["port"].as<uint16_t>();
+                if (cfg.port < 1024) {
+                    throw std::runtime_error("Metrics port must be between 1024 and 65535");
+                }
+            }
+
+            // Store the validated config
+            metricsConfig_ = cfg;
+        } catch (const YAML::Exception &e) {
+            throw std::runtime_error("Error parsing metrics configuration: " + std::string(e.what()));
+        }
+    }
+
+    void Config::LoadTracingConfig(const YAML::Node &config) {
+        try {
+            // Optional section, defaults apply when it's missing
+            const YAML::Node &tracingConfig = config["tracing"];
+            if (!tracingConfig) {
+                return;
+            }
+
+            TracingConfig cfg;
+
+            if (tracingConfig["enabled"]) {
+                cfg.enabled = tracingConfig["enabled"].as<bool>();
+            }
+
+            // Load and validate sampling
+            if (tracingConfig["sample_rate"]) {
+                cfg.sampleRate = tracingConfig["sample_rate"].as<double>();
+                if (cfg.sampleRate < 0.0 || cfg.sampleRate > 1.0) {
+                    throw std::runtime_error("Tracing sample_rate must be between 0 and 1");
+                }
+            }
+
+            // Load and validate buffering
+            if (tracingConfig["buffer_size"]) {
+                cfg.bufferSize = tracingConfig["buffer_size"].as<size_t>();
+                if (cfg.bufferSize == 0) {
+                    throw std::runtime_error("Tracing buffer_size must be greater than 0");
+                }
+            }
+
+            if (tracingConfig["export_interval_ms"]) {
+                cfg.exportIntervalMs = tracingConfig["export_interval_ms"].as<uint32_t>();
+                if (cfg.exportIntervalMs == 0) {
+                    throw std::runtime_error("Tracing export_interval_ms must be greater than 0");
+                }
+            }
+
+            // Load and validate destinations
+            if (tracingConfig["file_path"]) {
+                cfg.filePath = tracingConfig["file_path"].as<std::string>();
+            }
+
+            if (tracingConfig["collector_url"]) {
+                cfg.collectorUrl = ResolveEnvironmentVariable(tracingConfig["collector_url"].as<std::string>());
+            }
+
+            if (cfg.enabled && cfg.filePath.empty() && cfg.collectorUrl.empty()) {
+                throw std::runtime_error("Tracing needs a file_path or a collector_url");
+            }
+
+            // Store the validated config
+            tracingConfig_ = cfg;
+        } catch (const YAML::Exception &e) {
+            throw std::runtime_error("Error parsing tracing configuration: " + std::string(e.what()));
+        }
+    }
+
+    void Config::LoadMentionsConfig(const YAML::Node &config) {
+        try {
+            // Optional section, defaults apply when it's missing
+            const YAML::Node &mentionsConfig = config["mentions"];
+            if (!mentionsConfig) {
+                return;
+            }
+
+            MentionsConfig cfg;
+
+            // Every setting is a count or interval that must be positive
+            const auto loadPositive = [&](const char *key, auto &value) {
+                if (!mentionsConfig[key]) {
+                    return;
+                }
+                value = mentionsConfig[key].as<std::remove_reference_t<decltype(value)> >();
+                if (value == 0) {
+                    throw std::runtime_error(std::string("Mentions ") + key + " must be greater than 0");
+                }
+            };
+
+            loadPositive("max_per_message", cfg.maxPerMessage);
+            loadPositive("excerpt_bytes", cfg.excerptBytes);
+            loadPositive("inbox_limit", cfg.inboxLimit);
+            loadPositive("batch_size", cfg.batchSize);
+            loadPositive("flush_interval_ms", cfg.flushIntervalMs);
+            loadPositive("delivery_threads", cfg.deliveryThreads);
+            loadPositive("delivery_queue_capacity", cfg.deliveryQueueCapacity);
+
+            // Store the validated config
+            mentionsConfig_ = cfg;
+        } catch (const YAML::Exception &e) {
+            throw std::runtime_error("Error parsing mentions configuration: " + std::string(e.what()));
+        }
+    }
+
+    void Config::LoadPresenceConfig(const YAML::Node &config) {
+        try {
+            // Optional section, defaults apply when it's missing
+            const YAML::Node &presenceConfig = config["presence"];
+            if (!presenceConfig) {
+                return;
+            }
+
+            PresenceConfig cfg;
+
+            if (presenceConfig["default_room"]) {
+                cfg.defaultRoom = presenceConfig["default_room"].as<std::string>();
+            }
+
+            // Every other setting is a count or interval that must be positive
+            const auto loadPositive = [&](const char *key, auto &value) {
+                if (!presenceConfig[key]) {
+                    return;
+                }
+                value = presenceConfig[key].as<std::remove_reference_t<decltype(value)> >();
+                if (value == 0) {
+                    throw std::runtime_error(std::string("Presence ") + key + " must be greater than 0");
+                }
+            };
+
+            loadPositive("window_ms", cfg.windowMs);
+            loadPositive("max_rooms_per_user", cfg.maxRoomsPerUser);
+            loadPositive("max_contacts", cfg.maxContacts);
+            loadPositive("delivery_threads", cfg.deliveryThreads);
+            loadPositive("delivery_queue_capacity", cfg.deliveryQueueCapacity);
+
+            // Store the validated config
+            presenceConfig_ = cfg;
+        } catch (const YAML::Exception &e) {
+            throw std::runtime_error("Error parsing presence configuration: " + std::string(e.what()));
+        }
+    }
+
+    void Config::LoadTypingConfig(const YAML::Node &config) {
+        try {
+            // Optional section, defaults apply when it's missing
+            const YAML::Node &typingConfig = config["typing"];
+            if (!typingConfig) {
+                return;
+            }
+
+            TypingConfig cfg;
+
+            const auto loadPositive = [&](const char *key, auto &value) {
+                if (!typingConfig[key]) {
+                    return;
+                }
+                value = typingConfig[key].as<std::remove_reference_t<decltype(value)> >();
+                if (value == 0) {
+                    throw std::runtime_error(std::string("Typing ") + key + " must be greater than 0");
+                }
+            };
+
+            loadPositive("window_ms", cfg.windowMs);
+            loadPositive("timeout_ms", cfg.timeoutMs);
+            loadPositive("max_room_peers", cfg.maxRoomPeers);
+            loadPositive("delivery_threads", cfg.deliveryThreads);
+            loadPositive("delivery_queue_capacity", cfg.deliveryQueueCapacity);
+
+            // Store the validated config
+            typingConfig_ = cfg;
+        } catch (const YAML::Exception &e) {
+            throw std::runtime_error("Error parsing typing configuration: " + std::string(e.what()));
+        }
+    }
+
+    void Config::LoadShutdownConfig(const YAML::Node &config) {
+        try {
+            // Optional section, defaults apply when it's missing
+            const YAML::Node &shutdownConfig = config["shutdown"];
+            if (!shutdownConfig) {
+                return;
+            }
+
+            ShutdownConfig cfg;
+
+            const auto loadPositive = [&](const char *key, auto &value) {
+                if (!shutdownConfig[key]) {
+                    return;
+                }
+                value = shutdownConfig[key].as<std::remove_reference_t<decltype(value)> >();
+                if (value == 0) {
+                    throw std::runtime_error(std::string("Shutdown ") + key + " must be greater than 0");
+                }
+            };
+
+            loadPositive("drain_window_ms", cfg.drainWindowMs);
+            loadPositive("close_grace_ms", cfg.closeGraceMs);
+            loadPositive("reconnect_jitter_ms", cfg.reconnectJitterMs);
+            loadPositive("database_timeout_ms", cfg.databaseTimeoutMs);
+
+            // Store the validated config
+            shutdownConfig_ = cfg;
+        } catch (const YAML::Exception &e) {
+            throw std::runtime_error("Error parsing shutdown configuration: " + std::string(e.what()));
+        }
+    }
+
     void Config::SetDatabaseConfig(const DatabaseConfig &config) {
         databaseConfig_ = config;
         BuildConnectionString();
@@ -291,6 +865,50 @@ namespace nuansa::config {
         serverConfig_ = config;
     }
 
+    void Config::SetSecurityConfig(const SecurityConfig &config) {
+        securityConfig_ = config;
+    }
+
+    void Config::SetCircuitBreakerConfig(const CircuitBreakerConfig &config) {
+        circuitBreakerConfig_ = config;
+    }
+
+    void Config::SetLoadSheddingConfig(const LoadSheddingConfig &config) {
+        loadSheddingConfig_ = config;
+    }
+
+    void Config::SetRateLimitConfig(const RateLimitConfig &config) {
+        rateLimitConfig_ = config;
+    }
+
+    void Config::SetLoggingConfig(const LoggingConfig &config) {
+        loggingConfig_ = config;
+    }
+
+    void Config::SetMetricsConfig(const MetricsConfig &config) {
+        metricsConfig_ = config;
+    }
+
+    void Config::SetTracingConfig(const TracingConfig &config) {
+        tracingConfig_ = config;
+    }
+
+    void Config::SetMentionsConfig(const MentionsConfig &config) {
+        mentionsConfig_ = config;
+    }
+
+    void Config::SetPresenceConfig(const PresenceConfig &config) {
+        presenceConfig_ = config;
+    }
+
+    void Config::SetTypingConfig(const TypingConfig &config) {
+        typingConfig_ = config;
+    }
+
+    void Config::SetShutdownConfig(const ShutdownConfig &config) {
+        shutdownConfig_ = config;
+    }
+
     std::string Config::ResolveEnvironmentVariable(const std::string &value) {
         if (value.empty() || value[0] != '$') {
             return value;
@@ -395,12 +1013,17 @@ namespace nuansa::config {
         // Add host, port, and database name
         ss << databaseConfig_.host << ":" << databaseConfig_.port << "/" << databaseConfig_.database_name;
 
+        // Let the server abort runaway statements even if the client-side cancel never arrives
+        if (databaseConfig_.statement_timeout_ms > 0) {
+            ss << "?options=-c%20statement_timeout%3D" << databaseConfig_.statement_timeout_ms;
+        }
+
         // Optionally add additional parameters
-        // ss << "?sslmode=verify-full";  // Example of adding SSL mode
+        // ss << "&sslmode=verify-full";  // Example of adding SSL mode
 
         databaseConfig_.connection_string = ss.str();
 
-        BOOST_LOG_TRIVIAL(debug) << "Built PostgreSQL connection string (credentials masked)";
+        LOG_DEBUG << "Built PostgreSQL connection string (credentials masked)";
     }
 
     void Config::Initialize(const std::string &configFile) {
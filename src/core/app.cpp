@@ -1,12 +1,27 @@
 #include "nuansa/utils/pch.h"
 
+#include <future>
+
 #include "nuansa/core/app.h"
+#include "nuansa/core/listener.h"
 #include "nuansa/handler/websocket_server.h"
 #include "nuansa/handler/websocket_handler.h"
+#include "nuansa/handler/mention_dispatcher.h"
+#include "nuansa/handler/presence_service.h"
+#include "nuansa/handler/session_drainer.h"
+#include "nuansa/handler/typing_service.h"
 #include "nuansa/utils/program_options.h"
 #include "nuansa/config/config.h"
 #include "nuansa/database/db_connection_pool.h"
+#include "nuansa/services/user/user_service.h"
+#include "nuansa/services/storage/storage_registry.h"
+#include "nuansa/utils/crypto/password_hasher.h"
+#include "nuansa/utils/pattern/circuit_breaker.h"
+#include "nuansa/utils/pattern/concurrency_limiter.h"
 #include "nuansa/utils/exception/database_exception.h"
+#include "nuansa/utils/log/rotating_file_sink.h"
+#include "nuansa/utils/metrics/metrics_server.h"
+#include "nuansa/utils/trace/tracer.h"
 
 namespace beast = boost::beast;
 namespace websocket = beast::websocket;
@@ -14,10 +29,85 @@ namespace http = beast::http;
 
 
 namespace nuansa::core {
+    namespace {
+        // How long a client turned away at the connection cap should wait
+        constexpr auto CONNECTION_RETRY_AFTER = std::chrono::seconds(1);
+
+        // Answers with an "overloaded" frame and closes, without giving the connection a session thread
+        void RejectSession(const std::shared_ptr<websocket::stream<tcp::socket> > &ws) {
+            auto message = std::make_shared<std::string>(
+                nuansa::handler::WebSocketHandler::BuildOverloadedMessage(CONNECTION_RETRY_AFTER));
+            ws->text(true);
+            ws->async_write(net::buffer(*message), [ws, message](const boost::system::error_code &ec, std::size_t) {
+                if (ec) {
+                    return;
+                }
+                ws->async_close(websocket::close_code::try_again_later, [ws](const boost::system::error_code &) {
+                });
+            });
+        }
+
+        // Completes the WebSocket handshake, then hands the connection to a session thread of its own
+        void StartSession(const std::shared_ptr<websocket::stream<tcp::socket> > &ws,
+                          const std::shared_ptr<nuansa::handler::WebSocketHandler> &handler,
+                          const size_t maxConnections,
+                          const std::shared_ptr<std::atomic<size_t> > &activeSessions,
+                          const std::vector<int> &sessionCpus) {
+            ws->async_accept([handler, ws, maxConnections, activeSessions, sessionCpus](
+                const boost::system::error_code &ec) {
+                if (ec) {
+                    LOG_ERROR << "WebSocket accept error: " << ec.message();
+                    return;
+                }
+
+                if (activeSessions->fetch_add(1) >= maxConnections) {
+                    activeSessions->fetch_sub(1);
+                    LOG_WARNING << "Connection limit of " << maxConnections << " reached, rejecting session";
+                    RejectSession(ws);
+                    return;
+                }
+
+                LOG_DEBUG << "WebSocket handshake successful";
+                // Set suggested timeout options
+                ws->set_option(websocket::stream_base::timeout::suggested(beast::role_type::server));
+
+                // Set the decorator for the handshake response
+                ws->set_option(websocket::stream_base::decorator([](websocket::response_type &res) {
+                    res.set(http::field::server, "Nuansa WebSocket Server");
+                    res.set(http::field::access_control_allow_origin, "*");
+                }));
+
+                // Start the session in a separate thread to avoid blocking
+                std::thread([handler, ws, activeSessions, sessionCpus]() {
+                    // Undo the single-CPU pin inherited from the IO thread so blocking sessions can be rebalanced
+                    Listener::PinCurrentThread(sessionCpus);
+                    try {
+                        LOG_DEBUG << "Starting new session handler thread";
+                        handler->HandleSession(ws);
+                    } catch (const std::exception &e) {
+                        LOG_ERROR << "Session handling error: " << e.what();
+                    }
+                    activeSessions->fetch_sub(1);
+                    // Let the WebSocket close naturally through RAII
+                }).detach();
+            });
+        }
+    }
+
     void Initialize(const std::string &configPath) {
         InitializeConfig(configPath);
         InitializeLogging();
+        InitializeCircuitBreakers();
+        InitializeMetrics();
+        InitializeTracing();
+        InitializeLoadShedding();
         InitializeDatabase();
+        InitializeMentions();
+        InitializePresence();
+        InitializeTyping();
+
+        // Calibrate the password KDF before the first login pays for it
+        nuansa::utils::crypto::PasswordHasher::GetInstance();
     }
 
     bool CheckForRootUser() {
@@ -43,28 +133,141 @@ namespace nuansa::core {
         const auto &config = nuansa::config::GetConfig();
         std::filesystem::create_directories(std::filesystem::path(config.GetServerConfig().logPath).parent_path());
 
-        boost::log::register_simple_formatter_factory<boost::log::trivial::severity_level, char>("Severity");
+        // Records below this level are skipped before their arguments are formatted
+        nuansa::utils::log::AsyncLogger::SetLevel(
+            nuansa::utils::log::ParseLevel(config.GetServerConfig().logLevel));
+
+        const auto &logging = config.GetLoggingConfig();
+        std::vector<std::shared_ptr<nuansa::utils::log::LogSink> > sinks{
+            std::make_shared<nuansa::utils::log::ConsoleLogSink>()
+        };
+        if (logging.fileEnabled) {
+            sinks.push_back(std::make_shared<nuansa::utils::log::RotatingFileSink>(
+                nuansa::utils::log::RotatingFileSinkSettings{
+                    .path = config.GetServerConfig().logPath,
+                    .format = logging.format == "json"
+                                  ? nuansa::utils::log::LogFormat::Json
+                                  : nuansa::utils::log::LogFormat::Text,
+                    .bufferBytes = logging.bufferBytes,
+                    .maxFileBytes = logging.maxFileBytes,
+                    .rotateInterval = std::chrono::seconds(logging.rotateIntervalSeconds),
+                    .fsyncInterval = std::chrono::milliseconds(logging.fsyncIntervalMs),
+                    .maxRotatedFiles = logging.maxRotatedFiles,
+                    .compressRotated = logging.compressRotated
+                }));
+        }
+        nuansa::utils::log::AsyncLogger::GetInstance().SetSinks(std::move(sinks));
+    }
+
+    void InitializeCircuitBreakers() {
+        const auto &config = nuansa::config::GetConfig().GetCircuitBreakerConfig();
+
+        const auto toSettings = [](const nuansa::config::CircuitBreakerPolicy &policy) {
+            return nuansa::utils::pattern::CircuitBreakerSettings{
+                .failureThreshold = policy.failureThreshold,
+                .successThreshold = policy.successThreshold,
+                .resetTimeout = std::chrono::seconds(policy.resetTimeoutSeconds),
+                .timeout = std::chrono::seconds(policy.timeoutSeconds),
+                .failureRateThreshold = policy.failureRateThreshold,
+                .window = std::chrono::seconds(policy.windowSeconds)
+            };
+        };
+
+        std::unordered_map<std::string, nuansa::utils::pattern::CircuitBreakerSettings> overrides;
+        for (const auto &[name, policy]: config.dependencies) {
+            overrides.emplace(name, toSettings(policy));
+        }
+
+        nuansa::utils::pattern::CircuitBreakerRegistry::GetInstance().Configure(toSettings(config.defaults),
+                                                                                std::move(overrides));
+    }
 
-        // Only show debug messages when g_runDebug is true
-        boost::log::core::get()->set_filter(
-            boost::log::trivial::severity >= (config.GetServerConfig().logLevel == "debug"
-                                                  ? boost::log::trivial::debug
-                                                  : boost::log::trivial::info)
-        );
+    void InitializeTracing() {
+        const auto &tracing = nuansa::config::GetConfig().GetTracingConfig();
+        if (!tracing.enabled) {
+            return;
+        }
+
+        nuansa::utils::trace::Tracer::GetInstance().Configure(nuansa::utils::trace::TracerSettings{
+            .sampleRate = tracing.sampleRate,
+            .bufferCapacity = tracing.bufferSize,
+            .exportInterval = std::chrono::milliseconds(tracing.exportIntervalMs),
+            .filePath = tracing.filePath,
+            .collectorUrl = tracing.collectorUrl
+        });
+    }
 
-        // Define logging format
-        boost::log::add_console_log(
-            std::cout,
-            boost::log::keywords::format = "[%TimeStamp%] [%Severity%] %Message%"
-        );
+    void InitializeMetrics() {
+        auto &registry = nuansa::utils::metrics::MetricsRegistry::GetInstance();
+        using nuansa::utils::metrics::MetricType;
+        using nuansa::utils::pattern::CircuitBreaker;
+
+        // Breakers keep their own counts; they are read when scraped
+        for (const auto &name: {
+                 nuansa::utils::pattern::breakers::PRIMARY_DB, nuansa::utils::pattern::breakers::GOOGLE,
+                 nuansa::utils::pattern::breakers::GITHUB
+             }) {
+            auto &breaker = nuansa::utils::pattern::CircuitBreakerRegistry::GetInstance().Get(name);
+
+            registry.RegisterCallback("nuansa_circuit_breaker_state", "0 closed, 1 open, 2 half-open",
+                                      MetricType::Gauge, {{"dependency", name}}, [&breaker] {
+                                          return static_cast<double>(breaker.GetState());
+                                      });
+
+            const auto calls = [&](const char *outcome, size_t CircuitBreaker::Metrics::*field) {
+                registry.RegisterCallback("nuansa_circuit_breaker_calls_total", "Calls seen by the breaker",
+                                          MetricType::Counter, {{"dependency", name}, {"outcome", outcome}},
+                                          [&breaker, field] {
+                                              return static_cast<double>(breaker.GetMetrics().*field);
+                                          });
+            };
+            calls("success", &CircuitBreaker::Metrics::successfulCalls);
+            calls("failure", &CircuitBreaker::Metrics::failedCalls);
+            calls("timeout", &CircuitBreaker::Metrics::timeouts);
+            calls("rejected", &CircuitBreaker::Metrics::rejectedCalls);
+        }
 
-        // Add common attributes
-        boost::log::add_common_attributes();
+        auto &limiter = nuansa::utils::pattern::ConcurrencyLimiter::GetInstance();
+        registry.RegisterCallback("nuansa_auth_concurrency_limit", "Current adaptive limit on auth requests",
+                                  MetricType::Gauge, {}, [&limiter] {
+                                      return static_cast<double>(limiter.Limit());
+                                  });
+        registry.RegisterCallback("nuansa_auth_in_flight", "Auth requests currently admitted",
+                                  MetricType::Gauge, {}, [&limiter] {
+                                      return static_cast<double>(limiter.InFlight());
+                                  });
+        registry.RegisterCallback("nuansa_auth_shed_total", "Auth requests turned away by the limiter",
+                                  MetricType::Counter, {}, [&limiter] {
+                                      return static_cast<double>(limiter.Rejected());
+                                  });
+    }
+
+    void InitializeLoadShedding() {
+        const auto &config = nuansa::config::GetConfig().GetLoadSheddingConfig();
+
+        nuansa::utils::pattern::ConcurrencyLimiter::GetInstance().ApplySettings(
+            nuansa::utils::pattern::ConcurrencyLimiterSettings{
+                .initialLimit = config.initialLimit,
+                .minLimit = config.minLimit,
+                .maxLimit = config.maxLimit,
+                .latencyTolerance = config.latencyTolerance,
+                .backoffRatio = config.backoffRatio
+            });
     }
 
     void InitializeDatabase() {
         const auto &config = nuansa::config::GetConfig();
 
+        const auto backend = nuansa::services::storage::ParseStorageBackend(config.GetDatabaseConfig().backend)
+                .value_or(nuansa::services::storage::StorageBackend::Postgres);
+        auto &storage = nuansa::services::storage::StorageRegistry::GetInstance();
+        storage.Select(backend);
+
+        if (backend == nuansa::services::storage::StorageBackend::InMemory) {
+            storage.Users().Initialize();
+            return;
+        }
+
         try {
             nuansa::database::ConnectionPool::GetInstance().Initialize(
                 config.GetDatabaseConfig().connection_string,
@@ -74,6 +277,72 @@ namespace nuansa::core {
             std::cerr << "Database connection pool initialization error: " << e.what() << std::endl;
             throw;
         }
+
+        // Warm the username/email availability filters so registration checks can skip the database
+        nuansa::services::user::UserService::GetInstance().LoadIdentityFilters();
+    }
+
+    void InitializeMentions() {
+        const auto &config = nuansa::config::GetConfig().GetMentionsConfig();
+
+        nuansa::handler::MentionDispatcher::GetInstance().Configure(nuansa::handler::MentionDispatcherSettings{
+            .maxPerMessage = config.maxPerMessage,
+            .excerptBytes = config.excerptBytes,
+            .inboxLimit = config.inboxLimit,
+            .batchSize = config.batchSize,
+            .flushInterval = std::chrono::milliseconds(config.flushIntervalMs),
+            .deliveryThreads = config.deliveryThreads,
+            .deliveryQueueCapacity = config.deliveryQueueCapacity
+        });
+    }
+
+    void InitializePresence() {
+        const auto &config = nuansa::config::GetConfig().GetPresenceConfig();
+        if (!config.defaultRoom.empty() && !nuansa::handler::PresenceService::IsValidRoomName(config.defaultRoom)) {
+            throw std::runtime_error("presence.default_room may only contain letters, digits, '_', '-' and '.'");
+        }
+
+        nuansa::handler::PresenceService::GetInstance().Configure(nuansa::handler::PresenceSettings{
+            .defaultRoom = config.defaultRoom,
+            .window = std::chrono::milliseconds(config.windowMs),
+            .maxRoomsPerUser = config.maxRoomsPerUser,
+            .maxContacts = config.maxContacts,
+            .deliveryThreads = config.deliveryThreads,
+            .deliveryQueueCapacity = config.deliveryQueueCapacity
+        });
+    }
+
+    void InitializeTyping() {
+        const auto &config = nuansa::config::GetConfig().GetTypingConfig();
+        nuansa::handler::TypingService::GetInstance().Configure(nuansa::handler::TypingSettings{
+            .window = std::chrono::milliseconds(config.windowMs),
+            .timeout = std::chrono::milliseconds(config.timeoutMs),
+            .maxRoomPeers = config.maxRoomPeers,
+            .deliveryThreads = config.deliveryThreads,
+            .deliveryQueueCapacity = config.deliveryQueueCapacity
+        });
+    }
+
+    void Shutdown() {
+        const auto &config = nuansa::config::GetConfig().GetShutdownConfig();
+
+        // Sessions go first: they are what still produces mentions, presence changes and queries
+        nuansa::handler::SessionDrainer::GetInstance().Drain(nuansa::handler::DrainSettings{
+            .window = std::chrono::milliseconds(config.drainWindowMs),
+            .grace = std::chrono::milliseconds(config.closeGraceMs),
+            .reconnectJitter = std::chrono::milliseconds(config.reconnectJitterMs)
+        });
+
+        // Typing looks up rooms in presence; the mention dispatcher writes its buffered inbox entries
+        nuansa::handler::TypingService::GetInstance().Shutdown();
+        nuansa::handler::PresenceService::GetInstance().Shutdown();
+        nuansa::handler::MentionDispatcher::GetInstance().Shutdown();
+        nuansa::utils::trace::Tracer::GetInstance().Shutdown();
+
+        if (auto &pool = nuansa::database::ConnectionPool::GetInstance(); pool.IsInitialized()) {
+            pool.Shutdown(std::chrono::milliseconds(config.databaseTimeoutMs));
+        }
+        LOG_INFO << "Shutdown complete";
     }
 
     void Run(const utils::ProgramOptions &options) {
@@ -87,97 +356,60 @@ namespace nuansa::core {
 
         if (options.GetCommand() == "run") {
             try {
-                LOG_DEBUG << "Initializing io_context";
-                net::io_context ioc;
                 auto &serverConfig = nuansa::config::GetConfig().GetServerConfig();
+                Listener listener(ListenerSettings{
+                    .host = serverConfig.host,
+                    .port = serverConfig.port,
+                    .mode = serverConfig.ioMode == "per_core" ? IoMode::PerCore : IoMode::Shared,
+                    .threads = serverConfig.ioThreads,
+                    .pinThreads = serverConfig.pinIoThreads
+                });
 
-                auto const address = net::ip::make_address(serverConfig.host);
-                tcp::acceptor acceptor(ioc, {{address}, serverConfig.port});
-
-                LOG_INFO << "WebSocket server running on port " << serverConfig.port;
+                // Scrapes are served on their own port and thread
+                std::unique_ptr<nuansa::utils::metrics::MetricsServer> metricsServer;
+                if (const auto &metricsConfig = nuansa::config::GetConfig().GetMetricsConfig(); metricsConfig.enabled) {
+                    metricsServer = std::make_unique<nuansa::utils::metrics::MetricsServer>(
+                        nuansa::utils::metrics::MetricsRegistry::GetInstance(),
+                        nuansa::utils::metrics::MetricsServerSettings{
+                            .host = metricsConfig.host,
+                            .port = metricsConfig.port
+                        });
+                    metricsServer->Start();
+                }
 
                 auto websocketServer = std::make_shared<nuansa::handler::WebSocketServer>();
                 auto handler = std::make_shared<nuansa::handler::WebSocketHandler>(websocketServer);
 
-                // Start accepting connections asynchronously
-                auto DoAccept = [&acceptor, &ioc, handler]<typename T0>(T0 &&self) -> void {
-                    LOG_DEBUG << "Starting async accept";
-                    acceptor.async_accept(
-                        [handler, &acceptor, self=std::forward<T0>(self)]
-                (const boost::system::error_code &ec, tcp::socket socket) {
-                            if (!ec) {
-                                LOG_DEBUG << "New connection accepted";
-                                // Create WebSocket stream
-                                auto ws = std::make_shared<websocket::stream<tcp::socket> >(std::move(socket));
-
-                                // Accept WebSocket handshake asynchronously
-                                ws->async_accept(
-                                    [handler, ws](const boost::system::error_code &ws_ec) {
-                                        if (!ws_ec) {
-                                            LOG_DEBUG << "WebSocket handshake successful";
-                                            // Set suggested timeout options
-                                            ws->set_option(websocket::stream_base::timeout::suggested(
-                                                beast::role_type::server));
-
-                                            // Set the decorator for the handshake response
-                                            ws->set_option(websocket::stream_base::decorator(
-                                                [](websocket::response_type &res) {
-                                                    res.set(http::field::server, "Nuansa WebSocket Server");
-                                                    res.set(http::field::access_control_allow_origin, "*");
-                                                }));
-
-                                            // Start the session in a separate thread to avoid blocking
-                                            std::thread([handler, ws]() {
-                                                try {
-                                                    LOG_DEBUG << "Starting new session handler thread";
-                                                    handler->HandleSession(ws);
-                                                } catch (const std::exception &e) {
-                                                    LOG_ERROR << "Session handling error: " << e.what();
-                                                }
-                                                // Let the WebSocket close naturally through RAII
-                                            }).detach();
-                                        } else {
-                                            LOG_ERROR << "WebSocket accept error: " << ws_ec.message();
-                                        }
-                                    });
-                            } else {
-                                LOG_ERROR
-                                    << "Accept error: " << ec.message();
-                            }
-
-                            // Continue accepting
-                            self(self);
-                        });
-                };
+                // Every session owns a thread, so their number is capped
+                const auto maxConnections = nuansa::config::GetConfig().GetLoadSheddingConfig().maxConnections;
+                auto activeSessions = std::make_shared<std::atomic<size_t> >(0);
+
+                // The first SIGTERM or SIGINT stops the accept loop and lets the main thread drain
+                std::promise<int> stopSignal;
+                auto stopRequested = stopSignal.get_future();
+                net::signal_set signals(listener.GetContext(), SIGINT, SIGTERM);
+                signals.async_wait([&listener, &stopSignal](const boost::system::error_code &ec, const int signal) {
+                    if (ec) {
+                        return;
+                    }
+                    listener.StopAccepting();
+                    stopSignal.set_value(signal);
+                });
 
-                // Start the accept loop (recursive lambda)
                 LOG_DEBUG << "Starting accept loop";
-                DoAccept(DoAccept);
-
-                // Run the io_context
-                std::vector<std::thread> threads;
-                const auto thread_count = std::thread::hardware_concurrency();
-                threads.reserve(thread_count);
-
-                LOG_DEBUG << "Creating " << thread_count << " IO threads";
-                // Create a pool of threads to run the io_context
-                for (auto i = 0u; i < thread_count; ++i) {
-                    threads.emplace_back([&ioc] {
-                        try {
-                            LOG_DEBUG << "IO thread " << std::this_thread::get_id() << " starting";
-                            ioc.run();
-                        } catch (const std::exception &e) {
-                            LOG_ERROR
-                                << "IO context error: " << e.what();
-                        }
-                    });
-                }
+                // Session threads may run on any CPU the IO threads were spread over
+                const auto sessionCpus = listener.AllowedCpus();
+                listener.Start([handler, maxConnections, activeSessions, sessionCpus](tcp::socket socket) {
+                    StartSession(std::make_shared<websocket::stream<tcp::socket> >(std::move(socket)),
+                                 handler, maxConnections, activeSessions, sessionCpus);
+                });
+                LOG_INFO << "WebSocket server running on port " << listener.GetPort();
+
+                LOG_INFO << "Received signal " << stopRequested.get() << ", shutting down";
+                Shutdown();
 
-                // Wait for all threads to complete
                 LOG_DEBUG << "Waiting for IO threads to complete";
-                for (auto &thread: threads) {
-                    thread.join();
-                }
+                listener.Stop();
             } catch (const std::exception &e) {
                 LOG_ERROR << "Server error: " << e.what();
             }
@@ -0,0 +1,193 @@
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/core/listener.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace nuansa::core {
+    namespace {
+        // FreeBSD only balances connections across sockets with the _LB variant
+#if defined(SO_REUSEPORT_LB)
+        using ReusePort = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT_LB>;
+#elif defined(SO_REUSEPORT)
+        using ReusePort = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+
+        // The CPUs this process may run on, in ascending order; empty where affinity is not supported
+        std::vector<int> AllowedCpus() {
+            std::vector<int> cpus;
+#ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+                LOG_WARNING << "Failed to read the CPU affinity: " << std::strerror(errno);
+                return cpus;
+            }
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) {
+                    cpus.push_back(cpu);
+                }
+            }
+#else
+            LOG_WARNING << "CPU pinning is only supported on Linux, IO threads are not pinned";
+#endif
+            return cpus;
+        }
+    }
+
+    // An io_context with the acceptor whose connections it runs
+    struct Listener::Slot {
+        explicit Slot(const IoMode mode)
+            : ioc(mode == IoMode::PerCore ? 1 : BOOST_ASIO_CONCURRENCY_HINT_DEFAULT),
+              // Shared: on a strand so StopAccepting can close it while an accept is pending on another thread
+              acceptor(mode == IoMode::PerCore
+                           ? boost::asio::ip::tcp::acceptor(ioc)
+                           : boost::asio::ip::tcp::acceptor(boost::asio::make_strand(ioc))) {
+        }
+
+        boost::asio::io_context ioc;
+        boost::asio::ip::tcp::acceptor acceptor;
+    };
+
+    Listener::Listener(ListenerSettings settings)
+        : settings_(std::move(settings)),
+          threadCount_(settings_.threads > 0
+                           ? settings_.threads
+                           : std::max<size_t>(1, std::thread::hardware_concurrency())) {
+        const size_t slotCount = settings_.mode == IoMode::PerCore ? threadCount_ : 1;
+        slots_.reserve(slotCount);
+        for (size_t i = 0; i < slotCount; ++i) {
+            slots_.push_back(std::make_unique<Slot>(settings_.mode));
+        }
+        if (settings_.mode == IoMode::PerCore && settings_.pinThreads) {
+            allowedCpus_ = AllowedCpus();
+        }
+    }
+
+    Listener::~Listener() {
+        Stop();
+    }
+
+    void Listener::Start(AcceptHandler onAccept) {
+        onAccept_ = std::move(onAccept);
+
+        boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::make_address(settings_.host), settings_.port);
+        for (const auto &slot: slots_) {
+            slot->acceptor.open(endpoint.protocol());
+            slot->acceptor.set_option(boost::asio::socket_base::reuse_address(true));
+            if (settings_.mode == IoMode::PerCore) {
+#if defined(SO_REUSEPORT_LB) || defined(SO_REUSEPORT)
+                slot->acceptor.set_option(ReusePort(true));
+#else
+                throw std::runtime_error("The per_core IO mode needs SO_REUSEPORT, which this platform lacks");
+#endif
+            }
+            slot->acceptor.bind(endpoint);
+            slot->acceptor.listen();
+            // The rest join the port the first one got
+            endpoint.port(slot->acceptor.local_endpoint().port());
+            Accept(*slot);
+        }
+
+        // Thread i goes to the i-th CPU of the affinity mask, which under taskset or a cpuset need not be CPU i
+        threads_.reserve(threadCount_);
+        for (size_t i = 0; i < threadCount_; ++i) {
+            auto &slot = *slots_[i % slots_.size()];
+            const int cpu = allowedCpus_.empty() ? -1 : allowedCpus_[i % allowedCpus_.size()];
+            threads_.emplace_back([this, &slot, i, cpu] {
+                if (cpu >= 0) {
+                    PinCurrentThread({cpu});
+                }
+                try {
+                    LOG_DEBUG << "IO thread " << i << " starting";
+                    slot.ioc.run();
+                } catch (const std::exception &e) {
+                    LOG_ERROR << "IO context error: " << e.what();
+                }
+            });
+        }
+
+        LOG_INFO << "Listening on " << settings_.host << ":" << GetPort() << " with " << threadCount_
+                << " IO threads and " << slots_.size() << (slots_.size() == 1 ? " acceptor" : " acceptors");
+    }
+
+    void Listener::PinCurrentThread(const std::vector<int> &cpus) {
+        if (cpus.empty()) {
+            return;
+        }
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const int cpu: cpus) {
+            CPU_SET(cpu, &set);
+        }
+        if (const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); rc != 0) {
+            LOG_WARNING << "Failed to set the CPU affinity of a thread: " << std::strerror(rc);
+        }
+#endif
+    }
+
+    void Listener::StopAccepting() {
+        for (const auto &slot: slots_) {
+            boost::asio::post(slot->acceptor.get_executor(), [&acceptor = slot->acceptor] {
+                boost::system::error_code ignored;
+                acceptor.close(ignored);
+            });
+        }
+    }
+
+    void Listener::Stop() {
+        for (const auto &slot: slots_) {
+            slot->ioc.stop();
+        }
+        for (auto &thread: threads_) {
+            thread.join();
+        }
+        threads_.clear();
+
+        for (const auto &slot: slots_) {
+            boost::system::error_code ignored;
+            slot->acceptor.close(ignored);
+        }
+    }
+
+    uint16_t Listener::GetPort() const {
+        boost::system::error_code ec;
+        const auto endpoint = slots_.front()->acceptor.local_endpoint(ec);
+        return ec ? settings_.port : endpoint.port();
+    }
+
+    boost::asio::io_context &Listener::GetContext() {
+        return slots_.front()->ioc;
+    }
+
+    size_t Listener::ThreadCount() const {
+        return threadCount_;
+    }
+
+    void Listener::Accept(Slot &slot) {
+        auto onAccepted = [this, &slot](const boost::system::error_code &ec, boost::asio::ip::tcp::socket socket) {
+            if (ec == boost::asio::error::operation_aborted || !slot.acceptor.is_open()) {
+                LOG_INFO << "Stopped accepting connections";
+                return;
+            }
+            if (ec) {
+                LOG_ERROR << "Accept error: " << ec.message();
+            } else {
+                LOG_DEBUG << "New connection accepted";
+                onAccept_(std::move(socket));
+            }
+            Accept(slot);
+        };
+
+        if (settings_.mode == IoMode::PerCore) {
+            // Only this slot's thread runs the context, so the connection needs no strand
+            slot.acceptor.async_accept(slot.ioc, std::move(onAccepted));
+        } else {
+            slot.acceptor.async_accept(boost::asio::make_strand(slot.ioc), std::move(onAccepted));
+        }
+    }
+}
@@ -2,8 +2,35 @@
 
 #include "nuansa/database/db_connection_pool.h"
 #include "nuansa/utils/exception/database_exception.h"
+#include "nuansa/utils/metrics/metrics.h"
+#include "nuansa/utils/trace/tracer.h"
 
 namespace nuansa::database {
+    namespace {
+        struct PoolMetrics {
+            utils::metrics::Histogram &acquireWait;
+            utils::metrics::Counter &acquireTimeouts;
+            utils::metrics::Gauge &idle;
+            utils::metrics::Gauge &open;
+        };
+
+        PoolMetrics &Metrics() {
+            static PoolMetrics metrics = [] {
+                auto &registry = utils::metrics::MetricsRegistry::GetInstance();
+                return PoolMetrics{
+                    .acquireWait = registry.GetHistogram("nuansa_db_pool_acquire_wait_seconds",
+                                                         "Time spent waiting for a pooled connection", {}, 1e-6),
+                    .acquireTimeouts = registry.GetCounter("nuansa_db_pool_acquire_timeouts_total",
+                                                           "Acquires that gave up waiting for a connection"),
+                    .idle = registry.GetGauge("nuansa_db_pool_idle_connections", "Connections waiting in the pool"),
+                    .open = registry.GetGauge("nuansa_db_pool_open_connections",
+                                              "Connections counted against the pool maximum")
+                };
+            }();
+            return metrics;
+        }
+    }
+
     ConnectionPool &ConnectionPool::GetInstance() {
         static ConnectionPool instance;
         return instance;
@@ -13,7 +40,8 @@ namespace nuansa::database {
         std::lock_guard<std::mutex> lock(mutex_);
 
         if (initialized_) {
-            Shutdown();
+            initialized_ = false;
+            CloseConnections();
         }
 
         connectionString_ = connectionString;
@@ -21,14 +49,8 @@ namespace nuansa::database {
         maxPoolSize_ = poolSize * 2;
         activeConnections_ = 0;
 
-        // Initialize circuit breaker
-        circuitBreaker_.Initialize(utils::pattern::CircuitBreakerSettings{
-            .failureThreshold = 5,
-            .successThreshold = 2,
-            .resetTimeout = std::chrono::seconds(30),
-            .timeout = std::chrono::seconds(10)
-        });
-        circuitBreaker_.Reset();
+        // Start from a closed circuit; settings come from the circuit_breaker config
+        GetCircuitBreaker().Reset();
 
         LOG_INFO << "Initializing connection pool with size " << poolSize_;
 
@@ -53,7 +75,7 @@ namespace nuansa::database {
         // If we couldn't create even one connection, throw an exception
         if (initializationFailed || connections_.empty()) {
             LOG_ERROR << "Shutting down connection pool due to initialization failure";
-            Shutdown();
+            CloseConnections();
             throw nuansa::utils::exception::DatabaseCreateConnectionException(
                 "Failed to initialize connection pool: " + errorMessage
             );
@@ -73,6 +95,7 @@ namespace nuansa::database {
         }
 
         initialized_ = true;
+        UpdateGauges();
         LOG_INFO << "Connection pool initialized with " << connections_.size() << " connections";
     }
 
@@ -86,42 +109,34 @@ namespace nuansa::database {
         }
     }
 
-    void ConnectionPool::Shutdown() {
+    bool ConnectionPool::Shutdown(const std::chrono::milliseconds timeout) {
         std::unique_lock<std::mutex> lock(mutex_);
         LOG_INFO << "Shutting down connection pool";
-        // First mark as not initialized to prevent new connection requests
+        // New and waiting acquires fail from here on
         initialized_ = false;
-        LOG_INFO << "Connection pool marked as not initialized";
-        // Wake up any waiting threads before clearing connections
         connectionAvailable_.notify_all();
-        LOG_INFO << "Notified all waiting threads";
 
-        // Give waiting threads a chance to wake up and exit
-        lock.unlock();
-        LOG_INFO << "Unlocked mutex";
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        lock.lock();
-        LOG_INFO << "Locked mutex";
+        // Connections returned from now on are closed rather than pooled
+        const bool drained = connectionAvailable_.wait_for(lock, timeout, [this] {
+            return activeConnections_ <= connections_.size();
+        });
+        if (!drained) {
+            LOG_WARNING << "Connection pool shut down with " << activeConnections_ - connections_.size()
+                    << " connections still in use";
+        }
 
-        // Clear all connections
+        CloseConnections();
+        connectionAvailable_.notify_all();
+        LOG_INFO << "Connection pool shut down";
+        return drained;
+    }
+
+    void ConnectionPool::CloseConnections() {
         while (!connections_.empty()) {
-            LOG_INFO << "Clearing connections";
-            auto conn = std::move(connections_.front());
             connections_.pop();
-            try {
-                LOG_INFO << "Resetting connection";
-                conn.reset();
-            } catch (const std::exception &e) {
-                LOG_WARNING << "Error closing connection during shutdown: " << e.what();
-            }
         }
-
         activeConnections_ = 0;
-
-        // Final notification for any remaining waiters
-        connectionAvailable_.notify_all();
-
-        LOG_INFO << "Connection pool shut down";
+        UpdateGauges();
     }
 
     bool ConnectionPool::IsInitialized() const {
@@ -129,6 +144,7 @@ namespace nuansa::database {
     }
 
     std::shared_ptr<pqxx::connection> ConnectionPool::AcquireConnection(const std::chrono::milliseconds timeout) {
+        utils::trace::Span span("db.acquire");
         std::unique_lock<std::mutex> lock(mutex_);
 
         if (!initialized_) {
@@ -136,14 +152,23 @@ namespace nuansa::database {
             throw std::runtime_error("Connection pool is not initialized");
         }
 
-        LOG_INFO << "Acquiring connection from pool";
+        LOG_DEBUG << "Acquiring connection from pool";
 
         // Wait for a connection with timeout
+        auto &metrics = Metrics();
+        const auto waitStart = std::chrono::steady_clock::now();
         const auto waitResult = connectionAvailable_.wait_for(lock, timeout, [this] {
             return !initialized_ || !connections_.empty() || activeConnections_ < maxPoolSize_;
         });
+        metrics.acquireWait.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - waitStart).count()));
+
+        if (!initialized_) {
+            throw std::runtime_error("Connection pool is shutting down");
+        }
 
         if (!waitResult) {
+            metrics.acquireTimeouts.Increment();
             LOG_ERROR << "Timeout waiting for available connection";
             throw std::runtime_error("Timeout waiting for database connection");
         }
@@ -168,19 +193,21 @@ namespace nuansa::database {
 
         if (!conn || !conn->is_open()) {
             --activeConnections_;
+            UpdateGauges();
             connectionAvailable_.notify_one();
             throw std::runtime_error("Failed to acquire valid database connection");
         }
 
+        UpdateGauges();
         return conn;
     }
 
     std::shared_ptr<pqxx::connection> ConnectionPool::GetFallbackConnection() {
-        LOG_INFO << "Getting fallback connection";
+        LOG_DEBUG << "Getting fallback connection";
         try {
             // First try to use a dedicated read-only replica if configured
             if (!fallbackConnectionString_.empty()) {
-                LOG_INFO << "Using dedicated fallback connection string";
+                LOG_DEBUG << "Using dedicated fallback connection string";
                 return std::make_shared<pqxx::connection>(fallbackConnectionString_);
             }
 
@@ -220,6 +247,16 @@ namespace nuansa::database {
 
         std::lock_guard<std::mutex> lock(mutex_);
 
+        if (!initialized_) {
+            // Closed once the lock is released; Shutdown may be waiting for it, or may have given up on it
+            if (activeConnections_ > 0) {
+                --activeConnections_;
+            }
+            UpdateGauges();
+            connectionAvailable_.notify_all();
+            return;
+        }
+
         try {
             if (conn->is_open()) {
                 try {
@@ -229,20 +266,27 @@ namespace nuansa::database {
                 }
 
                 connections_.push(std::move(conn));
+                UpdateGauges();
                 connectionAvailable_.notify_one();
                 LOG_DEBUG << "Connection returned to pool. Pool size: " << connections_.size();
             } else {
-                ++activeConnections_;
+                --activeConnections_;
                 LOG_WARNING << "Discarding dead connection";
                 connectionAvailable_.notify_one();
             }
         } catch (const std::exception &e) {
-            ++activeConnections_;
+            --activeConnections_;
             LOG_ERROR << "Error returning connection: " << e.what();
             connectionAvailable_.notify_one();
         }
     }
 
+    void ConnectionPool::UpdateGauges() const {
+        auto &metrics = Metrics();
+        metrics.idle.Set(static_cast<int64_t>(connections_.size()));
+        metrics.open.Set(static_cast<int64_t>(activeConnections_.load()));
+    }
+
     void ConnectionPool::SetFallbackConnectionString(const std::string &connectionString) {
         std::lock_guard<std::mutex> lock(mutex_);
         fallbackConnectionString_ = connectionString;
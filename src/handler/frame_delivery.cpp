@@ -0,0 +1,37 @@
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/handler/frame_delivery.h"
+
+namespace nuansa::handler {
+    void FrameDelivery::Start(const utils::pattern::WorkerPoolSettings &settings) {
+        pool_ = std::make_unique<utils::pattern::WorkerPool>(settings);
+    }
+
+    void FrameDelivery::Shutdown() {
+        if (pool_) {
+            pool_->Shutdown();
+        }
+    }
+
+    bool FrameDelivery::Deliver(const std::shared_ptr<WebSocketClient> &client,
+                                std::shared_ptr<const std::string> frame) {
+        switch (client->QueueFrame(std::move(frame))) {
+            case WebSocketClient::QueueResult::Queued:
+                return true;
+
+            case WebSocketClient::QueueResult::NeedsFlush:
+                Schedule(client);
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    void FrameDelivery::Schedule(const std::shared_ptr<WebSocketClient> &client) {
+        // Without a free delivery thread the producer writes it, which slows only the producer
+        if (!pool_ || !pool_->TryPost([client] { client->FlushOutbound(); })) {
+            client->FlushOutbound();
+        }
+    }
+} // namespace nuansa::handler
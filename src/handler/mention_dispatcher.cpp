@@ -0,0 +1,343 @@
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/handler/mention_dispatcher.h"
+#include "nuansa/services/storage/storage_registry.h"
+#include "nuansa/utils/metrics/metrics.h"
+
+namespace nuansa::handler {
+    namespace {
+        struct MentionMetrics {
+            utils::metrics::Counter &notified;
+            utils::metrics::Counter &dropped;
+            utils::metrics::Counter &stored;
+            utils::metrics::Counter &unknown;
+            utils::metrics::Counter &storeErrors;
+            utils::metrics::Counter &delivered;
+            utils::metrics::Histogram &batchDuration;
+        };
+
+        MentionMetrics &Metrics() {
+            static MentionMetrics metrics = [] {
+                auto &registry = utils::metrics::MetricsRegistry::GetInstance();
+                return MentionMetrics{
+                    .notified = registry.GetCounter("nuansa_mentions_notified_total",
+                                                    "Mentions queued for online users"),
+                    .dropped = registry.GetCounter("nuansa_mentions_dropped_total",
+                                                   "Mentions dropped because a send queue or the inbox buffer was full"),
+                    .stored = registry.GetCounter("nuansa_mention_inbox_stored_total",
+                                                  "Mentions written to the offline inbox"),
+                    .unknown = registry.GetCounter("nuansa_mention_inbox_unknown_total",
+                                                   "Offline mentions not stored because no such user exists"),
+                    .storeErrors = registry.GetCounter("nuansa_mention_inbox_store_errors_total",
+                                                       "Mentions lost because an inbox batch could not be written"),
+                    .delivered = registry.GetCounter("nuansa_mention_inbox_delivered_total",
+                                                     "Inbox mentions sent to users on login"),
+                    .batchDuration = registry.GetHistogram("nuansa_mention_inbox_batch_duration_seconds",
+                                                           "Time to write one batch of inbox entries", {}, 1e-6)
+                };
+            }();
+            return metrics;
+        }
+
+        // Batches the writer could not keep up with are dropped beyond this many multiples of batchSize
+        constexpr size_t PENDING_BATCHES = 16;
+    }
+
+    MentionDispatcher &MentionDispatcher::GetInstance() {
+        static MentionDispatcher instance;
+        return instance;
+    }
+
+    MentionDispatcher::~MentionDispatcher() {
+        Shutdown();
+    }
+
+    void MentionDispatcher::Configure(const MentionDispatcherSettings &settings) {
+        Shutdown();
+
+        settings_ = settings;
+        delivery_.Start(utils::pattern::WorkerPoolSettings{
+            .name = "mention-delivery",
+            .threadCount = std::max<size_t>(1, settings_.deliveryThreads),
+            .queueCapacity = std::max<size_t>(1, settings_.deliveryQueueCapacity)
+        });
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = false;
+            running_ = true;
+        }
+        thread_ = std::thread([this] { Run(); });
+    }
+
+    void MentionDispatcher::Shutdown() {
+        delivery_.Shutdown();
+        if (!thread_.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = false;
+        }
+        FlushInbox();
+    }
+
+    std::vector<std::string_view> MentionDispatcher::ResolveRecipients(const messages::Message &message,
+                                                                       const size_t maxRecipients) {
+        std::vector<std::string_view> recipients;
+        recipients.reserve(message.mentions.size());
+        for (const auto &mention: message.mentions) {
+            if (!mention.empty() && mention != message.sender) {
+                recipients.emplace_back(mention);
+            }
+        }
+
+        std::ranges::sort(recipients);
+        const auto duplicates = std::ranges::unique(recipients);
+        recipients.erase(duplicates.begin(), duplicates.end());
+
+        if (recipients.size() > maxRecipients) {
+            recipients.resize(maxRecipients);
+        }
+        return recipients;
+    }
+
+    std::string_view MentionDispatcher::Excerpt(const std::string_view content, const size_t maxBytes) {
+        if (content.size() <= maxBytes) {
+            return content;
+        }
+        // Step back over continuation bytes so a multi-byte character isn't split
+        size_t end = maxBytes;
+        while (end > 0 && (static_cast<unsigned char>(content[end]) & 0xC0) == 0x80) {
+            --end;
+        }
+        return content.substr(0, end);
+    }
+
+    std::string MentionDispatcher::BuildInboxMessage(const std::vector<services::chat::InboxMention> &mentions) {
+        nlohmann::json entries = nlohmann::json::array();
+        for (const auto &mention: mentions) {
+            entries.push_back({
+                {"messageId", mention.messageId},
+                {"sender", mention.sender},
+                {"excerpt", mention.excerpt},
+                {"timestamp", mention.timestamp}
+            });
+        }
+
+        const nlohmann::json inboxMsg = {
+            {"type", "mention_inbox"},
+            {"count", mentions.size()},
+            {"mentions", std::move(entries)}
+        };
+        return inboxMsg.dump();
+    }
+
+    MentionDispatchResult MentionDispatcher::Dispatch(const messages::Message &message,
+                                                      const WebSocketServer &registry) {
+        MentionDispatchResult result;
+        const auto recipients = ResolveRecipients(message, settings_.maxPerMessage);
+        if (recipients.empty()) {
+            return result;
+        }
+
+        auto &metrics = Metrics();
+        const auto online = registry.FindClients(recipients);
+        if (!online.empty()) {
+            // Serialized once and shared by every recipient's queue
+            const nlohmann::json notification = {
+                {"type", "mention"},
+                {"messageId", message.id},
+                {"sender", message.sender},
+                {"content", message.content}
+            };
+            const auto frame = std::make_shared<const std::string>(notification.dump());
+
+            for (const auto &client: online | std::views::values) {
+                if (delivery_.Deliver(client, frame)) {
+                    ++result.online;
+                } else {
+                    ++result.dropped;
+                }
+            }
+            metrics.notified.Increment(result.online);
+        }
+
+        // Both lists are sorted, so whoever FindClients skipped is offline
+        std::vector<services::chat::InboxMention> offline;
+        const auto excerpt = std::string(Excerpt(message.content, settings_.excerptBytes));
+        auto next = online.begin();
+        for (const auto recipient: recipients) {
+            if (next != online.end() && next->first == recipient) {
+                ++next;
+                continue;
+            }
+            offline.push_back(services::chat::InboxMention{
+                std::string(recipient), message.id, message.sender, excerpt, message.timestamp
+            });
+        }
+
+        if (!offline.empty()) {
+            result.offline = offline.size();
+            const auto droppedOffline = BufferInbox(std::move(offline));
+            result.offline -= droppedOffline;
+            result.dropped += droppedOffline;
+        }
+
+        metrics.dropped.Increment(result.dropped);
+        LOG_DEBUG << "Mentions in " << message.id << ": " << result.online << " online, " << result.offline
+                << " offline, " << result.dropped << " dropped";
+        return result;
+    }
+
+    size_t MentionDispatcher::BufferInbox(std::vector<services::chat::InboxMention> &&mentions) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!running_) {
+            lock.unlock();
+            return mentions.size() - StoreInbox(mentions);
+        }
+
+        const auto capacity = std::max<size_t>(1, settings_.batchSize) * PENDING_BATCHES;
+        const auto accepted = std::min(mentions.size(), capacity - std::min(capacity, pending_.size()));
+        pending_.insert(pending_.end(), std::make_move_iterator(mentions.begin()),
+                        std::make_move_iterator(mentions.begin() + static_cast<std::ptrdiff_t>(accepted)));
+        const bool fullBatch = pending_.size() >= settings_.batchSize;
+        lock.unlock();
+
+        if (fullBatch) {
+            wake_.notify_one();
+        }
+        return mentions.size() - accepted;
+    }
+
+    size_t MentionDispatcher::StoreInbox(const std::vector<services::chat::InboxMention> &mentions) const {
+        auto &metrics = Metrics();
+        const auto batchSize = std::max<size_t>(1, settings_.batchSize);
+
+        // "@word" is anything after an @, e.g. the domain of an email address; one lookup per name
+        auto &users = Users();
+        std::unordered_map<std::string_view, bool> isUser;
+        std::vector<services::chat::InboxMention> known;
+        known.reserve(mentions.size());
+        for (const auto &mention: mentions) {
+            const auto [it, inserted] = isUser.try_emplace(mention.recipient, false);
+            if (inserted) {
+                it->second = users.IsUsernameTaken(mention.recipient);
+            }
+            if (it->second) {
+                known.push_back(mention);
+            }
+        }
+        metrics.unknown.Increment(mentions.size() - known.size());
+
+        size_t stored = 0;
+        for (size_t offset = 0; offset < known.size(); offset += batchSize) {
+            const auto end = std::min(known.size(), offset + batchSize);
+            const std::vector batch(known.begin() + static_cast<std::ptrdiff_t>(offset),
+                                    known.begin() + static_cast<std::ptrdiff_t>(end));
+
+            const utils::metrics::ScopedTimer timer(metrics.batchDuration);
+            if (Inbox().Append(batch, settings_.inboxLimit)) {
+                stored += batch.size();
+            } else {
+                metrics.storeErrors.Increment(batch.size());
+                LOG_WARNING << "Lost " << batch.size() << " inbox mentions";
+            }
+        }
+        metrics.stored.Increment(stored);
+        return stored;
+    }
+
+    size_t MentionDispatcher::FlushInbox() {
+        std::vector<services::chat::InboxMention> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batch.swap(pending_);
+        }
+        return batch.empty() ? 0 : StoreInbox(batch);
+    }
+
+    size_t MentionDispatcher::PendingInboxEntries() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pending_.size();
+    }
+
+    size_t MentionDispatcher::DeliverInbox(const std::shared_ptr<WebSocketClient> &client) {
+        if (!client || client->username.empty()) {
+            return 0;
+        }
+
+        // Entries still waiting for their batch are handed over directly instead of round-tripping the store
+        std::vector<services::chat::InboxMention> buffered;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto mine = std::ranges::stable_partition(pending_, [&](const auto &mention) {
+                return mention.recipient != client->username;
+            });
+            buffered.assign(std::make_move_iterator(mine.begin()), std::make_move_iterator(mine.end()));
+            pending_.erase(mine.begin(), mine.end());
+        }
+
+        auto mentions = Inbox().Take(client->username, settings_.inboxLimit);
+        mentions.insert(mentions.end(), std::make_move_iterator(buffered.begin()),
+                        std::make_move_iterator(buffered.end()));
+        if (mentions.empty()) {
+            return 0;
+        }
+
+        std::ranges::stable_sort(mentions, {}, &services::chat::InboxMention::timestamp);
+        if (mentions.size() > settings_.inboxLimit) {
+            mentions.erase(mentions.begin(), mentions.end() - static_cast<std::ptrdiff_t>(settings_.inboxLimit));
+        }
+
+        try {
+            client->Write(BuildInboxMessage(mentions));
+        } catch (const std::exception &e) {
+            // Keep them for the next login rather than losing them with the connection
+            LOG_WARNING << "Could not deliver inbox to " << client->username << ": " << e.what();
+            BufferInbox(std::move(mentions));
+            return 0;
+        }
+
+        Metrics().delivered.Increment(mentions.size());
+        LOG_DEBUG << "Delivered " << mentions.size() << " inbox mentions to " << client->username;
+        return mentions.size();
+    }
+
+    services::chat::IMentionInbox &MentionDispatcher::Inbox() const {
+        if (settings_.inbox) {
+            return *settings_.inbox;
+        }
+        return services::storage::StorageRegistry::GetInstance().MentionInbox();
+    }
+
+    services::user::IUserService &MentionDispatcher::Users() const {
+        if (settings_.users) {
+            return *settings_.users;
+        }
+        return services::storage::StorageRegistry::GetInstance().Users();
+    }
+
+    void MentionDispatcher::Run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            wake_.wait_for(lock, settings_.flushInterval, [this] {
+                return stopping_ || pending_.size() >= settings_.batchSize;
+            });
+            lock.unlock();
+            try {
+                FlushInbox();
+            } catch (const std::exception &e) {
+                LOG_ERROR << "Mention inbox flush failed: " << e.what();
+            }
+            lock.lock();
+        }
+    }
+} // namespace nuansa::handler
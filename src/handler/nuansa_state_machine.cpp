@@ -5,11 +5,17 @@
 
 #include "nuansa/utils/pch.h"
 
+#include "nuansa/handler/mention_dispatcher.h"
+#include "nuansa/handler/presence_service.h"
 #include "nuansa/handler/websocket_client.h"
+#include "nuansa/handler/websocket_handler.h"
 #include "nuansa/handler/websocket_state_machine.h"
 #include "nuansa/services/auth/auth_service.h"
+#include "nuansa/services/auth/auth_rate_limiter.h"
 #include "nuansa/services/auth/register_message.h"
 #include "nuansa/messages/message_types.h"
+#include "nuansa/utils/pattern/concurrency_limiter.h"
+#include "nuansa/utils/trace/tracer.h"
 
 using namespace nuansa::messages;
 using namespace nuansa::utils::common;
@@ -62,21 +68,55 @@ namespace nuansa::handler {
 
     void WebSocketStateMachine::HandleAuthMessage(const nlohmann::json &msgData) {
         LOG_DEBUG << "WebSocketStateMachine::HandleAuthMessage";
+
+        // Login carries the username at the top level, custom registration in the body
+        std::string username = msgData.value("username", "");
+        if (username.empty() && msgData.contains(MESSAGE_BODY) && msgData[MESSAGE_BODY].is_object()) {
+            username = msgData[MESSAGE_BODY].value("username", "");
+        }
+        if (!nuansa::services::auth::AuthRateLimiter::GetInstance().Allow(client->remoteAddress, username)) {
+            const nlohmann::json errorJson = {
+                {"type", "error"},
+                {"code", "rate_limited"},
+                {"message", "Too many authentication attempts, please try again later"}
+            };
+            SendMessage(errorJson.dump());
+            return;
+        }
+
+        // Login and registration end up on the database; shed them up front when it is saturated
+        auto &limiter = nuansa::utils::pattern::ConcurrencyLimiter::GetInstance();
+        auto permit = limiter.TryAcquire();
+        if (!permit) {
+            LOG_WARNING << "Shedding auth request: " << limiter.InFlight() << " in flight, limit " << limiter.Limit();
+            SendMessage(WebSocketHandler::BuildOverloadedMessage(limiter.RetryAfter()));
+            return;
+        }
+
+        auto outcome = AuthOutcome::Failed;
         if (const auto type = msgData[MESSAGE_HEADER][MESSAGE_HEADER_MESSAGE_TYPE].get<nuansa::messages::MessageType>();
             type == nuansa::messages::MessageType::Register) {
-            HandleRegistration(msgData);
+            outcome = HandleRegistration(msgData);
             TransitionTo(ClientState::AwaitingAuth);
         } else if (type == nuansa::messages::MessageType::Login) {
-            if (HandleLogin(msgData)) {
+            outcome = HandleLogin(msgData);
+            if (outcome == AuthOutcome::Succeeded) {
                 TransitionTo(ClientState::Authenticated);
                 AddAuthenticatedClient();
             } else {
                 TransitionTo(ClientState::AwaitingAuth);
             }
         }
+
+        // Only completed requests measure the database; overload answers make the limit back off
+        if (outcome == AuthOutcome::Overloaded) {
+            permit->Dropped();
+        } else {
+            permit->Success();
+        }
     }
 
-    void WebSocketStateMachine::HandleRegistration(const nlohmann::json &msgData) const {
+    AuthOutcome WebSocketStateMachine::HandleRegistration(const nlohmann::json &msgData) const {
         try {
             LOG_DEBUG << "Getting message header";
             auto messageHeader = nuansa::messages::MessageHeader::FromJson(msgData[MESSAGE_HEADER]);
@@ -175,6 +215,9 @@ namespace nuansa::handler {
             }
 
             SendMessage(responseJson.dump());
+            return response.IsSuccess()
+                       ? AuthOutcome::Succeeded
+                       : response.IsOverloaded() ? AuthOutcome::Overloaded : AuthOutcome::Failed;
         } catch (const std::exception& e) {
             LOG_ERROR << "Error during registration: " << e.what();
 
@@ -195,6 +238,7 @@ namespace nuansa::handler {
                 }
             };
             SendMessage(errorResponse.dump());
+            return AuthOutcome::Failed;
         }
     }
 
@@ -202,7 +246,7 @@ namespace nuansa::handler {
     void WebSocketStateMachine::HandleAuth(const std::string &message) {
     }
 
-    bool WebSocketStateMachine::HandleLogin(const nlohmann::json &msgData) const {
+    AuthOutcome WebSocketStateMachine::HandleLogin(const nlohmann::json &msgData) const {
         try {
             auto username = msgData["username"].get<std::string>();
             auto password = msgData["password"].get<std::string>();
@@ -217,7 +261,7 @@ namespace nuansa::handler {
 
             // Get auth service instance and authenticate
             auto &authService = nuansa::services::auth::AuthService::GetInstance();
-            auto [success, token, message] = authService.Authenticate(authRequest);
+            auto [success, token, message, overloaded] = authService.Authenticate(authRequest);
 
             // Prepare response JSON
             nlohmann::json response = {
@@ -239,7 +283,7 @@ namespace nuansa::handler {
 
                 // Send success response
                 SendMessage(response.dump());
-                return true;
+                return AuthOutcome::Succeeded;
             } else {
                 LOG_WARNING << "Authentication failed for user: " << username;
 
@@ -249,7 +293,7 @@ namespace nuansa::handler {
 
                 // Send failure response
                 SendMessage(response.dump());
-                return false;
+                return overloaded ? AuthOutcome::Overloaded : AuthOutcome::Failed;
             }
         } catch (const std::exception &e) {
             LOG_ERROR << "Error during login: " << e.what();
@@ -261,7 +305,7 @@ namespace nuansa::handler {
                 {"message", "Internal server error during login"}
             };
             SendMessage(errorResponse.dump());
-            return false;
+            return AuthOutcome::Failed;
         }
     }
 
@@ -272,13 +316,13 @@ namespace nuansa::handler {
             return;
         }
 
+        nuansa::utils::trace::Span span("websocket.send");
         try {
-            const auto ws = client->GetWebSocket();
-            ws->text(true);
-            ws->write(net::buffer(msgData));
+            client->Write(msgData);
 
             LOG_DEBUG << "Message sent: " << msgData;
         } catch (const std::exception &e) {
+            span.SetError();
             LOG_ERROR << "Error sending message: " << e.what();
         }
     }
@@ -293,6 +337,18 @@ namespace nuansa::handler {
     }
 
     void WebSocketStateMachine::HandleAuthenticatedState(const nlohmann::json &msgData) {
+        try {
+            WebSocketHandler::ValidateMessageFormat(msgData);
+        } catch (const std::invalid_argument &e) {
+            const nlohmann::json errorJson = {
+                {"type", "error"},
+                {"code", "invalid_message"},
+                {"message", e.what()}
+            };
+            SendMessage(errorJson.dump());
+            return;
+        }
+
         switch (msgData["type"].get<nuansa::messages::MessageType>()) {
             case nuansa::messages::MessageType::Logout:
                 HandleLogout();
@@ -315,6 +371,18 @@ namespace nuansa::handler {
                 HandleDirectMessage(msgData);
                 break;
 
+            case nuansa::messages::MessageType::PresenceSubscribe:
+                HandlePresenceSubscribe(msgData);
+                break;
+
+            case nuansa::messages::MessageType::PresenceUnsubscribe:
+                HandlePresenceUnsubscribe(msgData);
+                break;
+
+            case nuansa::messages::MessageType::Typing:
+                // Handled by the session loop before the frame is parsed
+                break;
+
             default:
                 LOG_WARNING << "Unhandled message type";
                 break;
@@ -334,8 +402,27 @@ namespace nuansa::handler {
         // Implement logout logic
     }
 
-    void WebSocketStateMachine::HandleNewMessage(const nlohmann::json &msgData) {
-        // Implement new message handling
+    void WebSocketStateMachine::HandleNewMessage(const nlohmann::json &msgData) const {
+        Message message;
+        message.sender = client->username;
+        // ValidateMessageFormat has checked that content is a string
+        message.content = msgData.at("content").get<std::string>();
+        message.timestamp = std::time(nullptr);
+
+        // The client's message id identifies the message in notifications and the inbox
+        if (const auto header = msgData.find(MESSAGE_HEADER);
+            header != msgData.end() && header->is_object() && header->contains(MESSAGE_HEADER_MESSAGE_ID) &&
+            header->at(MESSAGE_HEADER_MESSAGE_ID).is_string()) {
+            message.id = header->at(MESSAGE_HEADER_MESSAGE_ID).get<std::string>();
+        } else {
+            message.id = boost::uuids::to_string(boost::uuids::random_generator()());
+        }
+
+        for (const auto mention: WebSocketHandler::ExtractMentions(message.content)) {
+            message.mentions.emplace_back(mention);
+        }
+
+        MentionDispatcher::GetInstance().Dispatch(message, *websocketServer);
     }
 
     void WebSocketStateMachine::SendErrorMessage(const std::string &msgData) {
@@ -358,8 +445,26 @@ namespace nuansa::handler {
     void WebSocketStateMachine::HandlePluginMessage(const nlohmann::json &msgData) {
     }
 
-    void WebSocketStateMachine::AddAuthenticatedClient() {
-        // Implement client authentication logic
+    void WebSocketStateMachine::HandlePresenceSubscribe(const nlohmann::json &msgData) const {
+        auto &presence = PresenceService::GetInstance();
+        if (msgData.contains("rooms")) {
+            presence.JoinRooms(client, msgData["rooms"].get<std::vector<std::string> >());
+        }
+        if (msgData.contains("contacts")) {
+            presence.SetContacts(client, msgData["contacts"].get<std::vector<std::string> >());
+        }
+    }
+
+    void WebSocketStateMachine::HandlePresenceUnsubscribe(const nlohmann::json &msgData) const {
+        if (msgData.contains("rooms")) {
+            PresenceService::GetInstance().LeaveRooms(client, msgData["rooms"].get<std::vector<std::string> >());
+        }
+    }
+
+    void WebSocketStateMachine::AddAuthenticatedClient() const {
+        websocketServer->AddClient(client->username, client);
+        PresenceService::GetInstance().Connect(client);
+        MentionDispatcher::GetInstance().DeliverInbox(client);
     }
 
     void WebSocketStateMachine::SendAuthRequiredMessage() {
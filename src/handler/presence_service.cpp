@@ -0,0 +1,519 @@
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/handler/presence_service.h"
+#include "nuansa/utils/metrics/metrics.h"
+
+namespace nuansa::handler {
+    namespace {
+        struct PresenceMetrics {
+            utils::metrics::Gauge &online;
+            utils::metrics::Counter &snapshots;
+            utils::metrics::Counter &deltas;
+            utils::metrics::Counter &deltaRecipients;
+            utils::metrics::Counter &dropped;
+            utils::metrics::Histogram &flushDuration;
+        };
+
+        PresenceMetrics &Metrics() {
+            static PresenceMetrics metrics = [] {
+                auto &registry = utils::metrics::MetricsRegistry::GetInstance();
+                return PresenceMetrics{
+                    .online = registry.GetGauge("nuansa_presence_online_users", "Users currently online"),
+                    .snapshots = registry.GetCounter("nuansa_presence_snapshots_total",
+                                                     "Presence snapshots queued for clients"),
+                    .deltas = registry.GetCounter("nuansa_presence_deltas_total",
+                                                  "Presence deltas published, one per scope and window"),
+                    .deltaRecipients = registry.GetCounter("nuansa_presence_delta_recipients_total",
+                                                           "Clients presence deltas were queued for"),
+                    .dropped = registry.GetCounter("nuansa_presence_frames_dropped_total",
+                                                   "Presence frames dropped because a send queue was full"),
+                    .flushDuration = registry.GetHistogram("nuansa_presence_flush_duration_seconds",
+                                                           "Time to build and queue one window of deltas", {}, 1e-6)
+                };
+            }();
+            return metrics;
+        }
+
+        constexpr size_t MAX_ROOM_NAME_BYTES = 64;
+        constexpr std::string_view ROOM_SCOPE_PREFIX = "room:";
+        constexpr std::string_view CONTACTS_SCOPE = "contacts";
+
+        std::string RoomScope(const std::string_view room) {
+            std::string scope(ROOM_SCOPE_PREFIX);
+            scope += room;
+            return scope;
+        }
+
+        // Splits a window's changes into who came online and who went offline since the last delta
+        template<typename IsOnline>
+        void CollectChanges(const std::unordered_map<std::string, bool> &pending, IsOnline &&isOnline,
+                            std::vector<std::string_view> &online, std::vector<std::string_view> &offline) {
+            for (const auto &[username, wasOnline]: pending) {
+                if (const bool nowOnline = isOnline(username); nowOnline != wasOnline) {
+                    (nowOnline ? online : offline).emplace_back(username);
+                }
+            }
+        }
+
+        struct Delta {
+            std::shared_ptr<const std::string> frame;
+            std::vector<std::shared_ptr<WebSocketClient> > audience;
+        };
+    }
+
+    PresenceService &PresenceService::GetInstance() {
+        static PresenceService instance;
+        return instance;
+    }
+
+    PresenceService::~PresenceService() {
+        Shutdown();
+    }
+
+    void PresenceService::Configure(const PresenceSettings &settings) {
+        Shutdown();
+
+        settings_ = settings;
+        delivery_.Start(utils::pattern::WorkerPoolSettings{
+            .name = "presence-delivery",
+            .threadCount = std::max<size_t>(1, settings_.deliveryThreads),
+            .queueCapacity = std::max<size_t>(1, settings_.deliveryQueueCapacity)
+        });
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = false;
+        }
+        thread_ = std::thread([this] { Run(); });
+    }
+
+    void PresenceService::Shutdown() {
+        if (thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_one();
+            thread_.join();
+            Flush();
+        }
+        delivery_.Shutdown();
+    }
+
+    bool PresenceService::IsValidRoomName(const std::string_view room) {
+        if (room.empty() || room.size() > MAX_ROOM_NAME_BYTES) {
+            return false;
+        }
+        return std::ranges::all_of(room, [](const char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-' || c == '.';
+        });
+    }
+
+    bool PresenceService::IsOnline(const std::string &username) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return clients_.contains(username);
+    }
+
+    std::shared_ptr<WebSocketClient> PresenceService::FindClient(const std::string &username) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = clients_.find(username);
+        return it != clients_.end() ? it->second : nullptr;
+    }
+
+    std::optional<std::vector<std::shared_ptr<WebSocketClient> > > PresenceService::RoomPeers(
+        const std::string &room, const std::string &username, const size_t maxPeers) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = rooms_.find(room);
+        if (it == rooms_.end() || !it->second.members.contains(username) || it->second.members.size() > maxPeers + 1) {
+            return std::nullopt;
+        }
+
+        std::vector<std::shared_ptr<WebSocketClient> > peers;
+        peers.reserve(it->second.members.size() - 1);
+        for (const auto &member: it->second.members) {
+            if (member == username) {
+                continue;
+            }
+            if (const auto client = clients_.find(member); client != clients_.end()) {
+                peers.push_back(client->second);
+            }
+        }
+        return peers;
+    }
+
+    void PresenceService::Connect(const std::shared_ptr<WebSocketClient> &client) {
+        if (!client || client->username.empty()) {
+            return;
+        }
+
+        Flushes flushes;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto &username = client->username;
+
+            // A second login takes over the user's scopes; the others see no change
+            if (const auto [it, inserted] = clients_.insert_or_assign(username, client); inserted) {
+                Metrics().online.Set(static_cast<int64_t>(clients_.size()));
+                NotifyWatchers(username, true);
+                if (!settings_.defaultRoom.empty()) {
+                    JoinRoom(username, settings_.defaultRoom);
+                }
+            }
+
+            if (const auto rooms = roomsByUser_.find(username); rooms != roomsByUser_.end()) {
+                for (const auto &room: rooms->second) {
+                    QueueRoomSnapshot(client, room, flushes);
+                }
+            }
+            if (contactLists_.contains(username)) {
+                QueueContactSnapshot(client, flushes);
+            }
+        }
+        Schedule(flushes);
+    }
+
+    void PresenceService::Disconnect(const std::shared_ptr<WebSocketClient> &client) {
+        if (!client) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!IsCurrent(client)) {
+            return;
+        }
+
+        const auto username = client->username;
+        if (const auto rooms = roomsByUser_.find(username); rooms != roomsByUser_.end()) {
+            for (const auto joined = rooms->second; const auto &room: joined) {
+                LeaveRoom(username, room);
+            }
+            roomsByUser_.erase(username);
+        }
+        ClearContacts(username);
+
+        clients_.erase(username);
+        Metrics().online.Set(static_cast<int64_t>(clients_.size()));
+        NotifyWatchers(username, false);
+    }
+
+    std::vector<std::string> PresenceService::JoinRooms(const std::shared_ptr<WebSocketClient> &client,
+                                                        const std::vector<std::string> &rooms) {
+        std::vector<std::string> joined;
+        Flushes flushes;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!client || !IsCurrent(client)) {
+                return joined;
+            }
+
+            for (const auto &room: rooms) {
+                if (IsValidRoomName(room) && JoinRoom(client->username, room)) {
+                    QueueRoomSnapshot(client, room, flushes);
+                    joined.push_back(room);
+                }
+            }
+        }
+        Schedule(flushes);
+        return joined;
+    }
+
+    void PresenceService::LeaveRooms(const std::shared_ptr<WebSocketClient> &client,
+                                     const std::vector<std::string> &rooms) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!client || !IsCurrent(client)) {
+            return;
+        }
+        for (const auto &room: rooms) {
+            LeaveRoom(client->username, room);
+        }
+    }
+
+    void PresenceService::SetContacts(const std::shared_ptr<WebSocketClient> &client,
+                                      const std::vector<std::string> &contacts) {
+        Flushes flushes;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!client || !IsCurrent(client)) {
+                return;
+            }
+
+            const auto &owner = client->username;
+            auto &list = contactLists_[owner];
+            for (const auto &contact: list.contacts) {
+                if (const auto it = watchers_.find(contact); it != watchers_.end()) {
+                    it->second.erase(owner);
+                    if (it->second.empty()) {
+                        watchers_.erase(it);
+                    }
+                }
+            }
+            list.contacts.clear();
+            list.pending.clear();
+            dirtyContactLists_.erase(owner);
+
+            for (const auto &contact: contacts) {
+                if (list.contacts.size() >= settings_.maxContacts) {
+                    break;
+                }
+                if (!contact.empty() && contact != owner && list.contacts.insert(contact).second) {
+                    watchers_[contact].insert(owner);
+                }
+            }
+
+            // The new list starts from a snapshot; the version keeps counting so stale deltas stay recognizable
+            ++list.version;
+            QueueContactSnapshot(client, flushes);
+        }
+        Schedule(flushes);
+    }
+
+    void PresenceService::SendSnapshots(const std::shared_ptr<WebSocketClient> &client) {
+        Flushes flushes;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!client || !IsCurrent(client)) {
+                return;
+            }
+            if (const auto rooms = roomsByUser_.find(client->username); rooms != roomsByUser_.end()) {
+                for (const auto &room: rooms->second) {
+                    QueueRoomSnapshot(client, room, flushes);
+                }
+            }
+            if (contactLists_.contains(client->username)) {
+                QueueContactSnapshot(client, flushes);
+            }
+        }
+        Schedule(flushes);
+    }
+
+    size_t PresenceService::Flush() {
+        std::lock_guard<std::mutex> flushLock(flushMutex_);
+        auto &metrics = Metrics();
+        const utils::metrics::ScopedTimer timer(metrics.flushDuration);
+
+        std::vector<Delta> deltas;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::vector<std::string_view> online;
+            std::vector<std::string_view> offline;
+
+            for (const auto &name: dirtyRooms_) {
+                const auto it = rooms_.find(name);
+                if (it == rooms_.end()) {
+                    continue;
+                }
+                auto &room = it->second;
+
+                online.clear();
+                offline.clear();
+                CollectChanges(room.pending, [&](const std::string &username) {
+                    return room.members.contains(username);
+                }, online, offline);
+
+                if (!online.empty() || !offline.empty()) {
+                    Delta delta{BuildDelta(RoomScope(name), ++room.version, online, offline), {}};
+                    delta.audience.reserve(room.members.size());
+                    for (const auto &member: room.members) {
+                        if (const auto client = clients_.find(member); client != clients_.end()) {
+                            delta.audience.push_back(client->second);
+                        }
+                    }
+                    deltas.push_back(std::move(delta));
+                }
+                room.pending.clear();
+
+                if (room.members.empty()) {
+                    rooms_.erase(it);
+                }
+            }
+            dirtyRooms_.clear();
+
+            for (const auto &owner: dirtyContactLists_) {
+                const auto it = contactLists_.find(owner);
+                if (it == contactLists_.end()) {
+                    continue;
+                }
+                auto &list = it->second;
+
+                online.clear();
+                offline.clear();
+                CollectChanges(list.pending, [&](const std::string &username) {
+                    return clients_.contains(username);
+                }, online, offline);
+
+                if (!online.empty() || !offline.empty()) {
+                    if (const auto client = clients_.find(owner); client != clients_.end()) {
+                        deltas.push_back(Delta{
+                            BuildDelta(CONTACTS_SCOPE, ++list.version, online, offline), {client->second}
+                        });
+                    }
+                }
+                list.pending.clear();
+            }
+            dirtyContactLists_.clear();
+        }
+
+        // Queued outside the lock; flushMutex_ keeps a later window from overtaking this one
+        for (const auto &delta: deltas) {
+            for (const auto &client: delta.audience) {
+                if (delivery_.Deliver(client, delta.frame)) {
+                    metrics.deltaRecipients.Increment();
+                } else {
+                    metrics.dropped.Increment();
+                }
+            }
+        }
+        metrics.deltas.Increment(deltas.size());
+        return deltas.size();
+    }
+
+    bool PresenceService::IsCurrent(const std::shared_ptr<WebSocketClient> &client) const {
+        const auto it = clients_.find(client->username);
+        return it != clients_.end() && it->second == client;
+    }
+
+    void PresenceService::NotifyWatchers(const std::string &username, const bool online) {
+        const auto it = watchers_.find(username);
+        if (it == watchers_.end()) {
+            return;
+        }
+        for (const auto &owner: it->second) {
+            if (const auto list = contactLists_.find(owner); list != contactLists_.end()) {
+                list->second.pending.try_emplace(username, !online);
+                dirtyContactLists_.insert(owner);
+            }
+        }
+    }
+
+    bool PresenceService::JoinRoom(const std::string &username, const std::string &room) {
+        auto &joined = roomsByUser_[username];
+        if (joined.contains(room)) {
+            return true;
+        }
+        if (joined.size() >= settings_.maxRoomsPerUser) {
+            return false;
+        }
+        joined.insert(room);
+
+        auto &state = rooms_[room];
+        state.members.insert(username);
+        state.pending.try_emplace(username, false);
+        dirtyRooms_.insert(room);
+        return true;
+    }
+
+    void PresenceService::LeaveRoom(const std::string &username, const std::string &room) {
+        if (const auto joined = roomsByUser_.find(username); joined != roomsByUser_.end()) {
+            joined->second.erase(room);
+        }
+
+        const auto it = rooms_.find(room);
+        if (it == rooms_.end() || !it->second.members.erase(username)) {
+            return;
+        }
+        it->second.pending.try_emplace(username, true);
+        dirtyRooms_.insert(room);
+    }
+
+    void PresenceService::ClearContacts(const std::string &username) {
+        const auto it = contactLists_.find(username);
+        if (it == contactLists_.end()) {
+            return;
+        }
+        for (const auto &contact: it->second.contacts) {
+            if (const auto watching = watchers_.find(contact); watching != watchers_.end()) {
+                watching->second.erase(username);
+                if (watching->second.empty()) {
+                    watchers_.erase(watching);
+                }
+            }
+        }
+        contactLists_.erase(it);
+        dirtyContactLists_.erase(username);
+    }
+
+    void PresenceService::QueueSnapshot(const std::shared_ptr<WebSocketClient> &client,
+                                        std::shared_ptr<const std::string> frame, Flushes &flushes) {
+        switch (client->QueueFrame(std::move(frame))) {
+            case WebSocketClient::QueueResult::NeedsFlush:
+                flushes.push_back(client);
+                [[fallthrough]];
+            case WebSocketClient::QueueResult::Queued:
+                Metrics().snapshots.Increment();
+                break;
+            default:
+                Metrics().dropped.Increment();
+                break;
+        }
+    }
+
+    void PresenceService::QueueRoomSnapshot(const std::shared_ptr<WebSocketClient> &client, const std::string &room,
+                                            Flushes &flushes) {
+        const auto it = rooms_.find(room);
+        if (it == rooms_.end()) {
+            return;
+        }
+        std::vector<std::string_view> online(it->second.members.begin(), it->second.members.end());
+        QueueSnapshot(client, BuildSnapshot(RoomScope(room), it->second.version, online), flushes);
+    }
+
+    void PresenceService::QueueContactSnapshot(const std::shared_ptr<WebSocketClient> &client, Flushes &flushes) {
+        const auto it = contactLists_.find(client->username);
+        if (it == contactLists_.end()) {
+            return;
+        }
+        std::vector<std::string_view> online;
+        for (const auto &contact: it->second.contacts) {
+            if (clients_.contains(contact)) {
+                online.emplace_back(contact);
+            }
+        }
+        QueueSnapshot(client, BuildSnapshot(CONTACTS_SCOPE, it->second.version, online), flushes);
+    }
+
+    void PresenceService::Schedule(const Flushes &flushes) {
+        for (const auto &client: flushes) {
+            delivery_.Schedule(client);
+        }
+    }
+
+    std::shared_ptr<const std::string> PresenceService::BuildSnapshot(const std::string_view scope,
+                                                                      const uint64_t version,
+                                                                      const std::vector<std::string_view> &online) {
+        const nlohmann::json snapshot = {
+            {"type", "presence_snapshot"},
+            {"scope", scope},
+            {"version", version},
+            {"online", online}
+        };
+        return std::make_shared<const std::string>(snapshot.dump());
+    }
+
+    std::shared_ptr<const std::string> PresenceService::BuildDelta(const std::string_view scope,
+                                                                   const uint64_t version,
+                                                                   const std::vector<std::string_view> &online,
+                                                                   const std::vector<std::string_view> &offline) {
+        const nlohmann::json delta = {
+            {"type", "presence_delta"},
+            {"scope", scope},
+            {"version", version},
+            {"online", online},
+            {"offline", offline}
+        };
+        return std::make_shared<const std::string>(delta.dump());
+    }
+
+    void PresenceService::Run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            wake_.wait_for(lock, settings_.window, [this] { return stopping_; });
+            lock.unlock();
+            try {
+                Flush();
+            } catch (const std::exception &e) {
+                LOG_ERROR << "Presence flush failed: " << e.what();
+            }
+            lock.lock();
+        }
+    }
+} // namespace nuansa::handler
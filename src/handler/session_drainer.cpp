@@ -0,0 +1,134 @@
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/handler/session_drainer.h"
+#include "nuansa/handler/frame_delivery.h"
+#include "nuansa/utils/metrics/metrics.h"
+
+namespace nuansa::handler {
+    namespace {
+        struct DrainMetrics {
+            utils::metrics::Counter &hinted;
+            utils::metrics::Counter &terminated;
+            utils::metrics::Histogram &duration;
+        };
+
+        DrainMetrics &Metrics() {
+            static DrainMetrics metrics = [] {
+                auto &registry = utils::metrics::MetricsRegistry::GetInstance();
+                return DrainMetrics{
+                    .hinted = registry.GetCounter("nuansa_drain_reconnect_hints_total",
+                                                  "Sessions told to reconnect while the server stopped"),
+                    .terminated = registry.GetCounter("nuansa_drain_terminated_sessions_total",
+                                                      "Sessions cut off because they did not close in time"),
+                    .duration = registry.GetHistogram("nuansa_drain_duration_seconds",
+                                                      "Time from the start of a drain until every session ended",
+                                                      {}, 1e-6)
+                };
+            }();
+            return metrics;
+        }
+
+        // How long sessions get to notice their socket was shut down
+        constexpr auto TERMINATE_WAIT = std::chrono::seconds(1);
+    }
+
+    SessionDrainer &SessionDrainer::GetInstance() {
+        static SessionDrainer instance;
+        return instance;
+    }
+
+    void SessionDrainer::Register(const std::shared_ptr<WebSocketClient> &client) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions_.insert(client);
+        if (draining_) {
+            client->RequestClose();
+        }
+    }
+
+    void SessionDrainer::Unregister(const std::shared_ptr<WebSocketClient> &client) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sessions_.erase(client);
+        }
+        ended_.notify_all();
+    }
+
+    bool SessionDrainer::IsDraining() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return draining_;
+    }
+
+    size_t SessionDrainer::ActiveSessions() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return sessions_.size();
+    }
+
+    std::string SessionDrainer::BuildReconnectMessage(const std::chrono::milliseconds retryAfter) {
+        const nlohmann::json reconnectMsg = {
+            {"type", "reconnect"},
+            {"reason", "server_shutdown"},
+            {"retryAfterMs", retryAfter.count()}
+        };
+        return reconnectMsg.dump();
+    }
+
+    size_t SessionDrainer::Drain(const DrainSettings &settings) {
+        const auto start = Clock::now();
+        std::vector<std::shared_ptr<WebSocketClient> > sessions;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            draining_ = true;
+            sessions.assign(sessions_.begin(), sessions_.end());
+        }
+        LOG_INFO << "Draining " << sessions.size() << " sessions over " << settings.window.count() << "ms";
+
+        FrameDelivery delivery;
+        delivery.Start(utils::pattern::WorkerPoolSettings{
+            .name = "session-drain",
+            .threadCount = std::max<size_t>(1, settings.deliveryThreads),
+            .queueCapacity = std::max<size_t>(1, sessions.size())
+        });
+
+        auto &metrics = Metrics();
+        std::mt19937 random(std::random_device{}());
+        std::uniform_int_distribution<int64_t> jitter(0, std::max<int64_t>(0, settings.reconnectJitter.count()));
+        const auto step = sessions.empty() ? Clock::duration::zero() : settings.window / sessions.size();
+
+        for (size_t i = 0; i < sessions.size(); ++i) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ended_.wait_until(lock, start + step * i, [this] { return sessions_.empty(); });
+                if (sessions_.empty()) {
+                    break;
+                }
+                if (!sessions_.contains(sessions[i])) {
+                    continue;
+                }
+            }
+
+            const auto &client = sessions[i];
+            client->RequestClose();
+            delivery.Deliver(client, std::make_shared<const std::string>(
+                                 BuildReconnectMessage(std::chrono::milliseconds(jitter(random)))));
+            metrics.hinted.Increment();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!ended_.wait_until(lock, start + settings.window + settings.grace, [this] { return sessions_.empty(); })) {
+            LOG_WARNING << "Cutting off " << sessions_.size() << " sessions that did not close";
+            metrics.terminated.Increment(sessions_.size());
+            for (const auto &client: sessions_) {
+                client->Terminate();
+            }
+            ended_.wait_for(lock, TERMINATE_WAIT, [this] { return sessions_.empty(); });
+        }
+        const auto remaining = sessions_.size();
+        lock.unlock();
+
+        delivery.Shutdown();
+        metrics.duration.Record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count()));
+        LOG_INFO << "Drain finished with " << remaining << " sessions left";
+        return remaining;
+    }
+} // namespace nuansa::handler
@@ -0,0 +1,414 @@
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/handler/typing_service.h"
+#include "nuansa/utils/json_string.h"
+#include "nuansa/utils/metrics/metrics.h"
+
+namespace nuansa::handler {
+    namespace {
+        struct TypingMetrics {
+            utils::metrics::Counter &events;
+            utils::metrics::Counter &suppressed;
+            utils::metrics::Counter &sent;
+            utils::metrics::Counter &dropped;
+        };
+
+        TypingMetrics &Metrics() {
+            static TypingMetrics metrics = [] {
+                auto &registry = utils::metrics::MetricsRegistry::GetInstance();
+                return TypingMetrics{
+                    .events = registry.GetCounter("nuansa_typing_events_total", "Typing events received from clients"),
+                    .suppressed = registry.GetCounter("nuansa_typing_events_suppressed_total",
+                                                      "Typing events that repeated the last state or were held"),
+                    .sent = registry.GetCounter("nuansa_typing_indicators_sent_total",
+                                                "Typing indicators queued, one per audience"),
+                    .dropped = registry.GetCounter("nuansa_typing_frames_dropped_total",
+                                                   "Typing frames dropped because a send queue was full")
+                };
+            }();
+            return metrics;
+        }
+
+        constexpr std::string_view ROOM_SCOPE_PREFIX = "room:";
+        constexpr std::string_view USER_SCOPE_PREFIX = "user:";
+
+        // Reads the top-level fields of a typing event, giving up as soon as the type says it is something else
+        class TypingFrameReader final : public nlohmann::json::json_sax_t {
+        public:
+            bool null() override {
+                return Scalar();
+            }
+
+            bool boolean(const bool value) override {
+                if (field_ == Field::IsTyping && depth_ == 1) {
+                    event.typing = value;
+                    hasState_ = true;
+                    field_ = Field::None;
+                }
+                return Scalar();
+            }
+
+            bool number_integer(nlohmann::json::number_integer_t) override {
+                return Scalar();
+            }
+
+            bool number_unsigned(nlohmann::json::number_unsigned_t) override {
+                return Scalar();
+            }
+
+            bool number_float(nlohmann::json::number_float_t, const nlohmann::json::string_t &) override {
+                return Scalar();
+            }
+
+            bool string(nlohmann::json::string_t &value) override {
+                if (depth_ == 1) {
+                    switch (field_) {
+                        case Field::Type:
+                            if (value != "typing") {
+                                return false;
+                            }
+                            isTypingFrame = true;
+                            field_ = Field::None;
+                            break;
+                        case Field::Room:
+                            event.room = std::move(value);
+                            field_ = Field::None;
+                            break;
+                        case Field::Recipient:
+                            event.recipient = std::move(value);
+                            field_ = Field::None;
+                            break;
+                        default:
+                            break;
+                    }
+                }
+                return Scalar();
+            }
+
+            bool binary(nlohmann::json::binary_t &) override {
+                return Scalar();
+            }
+
+            bool start_object(std::size_t) override {
+                return Nested();
+            }
+
+            bool end_object() override {
+                --depth_;
+                return true;
+            }
+
+            bool start_array(std::size_t) override {
+                // Only an object can be a typing event
+                return depth_ > 0 && Nested();
+            }
+
+            bool end_array() override {
+                --depth_;
+                return true;
+            }
+
+            bool key(nlohmann::json::string_t &name) override {
+                if (depth_ == 1) {
+                    field_ = name == "type"
+                                 ? Field::Type
+                                 : name == "room"
+                                       ? Field::Room
+                                       : name == "recipient"
+                                             ? Field::Recipient
+                                             : name == "isTyping"
+                                                   ? Field::IsTyping
+                                                   : Field::None;
+                }
+                return true;
+            }
+
+            bool parse_error(std::size_t, const std::string &, const nlohmann::json::exception &) override {
+                return false;
+            }
+
+            bool Valid() const {
+                return !malformed_ && hasState_;
+            }
+
+            TypingEvent event;
+            bool isTypingFrame{false};
+
+        private:
+            enum class Field { None, Type, Room, Recipient, IsTyping };
+
+            // A field this reader cares about holding a value of the wrong kind; the type must be a string
+            bool Scalar() {
+                if (depth_ == 0) {
+                    return false;
+                }
+                if (depth_ == 1 && field_ != Field::None) {
+                    if (field_ == Field::Type) {
+                        return false;
+                    }
+                    malformed_ = true;
+                    field_ = Field::None;
+                }
+                return true;
+            }
+
+            bool Nested() {
+                if (depth_ == 1 && field_ != Field::None) {
+                    if (field_ == Field::Type) {
+                        return false;
+                    }
+                    malformed_ = true;
+                    field_ = Field::None;
+                }
+                ++depth_;
+                return true;
+            }
+
+            size_t depth_{0};
+            Field field_{Field::None};
+            bool hasState_{false};
+            bool malformed_{false};
+        };
+    }
+
+    TypingService &TypingService::GetInstance() {
+        static TypingService instance;
+        return instance;
+    }
+
+    TypingService::~TypingService() {
+        Shutdown();
+    }
+
+    void TypingService::Configure(const TypingSettings &settings) {
+        Shutdown();
+
+        settings_ = settings;
+        delivery_.Start(utils::pattern::WorkerPoolSettings{
+            .name = "typing-delivery",
+            .threadCount = std::max<size_t>(1, settings_.deliveryThreads),
+            .queueCapacity = std::max<size_t>(1, settings_.deliveryQueueCapacity)
+        });
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = false;
+        }
+        thread_ = std::thread([this] { Run(); });
+    }
+
+    void TypingService::Shutdown() {
+        if (thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_one();
+            thread_.join();
+        }
+        delivery_.Shutdown();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        indicators_.clear();
+    }
+
+    std::optional<TypingEvent> TypingService::ParseFrame(const std::string_view frame) {
+        // Most frames are not typing events and never reach the reader
+        if (frame.find("typing") == std::string_view::npos) {
+            return std::nullopt;
+        }
+
+        TypingFrameReader reader;
+        if (!nlohmann::json::sax_parse(frame.begin(), frame.end(), &reader) || !reader.isTypingFrame) {
+            return std::nullopt;
+        }
+        if (!reader.Valid()) {
+            return TypingEvent{};
+        }
+        return std::move(reader.event);
+    }
+
+    std::string TypingService::BuildFrame(const std::string_view username, const std::string_view room,
+                                          const bool typing) {
+        std::string frame;
+        frame.reserve(64 + username.size() + room.size());
+        frame += R"({"type":"typing","username":)";
+        utils::AppendJsonString(username, frame);
+        if (!room.empty()) {
+            frame += R"(,"room":)";
+            utils::AppendJsonString(room, frame);
+        }
+        frame += typing ? R"(,"isTyping":true})" : R"(,"isTyping":false})";
+        return frame;
+    }
+
+    TypingResult TypingService::Publish(const std::shared_ptr<WebSocketClient> &client, const TypingEvent &event,
+                                        const Clock::time_point now) {
+        auto &metrics = Metrics();
+        metrics.events.Increment();
+        if (!client || client->username.empty()) {
+            return TypingResult::Rejected;
+        }
+
+        const auto &username = client->username;
+        std::string scope;
+        if (event.recipient.empty() && PresenceService::IsValidRoomName(event.room)) {
+            scope = std::string(ROOM_SCOPE_PREFIX) + event.room;
+        } else if (event.room.empty() && !event.recipient.empty() && event.recipient != username) {
+            scope = std::string(USER_SCOPE_PREFIX) + event.recipient;
+        } else {
+            return TypingResult::Rejected;
+        }
+
+        TypingResult result;
+        std::vector<std::shared_ptr<WebSocketClient> > flushes;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto &indicators = indicators_[username];
+            auto &indicator = indicators[scope];
+            indicator.latest = event.typing;
+            indicator.updatedAt = now;
+
+            if (indicator.latest == indicator.sent) {
+                result = TypingResult::Duplicate;
+            } else if (now - indicator.sentAt < settings_.window) {
+                result = TypingResult::Held;
+            } else if (Send(username, scope, indicator, now, flushes)) {
+                result = TypingResult::Sent;
+            } else {
+                result = TypingResult::Rejected;
+                indicators.erase(scope);
+                if (indicators.empty()) {
+                    indicators_.erase(username);
+                }
+            }
+        }
+
+        for (const auto &recipient: flushes) {
+            delivery_.Schedule(recipient);
+        }
+        if (result == TypingResult::Duplicate || result == TypingResult::Held) {
+            metrics.suppressed.Increment();
+        }
+        return result;
+    }
+
+    size_t TypingService::Flush(const Clock::time_point now) {
+        size_t sent = 0;
+        std::vector<std::shared_ptr<WebSocketClient> > flushes;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto user = indicators_.begin(); user != indicators_.end();) {
+                auto &indicators = user->second;
+                for (auto it = indicators.begin(); it != indicators.end();) {
+                    auto &indicator = it->second;
+                    if (indicator.latest && now - indicator.updatedAt >= settings_.timeout) {
+                        indicator.latest = false;
+                    }
+                    if (indicator.latest != indicator.sent && now - indicator.sentAt >= settings_.window &&
+                        Send(user->first, it->first, indicator, now, flushes)) {
+                        ++sent;
+                    }
+
+                    // Kept until its window ends so a quick change back is still held
+                    if (!indicator.sent && !indicator.latest && now - indicator.sentAt >= settings_.window) {
+                        it = indicators.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                user = indicators.empty() ? indicators_.erase(user) : std::next(user);
+            }
+        }
+
+        for (const auto &recipient: flushes) {
+            delivery_.Schedule(recipient);
+        }
+        return sent;
+    }
+
+    void TypingService::Disconnect(const std::string &username) {
+        std::vector<std::shared_ptr<WebSocketClient> > flushes;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto user = indicators_.find(username);
+            if (user == indicators_.end()) {
+                return;
+            }
+            const auto now = Clock::now();
+            for (auto &[scope, indicator]: user->second) {
+                if (indicator.sent) {
+                    indicator.latest = false;
+                    Send(username, scope, indicator, now, flushes);
+                }
+            }
+            indicators_.erase(user);
+        }
+
+        for (const auto &recipient: flushes) {
+            delivery_.Schedule(recipient);
+        }
+    }
+
+    bool TypingService::Send(const std::string &username, const std::string &scope, Indicator &indicator,
+                             const Clock::time_point now, std::vector<std::shared_ptr<WebSocketClient> > &flushes) {
+        indicator.sent = indicator.latest;
+        indicator.sentAt = now;
+
+        std::string_view room;
+        std::vector<std::shared_ptr<WebSocketClient> > audience;
+        if (scope.starts_with(ROOM_SCOPE_PREFIX)) {
+            room = std::string_view(scope).substr(ROOM_SCOPE_PREFIX.size());
+            auto peers = Presence().RoomPeers(std::string(room), username, settings_.maxRoomPeers);
+            if (!peers) {
+                return false;
+            }
+            audience = std::move(*peers);
+        } else if (auto peer = Presence().FindClient(scope.substr(USER_SCOPE_PREFIX.size()))) {
+            audience.push_back(std::move(peer));
+        } else {
+            return false;
+        }
+
+        auto &metrics = Metrics();
+        metrics.sent.Increment();
+        if (audience.empty()) {
+            return true;
+        }
+
+        // Serialized once and shared by every recipient's queue
+        const auto frame = std::make_shared<const std::string>(BuildFrame(username, room, indicator.sent));
+        for (const auto &recipient: audience) {
+            switch (recipient->QueueFrame(frame)) {
+                case WebSocketClient::QueueResult::NeedsFlush:
+                    flushes.push_back(recipient);
+                    break;
+                case WebSocketClient::QueueResult::Dropped:
+                    metrics.dropped.Increment();
+                    break;
+                default:
+                    break;
+            }
+        }
+        return true;
+    }
+
+    PresenceService &TypingService::Presence() const {
+        return settings_.presence ? *settings_.presence : PresenceService::GetInstance();
+    }
+
+    void TypingService::Run() {
+        // Often enough that a held state goes out soon after its window ends
+        const auto tick = std::max<Clock::duration>(settings_.window / 4, std::chrono::milliseconds(10));
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            if (wake_.wait_for(lock, tick, [this] { return stopping_; })) {
+                break;
+            }
+            lock.unlock();
+            Flush();
+            lock.lock();
+        }
+    }
+} // namespace nuansa::handler
@@ -0,0 +1,73 @@
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/handler/websocket_client.h"
+
+namespace nuansa::handler {
+    void WebSocketClient::Write(const std::string_view frame) {
+        if (!ws) {
+            throw std::runtime_error("Client has no WebSocket");
+        }
+        std::lock_guard lock(writeMutex);
+        ws->text(true);
+        ws->write(net::buffer(frame.data(), frame.size()));
+    }
+
+    void WebSocketClient::Close(const websocket::close_reason &reason) {
+        if (!ws) {
+            throw std::runtime_error("Client has no WebSocket");
+        }
+        std::lock_guard lock(writeMutex);
+        ws->close(reason);
+    }
+
+    void WebSocketClient::Terminate() {
+        if (!ws) {
+            return;
+        }
+        // Not under writeMutex: the writer holding it may be the one stuck on this socket
+        boost::system::error_code ignored;
+        ws->next_layer().shutdown(tcp::socket::shutdown_both, ignored);
+    }
+
+    WebSocketClient::QueueResult WebSocketClient::QueueFrame(std::shared_ptr<const std::string> frame) {
+        std::lock_guard lock(outboundMutex);
+        if (writeFailed || outbound.size() >= OUTBOUND_QUEUE_LIMIT) {
+            return QueueResult::Dropped;
+        }
+        outbound.push_back(std::move(frame));
+        if (flushing) {
+            return QueueResult::Queued;
+        }
+        flushing = true;
+        return QueueResult::NeedsFlush;
+    }
+
+    size_t WebSocketClient::FlushOutbound() {
+        size_t written = 0;
+        while (true) {
+            std::shared_ptr<const std::string> frame;
+            {
+                std::lock_guard lock(outboundMutex);
+                if (outbound.empty()) {
+                    flushing = false;
+                    return written;
+                }
+                frame = std::move(outbound.front());
+                outbound.pop_front();
+            }
+
+            try {
+                Write(*frame);
+                ++written;
+            } catch (const std::exception &e) {
+                // The session notices the broken socket on its next read; queued frames would fail the same way
+                LOG_DEBUG << "Dropping queued frames for " << username << ": " << e.what();
+                std::lock_guard lock(outboundMutex);
+                writeFailed = true;
+                outbound.clear();
+                flushing = false;
+                return written;
+            }
+        }
+    }
+} // namespace nuansa::handler
@@ -3,18 +3,93 @@
 //
 #include "nuansa/utils/pch.h"
 #include "nuansa/handler/websocket_handler.h"
+#include "nuansa/handler/mention_dispatcher.h"
+#include "nuansa/handler/presence_service.h"
+#include "nuansa/handler/session_drainer.h"
+#include "nuansa/handler/typing_service.h"
 #include "nuansa/handler/websocket_state_machine.h"
+#include "nuansa/config/config.h"
+#include "nuansa/utils/metrics/metrics.h"
+#include "nuansa/utils/trace/tracer.h"
+#include "nuansa/utils/text_scanner.h"
 
 namespace beast = boost::beast;
 namespace websocket = beast::websocket;
 namespace http = beast::http;
 
 namespace nuansa::handler {
+    namespace {
+        struct HandlerMetrics {
+            utils::metrics::Gauge &sessions;
+            utils::metrics::Counter &received;
+            utils::metrics::Counter &receivedBytes;
+            utils::metrics::Counter &throttled;
+            utils::metrics::Counter &invalid;
+            utils::metrics::Histogram &handleDuration;
+            utils::metrics::Counter &sent;
+            utils::metrics::Counter &sendErrors;
+            utils::metrics::Histogram &broadcastDuration;
+            utils::metrics::Counter &broadcastRecipients;
+        };
+
+        // The client's correlation id, or its message id when it sent none
+        std::string_view TraceCorrelationId(const nlohmann::json &msgData) {
+            const auto header = msgData.find(utils::common::MESSAGE_HEADER);
+            if (header == msgData.end() || !header->is_object()) {
+                return {};
+            }
+            for (const auto *key: {utils::common::MESSAGE_HEADER_CORRELATION_ID,
+                                   utils::common::MESSAGE_HEADER_MESSAGE_ID}) {
+                if (const auto id = header->find(key); id != header->end() && id->is_string()) {
+                    return id->get_ref<const std::string &>();
+                }
+            }
+            return {};
+        }
+
+        bool HasString(const nlohmann::json &msgData, const char *key) {
+            const auto field = msgData.find(key);
+            return field != msgData.end() && field->is_string();
+        }
+
+        HandlerMetrics &Metrics() {
+            static HandlerMetrics metrics = [] {
+                auto &registry = utils::metrics::MetricsRegistry::GetInstance();
+                return HandlerMetrics{
+                    .sessions = registry.GetGauge("nuansa_websocket_sessions", "Open WebSocket sessions"),
+                    .received = registry.GetCounter("nuansa_websocket_messages_received_total",
+                                                    "Frames read from clients"),
+                    .receivedBytes = registry.GetCounter("nuansa_websocket_received_bytes_total",
+                                                         "Payload bytes read from clients"),
+                    .throttled = registry.GetCounter("nuansa_websocket_messages_throttled_total",
+                                                     "Frames dropped by the per-connection rate limit"),
+                    .invalid = registry.GetCounter("nuansa_websocket_messages_invalid_total",
+                                                   "Frames that were not valid JSON"),
+                    .handleDuration = registry.GetHistogram("nuansa_websocket_message_duration_seconds",
+                                                            "Time from a frame being read to its handling finishing",
+                                                            {}, 1e-6),
+                    .sent = registry.GetCounter("nuansa_websocket_messages_sent_total", "Frames written to clients"),
+                    .sendErrors = registry.GetCounter("nuansa_websocket_send_errors_total",
+                                                      "Frames that could not be written"),
+                    .broadcastDuration = registry.GetHistogram("nuansa_websocket_broadcast_duration_seconds",
+                                                               "Time to write one broadcast to every recipient",
+                                                               {}, 1e-6),
+                    .broadcastRecipients = registry.GetCounter("nuansa_websocket_broadcast_recipients_total",
+                                                               "Recipients written to by broadcasts")
+                };
+            }();
+            return metrics;
+        }
+    }
+
     WebSocketHandler::WebSocketHandler(const std::shared_ptr<WebSocketServer> &server)
         : websocketServer(server) {
     }
 
     void WebSocketHandler::HandleSession(std::shared_ptr<websocket::stream<tcp::socket> > ws) {
+        auto &metrics = Metrics();
+        metrics.sessions.Increment();
+
         std::shared_ptr<WebSocketClient> client;
         try {
             LOG_DEBUG << "Starting new WebSocket session";
@@ -38,13 +113,27 @@ namespace nuansa::handler {
             std::string clientId = boost::uuids::to_string(uuid);
             LOG_DEBUG << "Generated client ID: " << clientId;
 
+            const auto &rateLimit = nuansa::config::GetConfig().GetRateLimitConfig();
+            const ClientRateLimits limits{
+                .messages = {.ratePerSecond = rateLimit.messagesPerSecond, .burst = rateLimit.messageBurst},
+                .bytes = {.ratePerSecond = rateLimit.bytesPerSecond, .burst = rateLimit.byteBurst}
+            };
+            // A frame larger than the byte bucket could never be admitted; let beast refuse it while reading
+            ws->read_message_max(static_cast<std::uint64_t>(rateLimit.byteBurst));
+
             LOG_DEBUG << "Creating WebSocket client and state machine";
-            client = std::make_shared<WebSocketClient>(clientId, ws);
+            client = std::make_shared<WebSocketClient>(clientId, ws, limits);
+            boost::system::error_code endpointError;
+            client->remoteAddress = ws->next_layer().remote_endpoint(endpointError).address().to_string();
             auto stateMachine = std::make_shared<WebSocketStateMachine>(client, websocketServer);
+            SessionDrainer::GetInstance().Register(client);
+
+            // Tell a flooding client once per burst rather than answering every dropped frame
+            bool throttled = false;
 
             beast::flat_buffer buffer;
             LOG_DEBUG << "Entering message processing loop";
-            while (stateMachine->GetCurrentState() != ClientState::Disconnected) {
+            while (stateMachine->GetCurrentState() != ClientState::Disconnected && !client->CloseRequested()) {
                 boost::system::error_code ec;
                 buffer.consume(buffer.size());
 
@@ -60,15 +149,50 @@ namespace nuansa::handler {
                     break;
                 }
 
+                metrics.received.Increment();
+                metrics.receivedBytes.Increment(buffer.size());
+
+                // Checked before the frame is copied or parsed, so dropping it costs almost nothing
+                if (!client->AllowFrame(buffer.size())) {
+                    metrics.throttled.Increment();
+                    if (!throttled) {
+                        LOG_WARNING << "Rate limit exceeded by " << client->remoteAddress;
+                        SendErrorMessage(client, "Rate limit exceeded", "rate_limited");
+                        throttled = true;
+                    }
+                    continue;
+                }
+                throttled = false;
+
+                // Typing events are lossy and frequent: no copy, JSON document, log line or trace
+                if (stateMachine->GetCurrentState() == ClientState::Authenticated) {
+                    const std::string_view frame(static_cast<const char *>(buffer.data().data()), buffer.size());
+                    if (const auto event = TypingService::ParseFrame(frame)) {
+                        TypingService::GetInstance().Publish(client, *event);
+                        continue;
+                    }
+                }
+
+                const utils::metrics::ScopedTimer timer(metrics.handleDuration);
+                utils::trace::TraceScope trace("websocket.frame");
                 std::string message = beast::buffers_to_string(buffer.data());
                 LOG_DEBUG << "Received message: " << message;
 
                 try {
                     LOG_DEBUG << "Parsing message JSON";
-                    nlohmann::json msgData = nlohmann::json::parse(message);
+                    nlohmann::json msgData;
+                    {
+                        utils::trace::Span span("parse");
+                        msgData = nlohmann::json::parse(message);
+                    }
+                    trace.SetCorrelationId(TraceCorrelationId(msgData));
+
                     LOG_DEBUG << "Processing message through state machine";
+                    utils::trace::Span span("dispatch");
                     stateMachine->ProcessMessage(msgData);
                 } catch (const nlohmann::json::exception &e) {
+                    trace.SetError();
+                    metrics.invalid.Increment();
                     LOG_ERROR << "JSON parsing error: " << e.what();
                     LOG_DEBUG << "Sending error message to client";
                     SendErrorMessage(client, "Invalid message format");
@@ -77,7 +201,10 @@ namespace nuansa::handler {
 
             // Perform clean shutdown
             LOG_DEBUG << "Performing clean WebSocket shutdown";
-            ws->close(websocket::close_code::normal);
+            // A drained client is told to come back rather than that the conversation is over
+            client->Close(client->CloseRequested()
+                              ? websocket::close_reason(websocket::close_code::going_away, "server restarting")
+                              : websocket::close_reason(websocket::close_code::normal));
         } catch (const beast::system_error &se) {
             if (se.code() != websocket::error::closed) {
                 LOG_ERROR << "WebSocket error: " << se.code().message();
@@ -91,7 +218,9 @@ namespace nuansa::handler {
         if (client) {
             LOG_DEBUG << "Cleaning up client connection";
             HandleClientDisconnection(client);
+            SessionDrainer::GetInstance().Unregister(client);
         }
+        metrics.sessions.Decrement();
     }
 
     void WebSocketHandler::SendMessage(const std::shared_ptr<WebSocketClient> &client,
@@ -101,11 +230,13 @@ namespace nuansa::handler {
             return;
         }
 
+        utils::trace::Span span("websocket.send");
         try {
-            const auto ws = client->GetWebSocket();
-            ws->text(true);
-            ws->write(net::buffer(message));
+            client->Write(message);
+            Metrics().sent.Increment();
         } catch (const std::exception &e) {
+            span.SetError();
+            Metrics().sendErrors.Increment();
             LOG_ERROR << "Error sending message: " << e.what();
         }
     }
@@ -125,22 +256,28 @@ namespace nuansa::handler {
         SendMessage(client, errorJson.dump());
     }
 
+    std::string WebSocketHandler::BuildOverloadedMessage(const std::chrono::milliseconds retryAfter) {
+        const nlohmann::json errorJson = {
+            {"type", "error"},
+            {"code", "overloaded"},
+            {"message", "Server is busy, please retry later"},
+            {"retryAfterMs", retryAfter.count()}
+        };
+        return errorJson.dump();
+    }
+
     void WebSocketHandler::HandleClientDisconnection(const std::shared_ptr<WebSocketClient> &client) const {
         if (!client) return;
 
-        // Find and remove the client from the clients map
-        if (const auto it = websocketServer->clients.find(client->username); it != websocketServer->clients.end()) {
-            websocketServer->clients.erase(it);
-
+        // A newer login of the same user stays registered
+        if (websocketServer->RemoveClient(client->username, client)) {
             LOG_INFO << "Client disconnected: " << client->username;
 
-            // Broadcast disconnection message
-            const nlohmann::json disconnectMsg = {
-                {"type", "system"},
-                {"content", client->username + " has disconnected"}
-            };
+            // Before presence forgets the user's rooms, which typing needs to reach
+            TypingService::GetInstance().Disconnect(client->username);
 
-            BroadcastMessage("system", disconnectMsg.dump());
+            // Watchers learn about it from their next presence delta instead of a broadcast to everyone
+            PresenceService::GetInstance().Disconnect(client);
         }
     }
 
@@ -153,62 +290,26 @@ namespace nuansa::handler {
 
         std::string msgStr = broadcastMsg.dump();
 
-        for (auto &[username, client]: websocketServer->clients) {
+        auto &metrics = Metrics();
+        const utils::metrics::ScopedTimer timer(metrics.broadcastDuration);
+        for (const auto &client: websocketServer->GetClients()) {
             try {
-                if (const auto ws = client.GetWebSocket()) {
-                    ws->text(true);
-                    ws->write(net::buffer(msgStr));
-                    LOG_DEBUG << "Broadcast message sent to " << username;
-                }
+                client->Write(msgStr);
+                metrics.broadcastRecipients.Increment();
+                LOG_DEBUG << "Broadcast message sent to " << client->username;
             } catch (const std::exception &e) {
-                LOG_ERROR << "Error broadcasting to " << username << ": " << e.what();
+                metrics.sendErrors.Increment();
+                LOG_ERROR << "Error broadcasting to " << client->username << ": " << e.what();
             }
         }
     }
 
     void WebSocketHandler::NotifyMentionedUsers(const nuansa::messages::Message &msg) const {
-        const nlohmann::json notification = {
-            {"type", "mention"},
-            {"messageId", msg.id},
-            {"sender", msg.sender},
-            {"content", msg.content}
-        };
-
-        for (const auto &mention: msg.mentions) {
-            LOG_DEBUG << "Attempting to notify user: " << mention;
-
-            if (auto it = websocketServer->clients.find(mention);
-                it != websocketServer->clients.end()) {
-                try {
-                    auto &client = it->second;
-                    if (const auto ws = client.GetWebSocket()) {
-                        ws->text(true);
-                        ws->write(net::buffer(notification.dump()));
-                        LOG_DEBUG << "Notification sent to " << mention;
-                    }
-                } catch (const std::exception &e) {
-                    LOG_ERROR << "Error sending notification to "
-                                           << mention << ": " << e.what();
-                }
-            } else {
-                LOG_DEBUG << "Mentioned user " << mention
-                                       << " not found or offline";
-            }
-        }
+        MentionDispatcher::GetInstance().Dispatch(msg, *websocketServer);
     }
 
-    std::vector<std::string> WebSocketHandler::ExtractMentions(const std::string &content) {
-        std::vector<std::string> mentions;
-        std::regex mention_pattern("@(\\w+)");
-
-        auto words_begin = std::sregex_iterator(content.begin(), content.end(), mention_pattern);
-        auto words_end = std::sregex_iterator();
-
-        for (std::sregex_iterator i = words_begin; i != words_end; ++i) {
-            std::smatch match = *i;
-            mentions.push_back(match[1].str());
-        }
-        return mentions;
+    std::vector<std::string_view> WebSocketHandler::ExtractMentions(const std::string_view content) {
+        return nuansa::utils::TextScanner::FindMentions(content);
     }
 
     void WebSocketHandler::SendAuthRequiredMessage(const std::shared_ptr<WebSocketClient> &client) {
@@ -250,13 +351,13 @@ namespace nuansa::handler {
 
         switch (msgData["type"].get<nuansa::messages::MessageType>()) {
             case nuansa::messages::MessageType::New:
-                if (!msgData.contains("content")) {
+                if (!HasString(msgData, "content")) {
                     throw std::invalid_argument("New message must contain 'content' field");
                 }
                 break;
 
             case nuansa::messages::MessageType::Edit:
-                if (!msgData.contains("id") || !msgData.contains("content")) {
+                if (!msgData.contains("id") || !HasString(msgData, "content")) {
                     throw std::invalid_argument("Edit message must contain 'id' and 'content' fields");
                 }
                 break;
@@ -268,7 +369,7 @@ namespace nuansa::handler {
                 break;
 
             case nuansa::messages::MessageType::DirectMessage:
-                if (!msgData.contains("recipient") || !msgData.contains("content")) {
+                if (!HasString(msgData, "recipient") || !HasString(msgData, "content")) {
                     throw std::invalid_argument("Direct message must contain 'recipient' and 'content' fields");
                 }
                 break;
@@ -279,52 +380,25 @@ namespace nuansa::handler {
     }
 
     bool WebSocketHandler::IsUserOnline(const std::string &username) const {
-        return websocketServer->clients.contains(username);
+        return websocketServer->IsOnline(username);
     }
 
     std::size_t WebSocketHandler::GetOnlineUserCount() const {
-        return websocketServer->clients.size();
+        return websocketServer->ClientCount();
     }
 
     std::vector<std::string> WebSocketHandler::GetOnlineUsers() const {
-        std::vector<std::string> onlineUsers;
-        onlineUsers.reserve(websocketServer->clients.size());
-
-        for (const auto &username: websocketServer->clients | std::views::keys) {
-            onlineUsers.push_back(username);
-        }
-
-        return onlineUsers;
+        return websocketServer->GetUsernames();
     }
 
     void WebSocketHandler::SendOnlineUsersList(const std::shared_ptr<WebSocketClient> &client) const {
-        const nlohmann::json userListMsg = {
-            {"type", "userList"},
-            {"users", GetOnlineUsers()},
-            {"count", GetOnlineUserCount()}
-        };
-
-        SendMessage(client, userListMsg.dump());
+        PresenceService::GetInstance().SendSnapshots(client);
     }
 
-    void WebSocketHandler::SendTypingNotification(const std::string &username,
-                                                  bool isTyping,
-                                                  const std::string &recipient) const {
-        const nlohmann::json typingMsg = {
-            {"type", "typing"},
-            {"username", username},
-            {"isTyping", isTyping}
-        };
-
-        if (recipient.empty()) {
-            // Broadcast to all users
-            BroadcastMessage("system", typingMsg.dump());
-        } else {
-            // Send to specific recipient
-            if (const auto it = websocketServer->clients.find(recipient);
-                it != websocketServer->clients.end()) {
-                SendMessage(std::make_shared<WebSocketClient>(it->second), typingMsg.dump());
-            }
-        }
+    void WebSocketHandler::SendTypingNotification(const std::shared_ptr<WebSocketClient> &client,
+                                                  const bool isTyping,
+                                                  const std::string &room,
+                                                  const std::string &recipient) {
+        TypingService::GetInstance().Publish(client, TypingEvent{room, recipient, isTyping});
     }
 }
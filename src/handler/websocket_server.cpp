@@ -0,0 +1,73 @@
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/handler/websocket_server.h"
+
+namespace nuansa::handler {
+    void WebSocketServer::AddClient(const std::string &username, const std::shared_ptr<WebSocketClient> &client) {
+        std::unique_lock lock(clientsMutex);
+        clients.insert_or_assign(username, client);
+    }
+
+    bool WebSocketServer::RemoveClient(const std::string &username, const std::shared_ptr<WebSocketClient> &client) {
+        std::unique_lock lock(clientsMutex);
+        const auto it = clients.find(username);
+        if (it == clients.end() || it->second != client) {
+            return false;
+        }
+        clients.erase(it);
+        return true;
+    }
+
+    std::shared_ptr<WebSocketClient> WebSocketServer::FindClient(const std::string &username) const {
+        std::shared_lock lock(clientsMutex);
+        const auto it = clients.find(username);
+        return it == clients.end() ? nullptr : it->second;
+    }
+
+    std::vector<std::pair<std::string_view, std::shared_ptr<WebSocketClient> > > WebSocketServer::FindClients(
+        const std::vector<std::string_view> &usernames) const {
+        std::vector<std::pair<std::string_view, std::shared_ptr<WebSocketClient> > > found;
+        found.reserve(usernames.size());
+
+        // Keys are built before taking the lock so it is held only for the lookups
+        std::vector<std::string> keys(usernames.begin(), usernames.end());
+
+        std::shared_lock lock(clientsMutex);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (const auto it = clients.find(keys[i]); it != clients.end()) {
+                found.emplace_back(usernames[i], it->second);
+            }
+        }
+        return found;
+    }
+
+    bool WebSocketServer::IsOnline(const std::string &username) const {
+        std::shared_lock lock(clientsMutex);
+        return clients.contains(username);
+    }
+
+    size_t WebSocketServer::ClientCount() const {
+        std::shared_lock lock(clientsMutex);
+        return clients.size();
+    }
+
+    std::vector<std::string> WebSocketServer::GetUsernames() const {
+        std::shared_lock lock(clientsMutex);
+        std::vector<std::string> usernames;
+        usernames.reserve(clients.size());
+        for (const auto &username: clients | std::views::keys) {
+            usernames.push_back(username);
+        }
+        return usernames;
+    }
+
+    std::vector<std::shared_ptr<WebSocketClient> > WebSocketServer::GetClients() const {
+        std::shared_lock lock(clientsMutex);
+        std::vector<std::shared_ptr<WebSocketClient> > snapshot;
+        snapshot.reserve(clients.size());
+        for (const auto &client: clients | std::views::values) {
+            snapshot.push_back(client);
+        }
+        return snapshot;
+    }
+} // namespace nuansa::handler
@@ -0,0 +1,48 @@
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/services/auth/auth_rate_limiter.h"
+#include "nuansa/config/config.h"
+
+namespace nuansa::services::auth {
+    namespace {
+        AuthRateLimiterSettings MakeSettings() {
+            const auto &rateLimit = nuansa::config::Config::GetInstance().GetRateLimitConfig();
+            return AuthRateLimiterSettings{
+                .perIp = {.ratePerSecond = rateLimit.authPerIpPerMinute / 60, .burst = rateLimit.authIpBurst},
+                .perUsername = {
+                    .ratePerSecond = rateLimit.authPerUsernamePerMinute / 60, .burst = rateLimit.authUsernameBurst
+                }
+            };
+        }
+    }
+
+    AuthRateLimiter &AuthRateLimiter::GetInstance() {
+        static AuthRateLimiter instance(MakeSettings());
+        return instance;
+    }
+
+    AuthRateLimiter::AuthRateLimiter(const AuthRateLimiterSettings &settings)
+        : byAddress_(utils::pattern::TokenBucketTableSettings{.bucket = settings.perIp}),
+          byUsername_(utils::pattern::TokenBucketTableSettings{.bucket = settings.perUsername}) {
+    }
+
+    bool AuthRateLimiter::Allow(const std::string &address, const std::string &username) {
+        const auto now = utils::pattern::TokenBucket::Clock::now();
+
+        if (!byAddress_.TryConsume(address, 1.0, now)) {
+            LOG_WARNING << "Too many authentication attempts from " << address;
+            return false;
+        }
+
+        if (!username.empty() && !byUsername_.TryConsume(username, 1.0, now)) {
+            LOG_WARNING << "Too many authentication attempts for user " << username;
+            return false;
+        }
+
+        return true;
+    }
+
+    size_t AuthRateLimiter::TrackedKeys() const {
+        return byAddress_.Size() + byUsername_.Size();
+    }
+}
@@ -5,28 +5,92 @@
 
 #include "nuansa/services/auth/auth_service.h"
 #include "nuansa/messages/message_types.h"
-#include "nuansa/services/user/user_service.h"
+#include "nuansa/services/storage/storage_registry.h"
 #include "nuansa/utils/validation.h"
 #include "nuansa/services/auth/auth_message.h"
 #include "nuansa/services/auth/register_message.h"
 #include "nuansa/utils/http_client.h"
 #include "nuansa/config/config.h"
 #include "nuansa/services/token/token_service.h"
+#include "nuansa/utils/crypto/password_hasher.h"
+#include "nuansa/utils/crypto/crypto_util.h"
+#include "nuansa/utils/metrics/metrics.h"
 
 using namespace nuansa::config;
 
 namespace nuansa::services::auth {
-    #ifdef DEBUG
-    void AuthService::LogMutexState() const {
-        LOG_DEBUG << "Auth mutex state - trying to acquire";
-        if (std::unique_lock<std::timed_mutex> lock(authMutex, std::defer_lock); lock.try_lock()) {
-            LOG_DEBUG << "Auth mutex is free";
-            lock.unlock();
-        } else {
-            LOG_DEBUG << "Auth mutex is locked";
+    namespace {
+        utils::cache::LruCacheSettings MakeOAuthCacheSettings() {
+            const auto &security = Config::GetInstance().GetSecurityConfig();
+            return utils::cache::LruCacheSettings{
+                .capacity = security.oauthCacheSize,
+                .positiveTtl = std::chrono::seconds(security.oauthCacheMaxTtlSeconds)
+            };
+        }
+
+        int64_t UnixNow() {
+            return std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        struct AuthMetrics {
+            utils::metrics::Histogram &loginSuccess;
+            utils::metrics::Histogram &loginFailure;
+            utils::metrics::Histogram &registerSuccess;
+            utils::metrics::Histogram &registerFailure;
+        };
+
+        AuthMetrics &Metrics() {
+            static AuthMetrics metrics = [] {
+                auto &registry = utils::metrics::MetricsRegistry::GetInstance();
+                const auto histogram = [&registry](const char *operation, const char *result) -> auto & {
+                    return registry.GetHistogram("nuansa_auth_duration_seconds",
+                                                 "Login and registration latency, password hashing included",
+                                                 {{"operation", operation}, {"result", result}}, 1e-6);
+                };
+                return AuthMetrics{
+                    .loginSuccess = histogram("login", "success"),
+                    .loginFailure = histogram("login", "failure"),
+                    .registerSuccess = histogram("register", "success"),
+                    .registerFailure = histogram("register", "failure")
+                };
+            }();
+            return metrics;
+        }
+
+        // Records how long the request took under its outcome and passes the response through
+        AuthResponse Observe(utils::metrics::Histogram &success, utils::metrics::Histogram &failure,
+                             const std::chrono::steady_clock::time_point start, AuthResponse response) {
+            const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+            (response.IsSuccess() ? success : failure).Record(static_cast<uint64_t>(elapsed.count()));
+            return response;
+        }
+
+        // For requests that failed on a saturated or unavailable dependency; the auth concurrency limit backs off on it
+        AuthResponse BusyResponse() {
+            return AuthResponse{false, "", "Server busy, please try again", true};
+        }
+
+        // Providers send numeric claims either as numbers or as strings
+        std::optional<int64_t> JsonInteger(const nlohmann::json &json, const std::string &key) {
+            if (!json.contains(key)) {
+                return std::nullopt;
+            }
+            const auto &value = json[key];
+            if (value.is_number_integer()) {
+                return value.get<int64_t>();
+            }
+            if (value.is_string()) {
+                try {
+                    return std::stoll(value.get<std::string>());
+                } catch (const std::exception &) {
+                    return std::nullopt;
+                }
+            }
+            return std::nullopt;
         }
     }
-    #endif
 
     AuthService &AuthService::GetInstance() {
         static AuthService instance;
@@ -37,7 +101,10 @@ namespace nuansa::services::auth {
         : gen(rd()), 
           httpClient(std::make_unique<utils::HttpClient>()),
           tokenService_(std::make_unique<nuansa::services::token::TokenService>(
-              Config::GetInstance().GetServerConfig().jwtSecret)) {
+              Config::GetInstance().GetServerConfig().jwtSecret)),
+          oauthCache_(MakeOAuthCacheSettings()),
+          googleBreaker_(utils::pattern::CircuitBreakerRegistry::GetInstance().Get(utils::pattern::breakers::GOOGLE)),
+          githubBreaker_(utils::pattern::CircuitBreakerRegistry::GetInstance().Get(utils::pattern::breakers::GITHUB)) {
         // Get GitHub config from ServerConfig
         const auto& config = Config::GetInstance().GetServerConfig();
         GITHUB_CLIENT_ID = config.githubClientId;
@@ -58,6 +125,12 @@ namespace nuansa::services::auth {
             LOG_WARNING << "GitHub OAuth configuration is incomplete";
         }
 
+        // ID tokens are verified locally against Google's published keys
+        if (!GOOGLE_CLIENT_ID.empty()) {
+            googleIdTokenVerifier_ = std::make_unique<GoogleIdTokenVerifier>(
+                GoogleIdTokenVerifierSettings{.jwksUrl = config.googleJwksUrl}, *httpClient);
+        }
+
         // TODO: In production, load from secure database
         // For demonstration, adding some test users with hashed passwords
         userCredentials["alice"] = crypt("password123", "$6$random_salt");
@@ -65,17 +138,14 @@ namespace nuansa::services::auth {
     }
 
     nuansa::services::auth::AuthResponse AuthService::Authenticate(const nuansa::services::auth::AuthRequest &request) {
-        try {
-            LOG_DEBUG << "Attempting to acquire auth mutex for authentication";
-            std::unique_lock<std::timed_mutex> lock(authMutex, std::defer_lock);
-            if (!lock.try_lock_for(std::chrono::seconds(2))) {
-                LOG_ERROR << "Failed to acquire mutex for authentication";
-                return AuthResponse{false, "", "Server busy, please try again"};
-            }
-            LOG_DEBUG << "Auth mutex acquired for authentication";
+        const auto start = std::chrono::steady_clock::now();
+        return Observe(Metrics().loginSuccess, Metrics().loginFailure, start, AuthenticateUser(request));
+    }
 
+    AuthResponse AuthService::AuthenticateUser(const AuthRequest &request) {
+        try {
             // Delegate authentication to UserService
-            if (auto &userService = nuansa::services::user::UserService::GetInstance(); !userService.AuthenticateUser(
+            if (auto &userService = nuansa::services::storage::StorageRegistry::GetInstance().Users(); !userService.AuthenticateUser(
                 request.GetUsername(), request.GetPassword())) {
                 return nuansa::services::auth::AuthResponse{false, "", "Invalid credentials"};
             }
@@ -90,6 +160,9 @@ namespace nuansa::services::auth {
             };
 
             return nuansa::services::auth::AuthResponse{true, tokenResponse.dump(), "Authentication successful"};
+        } catch (const nuansa::utils::exception::WorkerPoolRejectedException& e) {
+            LOG_WARNING << "Authentication rejected: " << e.what();
+            return BusyResponse();
         } catch (const std::exception& e) {
             LOG_ERROR << "Authentication error: " << e.what();
             return AuthResponse{false, "", e.what()};
@@ -105,6 +178,11 @@ namespace nuansa::services::auth {
     }
 
     nuansa::services::auth::AuthResponse AuthService::Register(const nuansa::services::auth::RegisterRequest &request) {
+        const auto start = std::chrono::steady_clock::now();
+        return Observe(Metrics().registerSuccess, Metrics().registerFailure, start, RegisterUser(request));
+    }
+
+    AuthResponse AuthService::RegisterUser(const RegisterRequest &request) {
         LOG_DEBUG << "Registering user with provider: " << static_cast<int>(request.GetAuthProvider());
 
         switch (request.GetAuthProvider()) {
@@ -123,14 +201,6 @@ namespace nuansa::services::auth {
 
     AuthResponse AuthService::HandleCustomRegistration(const RegisterRequest& request) {
         try {
-            LOG_DEBUG << "Attempting to acquire auth mutex for custom registration";
-            std::unique_lock<std::timed_mutex> lock(authMutex, std::defer_lock);
-            if (!lock.try_lock_for(std::chrono::seconds(2))) {
-                LOG_ERROR << "Failed to acquire mutex for custom registration";
-                return AuthResponse{false, "", "Server busy, please try again"};
-            }
-            LOG_DEBUG << "Auth mutex acquired for custom registration";
-
             if (!request.GetUsername() || !request.GetEmail() || !request.GetPassword()) {
                 return AuthResponse{false, "", "Missing required fields for custom registration"};
             }
@@ -153,20 +223,39 @@ namespace nuansa::services::auth {
                 return AuthResponse{false, "", "Invalid password format"};
             }
 
-            // Create user with custom credentials
-            auto& userService = nuansa::services::user::UserService::GetInstance();
-            const std::string salt = nuansa::models::User::GenerateSalt();
-            const std::string hashedPassword = nuansa::utils::crypto::CryptoUtil::HashPassword(
-                *request.GetPassword(), salt);
-
-            if (!userService.CreateUser(nuansa::models::User{
-                *request.GetUsername(), 
-                *request.GetEmail(), 
-                hashedPassword, 
-                salt,
-                ""  // Empty picture for custom registration
-            })) {
-                return AuthResponse{false, "", "Registration failed"};
+            // Fail fast on taken identifiers before spending a KDF slot
+            auto& userService = nuansa::services::storage::StorageRegistry::GetInstance().Users();
+            if (userService.IsUsernameTaken(*request.GetUsername())) {
+                return AuthResponse{false, "", "Username already taken"};
+            }
+            if (userService.IsEmailTaken(*request.GetEmail())) {
+                return AuthResponse{false, "", "Email already registered"};
+            }
+
+            // Create user with custom credentials; the salt is embedded in the hash
+            const std::string salt;
+            const std::string hashedPassword = nuansa::utils::crypto::PasswordHasher::GetInstance().Hash(
+                *request.GetPassword());
+
+            {
+                // Re-check under the per-identity lock; the database unique constraints remain the
+                // final guard against registrations racing in from other processes
+                const auto identityGuard = identityLocks_.Lock({*request.GetUsername(), *request.GetEmail()});
+
+                if (userService.IsUsernameTaken(*request.GetUsername()) ||
+                    userService.IsEmailTaken(*request.GetEmail())) {
+                    return AuthResponse{false, "", "Username or email already registered"};
+                }
+
+                if (!userService.CreateUser(nuansa::models::User{
+                    *request.GetUsername(),
+                    *request.GetEmail(),
+                    hashedPassword,
+                    salt,
+                    ""  // Empty picture for custom registration
+                })) {
+                    return AuthResponse{false, "", "Registration failed"};
+                }
             }
 
             // Generate tokens and save to repository
@@ -176,6 +265,15 @@ namespace nuansa::services::auth {
             }
 
             return AuthResponse{true, token.ToJson().dump(), "Registration successful"};
+        } catch (const nuansa::utils::exception::WorkerPoolRejectedException& e) {
+            LOG_WARNING << "Custom registration rejected: " << e.what();
+            return BusyResponse();
+        } catch (const nuansa::utils::exception::CircuitBreakerOpenException& e) {
+            LOG_WARNING << "Custom registration rejected: " << e.what();
+            return BusyResponse();
+        } catch (const nuansa::utils::exception::CircuitBreakerTimeoutException& e) {
+            LOG_WARNING << "Custom registration timed out: " << e.what();
+            return BusyResponse();
         } catch (const std::exception& e) {
             LOG_ERROR << "Custom registration error: " << e.what();
             return AuthResponse{false, "", e.what()};
@@ -198,12 +296,8 @@ namespace nuansa::services::auth {
             // Validate OAuth token and get user info first, without locking
             switch (request.GetAuthProvider()) {
                 case AuthProvider::Google:
-                    LOG_DEBUG << "Starting Google OAuth validation";
-                    userInfo = ValidateGoogleToken(*request.GetOAuthCredentials());
-                    break;
                 case AuthProvider::GitHub:
-                    LOG_DEBUG << "Starting GitHub OAuth validation";
-                    userInfo = ValidateGitHubToken(*request.GetOAuthCredentials());
+                    userInfo = ValidateOAuthToken(request.GetAuthProvider(), *request.GetOAuthCredentials());
                     break;
                 default:
                     LOG_ERROR << "Unsupported OAuth provider: " << static_cast<int>(request.GetAuthProvider());
@@ -217,37 +311,32 @@ namespace nuansa::services::auth {
 
             LOG_DEBUG << "Successfully validated OAuth token for user: " << userInfo->email;
 
-            // Now acquire the lock only for the database operations
-            LOG_DEBUG << "Attempting to acquire auth mutex";
-            std::unique_lock<std::timed_mutex> lock(authMutex, std::defer_lock);
-            
-            // Reduce timeout to 2 seconds since we're only locking for DB operations
-            if (!lock.try_lock_for(std::chrono::seconds(2))) {
-                LOG_ERROR << "Failed to acquire mutex after 2 seconds timeout";
-                return AuthResponse{false, "", "Server busy, please try again"};
-            }
-            
-            LOG_DEBUG << "Auth mutex acquired";
-            
             try {
-                auto& userService = nuansa::services::user::UserService::GetInstance();
-                bool userExists = userService.UserExists(userInfo->email);
-                LOG_DEBUG << "User exists check completed: " << (userExists ? "true" : "false");
-
-                if (!userExists) {
-                    nuansa::models::User newUser{
-                        userInfo->username,
-                        userInfo->email,
-                        "",  // No password for OAuth users
-                        "",  // No salt needed
-                        userInfo->picture
-                    };
-                    
-                    if (!userService.CreateUser(newUser)) {
-                        LOG_ERROR << "Failed to create user account";
-                        return AuthResponse{false, "", "Failed to create user account"};
+                auto& userService = nuansa::services::storage::StorageRegistry::GetInstance().Users();
+                {
+                    // Only logins for the same identity are serialized around the check-then-create
+                    const auto identityGuard = identityLocks_.Lock({userInfo->username, userInfo->email});
+
+                    bool userExists = userService.UserExists(userInfo->email);
+                    LOG_DEBUG << "User exists check completed: " << (userExists ? "true" : "false");
+
+                    if (!userExists) {
+                        nuansa::models::User newUser{
+                            userInfo->username,
+                            userInfo->email,
+                            "",  // No password for OAuth users
+                            "",  // No salt needed
+                            userInfo->picture
+                        };
+
+                        // Another instance may have created the account first; the unique constraint rejects
+                        // our insert, so treat an account that exists afterwards as success
+                        if (!userService.CreateUser(newUser) && !userService.UserExists(userInfo->email)) {
+                            LOG_ERROR << "Failed to create user account";
+                            return AuthResponse{false, "", "Failed to create user account"};
+                        }
+                        LOG_DEBUG << "Successfully created user account";
                     }
-                    LOG_DEBUG << "Successfully created user account";
                 }
 
                 // Generate and save tokens
@@ -262,7 +351,7 @@ namespace nuansa::services::auth {
                     return AuthResponse{false, "", "Failed to create authentication tokens"};
                 }
 
-                // Create response (can be done after releasing lock)
+                // Create response
                 nlohmann::json tokenResponse = {
                     {"access_token", accessToken.ToJson()},
                     {"refresh_token", refreshToken.ToJson()}
@@ -275,6 +364,12 @@ namespace nuansa::services::auth {
                     "OAuth registration successful"
                 };
 
+            } catch (const nuansa::utils::exception::CircuitBreakerOpenException& e) {
+                LOG_WARNING << "OAuth registration rejected: " << e.what();
+                return BusyResponse();
+            } catch (const nuansa::utils::exception::CircuitBreakerTimeoutException& e) {
+                LOG_WARNING << "OAuth registration timed out: " << e.what();
+                return BusyResponse();
             } catch (const std::exception& e) {
                 LOG_ERROR << "Database operation failed: " << e.what();
                 return AuthResponse{false, "", "Database operation failed: " + std::string(e.what())};
@@ -286,8 +381,95 @@ namespace nuansa::services::auth {
         }
     }
 
+    std::optional<AuthService::OAuthUserInfo> AuthService::ValidateOAuthToken(
+        const AuthProvider provider, const OAuthCredentials& credentials) {
+        // A GitHub authorization code is single use: replaying it has to fail at GitHub, so its exchange is
+        // neither cached nor shared with a concurrent attempt
+        if (provider == AuthProvider::GitHub && credentials.code) {
+            return ValidateGitHubToken(credentials);
+        }
+
+        // Google sends an ID token or an access token
+        const auto& secret = provider == AuthProvider::Google && credentials.idToken && !credentials.idToken->empty()
+                                 ? *credentials.idToken
+                                 : credentials.accessToken;
+        const std::string key = std::to_string(static_cast<int>(provider)) + ":" +
+                                utils::crypto::CryptoUtil::GenerateSHA256Hash(secret);
+
+        if (const auto cached = oauthCache_.Get(key); cached.hit && cached.value) {
+            LOG_DEBUG << "OAuth token validation served from cache";
+            return cached.value;
+        }
+
+        // Retries with the same token while the first call is still out share its result
+        return oauthFlights_.Do(key, [&]() -> std::optional<OAuthUserInfo> {
+            LOG_DEBUG << "Starting " << (provider == AuthProvider::Google ? "Google" : "GitHub")
+                      << " OAuth validation";
+            auto userInfo = provider == AuthProvider::Google
+                                ? ValidateGoogleToken(credentials)
+                                : ValidateGitHubToken(credentials);
+
+            // Failures are not cached; a transient provider error must not stick
+            if (userInfo) {
+                if (const auto ttl = OAuthCacheTtl(*userInfo); ttl.count() > 0) {
+                    oauthCache_.Put(key, *userInfo, ttl);
+                }
+            }
+            return userInfo;
+        });
+    }
+
+    std::chrono::milliseconds AuthService::OAuthCacheTtl(const OAuthUserInfo& userInfo) const {
+        const std::chrono::milliseconds maxTtl = oauthCache_.GetSettings().positiveTtl;
+        if (userInfo.expiresAt == 0) {
+            return maxTtl;
+        }
+
+        // Never serve a token past the provider's own expiry
+        const auto remaining = std::chrono::seconds(userInfo.expiresAt - UnixNow());
+        return std::clamp<std::chrono::milliseconds>(remaining, std::chrono::milliseconds::zero(), maxTtl);
+    }
+
+    std::optional<AuthService::OAuthUserInfo> AuthService::ValidateGoogleIdToken(const std::string& idToken) {
+        const auto claims = googleIdTokenVerifier_->Verify(idToken);
+        if (!claims || !ValidateGoogleTokenClaims(*claims)) {
+            LOG_ERROR << "Invalid Google ID token";
+            return std::nullopt;
+        }
+
+        // An unverified address could belong to someone else's account
+        if (claims->contains("email_verified") &&
+            !((*claims)["email_verified"] == true || (*claims)["email_verified"] == "true")) {
+            LOG_ERROR << "Google account email is not verified";
+            return std::nullopt;
+        }
+
+        try {
+            const auto email = (*claims)["email"].get<std::string>();
+            return OAuthUserInfo{
+                (*claims)["sub"].get<std::string>(),
+                email,
+                claims->value("name", email),
+                claims->value("picture", ""),
+                JsonInteger(*claims, "exp").value_or(0)
+            };
+        } catch (const std::exception& e) {
+            LOG_ERROR << "Google ID token is missing required claims: " << e.what();
+            return std::nullopt;
+        }
+    }
+
     std::optional<AuthService::OAuthUserInfo> AuthService::ValidateGoogleToken(
         const OAuthCredentials& credentials) {
+        // Verify ID tokens offline once the signing keys are loaded; only fall back to
+        // the tokeninfo round trip before then, and only if an access token came along
+        if (googleIdTokenVerifier_ && credentials.idToken && !credentials.idToken->empty()) {
+            if (googleIdTokenVerifier_->HasKeys() || credentials.accessToken.empty()) {
+                return ValidateGoogleIdToken(*credentials.idToken);
+            }
+            LOG_WARNING << "Google signing keys not loaded yet, validating access token online";
+        }
+
         // Set up request headers with required fields
         std::vector<std::string> headers = {
             "Authorization: Bearer " + credentials.accessToken,
@@ -299,7 +481,9 @@ namespace nuansa::services::auth {
             GOOGLE_TOKEN_INFO_URL + "?access_token=" + credentials.accessToken;
 
         // First validate the token
-        auto tokenResponse = httpClient->Get(tokenInfoUrl);
+        auto tokenResponse = CallProvider(googleBreaker_, [&](const std::chrono::milliseconds timeout) {
+            return httpClient->Get(tokenInfoUrl, {}, timeout);
+        });
         if (!tokenResponse.success) {
             LOG_ERROR << "Failed to validate Google token: " << tokenResponse.error;
             return std::nullopt;
@@ -315,7 +499,9 @@ namespace nuansa::services::auth {
             }
 
             // If token is valid, get user info
-            auto userResponse = httpClient->Get(GOOGLE_USER_INFO_URL, headers);
+            auto userResponse = CallProvider(googleBreaker_, [&](const std::chrono::milliseconds timeout) {
+                return httpClient->Get(GOOGLE_USER_INFO_URL, headers, timeout);
+            });
             if (!userResponse.success) {
                 LOG_ERROR << "Failed to get Google user info: " << userResponse.error;
                 return std::nullopt;
@@ -326,7 +512,8 @@ namespace nuansa::services::auth {
                 userInfo["sub"].get<std::string>(),
                 userInfo["email"].get<std::string>(),
                 userInfo["name"].get<std::string>(),
-                userInfo["picture"].get<std::string>()
+                userInfo["picture"].get<std::string>(),
+                JsonInteger(tokenInfo, "exp").value_or(0)
             };
 
         } catch (const std::exception& e) {
@@ -349,9 +536,8 @@ namespace nuansa::services::auth {
             }
 
             // Verify expiration
-            const auto exp = tokenInfo["exp"].get<int64_t>();
-            const auto now = std::chrono::system_clock::now().time_since_epoch().count() / 1000;
-            if (now >= exp) {
+            const auto exp = JsonInteger(tokenInfo, "exp");
+            if (!exp || UnixNow() >= *exp) {
                 LOG_ERROR << "Token has expired";
                 return false;
             }
@@ -389,15 +575,18 @@ namespace nuansa::services::auth {
             };
 
             LOG_DEBUG << "Exchanging code for token with body: " << requestBody.dump();
-            auto tokenResponse = httpClient->Post(
-                "https://github.com/login/oauth/access_token",
-                requestBody.dump(),
-                {
-                    "Accept: application/json",
-                    "Content-Type: application/json",
-                    "User-Agent: Nuansa-App"
-                }
-            );
+            auto tokenResponse = CallProvider(githubBreaker_, [&](const std::chrono::milliseconds timeout) {
+                return httpClient->Post(
+                    "https://github.com/login/oauth/access_token",
+                    requestBody.dump(),
+                    {
+                        "Accept: application/json",
+                        "Content-Type: application/json",
+                        "User-Agent: Nuansa-App"
+                    },
+                    "", "", timeout
+                );
+            });
 
             if (!tokenResponse.success) {
                 LOG_ERROR << "Failed to exchange code for token: " << tokenResponse.error 
@@ -411,19 +600,25 @@ namespace nuansa::services::auth {
             // Parse the token response
             auto tokenJson = nlohmann::json::parse(tokenResponse.body);
             std::string accessToken = tokenJson["access_token"].get<std::string>();
+            // Only expiring GitHub App tokens carry expires_in; classic tokens fall back to the cache cap
+            const auto expiresIn = JsonInteger(tokenJson, "expires_in");
+            const int64_t expiresAt = expiresIn ? UnixNow() + *expiresIn : 0;
             
             LOG_DEBUG << "Successfully obtained access token";
 
             // Now get user info using the access token
-            auto userResponse = httpClient->Get(
-                "https://api.github.com/user",
-                {
-                    "Authorization: Bearer " + accessToken,  // Changed to Bearer as per docs
-                    "Accept: application/vnd.github+json",
-                    "X-GitHub-Api-Version: 2022-11-28",
-                    "User-Agent: Nuansa-App"
-                }
-            );
+            auto userResponse = CallProvider(githubBreaker_, [&](const std::chrono::milliseconds timeout) {
+                return httpClient->Get(
+                    "https://api.github.com/user",
+                    {
+                        "Authorization: Bearer " + accessToken,  // Changed to Bearer as per docs
+                        "Accept: application/vnd.github+json",
+                        "X-GitHub-Api-Version: 2022-11-28",
+                        "User-Agent: Nuansa-App"
+                    },
+                    timeout
+                );
+            });
 
             if (!userResponse.success) {
                 LOG_ERROR << "Failed to get user info: " << userResponse.error;
@@ -433,15 +628,18 @@ namespace nuansa::services::auth {
             auto userInfo = nlohmann::json::parse(userResponse.body);
             
             // Get user email
-            auto emailResponse = httpClient->Get(
-                GITHUB_USER_EMAILS_URL,
-                {
-                    "Authorization: Bearer " + accessToken,
-                    "Accept: application/vnd.github+json",
-                    "X-GitHub-Api-Version: 2022-11-28",
-                    "User-Agent: Nuansa-App"
-                }
-            );
+            auto emailResponse = CallProvider(githubBreaker_, [&](const std::chrono::milliseconds timeout) {
+                return httpClient->Get(
+                    GITHUB_USER_EMAILS_URL,
+                    {
+                        "Authorization: Bearer " + accessToken,
+                        "Accept: application/vnd.github+json",
+                        "X-GitHub-Api-Version: 2022-11-28",
+                        "User-Agent: Nuansa-App"
+                    },
+                    timeout
+                );
+            });
 
             std::string primaryEmail;
             if (emailResponse.success) {
@@ -467,7 +665,8 @@ namespace nuansa::services::auth {
                 std::to_string(userInfo["id"].get<int>()),
                 primaryEmail,
                 userInfo["login"].get<std::string>(),
-                userInfo["avatar_url"].get<std::string>()
+                userInfo["avatar_url"].get<std::string>(),
+                expiresAt
             };
 
         } catch (const std::exception& e) {
@@ -476,6 +675,31 @@ namespace nuansa::services::auth {
         }
     }
 
+    utils::HttpClient::Response AuthService::CallProvider(
+        utils::pattern::CircuitBreaker& breaker,
+        const std::function<utils::HttpClient::Response(std::chrono::milliseconds)>& request) {
+        if (!breaker.AllowRequest()) {
+            LOG_WARNING << "Circuit breaker '" << breaker.GetName() << "' is open, skipping provider call";
+            return utils::HttpClient::Response{false, "", "Circuit breaker is OPEN for " + breaker.GetName(), 0, {}};
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        // curl aborts the transfer at the breaker's timeout, so a hung provider holds nothing past it
+        auto response = request(std::chrono::duration_cast<std::chrono::milliseconds>(breaker.GetSettings().timeout));
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+
+        // Transport errors and 5xx mean the provider is unhealthy; a rejected token does not
+        if (response.timedOut) {
+            breaker.RecordTimeout(elapsed);
+        } else if (response.statusCode == 0 || response.statusCode >= 500) {
+            breaker.RecordFailure(elapsed);
+        } else {
+            breaker.RecordSuccess(elapsed);
+        }
+        return response;
+    }
+
     bool AuthService::VerifyGitHubScopes(const std::vector<std::string>& headers) {
         // Look for the X-OAuth-Scopes header
         for (const auto& header : headers) {
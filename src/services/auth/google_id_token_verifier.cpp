@@ -0,0 +1,232 @@
+#include "nuansa/utils/pch.h"
+
+#include <charconv>
+
+#include "nuansa/services/auth/google_id_token_verifier.h"
+#include "nuansa/utils/crypto/crypto_util.h"
+#include <openssl/core_names.h>
+#include <openssl/param_build.h>
+
+namespace nuansa::services::auth {
+    using utils::crypto::CryptoUtil;
+
+    GoogleIdTokenVerifier::GoogleIdTokenVerifier(GoogleIdTokenVerifierSettings settings,
+                                                 utils::HttpClient &httpClient)
+        : settings_(std::move(settings)),
+          httpClient_(httpClient),
+          keys_(std::make_shared<const KeyMap>()) {
+        refresher_ = std::thread([this] { RefreshLoop(); });
+    }
+
+    GoogleIdTokenVerifier::~GoogleIdTokenVerifier() {
+        {
+            std::lock_guard<std::mutex> lock(refreshMutex_);
+            stopping_ = true;
+        }
+        refreshCondition_.notify_all();
+
+        if (refresher_.joinable()) {
+            refresher_.join();
+        }
+    }
+
+    std::optional<nlohmann::json> GoogleIdTokenVerifier::Verify(const std::string &idToken) {
+        try {
+            // header.payload.signature, each base64url
+            const auto firstDot = idToken.find('.');
+            const auto secondDot = firstDot == std::string::npos ? std::string::npos : idToken.find('.', firstDot + 1);
+            if (secondDot == std::string::npos || idToken.find('.', secondDot + 1) != std::string::npos) {
+                LOG_WARNING << "Malformed Google ID token";
+                return std::nullopt;
+            }
+
+            const auto header = nlohmann::json::parse(CryptoUtil::Base64UrlDecode(idToken.substr(0, firstDot)));
+            if (header.value("alg", "") != "RS256" || !header.contains("kid")) {
+                LOG_WARNING << "Unsupported Google ID token algorithm";
+                return std::nullopt;
+            }
+
+            const auto keys = Keys();
+            const auto key = keys->find(header["kid"].get<std::string>());
+            if (key == keys->end()) {
+                // Google may have rotated its keys; pick them up for the next attempt
+                LOG_WARNING << "Google ID token signed with unknown key id";
+                RequestRefresh();
+                return std::nullopt;
+            }
+
+            const auto signature = CryptoUtil::Base64UrlDecode(idToken.substr(secondDot + 1));
+            const std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+            if (!ctx || EVP_DigestVerifyInit(ctx.get(), nullptr, EVP_sha256(), nullptr, key->second.get()) != 1) {
+                throw std::runtime_error("Failed to initialize signature verification");
+            }
+
+            if (EVP_DigestVerify(ctx.get(),
+                                 reinterpret_cast<const unsigned char *>(signature.data()), signature.size(),
+                                 reinterpret_cast<const unsigned char *>(idToken.data()), secondDot) != 1) {
+                LOG_WARNING << "Google ID token signature mismatch";
+                return std::nullopt;
+            }
+
+            return nlohmann::json::parse(
+                CryptoUtil::Base64UrlDecode(idToken.substr(firstDot + 1, secondDot - firstDot - 1)));
+        } catch (const std::exception &e) {
+            LOG_WARNING << "Failed to verify Google ID token: " << e.what();
+            return std::nullopt;
+        }
+    }
+
+    bool GoogleIdTokenVerifier::HasKeys() const {
+        return !Keys()->empty();
+    }
+
+    size_t GoogleIdTokenVerifier::KeyCount() const {
+        return Keys()->size();
+    }
+
+    bool GoogleIdTokenVerifier::Refresh() {
+        return FetchKeys().has_value();
+    }
+
+    std::optional<std::chrono::seconds> GoogleIdTokenVerifier::ParseMaxAge(const std::vector<std::string> &headers) {
+        std::optional<std::chrono::seconds> maxAge;
+
+        // With redirects several header blocks are present; the last one wins
+        for (const auto &line: headers) {
+            std::string lower(line);
+            std::ranges::transform(lower, lower.begin(), [](const unsigned char c) { return std::tolower(c); });
+            if (!lower.starts_with("cache-control:")) {
+                continue;
+            }
+
+            const auto position = lower.find("max-age=");
+            if (position == std::string::npos) {
+                continue;
+            }
+
+            int64_t seconds = 0;
+            const char *begin = lower.data() + position + 8;
+            if (const auto [ptr, ec] = std::from_chars(begin, lower.data() + lower.size(), seconds);
+                ec == std::errc() && seconds >= 0) {
+                maxAge = std::chrono::seconds(seconds);
+            }
+        }
+        return maxAge;
+    }
+
+    std::optional<std::chrono::seconds> GoogleIdTokenVerifier::FetchKeys() {
+        const auto response = httpClient_.Get(settings_.jwksUrl, {"Accept: application/json"},
+                                              settings_.fetchTimeout);
+        if (!response.success) {
+            LOG_ERROR << "Failed to fetch Google JWKS: " << response.error;
+            return std::nullopt;
+        }
+
+        try {
+            const auto jwks = nlohmann::json::parse(response.body);
+            auto keys = std::make_shared<KeyMap>();
+            for (const auto &jwk: jwks.at("keys")) {
+                if (jwk.value("kty", "") != "RSA" || jwk.value("use", "sig") != "sig" ||
+                    jwk.value("alg", "RS256") != "RS256" || !jwk.contains("kid")) {
+                    continue;
+                }
+                keys->emplace(jwk["kid"].get<std::string>(), ParseRsaKey(jwk));
+            }
+
+            if (keys->empty()) {
+                LOG_ERROR << "Google JWKS contained no usable RS256 keys";
+                return std::nullopt;
+            }
+
+            LOG_INFO << "Loaded " << keys->size() << " Google signing keys";
+            {
+                std::lock_guard<std::mutex> lock(keysMutex_);
+                keys_ = std::move(keys);
+            }
+
+            return ParseMaxAge(response.headers).value_or(settings_.defaultMaxAge);
+        } catch (const std::exception &e) {
+            LOG_ERROR << "Failed to parse Google JWKS: " << e.what();
+            return std::nullopt;
+        }
+    }
+
+    void GoogleIdTokenVerifier::RefreshLoop() {
+        auto nextRefresh = std::chrono::steady_clock::now();
+        auto lastAttempt = std::chrono::steady_clock::time_point{};
+
+        std::unique_lock<std::mutex> lock(refreshMutex_);
+        while (!stopping_) {
+            refreshCondition_.wait_until(lock, nextRefresh, [this] { return stopping_ || refreshRequested_; });
+            if (stopping_) {
+                break;
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            if (refreshRequested_) {
+                refreshRequested_ = false;
+                // Unknown key ids are attacker-controlled; don't let them drive the fetch rate
+                if (now < nextRefresh && now - lastAttempt < settings_.minRefreshInterval) {
+                    continue;
+                }
+            }
+
+            lock.unlock();
+            const auto maxAge = FetchKeys();
+            lock.lock();
+
+            lastAttempt = std::chrono::steady_clock::now();
+            if (maxAge) {
+                // Refresh a little before the keys go stale
+                nextRefresh = lastAttempt + std::max<std::chrono::seconds>(settings_.minRefreshInterval,
+                                                                           *maxAge - *maxAge / 10);
+            } else {
+                nextRefresh = lastAttempt + settings_.retryInterval;
+            }
+        }
+    }
+
+    void GoogleIdTokenVerifier::RequestRefresh() {
+        {
+            std::lock_guard<std::mutex> lock(refreshMutex_);
+            refreshRequested_ = true;
+        }
+        refreshCondition_.notify_one();
+    }
+
+    std::shared_ptr<const GoogleIdTokenVerifier::KeyMap> GoogleIdTokenVerifier::Keys() const {
+        std::lock_guard<std::mutex> lock(keysMutex_);
+        return keys_;
+    }
+
+    std::shared_ptr<EVP_PKEY> GoogleIdTokenVerifier::ParseRsaKey(const nlohmann::json &jwk) {
+        const auto modulus = CryptoUtil::Base64UrlDecode(jwk.at("n").get<std::string>());
+        const auto exponent = CryptoUtil::Base64UrlDecode(jwk.at("e").get<std::string>());
+
+        const std::unique_ptr<BIGNUM, decltype(&BN_free)> n(
+            BN_bin2bn(reinterpret_cast<const unsigned char *>(modulus.data()), static_cast<int>(modulus.size()),
+                      nullptr), BN_free);
+        const std::unique_ptr<BIGNUM, decltype(&BN_free)> e(
+            BN_bin2bn(reinterpret_cast<const unsigned char *>(exponent.data()), static_cast<int>(exponent.size()),
+                      nullptr), BN_free);
+        const std::unique_ptr<OSSL_PARAM_BLD, decltype(&OSSL_PARAM_BLD_free)> builder(
+            OSSL_PARAM_BLD_new(), OSSL_PARAM_BLD_free);
+        if (!n || !e || !builder ||
+            OSSL_PARAM_BLD_push_BN(builder.get(), OSSL_PKEY_PARAM_RSA_N, n.get()) != 1 ||
+            OSSL_PARAM_BLD_push_BN(builder.get(), OSSL_PKEY_PARAM_RSA_E, e.get()) != 1) {
+            throw std::runtime_error("Failed to build RSA key parameters");
+        }
+
+        const std::unique_ptr<OSSL_PARAM, decltype(&OSSL_PARAM_free)> params(
+            OSSL_PARAM_BLD_to_param(builder.get()), OSSL_PARAM_free);
+        const std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> ctx(
+            EVP_PKEY_CTX_new_from_name(nullptr, "RSA", nullptr), EVP_PKEY_CTX_free);
+
+        EVP_PKEY *key = nullptr;
+        if (!params || !ctx || EVP_PKEY_fromdata_init(ctx.get()) != 1 ||
+            EVP_PKEY_fromdata(ctx.get(), &key, EVP_PKEY_PUBLIC_KEY, params.get()) != 1) {
+            throw std::runtime_error("Failed to load RSA public key");
+        }
+        return {key, EVP_PKEY_free};
+    }
+}
@@ -0,0 +1,64 @@
+#include "nuansa/services/chat/in_memory_mention_inbox.h"
+#include "nuansa/utils/log/log.h"
+
+namespace nuansa::services::chat {
+
+    InMemoryMentionInbox& InMemoryMentionInbox::GetInstance() {
+        static InMemoryMentionInbox instance;
+        return instance;
+    }
+
+    bool InMemoryMentionInbox::Append(const std::vector<InboxMention>& mentions, const size_t limit) {
+        const auto capacity = std::max<size_t>(1, limit);
+        const auto add = [&](const InboxMention& mention) {
+            return [&](std::deque<InboxMention>& inbox) {
+                inbox.push_back(mention);
+                while (inbox.size() > capacity) {
+                    inbox.pop_front();
+                }
+                return true;
+            };
+        };
+
+        size_t dropped = 0;
+        for (const auto& mention: mentions) {
+            if (inboxes_.Update(mention.recipient, add(mention))) {
+                continue;
+            }
+            // Only a new inbox counts against the cap; concurrent appends may overshoot it by a few
+            if (inboxes_.Size() >= maxRecipients_) {
+                ++dropped;
+                continue;
+            }
+            inboxes_.Upsert(mention.recipient, add(mention));
+        }
+
+        if (dropped > 0) {
+            LOG_WARNING << "Dropped " << dropped << " mentions: " << maxRecipients_ << " users already have an inbox";
+        }
+        return dropped < mentions.size() || mentions.empty();
+    }
+
+    std::vector<InboxMention> InMemoryMentionInbox::Take(const std::string& recipient, const size_t limit) {
+        auto inbox = inboxes_.Erase(recipient);
+        if (!inbox) {
+            return {};
+        }
+
+        std::vector<InboxMention> mentions(std::make_move_iterator(inbox->begin()),
+                                           std::make_move_iterator(inbox->end()));
+        std::ranges::stable_sort(mentions, {}, &InboxMention::timestamp);
+        if (mentions.size() > limit) {
+            mentions.erase(mentions.begin(), mentions.end() - static_cast<std::ptrdiff_t>(limit));
+        }
+        return mentions;
+    }
+
+    size_t InMemoryMentionInbox::Size() const {
+        size_t total = 0;
+        inboxes_.ForEach([&](const std::string&, const std::deque<InboxMention>& inbox) {
+            total += inbox.size();
+        });
+        return total;
+    }
+}
@@ -0,0 +1,117 @@
+#include "nuansa/services/chat/mention_inbox_repository.h"
+#include "nuansa/database/db_connection_pool.h"
+#include "nuansa/database/db_connection_guard.h"
+#include "nuansa/utils/log/log.h"
+
+namespace nuansa::services::chat {
+
+    MentionInboxRepository& MentionInboxRepository::GetInstance() {
+        static MentionInboxRepository instance;
+        return instance;
+    }
+
+    bool MentionInboxRepository::Append(const std::vector<InboxMention>& mentions, const size_t limit) {
+        if (mentions.empty()) {
+            return true;
+        }
+
+        try {
+            auto conn = database::ConnectionPool::GetInstance().AcquireConnection();
+            if (!conn) {
+                LOG_ERROR << "Failed to acquire database connection";
+                return false;
+            }
+
+            database::ConnectionGuard guard(std::move(conn));
+
+            return guard.ExecuteWithRetry([&](pqxx::connection& db_conn) {
+                pqxx::work txn{db_conn};
+
+                // One statement for the whole batch instead of a round trip per mention; the join
+                // drops rows for names that are not users
+                std::string insert =
+                        "INSERT INTO mention_inbox (recipient, message_id, sender, excerpt, created_at) "
+                        "SELECT v.recipient, v.message_id, v.sender, v.excerpt, v.created_at FROM (VALUES ";
+                insert.reserve(insert.size() + mentions.size() * 128);
+                std::string recipients;
+                for (size_t i = 0; i < mentions.size(); ++i) {
+                    const auto& mention = mentions[i];
+                    insert += i == 0 ? "(" : ",(";
+                    insert += txn.quote(mention.recipient);
+                    insert += ',';
+                    insert += txn.quote(mention.messageId);
+                    insert += ',';
+                    insert += txn.quote(mention.sender);
+                    insert += ',';
+                    insert += txn.quote(mention.excerpt);
+                    insert += ",to_timestamp(";
+                    insert += std::to_string(static_cast<int64_t>(mention.timestamp));
+                    insert += "))";
+
+                    recipients += i == 0 ? "" : ",";
+                    recipients += txn.quote(mention.recipient);
+                }
+                insert += ") AS v (recipient, message_id, sender, excerpt, created_at) "
+                        "JOIN users u ON u.username = v.recipient";
+                txn.exec(insert);
+
+                // Only the newest limit rows per recipient can ever be delivered, so the rest go now
+                txn.exec(
+                    "DELETE FROM mention_inbox WHERE ctid IN ("
+                    "SELECT ctid FROM (SELECT ctid, row_number() OVER "
+                    "(PARTITION BY recipient ORDER BY created_at DESC) AS rank "
+                    "FROM mention_inbox WHERE recipient IN (" + recipients + ")) ranked "
+                    "WHERE rank > " + std::to_string(std::max<size_t>(1, limit)) + ")");
+                txn.commit();
+                return true;
+            });
+        } catch (const std::exception& e) {
+            LOG_ERROR << "Failed to store " << mentions.size() << " mentions: " << e.what();
+            return false;
+        }
+    }
+
+    std::vector<InboxMention> MentionInboxRepository::Take(const std::string& recipient, const size_t limit) {
+        try {
+            auto conn = database::ConnectionPool::GetInstance().AcquireConnection();
+            if (!conn) {
+                LOG_ERROR << "Failed to acquire database connection";
+                return {};
+            }
+
+            database::ConnectionGuard guard(std::move(conn));
+
+            return guard.ExecuteWithRetry([&](pqxx::connection& db_conn) {
+                pqxx::work txn{db_conn};
+
+                // Append keeps at most limit rows per recipient; clear whatever is there
+                const auto result = txn.exec_params(
+                    "DELETE FROM mention_inbox WHERE recipient = $1 "
+                    "RETURNING message_id, sender, excerpt, EXTRACT(EPOCH FROM created_at)::BIGINT",
+                    recipient);
+                txn.commit();
+
+                std::vector<InboxMention> mentions;
+                mentions.reserve(result.size());
+                for (const auto& row: result) {
+                    mentions.push_back(InboxMention{
+                        recipient,
+                        row[0].as<std::string>(),
+                        row[1].as<std::string>(),
+                        row[2].as<std::string>(),
+                        static_cast<std::time_t>(row[3].as<int64_t>())
+                    });
+                }
+
+                std::ranges::stable_sort(mentions, {}, &InboxMention::timestamp);
+                if (mentions.size() > limit) {
+                    mentions.erase(mentions.begin(), mentions.end() - static_cast<std::ptrdiff_t>(limit));
+                }
+                return mentions;
+            });
+        } catch (const std::exception& e) {
+            LOG_ERROR << "Failed to load mentions for " << recipient << ": " << e.what();
+            return {};
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/services/storage/storage_registry.h"
+#include "nuansa/services/user/user_service.h"
+#include "nuansa/services/user/in_memory_user_service.h"
+#include "nuansa/services/token/token_repository.h"
+#include "nuansa/services/token/in_memory_token_repository.h"
+#include "nuansa/services/chat/mention_inbox_repository.h"
+#include "nuansa/services/chat/in_memory_mention_inbox.h"
+
+namespace nuansa::services::storage {
+    std::optional<StorageBackend> ParseStorageBackend(const std::string_view name) {
+        if (name == "postgres") {
+            return StorageBackend::Postgres;
+        }
+        if (name == "memory") {
+            return StorageBackend::InMemory;
+        }
+        return std::nullopt;
+    }
+
+    std::string_view ToString(const StorageBackend backend) {
+        return backend == StorageBackend::InMemory ? "memory" : "postgres";
+    }
+
+    StorageRegistry &StorageRegistry::GetInstance() {
+        static StorageRegistry instance;
+        return instance;
+    }
+
+    void StorageRegistry::Select(const StorageBackend backend) {
+        backend_.store(backend, std::memory_order_release);
+        LOG_INFO << "Storage backend: " << ToString(backend);
+    }
+
+    user::IUserService &StorageRegistry::Users() const {
+        if (GetBackend() == StorageBackend::InMemory) {
+            return user::InMemoryUserService::GetInstance();
+        }
+        return user::UserService::GetInstance();
+    }
+
+    token::ITokenRepository &StorageRegistry::Tokens() const {
+        if (GetBackend() == StorageBackend::InMemory) {
+            return token::InMemoryTokenRepository::GetInstance();
+        }
+        return token::TokenRepository::GetInstance();
+    }
+
+    chat::IMentionInbox &StorageRegistry::MentionInbox() const {
+        if (GetBackend() == StorageBackend::InMemory) {
+            return chat::InMemoryMentionInbox::GetInstance();
+        }
+        return chat::MentionInboxRepository::GetInstance();
+    }
+} // namespace nuansa::services::storage
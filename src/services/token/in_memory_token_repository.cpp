@@ -0,0 +1,131 @@
+#include "nuansa/services/token/in_memory_token_repository.h"
+#include "nuansa/utils/log/log.h"
+
+namespace nuansa::services::token {
+
+    InMemoryTokenRepository& InMemoryTokenRepository::GetInstance() {
+        static InMemoryTokenRepository instance;
+        return instance;
+    }
+
+    bool InMemoryTokenRepository::IsActive(const StoredToken& stored, const std::time_t now) {
+        return !stored.revoked && stored.token.expiry > now;
+    }
+
+    bool InMemoryTokenRepository::SaveToken(const TokenService::Token& token, const std::string& userId,
+                                            const std::string& tokenType) {
+        if (!tokens_.Insert(token.token_id, StoredToken{token, userId, tokenType})) {
+            LOG_ERROR << "Token already exists: " << token.token_id;
+            return false;
+        }
+
+        tokensByUser_.Upsert(userId, [&](std::vector<std::string>& tokenIds) {
+            tokenIds.push_back(token.token_id);
+        });
+        return true;
+    }
+
+    bool InMemoryTokenRepository::RevokeToken(const std::string& tokenId) {
+        return tokens_.Update(tokenId, [](StoredToken& stored) {
+            return !std::exchange(stored.revoked, true);
+        });
+    }
+
+    bool InMemoryTokenRepository::IsTokenRevoked(const std::string& tokenId) const {
+        const auto stored = tokens_.Find(tokenId);
+        return stored && stored->revoked;
+    }
+
+    bool InMemoryTokenRepository::IsTokenActive(const std::string& tokenId) const {
+        const auto stored = tokens_.Find(tokenId);
+        return stored && IsActive(*stored, std::time(nullptr));
+    }
+
+    bool InMemoryTokenRepository::CleanupExpiredTokens() {
+        const auto now = std::time(nullptr);
+
+        std::vector<std::pair<std::string, std::string> > expired;
+        tokens_.EraseIf([&](const std::string& tokenId, const StoredToken& stored) {
+            if (stored.token.expiry > now) {
+                return false;
+            }
+            expired.emplace_back(stored.userId, tokenId);
+            return true;
+        });
+
+        for (const auto& [userId, tokenId]: expired) {
+            tokensByUser_.Update(userId, [&](std::vector<std::string>& tokenIds) {
+                std::erase(tokenIds, tokenId);
+                return true;
+            });
+        }
+        tokensByUser_.EraseIf([](const std::string&, const std::vector<std::string>& tokenIds) {
+            return tokenIds.empty();
+        });
+
+        LOG_INFO << "Cleaned up " << expired.size() << " expired tokens";
+        return true;
+    }
+
+    std::optional<std::string> InMemoryTokenRepository::GetUserIdFromToken(const std::string& tokenId) const {
+        const auto stored = tokens_.Find(tokenId);
+        if (!stored || !IsActive(*stored, std::time(nullptr))) {
+            return std::nullopt;
+        }
+        return stored->userId;
+    }
+
+    std::optional<std::time_t> InMemoryTokenRepository::GetTokenExpiry(const std::string& tokenId) const {
+        const auto stored = tokens_.Find(tokenId);
+        if (!stored) {
+            return std::nullopt;
+        }
+        return stored->token.expiry;
+    }
+
+    std::vector<TokenService::Token> InMemoryTokenRepository::GetActiveTokensForUser(
+        const std::string& userId) const {
+        std::vector<TokenService::Token> tokens;
+        const auto tokenIds = tokensByUser_.Find(userId);
+        if (!tokenIds) {
+            return tokens;
+        }
+
+        const auto now = std::time(nullptr);
+        for (const auto& tokenId: *tokenIds) {
+            if (const auto stored = tokens_.Find(tokenId); stored && IsActive(*stored, now)) {
+                tokens.push_back(stored->token);
+            }
+        }
+        return tokens;
+    }
+
+    bool InMemoryTokenRepository::RevokeAllTokensForUser(const std::string& userId) {
+        size_t revoked = 0;
+        if (const auto tokenIds = tokensByUser_.Find(userId)) {
+            for (const auto& tokenId: *tokenIds) {
+                revoked += RevokeToken(tokenId) ? 1 : 0;
+            }
+        }
+
+        LOG_INFO << "Revoked " << revoked << " tokens for user: " << userId;
+        return true;
+    }
+
+    bool InMemoryTokenRepository::IsTokenValid(const std::string& tokenId) const {
+        return IsTokenActive(tokenId);
+    }
+
+    std::optional<TokenService::Token> InMemoryTokenRepository::GetToken(const std::string& tokenId) const {
+        const auto stored = tokens_.Find(tokenId);
+        if (!stored || stored->revoked) {
+            return std::nullopt;
+        }
+        return stored->token;
+    }
+
+    void InMemoryTokenRepository::Clear() {
+        tokens_.Clear();
+        tokensByUser_.Clear();
+    }
+}
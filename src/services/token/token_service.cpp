@@ -1,9 +1,37 @@
 #include "nuansa/utils/random_generator.h"
 #include "nuansa/services/token/token_service.h"
-#include "nuansa/services/token/token_repository.h"
+#include "nuansa/services/storage/storage_registry.h"
 #include "nuansa/database/db_connection_pool.h"
+#include "nuansa/utils/metrics/metrics.h"
 
 namespace nuansa::services::token {
+    namespace {
+        struct TokenMetrics {
+            utils::metrics::Counter &issuedAccess;
+            utils::metrics::Counter &issuedRefresh;
+            utils::metrics::Counter &valid;
+            utils::metrics::Counter &invalid;
+            utils::metrics::Histogram &validateDuration;
+        };
+
+        TokenMetrics &Metrics() {
+            static TokenMetrics metrics = [] {
+                auto &registry = utils::metrics::MetricsRegistry::GetInstance();
+                const std::string issued = "nuansa_tokens_issued_total";
+                const std::string validations = "nuansa_token_validations_total";
+                return TokenMetrics{
+                    .issuedAccess = registry.GetCounter(issued, "Tokens generated", {{"type", "access"}}),
+                    .issuedRefresh = registry.GetCounter(issued, "Tokens generated", {{"type", "refresh"}}),
+                    .valid = registry.GetCounter(validations, "Token validations", {{"result", "valid"}}),
+                    .invalid = registry.GetCounter(validations, "Token validations", {{"result", "invalid"}}),
+                    .validateDuration = registry.GetHistogram("nuansa_token_validate_duration_seconds",
+                                                              "Time to check a token against the repository",
+                                                              {}, 1e-6)
+                };
+            }();
+            return metrics;
+        }
+    }
 
     TokenService::TokenService(const std::string& secret_key)
         : secret_key_(secret_key), gen_(rd_()) {
@@ -60,7 +88,8 @@ namespace nuansa::services::token {
         
         std::string data = CreateTokenData(token.token_id, token.expiry, user_id);
         token.signature = CreateSignature(data);
-        
+
+        Metrics().issuedAccess.Increment();
         return token;
     }
 
@@ -71,7 +100,8 @@ namespace nuansa::services::token {
         
         std::string data = CreateTokenData(token.token_id, token.expiry, user_id);
         token.signature = CreateSignature(data);
-        
+
+        Metrics().issuedRefresh.Increment();
         return token;
     }
 
@@ -80,7 +110,7 @@ namespace nuansa::services::token {
             return false;
         }
         
-        auto& repo = services::token::TokenRepository::GetInstance();
+        auto& repo = services::storage::StorageRegistry::GetInstance().Tokens();
         return !repo.IsTokenRevoked(token.token_id);
     }
 
@@ -89,11 +119,11 @@ namespace nuansa::services::token {
     }
 
     void TokenService::RevokeToken(const std::string& token_id) {
-        services::token::TokenRepository::GetInstance().RevokeToken(token_id);
+        services::storage::StorageRegistry::GetInstance().Tokens().RevokeToken(token_id);
     }
 
     bool TokenService::IsTokenRevoked(const std::string& token_id) const {
-        return services::token::TokenRepository::GetInstance().IsTokenRevoked(token_id);
+        return services::storage::StorageRegistry::GetInstance().Tokens().IsTokenRevoked(token_id);
     }
 
     std::optional<std::string> TokenService::ExtractUserIdFromToken(const Token& token) const {
@@ -116,27 +146,32 @@ namespace nuansa::services::token {
     }
 
     bool TokenService::ValidateToken(const std::string& token_id) const {
-        auto& repo = services::token::TokenRepository::GetInstance();
-        
+        auto& repo = services::storage::StorageRegistry::GetInstance().Tokens();
+        auto& metrics = Metrics();
+        const utils::metrics::ScopedTimer timer(metrics.validateDuration);
+
         if (!repo.IsTokenActive(token_id)) {
+            metrics.invalid.Increment();
             return false;
         }
 
         auto expiry = repo.GetTokenExpiry(token_id);
         if (!expiry || std::time(nullptr) > *expiry) {
             repo.RevokeToken(token_id);
+            metrics.invalid.Increment();
             return false;
         }
 
+        metrics.valid.Increment();
         return true;
     }
 
     void TokenService::CleanupExpiredTokens() {
-        services::token::TokenRepository::GetInstance().CleanupExpiredTokens();
+        services::storage::StorageRegistry::GetInstance().Tokens().CleanupExpiredTokens();
     }
 
     void TokenService::LogoutToken(const std::string& token_id) {
-        auto& repo = services::token::TokenRepository::GetInstance();
+        auto& repo = services::storage::StorageRegistry::GetInstance().Tokens();
         
         if (repo.IsTokenActive(token_id)) {
             if (repo.RevokeToken(token_id)) {
@@ -150,7 +185,7 @@ namespace nuansa::services::token {
     }
 
     std::optional<std::string> TokenService::GetUsernameFromToken(const std::string& token_id) const {
-        auto& repo = services::token::TokenRepository::GetInstance();
+        auto& repo = services::storage::StorageRegistry::GetInstance().Tokens();
         
         if (!repo.IsTokenActive(token_id)) {
             return std::nullopt;
@@ -160,7 +195,7 @@ namespace nuansa::services::token {
     }
 
     bool TokenService::SaveNewToken(const Token& token, const std::string& username, const std::string& type) {
-        auto& repo = services::token::TokenRepository::GetInstance();
+        auto& repo = services::storage::StorageRegistry::GetInstance().Tokens();
         
         if (!repo.SaveToken(token, username, type)) {
             LOG_ERROR << "Failed to save token for user: " << username;
@@ -185,7 +220,7 @@ namespace nuansa::services::token {
     }
 
     std::vector<TokenService::Token> TokenService::GetActiveTokensForUser(const std::string& user_id) const {
-        auto& repo = services::token::TokenRepository::GetInstance();
+        auto& repo = services::storage::StorageRegistry::GetInstance().Tokens();
         std::vector<Token> tokens;
         
         try {
@@ -201,7 +236,7 @@ namespace nuansa::services::token {
     }
 
     void TokenService::RevokeAllTokensForUser(const std::string& user_id) {
-        auto& repo = services::token::TokenRepository::GetInstance();
+        auto& repo = services::storage::StorageRegistry::GetInstance().Tokens();
         try {
             repo.RevokeAllTokensForUser(user_id);
             LOG_INFO << "Revoked all tokens for user: " << user_id;
@@ -0,0 +1,192 @@
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/services/user/in_memory_user_service.h"
+#include "nuansa/utils/crypto/password_hasher.h"
+#include "nuansa/utils/validation.h"
+
+namespace nuansa::services::user {
+    InMemoryUserService &InMemoryUserService::GetInstance() {
+        static InMemoryUserService instance;
+        return instance;
+    }
+
+    void InMemoryUserService::Initialize() {
+        LOG_INFO << "UserService using the in-memory backend with " << usersByUsername_.Size() << " users";
+    }
+
+    std::optional<std::pair<nuansa::models::User, InMemoryUserService::IdentityGuard> >
+    InMemoryUserService::LockUser(const std::string &username, const std::string_view newEmail) {
+        // Writes to a user hold its stripes, so the email read after locking is stable;
+        // if it moved between the unlocked read and the lock, take the new one's stripe instead
+        while (true) {
+            const auto user = usersByUsername_.Find(username);
+            if (!user) {
+                return std::nullopt;
+            }
+
+            auto guard = identityLocks_.Lock({username, user->GetEmail(), newEmail});
+            auto current = usersByUsername_.Find(username);
+            if (!current) {
+                return std::nullopt;
+            }
+            if (current->GetEmail() == user->GetEmail()) {
+                return std::make_pair(std::move(*current), std::move(guard));
+            }
+        }
+    }
+
+    std::optional<nuansa::models::User> InMemoryUserService::GetUserByUsername(const std::string &username) const {
+        return usersByUsername_.Find(username);
+    }
+
+    std::optional<nuansa::models::User> InMemoryUserService::GetUserByEmail(const std::string &email) {
+        const auto username = usernamesByEmail_.Find(email);
+        if (!username) {
+            return std::nullopt;
+        }
+
+        // The index can briefly point at a user whose email was just changed
+        auto user = usersByUsername_.Find(*username);
+        if (!user || user->GetEmail() != email) {
+            return std::nullopt;
+        }
+        return user;
+    }
+
+    bool InMemoryUserService::IsEmailTaken(const std::string &email) const {
+        return usernamesByEmail_.Contains(email);
+    }
+
+    bool InMemoryUserService::IsUsernameTaken(const std::string &username) const {
+        return usersByUsername_.Contains(username);
+    }
+
+    bool InMemoryUserService::UserExists(const std::string &username) const {
+        return usersByUsername_.Contains(username) || usernamesByEmail_.Contains(username);
+    }
+
+    bool InMemoryUserService::CreateUser(const nuansa::models::User &user) {
+        const auto guard = identityLocks_.Lock({user.GetUsername(), user.GetEmail()});
+
+        if (usersByUsername_.Contains(user.GetUsername()) || usernamesByEmail_.Contains(user.GetEmail())) {
+            LOG_WARNING << "User already exists: " << user.GetUsername();
+            return false;
+        }
+
+        // Username first, so an email lookup never finds an index entry without its user
+        usersByUsername_.Insert(user.GetUsername(), user);
+        usernamesByEmail_.Insert(user.GetEmail(), user.GetUsername());
+        return true;
+    }
+
+    bool InMemoryUserService::AuthenticateUser(const std::string &username, const std::string &password) {
+        try {
+            const auto user = GetUserByUsername(username);
+            if (!user) {
+                return false;
+            }
+
+            auto &hasher = nuansa::utils::crypto::PasswordHasher::GetInstance();
+            const auto verification = hasher.Verify(password, user->GetSalt(), user->GetPasswordHash());
+            if (!verification.matches) {
+                return false;
+            }
+
+            if (verification.needsRehash &&
+                ReplacePasswordHash(username, user->GetPasswordHash(), hasher.Hash(password))) {
+                LOG_INFO << "Upgraded password hash for user: " << username;
+            }
+
+            return true;
+        } catch (const nuansa::utils::exception::WorkerPoolRejectedException &) {
+            throw; // Let the caller report "server busy" rather than "invalid credentials"
+        } catch (const std::exception &e) {
+            LOG_ERROR << "Error authenticating user: " << e.what();
+            return false;
+        }
+    }
+
+    bool InMemoryUserService::UpdateUserEmail(const std::string &username, const std::string &newEmail) {
+        if (!nuansa::utils::Validation::ValidateEmail(newEmail)) {
+            LOG_ERROR << "Invalid email format";
+            return false;
+        }
+
+        const auto locked = LockUser(username, newEmail);
+        if (!locked) {
+            return false;
+        }
+
+        const auto oldEmail = locked->first.GetEmail();
+        if (oldEmail == newEmail) {
+            return true;
+        }
+        if (usernamesByEmail_.Contains(newEmail)) {
+            LOG_WARNING << "Email already registered: " << newEmail;
+            return false;
+        }
+
+        usernamesByEmail_.Insert(newEmail, username);
+        usersByUsername_.Update(username, [&](nuansa::models::User &stored) {
+            stored = nuansa::models::User(stored.GetUsername(), newEmail, stored.GetPasswordHash(),
+                                          stored.GetSalt(), stored.GetPicture());
+            return true;
+        });
+        usernamesByEmail_.Erase(oldEmail);
+
+        LOG_INFO << "Email updated for user: " << username;
+        return true;
+    }
+
+    bool InMemoryUserService::UpdateUserPassword(const std::string &username, const std::string &newPassword) {
+        try {
+            if (!nuansa::utils::Validation::ValidatePassword(newPassword)) {
+                LOG_WARNING << "Invalid password format";
+                return false;
+            }
+
+            const auto hashedPassword = nuansa::utils::crypto::PasswordHasher::GetInstance().Hash(newPassword);
+            if (!ReplacePasswordHash(username, std::nullopt, hashedPassword)) {
+                return false;
+            }
+
+            LOG_INFO << "Password updated for user: " << username;
+            return true;
+        } catch (const std::exception &e) {
+            LOG_ERROR << "Error updating user password: " << e.what();
+            return false;
+        }
+    }
+
+    bool InMemoryUserService::ReplacePasswordHash(const std::string &username,
+                                                  const std::optional<std::string> &expectedHash,
+                                                  const std::string &newHash) {
+        // The salt is embedded in new hashes, so the legacy salt is cleared
+        return usersByUsername_.Update(username, [&](nuansa::models::User &stored) {
+            if (expectedHash && stored.GetPasswordHash() != *expectedHash) {
+                return false;
+            }
+            stored = nuansa::models::User(stored.GetUsername(), stored.GetEmail(), newHash, "",
+                                          stored.GetPicture());
+            return true;
+        });
+    }
+
+    bool InMemoryUserService::DeleteUser(const std::string &username) {
+        const auto locked = LockUser(username);
+        if (!locked) {
+            return false;
+        }
+
+        usernamesByEmail_.Erase(locked->first.GetEmail());
+        usersByUsername_.Erase(username);
+
+        LOG_INFO << "User deleted: " << username;
+        return true;
+    }
+
+    void InMemoryUserService::Clear() {
+        usernamesByEmail_.Clear();
+        usersByUsername_.Clear();
+    }
+} // namespace nuansa::services::user
@@ -9,9 +9,37 @@
 #include "nuansa/database/db_connection_guard.h"
 #include "nuansa/config/config.h"
 #include "nuansa/utils/crypto/crypto_util.h"
+#include "nuansa/utils/crypto/password_hasher.h"
 #include "nuansa/utils/validation.h"
 
 namespace nuansa::services::user {
+    namespace {
+        // What is left of deadline as a wait timeout, never negative
+        std::chrono::milliseconds Remaining(const std::chrono::steady_clock::time_point deadline) {
+            return std::max(std::chrono::milliseconds::zero(), std::chrono::duration_cast<std::chrono::milliseconds>(
+                                deadline - std::chrono::steady_clock::now()));
+        }
+
+        // One query under the breaker's timeout; waiting for a connection and the statement share the deadline
+        template<typename F>
+        auto QueryWithDeadline(utils::pattern::CircuitBreaker &breaker, F &&func) {
+            if (!nuansa::database::ConnectionPool::GetInstance().IsInitialized()) {
+                LOG_ERROR << "Connection pool not initialized";
+                throw std::runtime_error("Database connection pool not initialized");
+            }
+
+            return breaker.ExecuteWithTimeout([&](const auto deadline) {
+                auto conn = nuansa::database::ConnectionPool::GetInstance().AcquireConnection(Remaining(deadline));
+                if (!conn) {
+                    throw std::runtime_error("Failed to acquire database connection");
+                }
+
+                nuansa::database::ConnectionGuard guard(std::move(conn));
+                return guard.ExecuteWithDeadline(deadline, std::forward<F>(func));
+            });
+        }
+    }
+
     UserService &UserService::GetInstance() {
         static UserService instance;
         return instance;
@@ -39,6 +67,110 @@ namespace nuansa::services::user {
 
         // Reset circuit breaker state
         circuitBreaker_.Reset();
+
+        // Drop cached rows, the table may have been changed behind our back
+        cacheGeneration_.fetch_add(1, std::memory_order_acq_rel);
+        usersByUsername_.Clear();
+        usersByEmail_.Clear();
+
+        LoadIdentityFilters();
+    }
+
+    void UserService::LoadIdentityFilters() {
+        try {
+            if (!nuansa::database::ConnectionPool::GetInstance().IsInitialized()) {
+                LOG_WARNING << "Connection pool not initialized, skipping identity filter load";
+                return;
+            }
+
+            auto conn = nuansa::database::ConnectionPool::GetInstance().AcquireConnection(
+                std::chrono::milliseconds(1000)
+            );
+
+            if (!conn) {
+                LOG_WARNING << "Failed to acquire database connection for identity filter load";
+                return;
+            }
+
+            nuansa::database::ConnectionGuard guard(std::move(conn));
+            const auto start = std::chrono::steady_clock::now();
+
+            auto filters = guard.ExecuteWithRetry([&](pqxx::connection &db_conn) {
+                pqxx::read_transaction txn{db_conn};
+
+                // Leave headroom for growth so the false positive rate stays close to target until the next load
+                const auto userCount = txn.exec("SELECT COUNT(*) FROM users")[0][0].as<size_t>();
+                auto loading = std::make_shared<IdentityFilters>(utils::cache::CountingBloomFilterSettings{
+                    .expectedItems = std::max<size_t>(100000, userCount * 2),
+                    .falsePositiveRate = 0.01
+                });
+
+                {
+                    std::lock_guard<std::mutex> lock(identityFilterMutex_);
+                    pendingIdentityFilters_ = loading;
+                }
+
+                for (const auto &[username, email]:
+                     txn.stream<std::string_view, std::string_view>("SELECT username, email FROM users")) {
+                    loading->usernames.Add(username);
+                    loading->emails.Add(email);
+                }
+
+                return loading;
+            });
+
+            {
+                std::lock_guard<std::mutex> lock(identityFilterMutex_);
+                identityFilters_ = filters;
+                pendingIdentityFilters_.reset();
+            }
+
+            LOG_INFO << "Identity filters loaded: " << filters->usernames.ItemCount() << " users, "
+                    << filters->usernames.SlotCount() << " slots per filter, in "
+                    << std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - start).count() << "ms";
+        } catch (const std::exception &e) {
+            LOG_WARNING << "Failed to load identity filters, availability checks will query the database: "
+                    << e.what();
+            std::lock_guard<std::mutex> lock(identityFilterMutex_);
+            pendingIdentityFilters_.reset();
+        }
+    }
+
+    std::shared_ptr<UserService::IdentityFilters> UserService::GetIdentityFilters() const {
+        std::lock_guard<std::mutex> lock(identityFilterMutex_);
+        return identityFilters_;
+    }
+
+    void UserService::AddIdentity(const std::string &username, const std::string &email) {
+        std::lock_guard<std::mutex> lock(identityFilterMutex_);
+        for (const auto &filters: {identityFilters_, pendingIdentityFilters_}) {
+            if (filters) {
+                filters->usernames.Add(username);
+                filters->emails.Add(email);
+            }
+        }
+    }
+
+    void UserService::RemoveIdentity(const std::string &username, const std::string &email) {
+        // A pending filter may not have streamed this row yet, so removing from it could
+        // clear slots owned by other users; it's left with a harmless stale entry instead.
+        std::lock_guard<std::mutex> lock(identityFilterMutex_);
+        if (identityFilters_) {
+            identityFilters_->usernames.Remove(username);
+            identityFilters_->emails.Remove(email);
+        }
+    }
+
+    void UserService::ReplaceEmailIdentity(const std::string &oldEmail, const std::string &newEmail) {
+        std::lock_guard<std::mutex> lock(identityFilterMutex_);
+        if (identityFilters_) {
+            identityFilters_->emails.Remove(oldEmail);
+            identityFilters_->emails.Add(newEmail);
+        }
+        if (pendingIdentityFilters_) {
+            pendingIdentityFilters_->emails.Add(newEmail);
+        }
     }
 
     pqxx::connection *UserService::GetConnection() const {
@@ -53,27 +185,100 @@ namespace nuansa::services::user {
         }
     }
 
+    std::optional<nuansa::models::User> UserService::FetchUser(const UserKey key, const std::string &value) const {
+        return QueryWithDeadline(circuitBreaker_, [&](pqxx::connection &db_conn) {
+            pqxx::work txn{db_conn};
+
+            const auto result = txn.exec_params(
+                key == UserKey::Username
+                    ? "SELECT username, email, password_hash, salt, picture FROM users WHERE username = $1"
+                    : "SELECT username, email, password_hash, salt, picture FROM users WHERE email = $1",
+                value
+            );
+
+            if (result.empty()) {
+                return std::optional<nuansa::models::User>();
+            }
+
+            return std::optional<nuansa::models::User>(nuansa::models::User(
+                result[0]["username"].as<std::string>(),
+                result[0]["email"].as<std::string>(),
+                result[0]["password_hash"].as<std::string>(),
+                result[0]["salt"].as<std::string>(),
+                result[0]["picture"].as<std::string>()
+            ));
+        });
+    }
+
+    bool UserService::MightHaveIdentity(const UserKey key, const std::string &value) const {
+        const auto filters = GetIdentityFilters();
+        return !filters || (key == UserKey::Username ? filters->usernames : filters->emails).MightContain(value);
+    }
+
+    std::optional<nuansa::models::User> UserService::LookupUser(const UserKey key, const std::string &value) const {
+        auto &cache = key == UserKey::Username ? usersByUsername_ : usersByEmail_;
+        if (auto cached = cache.Get(value); cached.hit) {
+            return std::move(cached.value);
+        }
+
+        // Remember the generation so a concurrent write can't be shadowed by the row or "not found" read before it
+        const auto generation = cacheGeneration_.load(std::memory_order_acquire);
+        auto user = FetchUser(key, value);
+
+        if (generation != cacheGeneration_.load(std::memory_order_acquire)) {
+            return user;
+        }
+        if (user) {
+            CacheUser(*user);
+        } else {
+            cache.PutNegative(value);
+        }
+
+        // An invalidation between the check and the put may have missed what was just cached
+        if (generation != cacheGeneration_.load(std::memory_order_acquire)) {
+            if (user) {
+                usersByUsername_.Erase(user->GetUsername());
+                usersByEmail_.Erase(user->GetEmail());
+            } else {
+                cache.Erase(value);
+            }
+        }
+
+        return user;
+    }
+
+    void UserService::CacheUser(const nuansa::models::User &user) const {
+        usersByUsername_.Put(user.GetUsername(), user);
+        usersByEmail_.Put(user.GetEmail(), user);
+    }
+
+    void UserService::InvalidateUser(const std::string &username, const std::string &email) const {
+        cacheGeneration_.fetch_add(1, std::memory_order_acq_rel);
+        usersByUsername_.Erase(username);
+        usersByEmail_.Erase(email);
+    }
+
     bool UserService::UserExists(const std::string& username) const {
         try {
             LOG_DEBUG << "Checking if user exists: " << username;
-            
-            if (!nuansa::database::ConnectionPool::GetInstance().IsInitialized()) {
-                LOG_ERROR << "Connection pool not initialized";
-                throw std::runtime_error("Database connection pool not initialized");
-            }
 
-            auto conn = nuansa::database::ConnectionPool::GetInstance().AcquireConnection(
-                std::chrono::milliseconds(1000)
-            );
+            // The identifier may be either a username or an email, so consult both indexes
+            const auto byUsername = usersByUsername_.Get(username);
+            const auto byEmail = usersByEmail_.Get(username);
+            if (byUsername.value || byEmail.value) {
+                return true;
+            }
+            if (byUsername.hit && byEmail.hit) {
+                return false;
+            }
 
-            if (!conn) {
-                LOG_ERROR << "Failed to acquire database connection";
-                throw std::runtime_error("Failed to acquire database connection");
+            if (const auto filters = GetIdentityFilters();
+                filters && !filters->usernames.MightContain(username) && !filters->emails.MightContain(username)) {
+                return false;
             }
 
-            nuansa::database::ConnectionGuard guard(std::move(conn));
-            
-            return guard.ExecuteWithRetry([&](pqxx::connection& db_conn) {
+            const auto generation = cacheGeneration_.load(std::memory_order_acquire);
+            const bool exists = QueryWithDeadline(circuitBreaker_, [&](pqxx::connection& db_conn) {
                 try {
                     pqxx::work txn{db_conn};
                     
@@ -91,10 +296,16 @@ namespace nuansa::services::user {
                     return exists;
                 } catch (const std::exception& e) {
                     LOG_ERROR << "Database query failed: " << e.what();
-                    throw; // Let ExecuteWithRetry handle the retry logic
+                    throw; // Counted by the circuit breaker
                 }
             });
 
+            if (!exists && generation == cacheGeneration_.load(std::memory_order_acquire)) {
+                usersByUsername_.PutNegative(username);
+                usersByEmail_.PutNegative(username);
+            }
+
+            return exists;
         } catch (const std::exception& e) {
             LOG_ERROR << "Error checking if user exists: " << e.what();
             throw; // Re-throw to be caught by caller
@@ -104,49 +315,7 @@ namespace nuansa::services::user {
     // TODO: Fix error in this function when registering new user
     std::optional<nuansa::models::User> UserService::GetUserByUsername(const std::string &username) const {
         try {
-            if (!nuansa::database::ConnectionPool::GetInstance().IsInitialized()) {
-                LOG_ERROR << "Connection pool not initialized";
-                return std::nullopt;
-            }
-
-            auto conn = nuansa::database::ConnectionPool::GetInstance().AcquireConnection(
-                std::chrono::milliseconds(1000)
-            );
-
-            if (!conn) {
-                LOG_ERROR << "Failed to acquire database connection";
-                return std::nullopt;
-            }
-
-            nuansa::database::ConnectionGuard guard(std::move(conn));
-            
-            try {
-                return guard.ExecuteWithRetry([&](pqxx::connection &db_conn) {
-                    pqxx::work txn{db_conn};
-
-                    const auto result = txn.exec_params(
-                        "SELECT username, email, password_hash, salt, picture "
-                        "FROM users WHERE username = $1",
-                        username
-                    );
-
-                    if (result.empty()) {
-                        return std::optional<nuansa::models::User>();
-                    }
-
-                    return std::optional<nuansa::models::User>(nuansa::models::User(
-                        result[0]["username"].as<std::string>(),
-                        result[0]["email"].as<std::string>(),
-                        result[0]["password_hash"].as<std::string>(),
-                        result[0]["salt"].as<std::string>(),
-                        result[0]["picture"].as<std::string>()
-                    ));
-                });
-            } catch (const std::exception& e) {
-                LOG_ERROR << "Database query failed: " << e.what();
-                return std::nullopt;
-            }
-
+            return LookupUser(UserKey::Username, username);
         } catch (const std::exception &e) {
             LOG_ERROR << "Error retrieving user by username: " << e.what();
             return std::nullopt;
@@ -155,26 +324,7 @@ namespace nuansa::services::user {
 
     std::optional<nuansa::models::User> UserService::GetUserByEmail(const std::string &email) {
         try {
-            const auto conn = nuansa::database::ConnectionPool::GetInstance().AcquireConnection();
-            nuansa::database::ConnectionGuard guard(conn);
-            pqxx::work txn{*conn};
-
-            const auto result = txn.exec_params(
-                "SELECT username, email, password_hash, salt, picture FROM users WHERE email = $1",
-                email);
-
-            if (result.empty()) {
-                return std::nullopt;
-            }
-
-            return std::optional<nuansa::models::User>(nuansa::models::User(
-                result[0]["username"].as<std::string>(),
-                result[0]["email"].as<std::string>(),
-                result[0]["password_hash"].as<std::string>(),
-                result[0]["salt"].as<std::string>(),
-                result[0]["picture"].as<std::string>()
-            ));
-
+            return LookupUser(UserKey::Email, email);
         } catch (const std::exception &e) {
             LOG_ERROR << "Error retrieving user by email: " << e.what();
             return std::nullopt;
@@ -183,15 +333,10 @@ namespace nuansa::services::user {
 
     bool UserService::IsEmailTaken(const std::string &email) const {
         try {
-            const auto conn = nuansa::database::ConnectionPool::GetInstance().AcquireConnection();
-            nuansa::database::ConnectionGuard guard(conn);
-            pqxx::work txn{*conn};
-
-            const auto result = txn.exec_params(
-                "SELECT 1 FROM users WHERE email = $1",
-                email);
-
-            return !result.empty();
+            if (!MightHaveIdentity(UserKey::Email, email)) {
+                return false;
+            }
+            return LookupUser(UserKey::Email, email).has_value();
         } catch (const std::exception &e) {
             LOG_ERROR << "Error checking email: " << e.what();
             return false;
@@ -200,112 +345,55 @@ namespace nuansa::services::user {
 
     bool UserService::IsUsernameTaken(const std::string &username) const {
         try {
-            const auto conn = nuansa::database::ConnectionPool::GetInstance().AcquireConnection();
-            nuansa::database::ConnectionGuard guard(conn);
-            pqxx::work txn{*conn};
-
-            const auto result = txn.exec_params(
-                "SELECT 1 FROM users WHERE username = $1",
-                username);
-
-            return !result.empty();
+            if (!MightHaveIdentity(UserKey::Username, username)) {
+                return false;
+            }
+            return LookupUser(UserKey::Username, username).has_value();
         } catch (const std::exception &e) {
             LOG_ERROR << "Error checking username: " << e.what();
             return false;
         }
     }
 
-    // TODO: refactor this
-    namespace {
-        constexpr size_t SALT_LENGTH = 16;
-        constexpr size_t HASH_LENGTH = 32;
-        constexpr int ITERATIONS = 10000;
-
-        std::string bytesToHex(const unsigned char *data, const size_t len) {
-            std::stringstream ss;
-            ss << std::hex << std::setfill('0');
-            for (size_t i = 0; i < len; i++) {
-                ss << std::setw(2) << static_cast<int>(data[i]);
-            }
-            return ss.str();
-        }
-
-        std::vector<unsigned char> hexToBytes(const std::string &hex) {
-            std::vector<unsigned char> bytes;
-            for (size_t i = 0; i < hex.length(); i += 2) {
-                std::string byteString = hex.substr(i, 2);
-                unsigned char byte = static_cast<unsigned char>(std::stoi(byteString, nullptr, 16));
-                bytes.push_back(byte);
-            }
-            return bytes;
-        }
-    }
-
     std::string UserService::HashPassword(const std::string &password) {
-        // Generate random salt
-        std::vector<unsigned char> salt(SALT_LENGTH);
-        std::random_device rd;
-        std::ranges::generate(salt, std::ref(rd));
-
-        // Generate hash
-        std::vector<unsigned char> hash(HASH_LENGTH);
-        PKCS5_PBKDF2_HMAC(password.c_str(), password.length(),
-                          salt.data(), salt.size(),
-                          ITERATIONS,
-                          EVP_sha256(),
-                          HASH_LENGTH, hash.data());
-
-        // Format: iterations$salt$hash
-        return std::to_string(ITERATIONS) + "$" +
-               bytesToHex(salt.data(), salt.size()) + "$" +
-               bytesToHex(hash.data(), hash.size());
+        return nuansa::utils::crypto::PasswordHasher::GetInstance().Hash(password);
     }
 
-
     bool UserService::CreateUser(const nuansa::models::User &user) {
-        if (circuitBreaker_.IsOpen()) {
-            LOG_WARNING << "Circuit breaker is open, registration rejected";
-            return false;
-        }
-
         try {
-            // Create user with all required fields including picture
-            nuansa::models::User userToCreate(
-                user.GetUsername(),
-                user.GetEmail(),
-                user.GetPasswordHash(),
-                user.GetSalt(),
-                user.GetPicture()
-            );
-
             if (!nuansa::database::ConnectionPool::GetInstance().IsInitialized()) {
                 LOG_ERROR << "Connection pool not initialized";
                 return false;
             }
 
-            auto conn = nuansa::database::ConnectionPool::GetInstance().AcquireConnection(
-                std::chrono::milliseconds(1000)
-            );
-
-            if (!conn) {
-                LOG_ERROR << "Failed to acquire connection for user creation";
-                return false;
-            }
-
-            nuansa::database::ConnectionGuard guard(std::move(conn));
-            guard.ExecuteWithRetry([&](pqxx::connection &db_conn) {
-                pqxx::work txn(db_conn);
-                txn.exec_params(
-                    "INSERT INTO users (username, email, password_hash, salt, picture) VALUES ($1, $2, $3, $4, $5)",
-                    user.GetUsername(), user.GetEmail(), user.GetPasswordHash(), user.GetSalt(), user.GetPicture());
-                txn.commit();
-                return true;
+            const bool created = QueryWithDeadline(circuitBreaker_, [&](pqxx::connection &db_conn) {
+                try {
+                    pqxx::work txn(db_conn);
+                    txn.exec_params(
+                        "INSERT INTO users (username, email, password_hash, salt, picture) VALUES ($1, $2, $3, $4, $5)",
+                        user.GetUsername(), user.GetEmail(), user.GetPasswordHash(), user.GetSalt(),
+                        user.GetPicture());
+                    txn.commit();
+                    return true;
+                } catch (const pqxx::unique_violation &e) {
+                    // A duplicate username/email is a normal outcome, not a database failure
+                    LOG_WARNING << "User already exists: " << e.what();
+                    return false;
+                }
             });
 
-            circuitBreaker_.RecordSuccess();
-            return true;
+            // Drop any cached "not found" entries for the identifiers. On a duplicate the row may come
+            // from another instance, so make sure the local cache and filters stop reporting it absent.
+            InvalidateUser(user.GetUsername(), user.GetEmail());
+            AddIdentity(user.GetUsername(), user.GetEmail());
+            return created;
+        } catch (const nuansa::utils::exception::CircuitBreakerOpenException &) {
+            LOG_WARNING << "Circuit breaker is open, registration rejected";
+            throw; // Let the caller report "server busy" rather than a failed registration
+        } catch (const nuansa::utils::exception::CircuitBreakerTimeoutException &) {
+            LOG_WARNING << "User creation exceeded its deadline";
+            throw;
         } catch (const std::exception &e) {
-            circuitBreaker_.RecordFailure();
             LOG_ERROR << "Database error during user creation: " << e.what();
             return false;
         }
@@ -319,12 +407,27 @@ namespace nuansa::services::user {
                 return false;
             }
 
-            // Hash the provided password with the stored salt
-            const std::string hashedPassword = nuansa::utils::crypto::CryptoUtil::HashPassword(
-                password, user->GetSalt());
+            // Verify on the KDF pool; the salt column is only used by legacy hashes
+            auto &hasher = nuansa::utils::crypto::PasswordHasher::GetInstance();
+            const auto verification = hasher.Verify(password, user->GetSalt(), user->GetPasswordHash());
+            if (!verification.matches) {
+                return false;
+            }
+
+            // Transparently move legacy or under-cost hashes to the current format
+            if (verification.needsRehash) {
+                try {
+                    if (UpdatePasswordHash(username, user->GetPasswordHash(), hasher.Hash(password))) {
+                        LOG_INFO << "Upgraded password hash for user: " << username;
+                    }
+                } catch (const std::exception &e) {
+                    LOG_WARNING << "Failed to upgrade password hash for user " << username << ": " << e.what();
+                }
+            }
 
-            // Compare the hashed password with the stored hash
-            return hashedPassword == user->GetPasswordHash();
+            return true;
+        } catch (const nuansa::utils::exception::WorkerPoolRejectedException &) {
+            throw; // Let the caller report "server busy" rather than "invalid credentials"
         } catch (const std::exception &e) {
             LOG_ERROR << "Error authenticating user: " << e.what();
             return false;
@@ -338,21 +441,31 @@ namespace nuansa::services::user {
                 return false;
             }
 
-            const auto conn = nuansa::database::ConnectionPool::GetInstance().AcquireConnection();
-            nuansa::database::ConnectionGuard guard(conn);
-
-            return guard.ExecuteWithRetry([&](pqxx::connection &db_conn) {
+            return QueryWithDeadline(circuitBreaker_, [&](pqxx::connection &db_conn) {
                 pqxx::work txn{db_conn};
 
-                const auto result = txn.exec_params(
-                    "UPDATE users SET email = $1 WHERE username = $2",
-                    newEmail, username);
+                // Self-join so the previous email can be invalidated as well
+                pqxx::result result;
+                try {
+                    result = txn.exec_params(
+                        "UPDATE users AS u SET email = $1 FROM users AS old "
+                        "WHERE u.username = $2 AND old.id = u.id RETURNING old.email",
+                        newEmail, username);
+                } catch (const pqxx::unique_violation &e) {
+                    // Someone else has the email; not a database failure the breaker should count
+                    LOG_WARNING << "Email already in use: " << e.what();
+                    return false;
+                }
 
-                if (result.affected_rows() == 0) {
+                if (result.empty()) {
                     return false;
                 }
 
                 txn.commit();
+                const auto oldEmail = result[0][0].as<std::string>();
+                InvalidateUser(username, oldEmail);
+                usersByEmail_.Erase(newEmail);
+                ReplaceEmailIdentity(oldEmail, newEmail);
                 LOG_INFO << "Email updated for user: " << username;
                 return true;
             });
@@ -370,27 +483,24 @@ namespace nuansa::services::user {
                 return false;
             }
 
-            const auto conn = nuansa::database::ConnectionPool::GetInstance().AcquireConnection();
-            nuansa::database::ConnectionGuard guard(conn);
+            // Hash before taking a connection so a busy KDF pool doesn't hold one idle; the
+            // salt is embedded in the hash, so the legacy salt column is cleared
+            std::string hashedPassword = nuansa::utils::crypto::PasswordHasher::GetInstance().Hash(newPassword);
+            const std::string newSalt;
 
-            // Generate new salt for the new password
-            std::string newSalt = nuansa::utils::crypto::CryptoUtil::GenerateRandomSalt();
-
-            // Hash the new password with the new salt
-            std::string hashedPassword = nuansa::utils::crypto::CryptoUtil::HashPassword(newPassword, newSalt);
-
-            return guard.ExecuteWithRetry([&](pqxx::connection &db_conn) {
+            return QueryWithDeadline(circuitBreaker_, [&](pqxx::connection &db_conn) {
                 pqxx::work txn{db_conn};
 
                 const auto result = txn.exec_params(
-                    "UPDATE users SET password_hash = $1, salt = $2 WHERE username = $3",
+                    "UPDATE users SET password_hash = $1, salt = $2 WHERE username = $3 RETURNING email",
                     hashedPassword, newSalt, username);
 
-                if (result.affected_rows() == 0) {
+                if (result.empty()) {
                     return false;
                 }
 
                 txn.commit();
+                InvalidateUser(username, result[0][0].as<std::string>());
                 LOG_INFO << "Password updated for user: " << username;
                 return true;
             });
@@ -400,23 +510,44 @@ namespace nuansa::services::user {
         }
     }
 
+    bool UserService::UpdatePasswordHash(const std::string &username, const std::string &expectedHash,
+                                         const std::string &newHash) {
+        return QueryWithDeadline(circuitBreaker_, [&](pqxx::connection &db_conn) {
+            pqxx::work txn{db_conn};
+
+            // Only replace the hash we verified, so a concurrent password change wins
+            const auto result = txn.exec_params(
+                "UPDATE users SET password_hash = $1, salt = '' WHERE username = $2 AND password_hash = $3 "
+                "RETURNING email",
+                newHash, username, expectedHash);
+
+            if (result.empty()) {
+                return false;
+            }
+
+            txn.commit();
+            InvalidateUser(username, result[0][0].as<std::string>());
+            return true;
+        });
+    }
+
     bool UserService::DeleteUser(const std::string &username) {
         try {
-            const auto conn = nuansa::database::ConnectionPool::GetInstance().AcquireConnection();
-            nuansa::database::ConnectionGuard guard(conn);
-
-            return guard.ExecuteWithRetry([&](pqxx::connection &db_conn) {
+            return QueryWithDeadline(circuitBreaker_, [&](pqxx::connection &db_conn) {
                 pqxx::work txn{db_conn};
 
                 const auto result = txn.exec_params(
-                    "DELETE FROM users WHERE username = $1",
+                    "DELETE FROM users WHERE username = $1 RETURNING email",
                     username);
 
-                if (result.affected_rows() == 0) {
+                if (result.empty()) {
                     return false;
                 }
 
                 txn.commit();
+                const auto email = result[0][0].as<std::string>();
+                InvalidateUser(username, email);
+                RemoveIdentity(username, email);
                 LOG_INFO << "User deleted: " << username;
                 return true;
             });
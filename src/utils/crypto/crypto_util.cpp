@@ -71,4 +71,50 @@ namespace nuansa::utils::crypto {
 
         return result;
     }
+
+    std::string CryptoUtil::Base64EncodeUnpadded(const std::string& input) {
+        std::string encoded(4 * ((input.size() + 2) / 3), '\0');
+        const int written = EVP_EncodeBlock(reinterpret_cast<unsigned char *>(encoded.data()),
+                                            reinterpret_cast<const unsigned char *>(input.data()),
+                                            static_cast<int>(input.size()));
+        encoded.resize(written);
+        while (!encoded.empty() && encoded.back() == '=') {
+            encoded.pop_back();
+        }
+        return encoded;
+    }
+
+    std::string CryptoUtil::Base64Decode(const std::string& input) {
+        std::string padded = input;
+        padded.erase(std::remove_if(padded.begin(), padded.end(),
+                                    [](const unsigned char c) { return std::isspace(c); }),
+                     padded.end());
+        if (padded.size() % 4 == 1) {
+            throw std::runtime_error("Invalid base64 length");
+        }
+        padded.append((4 - padded.size() % 4) % 4, '=');
+
+        const size_t padding = padded.empty() ? 0 : (padded.back() == '=') + (padded[padded.size() - 2] == '=');
+        std::string result(3 * padded.size() / 4, '\0');
+        const int written = EVP_DecodeBlock(reinterpret_cast<unsigned char *>(result.data()),
+                                            reinterpret_cast<const unsigned char *>(padded.data()),
+                                            static_cast<int>(padded.size()));
+        if (written < 0) {
+            throw std::runtime_error("Invalid base64 input");
+        }
+
+        // EVP_DecodeBlock counts padding as output bytes
+        result.resize(written - padding);
+        return result;
+    }
+
+    std::string CryptoUtil::Base64UrlDecode(const std::string& input) {
+        std::string standard = input;
+        for (auto &c: standard) {
+            if (c == '-') c = '+';
+            else if (c == '_') c = '/';
+            else if (c == '+' || c == '/') throw std::runtime_error("Invalid base64url input");
+        }
+        return Base64Decode(standard);
+    }
 }
@@ -0,0 +1,263 @@
+#include "nuansa/utils/pch.h"
+
+#include <charconv>
+
+#include "nuansa/utils/crypto/password_hasher.h"
+#include "nuansa/utils/crypto/crypto_util.h"
+#include "nuansa/config/config.h"
+#include "nuansa/utils/trace/tracer.h"
+#include <openssl/crypto.h>
+
+namespace nuansa::utils::crypto {
+    namespace {
+        constexpr size_t SCRYPT_SALT_LENGTH = 16;
+        constexpr size_t SCRYPT_KEY_LENGTH = 32;
+        constexpr std::string_view SCRYPT_PREFIX = "$scrypt$";
+
+        pattern::WorkerPoolSettings MakePoolSettings() {
+            const auto &security = nuansa::config::Config::GetInstance().GetSecurityConfig();
+
+            // Leave the other half of the cores to the I/O and session threads
+            size_t workers = security.kdfWorkers;
+            if (workers == 0) {
+                workers = std::max<size_t>(1, std::thread::hardware_concurrency() / 2);
+            }
+
+            return pattern::WorkerPoolSettings{
+                .name = "kdf",
+                .threadCount = workers,
+                .queueCapacity = security.kdfQueueSize
+            };
+        }
+
+        // PHC strings use standard base64 without padding
+        std::string EncodeBase64(const std::vector<unsigned char> &bytes) {
+            return CryptoUtil::Base64EncodeUnpadded(std::string(bytes.begin(), bytes.end()));
+        }
+
+        std::optional<std::vector<unsigned char> > DecodeBase64(const std::string_view input) {
+            try {
+                const auto decoded = CryptoUtil::Base64Decode(std::string(input));
+                return std::vector<unsigned char>(decoded.begin(), decoded.end());
+            } catch (const std::runtime_error &) {
+                return std::nullopt;
+            }
+        }
+
+        std::optional<std::vector<unsigned char> > DecodeHex(const std::string_view hex) {
+            if (hex.size() % 2 != 0) {
+                return std::nullopt;
+            }
+
+            std::vector<unsigned char> bytes(hex.size() / 2);
+            for (size_t i = 0; i < bytes.size(); ++i) {
+                unsigned int value = 0;
+                const auto [ptr, ec] = std::from_chars(hex.data() + 2 * i, hex.data() + 2 * i + 2, value, 16);
+                if (ec != std::errc() || ptr != hex.data() + 2 * i + 2) {
+                    return std::nullopt;
+                }
+                bytes[i] = static_cast<unsigned char>(value);
+            }
+            return bytes;
+        }
+
+        std::vector<std::string_view> Split(const std::string_view value, const char delimiter) {
+            std::vector<std::string_view> parts;
+            size_t start = 0;
+            while (true) {
+                const auto end = value.find(delimiter, start);
+                parts.push_back(value.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start));
+                if (end == std::string_view::npos) {
+                    return parts;
+                }
+                start = end + 1;
+            }
+        }
+
+        bool ConstantTimeEquals(const unsigned char *a, const size_t aLength, const unsigned char *b,
+                                const size_t bLength) {
+            return aLength == bLength && CRYPTO_memcmp(a, b, aLength) == 0;
+        }
+
+        std::vector<unsigned char> DeriveScrypt(const std::string &password, const std::vector<unsigned char> &salt,
+                                                const ScryptParameters &parameters, const size_t keyLength) {
+            const uint64_t n = uint64_t{1} << parameters.logN;
+
+            // OpenSSL refuses to allocate more than maxmem; leave room above 128 * r * (N + p)
+            const uint64_t maxMemory = 128 * uint64_t{parameters.r} * (n + parameters.p) + (uint64_t{1} << 20);
+
+            std::vector<unsigned char> key(keyLength);
+            if (EVP_PBE_scrypt(password.data(), password.size(), salt.data(), salt.size(),
+                               n, parameters.r, parameters.p, maxMemory, key.data(), key.size()) != 1) {
+                throw std::runtime_error("scrypt key derivation failed");
+            }
+            return key;
+        }
+
+        PasswordVerification VerifyScrypt(const std::string &password, const std::string_view storedHash,
+                                          const ScryptParameters &current) {
+            // $scrypt$ln=15,r=8,p=1$salt$key
+            const auto parts = Split(storedHash, '$');
+            if (parts.size() != 5 || !parts[0].empty() || parts[1] != "scrypt") {
+                LOG_WARNING << "Malformed scrypt hash";
+                return {};
+            }
+
+            ScryptParameters stored{0, 0, 0};
+            for (const auto parameter: Split(parts[2], ',')) {
+                const auto separator = parameter.find('=');
+                if (separator == std::string_view::npos) {
+                    return {};
+                }
+                const auto name = parameter.substr(0, separator);
+                const auto text = parameter.substr(separator + 1);
+                uint32_t value = 0;
+                if (std::from_chars(text.data(), text.data() + text.size(), value).ec != std::errc()) {
+                    return {};
+                }
+
+                if (name == "ln") stored.logN = value;
+                else if (name == "r") stored.r = value;
+                else if (name == "p") stored.p = value;
+            }
+
+            if (stored.logN == 0 || stored.logN > 30 || stored.r == 0 || stored.p == 0) {
+                LOG_WARNING << "Invalid scrypt parameters in stored hash";
+                return {};
+            }
+
+            const auto salt = DecodeBase64(parts[3]);
+            const auto expected = DecodeBase64(parts[4]);
+            if (!salt || !expected || expected->empty()) {
+                LOG_WARNING << "Malformed scrypt salt or key";
+                return {};
+            }
+
+            const auto actual = DeriveScrypt(password, *salt, stored, expected->size());
+            const bool matches = ConstantTimeEquals(actual.data(), actual.size(), expected->data(), expected->size());
+
+            // Only upgrade, never rehash down if the configured cost was lowered
+            return {matches, matches && (stored.logN < current.logN || stored.r < current.r)};
+        }
+
+        // iterations$salthex$hashhex, produced by the old UserService::HashPassword
+        std::optional<PasswordVerification> VerifyLegacyPbkdf2(const std::string &password,
+                                                               const std::string_view storedHash) {
+            const auto parts = Split(storedHash, '$');
+            if (parts.size() != 3) {
+                return std::nullopt;
+            }
+
+            int iterations = 0;
+            if (std::from_chars(parts[0].data(), parts[0].data() + parts[0].size(), iterations).ec != std::errc() ||
+                iterations <= 0) {
+                return std::nullopt;
+            }
+
+            const auto salt = DecodeHex(parts[1]);
+            const auto expected = DecodeHex(parts[2]);
+            if (!salt || !expected || expected->empty()) {
+                return std::nullopt;
+            }
+
+            std::vector<unsigned char> actual(expected->size());
+            if (PKCS5_PBKDF2_HMAC(password.c_str(), static_cast<int>(password.length()),
+                                  salt->data(), static_cast<int>(salt->size()),
+                                  iterations, EVP_sha256(),
+                                  static_cast<int>(actual.size()), actual.data()) != 1) {
+                throw std::runtime_error("PBKDF2 key derivation failed");
+            }
+
+            const bool matches = ConstantTimeEquals(actual.data(), actual.size(), expected->data(), expected->size());
+            return PasswordVerification{matches, matches};
+        }
+    }
+
+    PasswordHasher &PasswordHasher::GetInstance() {
+        static PasswordHasher instance;
+        return instance;
+    }
+
+    PasswordHasher::PasswordHasher()
+        : parameters_(Calibrate()),
+          pool_(MakePoolSettings()) {
+    }
+
+    std::string PasswordHasher::Hash(const std::string &password) {
+        trace::Span span("kdf.hash");
+        return pool_.Submit([&] { return HashInline(password, parameters_); }).get();
+    }
+
+    PasswordVerification PasswordHasher::Verify(const std::string &password, const std::string &salt,
+                                                const std::string &storedHash) {
+        trace::Span span("kdf.verify");
+        return pool_.Submit([&] { return VerifyInline(password, salt, storedHash, parameters_); }).get();
+    }
+
+    void PasswordHasher::Shutdown() {
+        pool_.Shutdown();
+    }
+
+    ScryptParameters PasswordHasher::Calibrate() {
+        const auto &security = nuansa::config::Config::GetInstance().GetSecurityConfig();
+        const auto target = std::chrono::milliseconds(security.kdfTargetMs);
+
+        // Each step doubles the cost, so stop at the first logN that reaches the target
+        ScryptParameters parameters{.logN = security.kdfMinLogN};
+        std::chrono::steady_clock::duration elapsed{};
+        for (; parameters.logN <= security.kdfMaxLogN; ++parameters.logN) {
+            const auto start = std::chrono::steady_clock::now();
+            HashInline("calibration-password", parameters);
+            elapsed = std::chrono::steady_clock::now() - start;
+
+            if (elapsed >= target || parameters.logN == security.kdfMaxLogN) {
+                break;
+            }
+        }
+
+        LOG_INFO << "Password hashing calibrated to scrypt ln=" << parameters.logN << ", r=" << parameters.r
+                << ", p=" << parameters.p << " ("
+                << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+                << "ms per hash, target " << target.count() << "ms)";
+        return parameters;
+    }
+
+    std::string PasswordHasher::HashInline(const std::string &password, const ScryptParameters &parameters) {
+        std::vector<unsigned char> salt(SCRYPT_SALT_LENGTH);
+        if (RAND_bytes(salt.data(), static_cast<int>(salt.size())) != 1) {
+            throw std::runtime_error("Failed to generate salt");
+        }
+
+        const auto key = DeriveScrypt(password, salt, parameters, SCRYPT_KEY_LENGTH);
+
+        std::ostringstream encoded;
+        encoded << SCRYPT_PREFIX << "ln=" << parameters.logN << ",r=" << parameters.r << ",p=" << parameters.p
+                << "$" << EncodeBase64(salt)
+                << "$" << EncodeBase64(key);
+        return encoded.str();
+    }
+
+    PasswordVerification PasswordHasher::VerifyInline(const std::string &password, const std::string &salt,
+                                                      const std::string &storedHash,
+                                                      const ScryptParameters &current) {
+        if (storedHash.empty()) {
+            // OAuth accounts have no password
+            return {};
+        }
+
+        if (storedHash.starts_with(SCRYPT_PREFIX)) {
+            return VerifyScrypt(password, storedHash, current);
+        }
+
+        if (auto result = VerifyLegacyPbkdf2(password, storedHash)) {
+            return *result;
+        }
+
+        // Oldest format: hex SHA-256 of password + salt
+        const auto actual = CryptoUtil::HashPassword(password, salt);
+        const bool matches = ConstantTimeEquals(reinterpret_cast<const unsigned char *>(actual.data()), actual.size(),
+                                                reinterpret_cast<const unsigned char *>(storedHash.data()),
+                                                storedHash.size());
+        return {matches, matches};
+    }
+} // namespace nuansa::utils::crypto
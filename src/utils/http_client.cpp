@@ -2,190 +2,422 @@
 #include "nuansa/utils/log/log.h"
 
 namespace nuansa::utils {
-    HttpClient::HttpClient() {
-        curl = curl_easy_init();
-        if (!curl) {
+    struct HttpClient::Transfer {
+        Request request;
+        Callback callback;
+        CURL *easy{nullptr};
+        curl_slist *headerList{nullptr};
+        std::string responseBody;
+        std::vector<std::string> responseHeaders;
+        char errorBuffer[CURL_ERROR_SIZE]{};
+        std::chrono::steady_clock::time_point started{std::chrono::steady_clock::now()};
+
+        ~Transfer() {
+            if (easy) {
+                curl_easy_cleanup(easy);
+            }
+            if (headerList) {
+                curl_slist_free_all(headerList);
+            }
+        }
+    };
+
+    struct HttpClient::Socket {
+        Socket(boost::asio::io_context &ioc, const curl_socket_t fd)
+            : descriptor(ioc, fd) {
+        }
+
+        // curl owns the file descriptor; it is released, never closed, by us
+        boost::asio::posix::stream_descriptor descriptor;
+        int action{CURL_POLL_NONE};
+        bool reading{false};
+        bool writing{false};
+    };
+
+    HttpClient::HttpClient()
+        : HttpClient(HttpClientSettings{}) {
+    }
+
+    HttpClient::HttpClient(const HttpClientSettings &settings)
+        : settings_{settings},
+          work_(boost::asio::make_work_guard(ioc_)),
+          timer_(ioc_) {
+        static std::once_flag globalInit;
+        std::call_once(globalInit, [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
+        multi_ = curl_multi_init();
+        if (!multi_) {
             LOG_ERROR << "Failed to initialize CURL";
             throw std::runtime_error("Failed to initialize CURL");
         }
+
+        curl_multi_setopt(multi_, CURLMOPT_SOCKETFUNCTION, SocketCallback);
+        curl_multi_setopt(multi_, CURLMOPT_SOCKETDATA, this);
+        curl_multi_setopt(multi_, CURLMOPT_TIMERFUNCTION, TimerCallback);
+        curl_multi_setopt(multi_, CURLMOPT_TIMERDATA, this);
+        curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, settings_.maxConnectionsPerHost);
+        curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, settings_.maxCachedConnections);
+
+        thread_ = std::thread([this] { ioc_.run(); });
     }
 
     HttpClient::~HttpClient() {
-        if (curl) {
-            curl_easy_cleanup(curl);
+        boost::asio::post(ioc_, [this] { AbortAllTransfers(); });
+        work_.reset();
+
+        if (thread_.joinable()) {
+            thread_.join();
         }
     }
 
-    size_t HttpClient::WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-        userp->append((char*)contents, size * nmemb);
+    size_t HttpClient::WriteCallback(void *contents, size_t size, size_t nmemb, std::string *userp) {
+        userp->append(static_cast<char *>(contents), size * nmemb);
         return size * nmemb;
     }
 
+    size_t HttpClient::HeaderCallback(char *buffer, size_t size, size_t nitems, void *userdata) {
+        if (!buffer || !userdata) return 0;
+        auto *headers = static_cast<std::vector<std::string> *>(userdata);
+        headers->emplace_back(buffer, size * nitems);
+        return size * nitems;
+    }
+
+    void HttpClient::AsyncPerform(Request request, Callback callback) {
+        auto transfer = std::make_unique<Transfer>();
+        transfer->request = std::move(request);
+        transfer->callback = std::move(callback);
+
+        // All curl_multi calls happen on the client's thread
+        boost::asio::post(ioc_, [this, transfer = std::move(transfer)]() mutable {
+            StartTransfer(std::move(transfer));
+        });
+    }
+
+    void HttpClient::AsyncGet(const std::string &url, const std::vector<std::string> &headers,
+                              const std::optional<std::chrono::milliseconds> timeout, Callback callback) {
+        AsyncPerform(Request{
+                         .method = "GET",
+                         .url = url,
+                         .headers = headers,
+                         .timeout = timeout
+                     }, std::move(callback));
+    }
+
+    void HttpClient::AsyncPost(const std::string &url, const std::string &body,
+                               const std::vector<std::string> &headers,
+                               const std::optional<std::chrono::milliseconds> timeout, Callback callback) {
+        AsyncPerform(Request{
+                         .method = "POST",
+                         .url = url,
+                         .body = body,
+                         .headers = headers,
+                         .timeout = timeout
+                     }, std::move(callback));
+    }
+
+    std::future<HttpClient::Response> HttpClient::Perform(Request request) {
+        auto promise = std::make_shared<std::promise<Response> >();
+        auto future = promise->get_future();
+        AsyncPerform(std::move(request), [promise](Response response) {
+            promise->set_value(std::move(response));
+        });
+        return future;
+    }
 
-    HttpClient::Response HttpClient::Get(const std::string& url, 
-                                       const std::vector<std::string>& headers) {
+    HttpClient::Response HttpClient::Get(const std::string &url,
+                                         const std::vector<std::string> &headers,
+                                         const std::optional<std::chrono::milliseconds> timeout) {
         LOG_DEBUG << "Getting URL: " << url;
 
-        Response response{false, "", "", 0};
-        std::string responseData;
+        return Perform(Request{
+            .method = "GET",
+            .url = url,
+            .headers = headers,
+            .timeout = timeout
+        }).get();
+    }
 
-        if (!curl) {
-            curl = curl_easy_init();
-            if (!curl) {
-                LOG_ERROR << "CURL not initialized and reinit failed";
-                response.error = "CURL initialization failed";
-                return response;
-            }
+    HttpClient::Response HttpClient::Post(const std::string &url,
+                                          const std::string &body,
+                                          const std::vector<std::string> &headers,
+                                          const std::string &username,
+                                          const std::string &password,
+                                          const std::optional<std::chrono::milliseconds> timeout) {
+        return Perform(Request{
+            .method = "POST",
+            .url = url,
+            .body = body,
+            .headers = headers,
+            .username = username,
+            .password = password,
+            .timeout = timeout
+        }).get();
+    }
+
+    void HttpClient::StartTransfer(std::unique_ptr<Transfer> transfer) {
+        auto fail = [&transfer](const std::string &error) {
+            LOG_ERROR << "HTTP " << transfer->request.method << " failed for URL " << transfer->request.url
+                    << ": " << error;
+            transfer->callback(Response{false, "", error, 0, {}});
+        };
+
+        if (!multi_) {
+            fail("HTTP client is shutting down");
+            return;
+        }
+
+        transfer->easy = curl_easy_init();
+        if (!transfer->easy) {
+            fail("CURL initialization failed");
+            return;
         }
 
         try {
-            std::unique_ptr<curl_slist, decltype(&curl_slist_free_all)> 
-                headerList(nullptr, curl_slist_free_all);
+            CURL *easy = transfer->easy;
+            const auto &request = transfer->request;
 
-            curl_easy_reset(curl);
-            
             // Set basic CURL options with error checking
-            auto setopt = [this](CURLoption option, auto value) {
-                CURLcode res = curl_easy_setopt(curl, option, value);
+            auto setopt = [easy](CURLoption option, auto value) {
+                CURLcode res = curl_easy_setopt(easy, option, value);
                 if (res != CURLE_OK) {
-                    throw std::runtime_error(std::string("CURL setopt failed: ") + 
-                                          curl_easy_strerror(res));
+                    throw std::runtime_error(std::string("CURL setopt failed: ") +
+                                             curl_easy_strerror(res));
                 }
             };
 
             // Basic options
-            setopt(CURLOPT_URL, url.c_str());
+            setopt(CURLOPT_URL, request.url.c_str());
             setopt(CURLOPT_FOLLOWLOCATION, 1L);
             setopt(CURLOPT_NOSIGNAL, 1L);
-            
-            // Add timeouts
-            setopt(CURLOPT_TIMEOUT, 10L);           // Total timeout in seconds
-            setopt(CURLOPT_CONNECTTIMEOUT, 5L);     // Connection timeout
-            setopt(CURLOPT_LOW_SPEED_TIME, 3L);     // Time in seconds for low speed
-            setopt(CURLOPT_LOW_SPEED_LIMIT, 100L);  // Speed in bytes per second
-            
+            setopt(CURLOPT_PRIVATE, transfer.get());
+            setopt(CURLOPT_ERRORBUFFER, transfer->errorBuffer);
+
+            // Per-request deadline covers DNS, connect, TLS and transfer
+            setopt(CURLOPT_TIMEOUT_MS, static_cast<long>(request.timeout.value_or(settings_.defaultTimeout).count()));
+            setopt(CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(settings_.connectTimeout.count()));
+
+            // Reuse resolved addresses and keep idle connections alive for the next request
+            setopt(CURLOPT_DNS_CACHE_TIMEOUT, settings_.dnsCacheTimeoutSeconds);
+            setopt(CURLOPT_TCP_KEEPALIVE, 1L);
+
             setopt(CURLOPT_SSL_VERIFYPEER, 1L);
             setopt(CURLOPT_SSL_VERIFYHOST, 2L);
-            
+
             // Verbose debug output
             #ifdef DEBUG
             setopt(CURLOPT_VERBOSE, 1L);
             #endif
-            
+
             // Callbacks
             setopt(CURLOPT_WRITEFUNCTION, WriteCallback);
-            setopt(CURLOPT_WRITEDATA, &responseData);
-            setopt(CURLOPT_HEADERFUNCTION, 
-                +[](char* buffer, size_t size, size_t nitems, void* userdata) -> size_t {
-                    if (!buffer || !userdata) return 0;
-                    auto* headers = static_cast<std::vector<std::string>*>(userdata);
-                    headers->emplace_back(buffer, size * nitems);
-                    return size * nitems;
-                });
-            setopt(CURLOPT_HEADERDATA, &response.headers);
+            setopt(CURLOPT_WRITEDATA, &transfer->responseBody);
+            setopt(CURLOPT_HEADERFUNCTION, HeaderCallback);
+            setopt(CURLOPT_HEADERDATA, &transfer->responseHeaders);
+
+            if (request.method == "POST") {
+                setopt(CURLOPT_POST, 1L);
+                setopt(CURLOPT_POSTFIELDS, request.body.c_str());
+                setopt(CURLOPT_POSTFIELDSIZE, static_cast<long>(request.body.size()));
+            } else if (request.method != "GET") {
+                setopt(CURLOPT_CUSTOMREQUEST, request.method.c_str());
+                if (!request.body.empty()) {
+                    setopt(CURLOPT_POSTFIELDS, request.body.c_str());
+                    setopt(CURLOPT_POSTFIELDSIZE, static_cast<long>(request.body.size()));
+                }
+            }
+
+            // Set Basic Auth if provided
+            if (!request.username.empty()) {
+                setopt(CURLOPT_USERNAME, request.username.c_str());
+                setopt(CURLOPT_PASSWORD, request.password.c_str());
+            }
 
             // Set custom headers
-            curl_slist* list = nullptr;
-            for (const auto& header : headers) {
-                list = curl_slist_append(list, header.c_str());
+            for (const auto &header: request.headers) {
+                curl_slist *list = curl_slist_append(transfer->headerList, header.c_str());
                 if (!list) {
                     throw std::runtime_error("Failed to append header");
                 }
-            }
-            
-            if (list) {
-                headerList.reset(list);
-                setopt(CURLOPT_HTTPHEADER, list);
+                transfer->headerList = list;
             }
 
-            // Perform request with timeout handling
-            CURLcode res;
-            {
-                const auto start = std::chrono::steady_clock::now();
-                res = curl_easy_perform(curl);
-                const auto duration = std::chrono::steady_clock::now() - start;
-                LOG_DEBUG << "Request took " 
-                         << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() 
-                         << "ms";
+            if (transfer->headerList) {
+                setopt(CURLOPT_HTTPHEADER, transfer->headerList);
             }
 
-            if (res != CURLE_OK) {
-                throw std::runtime_error(std::string("CURL request failed: ") + 
-                                       curl_easy_strerror(res));
+            if (const CURLMcode res = curl_multi_add_handle(multi_, easy); res != CURLM_OK) {
+                throw std::runtime_error(std::string("CURL multi add failed: ") + curl_multi_strerror(res));
             }
 
-            long httpCode;
-            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-            response.statusCode = httpCode;
-            response.body = responseData;
-            response.success = (httpCode >= 200 && httpCode < 300);
+            transfers_.emplace(easy, std::move(transfer));
+        } catch (const std::exception &e) {
+            fail(e.what());
+        }
+    }
+
+    int HttpClient::SocketCallback(CURL *, const curl_socket_t fd, const int what, void *clientp, void *) {
+        auto *self = static_cast<HttpClient *>(clientp);
 
-            if (!response.success) {
-                LOG_ERROR << "Request failed with status " << httpCode 
-                         << ": " << responseData;
+        if (what == CURL_POLL_REMOVE) {
+            if (const auto it = self->sockets_.find(fd); it != self->sockets_.end()) {
+                // Cancels pending waits; curl closes the descriptor itself
+                it->second->descriptor.release();
+                self->sockets_.erase(it);
             }
+            return 0;
+        }
 
-            return response;
+        auto &socket = self->sockets_[fd];
+        if (!socket) {
+            socket = std::make_shared<Socket>(self->ioc_, fd);
+        }
+        socket->action = what;
+        self->WatchSocket(socket, fd);
+        return 0;
+    }
+
+    int HttpClient::TimerCallback(CURLM *, const long timeoutMs, void *clientp) {
+        auto *self = static_cast<HttpClient *>(clientp);
 
-        } catch (const std::exception& e) {
-            LOG_ERROR << "HTTP GET failed for URL " << url << ": " << e.what();
-            response.error = e.what();
-            return response;
+        if (timeoutMs < 0) {
+            self->timer_.cancel();
+            return 0;
         }
+
+        // curl must not be re-entered from this callback, so even a zero timeout goes through the timer
+        self->timer_.expires_after(std::chrono::milliseconds(timeoutMs));
+        self->timer_.async_wait([self](const boost::system::error_code &ec) { self->OnTimeout(ec); });
+        return 0;
     }
 
-    HttpClient::Response HttpClient::Post(const std::string& url,
-                                         const std::string& body,
-                                         const std::vector<std::string>& headers,
-                                         const std::string& username,
-                                         const std::string& password) {
-        Response response{false, "", "", 0};
-        std::string responseData;
+    void HttpClient::WatchSocket(const std::shared_ptr<Socket> &socket, const curl_socket_t fd) {
+        const std::weak_ptr<Socket> weakSocket = socket;
 
-        try {
-            curl_easy_reset(curl);
-            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-            curl_easy_setopt(curl, CURLOPT_POST, 1L);
-            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
-            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseData);
+        if ((socket->action & CURL_POLL_IN) && !socket->reading) {
+            socket->reading = true;
+            socket->descriptor.async_wait(boost::asio::posix::descriptor_base::wait_read,
+                                          [this, weakSocket, fd](const boost::system::error_code &ec) {
+                                              OnSocketReady(weakSocket, fd, CURL_CSELECT_IN, ec);
+                                          });
+        }
 
-            // Set Basic Auth if provided
-            if (!username.empty()) {
-                curl_easy_setopt(curl, CURLOPT_USERNAME, username.c_str());
-                curl_easy_setopt(curl, CURLOPT_PASSWORD, password.c_str());
-            }
+        if ((socket->action & CURL_POLL_OUT) && !socket->writing) {
+            socket->writing = true;
+            socket->descriptor.async_wait(boost::asio::posix::descriptor_base::wait_write,
+                                          [this, weakSocket, fd](const boost::system::error_code &ec) {
+                                              OnSocketReady(weakSocket, fd, CURL_CSELECT_OUT, ec);
+                                          });
+        }
+    }
+
+    void HttpClient::OnSocketReady(const std::weak_ptr<Socket> &weakSocket, const curl_socket_t fd,
+                                   const int direction, const boost::system::error_code &ec) {
+        // A removed socket's waits complete after it is gone; the fd may already belong to a new one
+        const auto socket = weakSocket.lock();
+        if (!socket) {
+            return;
+        }
 
-            struct curl_slist* headerList = nullptr;
-            for (const auto& header : headers) {
-                headerList = curl_slist_append(headerList, header.c_str());
+        (direction == CURL_CSELECT_IN ? socket->reading : socket->writing) = false;
+        if (ec == boost::asio::error::operation_aborted || !multi_) {
+            return;
+        }
+
+        int running = 0;
+        curl_multi_socket_action(multi_, fd, ec ? CURL_CSELECT_ERR : direction, &running);
+        CompleteFinishedTransfers();
+
+        // Re-arm unless curl removed or replaced the socket while handling the event
+        if (const auto it = sockets_.find(fd); it != sockets_.end() && it->second == socket) {
+            WatchSocket(socket, fd);
+        }
+    }
+
+    void HttpClient::OnTimeout(const boost::system::error_code &ec) {
+        if (ec == boost::asio::error::operation_aborted || !multi_) {
+            return;
+        }
+
+        int running = 0;
+        curl_multi_socket_action(multi_, CURL_SOCKET_TIMEOUT, 0, &running);
+        CompleteFinishedTransfers();
+    }
+
+    void HttpClient::CompleteFinishedTransfers() {
+        int pending = 0;
+        while (const CURLMsg *message = curl_multi_info_read(multi_, &pending)) {
+            if (message->msg != CURLMSG_DONE) {
+                continue;
             }
-            if (headerList) {
-                curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headerList);
+
+            CURL *easy = message->easy_handle;
+            const CURLcode result = message->data.result;
+
+            const auto it = transfers_.find(easy);
+            if (it == transfers_.end()) {
+                continue;
             }
 
-            CURLcode res = curl_easy_perform(curl);
-            
-            if (headerList) {
-                curl_slist_free_all(headerList);
+            auto transfer = std::move(it->second);
+            transfers_.erase(it);
+            curl_multi_remove_handle(multi_, easy);
+
+            Response response{false, "", "", 0, std::move(transfer->responseHeaders)};
+            const auto &request = transfer->request;
+
+            LOG_DEBUG << "Request took "
+                    << std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - transfer->started).count()
+                    << "ms";
+
+            if (result != CURLE_OK) {
+                response.timedOut = result == CURLE_OPERATION_TIMEDOUT;
+                response.error = std::string("CURL request failed: ") +
+                                 (transfer->errorBuffer[0] ? transfer->errorBuffer : curl_easy_strerror(result));
+                LOG_ERROR << "HTTP " << request.method << " failed for URL " << request.url << ": "
+                        << response.error;
+            } else {
+                long httpCode = 0;
+                curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &httpCode);
+                response.statusCode = httpCode;
+                response.body = std::move(transfer->responseBody);
+                response.success = (httpCode >= 200 && httpCode < 300);
+
+                if (!response.success) {
+                    LOG_ERROR << "Request failed with status " << httpCode
+                            << ": " << response.body;
+                }
             }
 
-            if (res != CURLE_OK) {
-                response.error = curl_easy_strerror(res);
-                return response;
+            auto callback = std::move(transfer->callback);
+            transfer.reset();
+
+            try {
+                callback(std::move(response));
+            } catch (const std::exception &e) {
+                LOG_ERROR << "HTTP completion handler threw: " << e.what();
             }
+        }
+    }
+
+    void HttpClient::AbortAllTransfers() {
+        auto transfers = std::move(transfers_);
+        transfers_.clear();
+
+        for (auto &[easy, transfer]: transfers) {
+            curl_multi_remove_handle(multi_, easy);
+            transfer->callback(Response{false, "", "HTTP client is shutting down", 0, {}});
+        }
+        transfers.clear();
 
-            long httpCode;
-            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-            response.statusCode = httpCode;
-            response.body = responseData;
-            response.success = (httpCode >= 200 && httpCode < 300);
+        // May still report socket removals for cached connections, so run before releasing the rest
+        curl_multi_cleanup(multi_);
+        multi_ = nullptr;
 
-            return response;
-        } catch (const std::exception& e) {
-            LOG_ERROR << "HTTP POST failed: " << e.what();
-            response.error = e.what();
-            return response;
+        for (auto &[fd, socket]: sockets_) {
+            socket->descriptor.release();
         }
+        sockets_.clear();
+        timer_.cancel();
     }
-} 
\ No newline at end of file
+}
@@ -0,0 +1,39 @@
+#include "nuansa/utils/pch.h"
+
+#include <cstdio>
+
+#include "nuansa/utils/json_string.h"
+
+namespace nuansa::utils {
+    void AppendJsonString(const std::string_view text, std::string &out) {
+        out += '"';
+        for (const char c: text) {
+            switch (c) {
+                case '"':
+                    out += "\\\"";
+                    break;
+                case '\\':
+                    out += "\\\\";
+                    break;
+                case '\n':
+                    out += "\\n";
+                    break;
+                case '\r':
+                    out += "\\r";
+                    break;
+                case '\t':
+                    out += "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                        out += escaped;
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        out += '"';
+    }
+}
@@ -0,0 +1,308 @@
+#include "nuansa/utils/pch.h"
+
+#include <cstdio>
+
+#include "nuansa/utils/log/async_logger.h"
+#include "nuansa/utils/json_string.h"
+
+namespace nuansa::utils::log {
+    const char *LevelName(const Level level) {
+        switch (level) {
+            case Level::Debug:
+                return "debug";
+            case Level::Info:
+                return "info";
+            case Level::Warning:
+                return "warning";
+            case Level::Error:
+                return "error";
+        }
+        return "info";
+    }
+
+    Level ParseLevel(const std::string_view name) {
+        if (name == "debug") return Level::Debug;
+        if (name == "warn" || name == "warning") return Level::Warning;
+        if (name == "error") return Level::Error;
+        return Level::Info;
+    }
+
+    namespace {
+        // ISO 8601 for JSON, with a space instead of the 'T' for the text format
+        void AppendTimestamp(const std::chrono::system_clock::time_point time, const bool iso, std::string &out) {
+            const auto seconds = std::chrono::system_clock::to_time_t(time);
+            const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+                time.time_since_epoch()).count() % 1000000;
+            std::tm local{};
+            localtime_r(&seconds, &local);
+
+            char timestamp[40];
+            const auto *pattern = iso ? "%Y-%m-%dT%H:%M:%S" : "%Y-%m-%d %H:%M:%S";
+            const auto length = std::strftime(timestamp, sizeof(timestamp), pattern, &local);
+            std::snprintf(timestamp + length, sizeof(timestamp) - length, ".%06lld", static_cast<long long>(micros));
+            out += timestamp;
+        }
+    }
+
+    void FormatRecord(const LogRecord &record, const LogFormat format, std::string &out) {
+        char number[16];
+        const auto line = std::string_view(number, std::to_chars(number, number + sizeof(number), record.line).ptr);
+
+        if (format == LogFormat::Json) {
+            out += "{\"ts\":\"";
+            AppendTimestamp(record.time, true, out);
+            out += "\",\"level\":\"";
+            out += LevelName(record.level);
+            out += "\",\"file\":";
+            AppendJsonString(record.file, out);
+            out += ",\"line\":";
+            out += line;
+            out += ",\"func\":";
+            AppendJsonString(record.function, out);
+            out += ",\"msg\":";
+            AppendJsonString(record.Text(), out);
+            if (record.truncated) {
+                out += ",\"truncated\":true";
+            }
+            out += "}\n";
+            return;
+        }
+
+        out += '[';
+        AppendTimestamp(record.time, false, out);
+        out += "] [";
+        out += LevelName(record.level);
+        out += "] [";
+        out += record.file;
+        out += ':';
+        out += line;
+        out += ' ';
+        out += record.function;
+        out += "] ";
+        out += record.Text();
+        if (record.truncated) {
+            out += "...";
+        }
+        out += '\n';
+    }
+
+    void ConsoleLogSink::Write(const LogRecord &record) {
+        line_.clear();
+        FormatRecord(record, LogFormat::Text, line_);
+        std::fwrite(line_.data(), 1, line_.size(), stdout);
+    }
+
+    void ConsoleLogSink::Flush() {
+        std::fflush(stdout);
+    }
+
+    static_assert((AsyncLogger::RING_CAPACITY & (AsyncLogger::RING_CAPACITY - 1)) == 0,
+                  "Ring slots are picked with a mask");
+
+    // Bounded multi-producer single-consumer queue, with a sequence number per slot like trace::SpanBuffer
+    class AsyncLogger::Ring {
+    public:
+        explicit Ring(const size_t capacity)
+            : slots_(std::make_unique<Slot[]>(capacity)), mask_(capacity - 1) {
+            for (size_t i = 0; i < capacity; ++i) {
+                slots_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        bool TryPush(const LogRecord &record) {
+            auto position = tail_.load(std::memory_order_relaxed);
+            for (;;) {
+                auto &slot = slots_[position & mask_];
+                const auto sequence = slot.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+                if (difference == 0) {
+                    if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        // Copy only the used part of the text
+                        std::memcpy(static_cast<void *>(&slot.record), &record, offsetof(LogRecord, text));
+                        std::memcpy(slot.record.text, record.text, record.length);
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (difference < 0) {
+                    return false; // Full
+                } else {
+                    position = tail_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Only ever called by one thread at a time
+        template<typename F>
+        void Drain(F &&consume) {
+            for (auto position = head_.load(std::memory_order_relaxed);; ++position) {
+                auto &slot = slots_[position & mask_];
+                if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+                    return; // Empty, or the next record is still being copied in
+                }
+                consume(slot.record);
+                // Hand each slot back right away so producers can reuse it
+                head_.store(position + 1, std::memory_order_relaxed);
+                slot.sequence.store(position + mask_ + 1, std::memory_order_release);
+            }
+        }
+
+    private:
+        struct Slot {
+            std::atomic<size_t> sequence{0};
+            LogRecord record;
+        };
+
+        std::unique_ptr<Slot[]> slots_;
+        size_t mask_;
+        alignas(64) std::atomic<size_t> head_{0};
+        alignas(64) std::atomic<size_t> tail_{0};
+    };
+
+    AsyncLogger &AsyncLogger::GetInstance() {
+        // Leaked on purpose: code running during static destruction may still log
+        static AsyncLogger *instance = [] {
+            auto *logger = new AsyncLogger();
+            std::atexit([] { GetInstance().Shutdown(); });
+            return logger;
+        }();
+        return *instance;
+    }
+
+    AsyncLogger::AsyncLogger()
+        : ring_(std::make_unique<Ring>(RING_CAPACITY)), sinks_{std::make_shared<ConsoleLogSink>()} {
+        thread_ = std::thread([this] { Run(); });
+    }
+
+    void AsyncLogger::Configure(const AsyncLoggerSettings &settings) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        settings_ = settings;
+    }
+
+    void AsyncLogger::SetSinks(std::vector<std::shared_ptr<LogSink> > sinks) {
+        std::lock_guard<std::mutex> lock(sinksMutex_);
+        for (const auto &sink: sinks_) {
+            sink->Flush();
+        }
+        sinks_ = std::move(sinks);
+    }
+
+    void AsyncLogger::Submit(const LogRecord &record) {
+        if (record.truncated) {
+            truncated_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Announced before stopped_ is read, so Shutdown can wait for pushes that missed the flag
+        submitting_.fetch_add(1);
+        if (stopped_.load()) {
+            submitting_.fetch_sub(1, std::memory_order_release);
+            std::lock_guard<std::mutex> lock(sinksMutex_);
+            WriteToSinks(record);
+            for (const auto &sink: sinks_) {
+                sink->Flush();
+            }
+            return;
+        }
+
+        if (!ring_->TryPush(record)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        submitting_.fetch_sub(1, std::memory_order_release);
+    }
+
+    void AsyncLogger::Flush() {
+        if (stopped_.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        const auto target = ++flushRequested_;
+        wake_.notify_one();
+        flushed_.wait(lock, [&] { return flushCompleted_ >= target || stopping_; });
+    }
+
+    void AsyncLogger::Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            stopping_ = true;
+        }
+        // Anything logged from here on is written by the caller
+        stopped_.store(true);
+        wake_.notify_one();
+        thread_.join();
+
+        // Records pushed by threads that read stopped_ just before it was set
+        while (submitting_.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+        Drain();
+    }
+
+    LogStats AsyncLogger::GetStats() const {
+        return LogStats{
+            .written = written_.load(std::memory_order_relaxed),
+            .dropped = dropped_.load(std::memory_order_relaxed),
+            .truncated = truncated_.load(std::memory_order_relaxed)
+        };
+    }
+
+    void AsyncLogger::Run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait_for(lock, settings_.drainInterval, [this] {
+                return stopping_ || flushRequested_ != flushCompleted_;
+            });
+            const bool stopping = stopping_;
+            const auto target = flushRequested_;
+
+            lock.unlock();
+            Drain();
+            lock.lock();
+
+            flushCompleted_ = target;
+            flushed_.notify_all();
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    void AsyncLogger::Drain() {
+        std::lock_guard<std::mutex> lock(sinksMutex_);
+        ring_->Drain([this](const LogRecord &record) { WriteToSinks(record); });
+
+        // Say so when records were lost, instead of failing silently
+        if (const auto dropped = dropped_.load(std::memory_order_relaxed); dropped > reportedDrops_) {
+            LogRecord notice;
+            notice.time = std::chrono::system_clock::now();
+            notice.file = __FILE__;
+            notice.function = __func__;
+            notice.line = __LINE__;
+            notice.level = Level::Warning;
+            const auto result = std::to_chars(notice.text, notice.text + LogRecord::MAX_TEXT,
+                                              dropped - reportedDrops_);
+            constexpr std::string_view suffix = " log records dropped, logging threads outpaced the sink";
+            std::memcpy(result.ptr, suffix.data(), suffix.size());
+            notice.length = static_cast<uint16_t>(result.ptr - notice.text + suffix.size());
+            WriteToSinks(notice);
+            reportedDrops_ = dropped;
+        }
+
+        for (const auto &sink: sinks_) {
+            sink->Flush();
+        }
+    }
+
+    void AsyncLogger::WriteToSinks(const LogRecord &record) {
+        for (const auto &sink: sinks_) {
+            try {
+                sink->Write(record);
+            } catch (const std::exception &e) {
+                std::fprintf(stderr, "Log sink failed: %s\n", e.what());
+            }
+        }
+        written_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
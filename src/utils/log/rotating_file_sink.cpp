@@ -0,0 +1,314 @@
+#include "nuansa/utils/pch.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "nuansa/utils/log/rotating_file_sink.h"
+
+namespace nuansa::utils::log {
+    namespace {
+        constexpr std::string_view COMPRESSED_SUFFIX = ".gz";
+        constexpr std::string_view PARTIAL_SUFFIX = ".tmp";
+        constexpr std::chrono::milliseconds MAX_REOPEN_BACKOFF = std::chrono::minutes(1);
+
+        // Rotated names sort by age once the ".gz" is ignored
+        std::string SegmentKey(std::string name) {
+            if (name.ends_with(COMPRESSED_SUFFIX)) {
+                name.resize(name.size() - COMPRESSED_SUFFIX.size());
+            }
+            return name;
+        }
+    }
+
+    RotatingFileSink::RotatingFileSink(RotatingFileSinkSettings settings)
+        : settings_(std::move(settings)) {
+        if (settings_.path.has_parent_path()) {
+            std::filesystem::create_directories(settings_.path.parent_path());
+        }
+        buffer_.reserve(settings_.bufferBytes + LogRecord::MAX_TEXT + 256);
+        Open();
+
+        if (settings_.compressRotated) {
+            compressor_ = std::thread([this] { RunCompressor(); });
+        }
+    }
+
+    RotatingFileSink::~RotatingFileSink() {
+        WriteBuffer();
+        Sync();
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+
+        if (compressor_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(compressMutex_);
+                stopping_ = true;
+            }
+            compressWake_.notify_one();
+            compressor_.join();
+        }
+    }
+
+    void RotatingFileSink::Write(const LogRecord &record) {
+        if (!EnsureOpen()) {
+            ++dropped_;
+            return;
+        }
+
+        const auto now = Clock::now();
+        if (settings_.rotateInterval.count() > 0 && now - openedAt_ >= settings_.rotateInterval &&
+            fileBytes_ + buffer_.size() > 0) {
+            Rotate();
+        }
+
+        FormatRecord(record, settings_.format, buffer_);
+
+        if (fd_ < 0) {
+            // The reopen after a rotation above failed
+            buffer_.clear();
+            ++dropped_;
+        } else if (settings_.maxFileBytes > 0 && fileBytes_ + buffer_.size() >= settings_.maxFileBytes) {
+            Rotate();
+        } else if (buffer_.size() >= settings_.bufferBytes) {
+            WriteBuffer();
+        }
+    }
+
+    void RotatingFileSink::Flush() {
+        WriteBuffer();
+        if (unsynced_ && Clock::now() - lastSync_ >= settings_.fsyncInterval) {
+            Sync();
+        }
+    }
+
+    void RotatingFileSink::WaitForCompression() {
+        std::unique_lock<std::mutex> lock(compressMutex_);
+        compressIdle_.wait(lock, [this] { return pending_.empty() && !compressing_; });
+    }
+
+    void RotatingFileSink::Open() {
+        fd_ = ::open(settings_.path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0640);
+        if (fd_ < 0) {
+            throw std::runtime_error("Failed to open log file " + settings_.path.string() + ": " +
+                                     std::strerror(errno));
+        }
+
+        struct stat info{};
+        fileBytes_ = ::fstat(fd_, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+        openedAt_ = Clock::now();
+        lastSync_ = openedAt_;
+    }
+
+    bool RotatingFileSink::EnsureOpen() {
+        if (fd_ >= 0) {
+            return true;
+        }
+        const auto now = Clock::now();
+        if (now < nextReopen_) {
+            return false;
+        }
+
+        try {
+            Open();
+        } catch (const std::runtime_error &e) {
+            reopenDelay_ = std::min(MAX_REOPEN_BACKOFF, std::max(settings_.reopenBackoff, reopenDelay_ * 2));
+            nextReopen_ = now + reopenDelay_;
+            std::fprintf(stderr, "%s, retrying in %lld ms\n", e.what(), static_cast<long long>(reopenDelay_.count()));
+            return false;
+        }
+
+        reopenDelay_ = std::chrono::milliseconds(0);
+        if (dropped_ > droppedReported_) {
+            std::fprintf(stderr, "%llu log records dropped while %s could not be opened\n",
+                         static_cast<unsigned long long>(dropped_ - droppedReported_), settings_.path.c_str());
+            droppedReported_ = dropped_;
+        }
+        return true;
+    }
+
+    void RotatingFileSink::WriteBuffer() {
+        if (buffer_.empty()) {
+            return;
+        }
+        if (fd_ < 0) {
+            // Nowhere to write; the lines are lost but memory stays bounded
+            buffer_.clear();
+            return;
+        }
+
+        const char *data = buffer_.data();
+        size_t remaining = buffer_.size();
+        while (remaining > 0) {
+            const auto written = ::write(fd_, data, remaining);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                // Keep serving the console sink; the lines are lost but memory stays bounded
+                std::fprintf(stderr, "Failed to write log file %s: %s\n", settings_.path.c_str(),
+                             std::strerror(errno));
+                break;
+            }
+            data += written;
+            remaining -= static_cast<size_t>(written);
+        }
+
+        fileBytes_ += buffer_.size() - remaining;
+        unsynced_ = true;
+        buffer_.clear();
+    }
+
+    void RotatingFileSink::Sync() {
+        if (fd_ >= 0 && unsynced_) {
+            ::fdatasync(fd_);
+        }
+        unsynced_ = false;
+        lastSync_ = Clock::now();
+    }
+
+    void RotatingFileSink::Rotate() {
+        WriteBuffer();
+        Sync();
+        ::close(fd_);
+        fd_ = -1;
+
+        const auto segment = NextRotatedPath();
+        std::error_code ec;
+        std::filesystem::rename(settings_.path, segment, ec);
+        if (ec) {
+            std::fprintf(stderr, "Failed to rotate log file %s: %s\n", settings_.path.c_str(), ec.message().c_str());
+        }
+
+        ++rotations_;
+        nextReopen_ = Clock::time_point{};
+        if (!EnsureOpen()) {
+            return;
+        }
+
+        if (ec) {
+            return;
+        }
+
+        if (settings_.compressRotated) {
+            {
+                std::lock_guard<std::mutex> lock(compressMutex_);
+                pending_.push_back(segment);
+            }
+            compressWake_.notify_one();
+        } else {
+            PruneRotated();
+        }
+    }
+
+    std::filesystem::path RotatingFileSink::NextRotatedPath() const {
+        const auto now = Clock::now();
+        const auto seconds = Clock::to_time_t(now);
+        const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+            now.time_since_epoch()).count() % 1000;
+        std::tm local{};
+        localtime_r(&seconds, &local);
+
+        char stamp[32];
+        const auto length = std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &local);
+        std::snprintf(stamp + length, sizeof(stamp) - length, ".%03lld", static_cast<long long>(millis));
+
+        const auto base = settings_.path.string() + "." + stamp;
+        auto candidate = std::filesystem::path(base);
+        for (int suffix = 1; std::filesystem::exists(candidate) ||
+                             std::filesystem::exists(candidate.string() + std::string(COMPRESSED_SUFFIX)); ++suffix) {
+            candidate = base + "-" + std::to_string(suffix);
+        }
+        return candidate;
+    }
+
+    void RotatingFileSink::RunCompressor() {
+        std::unique_lock<std::mutex> lock(compressMutex_);
+        while (true) {
+            compressWake_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+            if (pending_.empty()) {
+                return;
+            }
+
+            const auto segment = pending_.front();
+            pending_.pop_front();
+            compressing_ = true;
+
+            lock.unlock();
+            Compress(segment);
+            PruneRotated();
+            lock.lock();
+
+            compressing_ = false;
+            compressIdle_.notify_all();
+        }
+    }
+
+    void RotatingFileSink::Compress(const std::filesystem::path &segment) const {
+        const auto target = segment.string() + std::string(COMPRESSED_SUFFIX);
+        const auto partial = target + std::string(PARTIAL_SUFFIX);
+
+        std::FILE *input = std::fopen(segment.c_str(), "rb");
+        if (!input) {
+            return;
+        }
+        gzFile output = gzopen(partial.c_str(), "wb6");
+        if (!output) {
+            std::fclose(input);
+            return;
+        }
+
+        bool ok = true;
+        std::vector<char> chunk(64 * 1024);
+        while (const auto read = std::fread(chunk.data(), 1, chunk.size(), input)) {
+            if (gzwrite(output, chunk.data(), static_cast<unsigned>(read)) != static_cast<int>(read)) {
+                ok = false;
+                break;
+            }
+        }
+        ok = !std::ferror(input) && ok;
+        std::fclose(input);
+        ok = gzclose(output) == Z_OK && ok;
+
+        std::error_code ec;
+        if (!ok) {
+            // Leave the uncompressed segment in place
+            std::fprintf(stderr, "Failed to compress log segment %s\n", segment.c_str());
+            std::filesystem::remove(partial, ec);
+            return;
+        }
+        std::filesystem::rename(partial, target, ec);
+        if (!ec) {
+            std::filesystem::remove(segment, ec);
+        }
+    }
+
+    void RotatingFileSink::PruneRotated() const {
+        const auto directory = settings_.path.has_parent_path() ? settings_.path.parent_path()
+                                                                : std::filesystem::path(".");
+        const auto prefix = settings_.path.filename().string() + ".";
+
+        std::vector<std::string> segments;
+        std::error_code ec;
+        for (const auto &entry: std::filesystem::directory_iterator(directory, ec)) {
+            const auto name = entry.path().filename().string();
+            if (name.starts_with(prefix) && !name.ends_with(PARTIAL_SUFFIX) && entry.is_regular_file(ec)) {
+                segments.push_back(name);
+            }
+        }
+        if (segments.size() <= settings_.maxRotatedFiles) {
+            return;
+        }
+
+        std::ranges::sort(segments, {}, SegmentKey);
+        const auto excess = segments.size() - settings_.maxRotatedFiles;
+        for (size_t i = 0; i < excess; ++i) {
+            std::filesystem::remove(directory / segments[i], ec);
+        }
+    }
+}
@@ -0,0 +1,246 @@
+#include "nuansa/utils/pch.h"
+
+#include <bit>
+#include <cmath>
+
+#include "nuansa/utils/metrics/metrics.h"
+
+namespace nuansa::utils::metrics {
+    namespace {
+        const char *TypeName(const MetricType type) {
+            switch (type) {
+                case MetricType::Counter:
+                    return "counter";
+                case MetricType::Gauge:
+                    return "gauge";
+                case MetricType::Histogram:
+                    return "histogram";
+            }
+            return "untyped";
+        }
+
+        void AppendEscaped(const std::string_view text, std::string &out) {
+            for (const char c: text) {
+                if (c == '\\' || c == '"') {
+                    out += '\\';
+                    out += c;
+                } else if (c == '\n') {
+                    out += "\\n";
+                } else {
+                    out += c;
+                }
+            }
+        }
+
+        // {a="1",b="2"}, or nothing without labels
+        std::string RenderLabels(const Labels &labels) {
+            std::string out;
+            for (const auto &[key, value]: labels) {
+                out += out.empty() ? "{" : ",";
+                out += key;
+                out += "=\"";
+                AppendEscaped(value, out);
+                out += '"';
+            }
+            if (!out.empty()) {
+                out += '}';
+            }
+            return out;
+        }
+
+        std::string WithLabel(const std::string &rendered, const std::string_view key, const std::string_view value) {
+            std::string out = rendered.empty() ? "{" : rendered.substr(0, rendered.size() - 1) + ",";
+            out += key;
+            out += "=\"";
+            out += value;
+            out += "\"}";
+            return out;
+        }
+
+        std::string FormatNumber(const double value) {
+            if (std::isinf(value)) {
+                return value > 0 ? "+Inf" : "-Inf";
+            }
+            char buffer[32];
+            const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            return {buffer, ec == std::errc() ? end : buffer};
+        }
+    }
+
+    Histogram::Histogram(const double scale)
+        : scale_(scale), shards_(std::make_unique<Shard[]>(detail::SHARDS)) {
+    }
+
+    size_t Histogram::BucketIndex(const uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        const int exponent = std::bit_width(value) - 1;
+        if (exponent > MAX_EXPONENT) {
+            return BUCKETS - 1;
+        }
+        const auto sub = (value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return static_cast<size_t>(exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+    uint64_t Histogram::BucketUpperBound(const size_t index) {
+        if (index < SUB_BUCKETS) {
+            return index + 1;
+        }
+        const auto exponent = static_cast<int>(index / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+        const auto sub = index % SUB_BUCKETS;
+        return (SUB_BUCKETS + sub + 1) << (exponent - SUB_BUCKET_BITS);
+    }
+
+    void Histogram::Record(const uint64_t value) {
+        auto &shard = shards_[detail::ShardIndex()];
+        shard.buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    std::vector<uint64_t> Histogram::Snapshot() const {
+        std::vector<uint64_t> counts(BUCKETS, 0);
+        for (size_t s = 0; s < detail::SHARDS; ++s) {
+            for (size_t i = 0; i < BUCKETS; ++i) {
+                counts[i] += shards_[s].buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+        return counts;
+    }
+
+    uint64_t Histogram::Count() const {
+        uint64_t total = 0;
+        for (const auto count: Snapshot()) {
+            total += count;
+        }
+        return total;
+    }
+
+    uint64_t Histogram::Sum() const {
+        uint64_t total = 0;
+        for (size_t s = 0; s < detail::SHARDS; ++s) {
+            total += shards_[s].sum.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    uint64_t Histogram::Percentile(const double q) const {
+        const auto counts = Snapshot();
+        uint64_t total = 0;
+        for (const auto count: counts) {
+            total += count;
+        }
+        if (total == 0) {
+            return 0;
+        }
+
+        const auto rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(total)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= std::max<uint64_t>(rank, 1)) {
+                return BucketUpperBound(i);
+            }
+        }
+        return BucketUpperBound(counts.size() - 1);
+    }
+
+    MetricsRegistry &MetricsRegistry::GetInstance() {
+        static MetricsRegistry instance;
+        return instance;
+    }
+
+    MetricsRegistry::Series &MetricsRegistry::FindSeries(const std::string &name, const std::string &help,
+                                                         const MetricType type, const Labels &labels) {
+        auto [it, inserted] = families_.try_emplace(name);
+        auto &family = it->second;
+        if (inserted) {
+            family.help = help;
+            family.type = type;
+        } else if (family.type != type) {
+            throw std::invalid_argument("Metric " + name + " is already registered as a " + TypeName(family.type));
+        }
+        return family.series[RenderLabels(labels)];
+    }
+
+    Counter &MetricsRegistry::GetCounter(const std::string &name, const std::string &help, const Labels &labels) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &series = FindSeries(name, help, MetricType::Counter, labels);
+        if (!series.counter) {
+            series.counter = std::make_unique<Counter>();
+        }
+        return *series.counter;
+    }
+
+    Gauge &MetricsRegistry::GetGauge(const std::string &name, const std::string &help, const Labels &labels) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &series = FindSeries(name, help, MetricType::Gauge, labels);
+        if (!series.gauge) {
+            series.gauge = std::make_unique<Gauge>();
+        }
+        return *series.gauge;
+    }
+
+    Histogram &MetricsRegistry::GetHistogram(const std::string &name, const std::string &help, const Labels &labels,
+                                             const double scale) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &series = FindSeries(name, help, MetricType::Histogram, labels);
+        if (!series.histogram) {
+            series.histogram = std::make_unique<Histogram>(scale);
+        }
+        return *series.histogram;
+    }
+
+    void MetricsRegistry::RegisterCallback(const std::string &name, const std::string &help, const MetricType type,
+                                           const Labels &labels, std::function<double()> read) {
+        if (type == MetricType::Histogram) {
+            throw std::invalid_argument("Histogram " + name + " cannot be backed by a callback");
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        FindSeries(name, help, type, labels).callback = std::move(read);
+    }
+
+    std::string MetricsRegistry::RenderPrometheus() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string out;
+        out.reserve(16 * 1024);
+
+        for (const auto &[name, family]: families_) {
+            out += "# HELP " + name + " ";
+            AppendEscaped(family.help, out);
+            out += "\n# TYPE " + name + " " + TypeName(family.type) + "\n";
+
+            for (const auto &[labels, series]: family.series) {
+                if (series.callback) {
+                    out += name + labels + " " + FormatNumber(series.callback()) + "\n";
+                } else if (series.counter) {
+                    out += name + labels + " " + std::to_string(series.counter->Value()) + "\n";
+                } else if (series.gauge) {
+                    out += name + labels + " " + std::to_string(series.gauge->Value()) + "\n";
+                } else if (series.histogram) {
+                    // Cumulative buckets at every power of two below the overflow bucket, the same set on every
+                    // scrape. A bucket holds values below its exclusive bound, so le is the bound minus one.
+                    const auto &histogram = *series.histogram;
+                    const auto counts = histogram.Snapshot();
+                    uint64_t cumulative = 0;
+                    for (size_t i = 0; i + 1 < counts.size(); ++i) {
+                        cumulative += counts[i];
+                        const auto bound = Histogram::BucketUpperBound(i);
+                        if (std::has_single_bit(bound)) {
+                            const auto le = FormatNumber(static_cast<double>(bound - 1) * histogram.Scale());
+                            out += name + "_bucket" + WithLabel(labels, "le", le) + " " +
+                                    std::to_string(cumulative) + "\n";
+                        }
+                    }
+                    cumulative += counts.back();
+                    out += name + "_bucket" + WithLabel(labels, "le", "+Inf") + " " + std::to_string(cumulative) +
+                            "\n";
+                    out += name + "_sum" + labels + " " +
+                            FormatNumber(static_cast<double>(histogram.Sum()) * histogram.Scale()) + "\n";
+                    out += name + "_count" + labels + " " + std::to_string(cumulative) + "\n";
+                }
+            }
+        }
+        return out;
+    }
+}
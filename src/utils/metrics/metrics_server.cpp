@@ -0,0 +1,118 @@
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/utils/metrics/metrics_server.h"
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+namespace nuansa::utils::metrics {
+    namespace {
+        // A scraper that stalls mid-request is cut off after this
+        constexpr auto REQUEST_TIMEOUT = std::chrono::seconds(10);
+    }
+
+    // One request per connection, then close
+    class MetricsServer::Session : public std::enable_shared_from_this<Session> {
+    public:
+        Session(boost::asio::ip::tcp::socket socket, MetricsRegistry &registry)
+            : stream_(std::move(socket)), registry_(registry) {
+        }
+
+        void Start() {
+            stream_.expires_after(REQUEST_TIMEOUT);
+            http::async_read(stream_, buffer_, request_,
+                             [self = shared_from_this()](const beast::error_code &ec, std::size_t) {
+                                 if (!ec) {
+                                     self->Respond();
+                                 }
+                             });
+        }
+
+    private:
+        void Respond() {
+            response_.version(request_.version());
+            response_.keep_alive(false);
+            response_.set(http::field::server, "Nuansa Metrics");
+
+            if (request_.method() == http::verb::get && request_.target() == "/metrics") {
+                response_.result(http::status::ok);
+                response_.set(http::field::content_type, "text/plain; version=0.0.4; charset=utf-8");
+                response_.body() = registry_.RenderPrometheus();
+            } else {
+                response_.result(http::status::not_found);
+                response_.set(http::field::content_type, "text/plain");
+                response_.body() = "Not found\n";
+            }
+            response_.prepare_payload();
+
+            http::async_write(stream_, response_,
+                              [self = shared_from_this()](const beast::error_code &, std::size_t) {
+                                  beast::error_code ignored;
+                                  self->stream_.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_send,
+                                                                  ignored);
+                              });
+        }
+
+        beast::tcp_stream stream_;
+        MetricsRegistry &registry_;
+        beast::flat_buffer buffer_;
+        http::request<http::string_body> request_;
+        http::response<http::string_body> response_;
+    };
+
+    MetricsServer::MetricsServer(MetricsRegistry &registry, MetricsServerSettings settings)
+        : registry_(registry), settings_(std::move(settings)), acceptor_(ioc_) {
+    }
+
+    MetricsServer::~MetricsServer() {
+        Stop();
+    }
+
+    void MetricsServer::Start() {
+        const boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::make_address(settings_.host), settings_.port);
+        acceptor_.open(endpoint.protocol());
+        acceptor_.set_option(boost::asio::socket_base::reuse_address(true));
+        acceptor_.bind(endpoint);
+        acceptor_.listen();
+
+        Accept();
+        thread_ = std::thread([this] {
+            try {
+                ioc_.run();
+            } catch (const std::exception &e) {
+                LOG_ERROR << "Metrics server stopped: " << e.what();
+            }
+        });
+
+        LOG_INFO << "Metrics available on http://" << settings_.host << ":" << GetPort() << "/metrics";
+    }
+
+    void MetricsServer::Stop() {
+        if (!thread_.joinable()) {
+            return;
+        }
+        ioc_.stop();
+        thread_.join();
+
+        beast::error_code ignored;
+        acceptor_.close(ignored);
+    }
+
+    uint16_t MetricsServer::GetPort() const {
+        beast::error_code ec;
+        const auto endpoint = acceptor_.local_endpoint(ec);
+        return ec ? settings_.port : endpoint.port();
+    }
+
+    void MetricsServer::Accept() {
+        acceptor_.async_accept([this](const beast::error_code &ec, boost::asio::ip::tcp::socket socket) {
+            if (ec == boost::asio::error::operation_aborted || !acceptor_.is_open()) {
+                return;
+            }
+            if (!ec) {
+                std::make_shared<Session>(std::move(socket), registry_)->Start();
+            }
+            Accept();
+        });
+    }
+}
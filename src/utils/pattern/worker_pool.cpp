@@ -0,0 +1,84 @@
+#include "nuansa/utils/pch.h"
+
+#include "nuansa/utils/pattern/worker_pool.h"
+
+namespace nuansa::utils::pattern {
+    WorkerPool::WorkerPool(const WorkerPoolSettings &settings)
+        : settings_{settings} {
+        settings_.threadCount = std::max<size_t>(1, settings_.threadCount);
+        settings_.queueCapacity = std::max<size_t>(1, settings_.queueCapacity);
+
+        workers_.reserve(settings_.threadCount);
+        for (size_t i = 0; i < settings_.threadCount; ++i) {
+            workers_.emplace_back([this] { WorkerLoop(); });
+        }
+
+        LOG_INFO << "Worker pool '" << settings_.name << "' started with " << settings_.threadCount
+                << " threads, queue capacity " << settings_.queueCapacity;
+    }
+
+    WorkerPool::~WorkerPool() {
+        Shutdown();
+    }
+
+    bool WorkerPool::TryPost(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_ || queue_.size() >= settings_.queueCapacity) {
+                rejected_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            queue_.push_back(std::move(task));
+        }
+        condition_.notify_one();
+        return true;
+    }
+
+    void WorkerPool::Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            stopping_ = true;
+        }
+        condition_.notify_all();
+
+        for (auto &worker: workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+
+        LOG_INFO << "Worker pool '" << settings_.name << "' stopped";
+    }
+
+    size_t WorkerPool::QueueDepth() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+    void WorkerPool::WorkerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                condition_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+
+                // Drain remaining work before exiting so no submitted future is left broken
+                if (queue_.empty()) {
+                    return;
+                }
+
+                task = std::move(queue_.front());
+                queue_.pop_front();
+            }
+
+            try {
+                task();
+            } catch (const std::exception &e) {
+                LOG_ERROR << "Unhandled exception in worker pool '" << settings_.name << "': " << e.what();
+            }
+        }
+    }
+} // namespace nuansa::utils::pattern
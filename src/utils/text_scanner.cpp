@@ -0,0 +1,31 @@
+#include <cstring>
+
+#include "nuansa/utils/text_scanner.h"
+
+namespace nuansa::utils {
+    std::vector<std::string_view> TextScanner::FindMentions(const std::string_view content) {
+        std::vector<std::string_view> mentions;
+
+        // Jumps between '@'s with memchr, which libc vectorizes, so long messages
+        // with few mentions are skipped 16-64 bytes at a time
+        const char *cursor = content.data();
+        const char *const end = content.data() + content.size();
+        while (cursor < end) {
+            const auto *at = static_cast<const char *>(std::memchr(cursor, '@', static_cast<size_t>(end - cursor)));
+            if (at == nullptr) {
+                break;
+            }
+
+            const char *name = at + 1;
+            cursor = name;
+            while (cursor < end && IsWordChar(*cursor)) {
+                ++cursor;
+            }
+            if (cursor > name) {
+                mentions.emplace_back(name, static_cast<size_t>(cursor - name));
+            }
+        }
+
+        return mentions;
+    }
+}
@@ -0,0 +1,385 @@
+#include "nuansa/utils/pch.h"
+
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+#include "nuansa/utils/trace/tracer.h"
+#include "nuansa/utils/http_client.h"
+#include "nuansa/utils/json_string.h"
+#include "nuansa/utils/metrics/metrics.h"
+
+namespace nuansa::utils::trace {
+    namespace {
+        // What the spans of the trace running on this thread attach to
+        struct ThreadContext {
+            bool active{false};
+            bool sampled{false};
+            std::array<uint8_t, 16> traceId{};
+            uint64_t currentSpanId{0};
+            uint8_t correlationIdLength{0};
+            char correlationId[SpanData::MAX_CORRELATION_ID]{};
+        };
+
+        thread_local ThreadContext context;
+
+        // splitmix64; ids and sampling only need to be unpredictable enough not to collide
+        uint64_t NextRandom() {
+            thread_local uint64_t state = std::random_device{}() ^
+                                          static_cast<uint64_t>(std::hash<std::thread::id>{}(
+                                              std::this_thread::get_id())) << 32;
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        uint64_t NextSpanId() {
+            uint64_t id;
+            do {
+                id = NextRandom();
+            } while (id == 0);
+            return id;
+        }
+
+        int64_t NowUnixNanos() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        void AppendHex(std::string &out, const uint8_t *bytes, const size_t size) {
+            constexpr char DIGITS[] = "0123456789abcdef";
+            for (size_t i = 0; i < size; ++i) {
+                out += DIGITS[bytes[i] >> 4];
+                out += DIGITS[bytes[i] & 0x0F];
+            }
+        }
+
+        void AppendSpanId(std::string &out, const uint64_t id) {
+            std::array<uint8_t, 8> bytes{};
+            for (size_t i = 0; i < bytes.size(); ++i) {
+                bytes[i] = static_cast<uint8_t>(id >> (56 - 8 * i));
+            }
+            AppendHex(out, bytes.data(), bytes.size());
+        }
+
+        void AppendNumber(std::string &out, const int64_t value) {
+            char digits[24];
+            const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, result.ptr);
+        }
+
+        struct TraceMetrics {
+            metrics::Counter &exported;
+            metrics::Counter &dropped;
+            metrics::Counter &failed;
+            metrics::Counter &exportErrors;
+        };
+
+        TraceMetrics &Metrics() {
+            static TraceMetrics metrics = [] {
+                auto &registry = metrics::MetricsRegistry::GetInstance();
+                return TraceMetrics{
+                    .exported = registry.GetCounter("nuansa_trace_spans_exported_total", "Spans written by the exporter"),
+                    .dropped = registry.GetCounter("nuansa_trace_spans_dropped_total",
+                                                   "Spans lost because the trace buffer was full"),
+                    .failed = registry.GetCounter("nuansa_trace_spans_failed_total",
+                                                  "Spans lost because the file or collector did not accept them"),
+                    .exportErrors = registry.GetCounter("nuansa_trace_export_errors_total",
+                                                        "Span batches the file or collector did not accept")
+                };
+            }();
+            return metrics;
+        }
+    }
+
+    SpanBuffer::SpanBuffer(const size_t capacity)
+        : mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1) {
+        slots_ = std::make_unique<Slot[]>(mask_ + 1);
+        for (size_t i = 0; i <= mask_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool SpanBuffer::TryPush(const SpanData &span) {
+        auto position = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            auto &slot = slots_[position & mask_];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.span = span;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false; // Full
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool SpanBuffer::TryPop(SpanData &span) {
+        auto position = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            auto &slot = slots_[position & mask_];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+            if (difference == 0) {
+                if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    span = slot.span;
+                    slot.sequence.store(position + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false; // Empty
+            } else {
+                position = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    Span::Span(const char *name) {
+        if (!context.sampled) {
+            return;
+        }
+        recording_ = true;
+        data_.name = name;
+        data_.traceId = context.traceId;
+        data_.spanId = NextSpanId();
+        data_.parentSpanId = context.currentSpanId;
+        data_.startUnixNanos = NowUnixNanos();
+        context.currentSpanId = data_.spanId;
+    }
+
+    Span::~Span() {
+        if (!recording_) {
+            return;
+        }
+        data_.endUnixNanos = NowUnixNanos();
+        data_.correlationIdLength = context.correlationIdLength;
+        std::memcpy(data_.correlationId, context.correlationId, context.correlationIdLength);
+        context.currentSpanId = data_.parentSpanId;
+        Tracer::GetInstance().Submit(data_);
+    }
+
+    TraceScope::TraceScope(const char *name) {
+        if (!context.active) {
+            owner_ = true;
+            context.active = true;
+            context.sampled = Tracer::GetInstance().ShouldSample();
+            context.currentSpanId = 0;
+            context.correlationIdLength = 0;
+            if (context.sampled) {
+                const uint64_t high = NextRandom();
+                const uint64_t low = NextRandom();
+                for (size_t i = 0; i < 8; ++i) {
+                    context.traceId[i] = static_cast<uint8_t>(high >> (56 - 8 * i));
+                    context.traceId[8 + i] = static_cast<uint8_t>(low >> (56 - 8 * i));
+                }
+            }
+        }
+        span_.emplace(name);
+        span_->data_.root = owner_;
+    }
+
+    TraceScope::~TraceScope() {
+        span_.reset();
+        if (owner_) {
+            context.active = false;
+            context.sampled = false;
+        }
+    }
+
+    void TraceScope::SetCorrelationId(const std::string_view correlationId) {
+        if (!context.sampled) {
+            return;
+        }
+        const auto length = std::min(correlationId.size(), SpanData::MAX_CORRELATION_ID);
+        std::memcpy(context.correlationId, correlationId.data(), length);
+        context.correlationIdLength = static_cast<uint8_t>(length);
+    }
+
+    Tracer &Tracer::GetInstance() {
+        static Tracer instance;
+        return instance;
+    }
+
+    Tracer::Tracer() {
+        // Built first so the counters outlive the final export in the destructor
+        Metrics();
+    }
+
+    Tracer::~Tracer() {
+        Shutdown();
+    }
+
+    void Tracer::Configure(const TracerSettings &settings) {
+        Shutdown();
+
+        settings_ = settings;
+        if (!ownedBuffer_) {
+            ownedBuffer_ = std::make_unique<SpanBuffer>(settings_.bufferCapacity);
+            buffer_.store(ownedBuffer_.get(), std::memory_order_release);
+        } else if (ownedBuffer_->Capacity() != std::bit_ceil(std::max<size_t>(settings_.bufferCapacity, 2))) {
+            LOG_WARNING << "Trace buffer keeps its capacity of " << ownedBuffer_->Capacity() << " spans";
+        }
+        if (!settings_.collectorUrl.empty()) {
+            httpClient_ = std::make_unique<HttpClient>();
+        }
+        if (!settings_.filePath.empty()) {
+            const std::filesystem::path path(settings_.filePath);
+            if (path.has_parent_path()) {
+                std::filesystem::create_directories(path.parent_path());
+            }
+        }
+
+        const auto rate = std::clamp(settings_.sampleRate, 0.0, 1.0);
+        sampleThreshold_.store(rate >= 1.0
+                                   ? std::numeric_limits<uint64_t>::max()
+                                   : static_cast<uint64_t>(rate * 18446744073709551616.0),
+                               std::memory_order_release);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = false;
+        }
+        thread_ = std::thread([this] { Run(); });
+
+        LOG_INFO << "Tracing " << rate * 100 << "% of requests"
+                << (settings_.filePath.empty() ? "" : " to " + settings_.filePath)
+                << (settings_.collectorUrl.empty() ? "" : " to " + settings_.collectorUrl);
+    }
+
+    void Tracer::Shutdown() {
+        sampleThreshold_.store(0, std::memory_order_release);
+        if (!thread_.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    bool Tracer::ShouldSample() {
+        const auto threshold = sampleThreshold_.load(std::memory_order_relaxed);
+        return threshold != 0 && (threshold == std::numeric_limits<uint64_t>::max() || NextRandom() < threshold);
+    }
+
+    void Tracer::Submit(const SpanData &span) {
+        auto *buffer = buffer_.load(std::memory_order_acquire);
+        if (!buffer || !buffer->TryPush(span)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            Metrics().dropped.Increment();
+        }
+    }
+
+    size_t Tracer::ExportNow() {
+        std::lock_guard<std::mutex> exportLock(exportMutex_);
+        if (!ownedBuffer_) {
+            return 0;
+        }
+
+        std::vector<SpanData> batch;
+        SpanData span;
+        while (ownedBuffer_->TryPop(span)) {
+            batch.push_back(span);
+        }
+        if (batch.empty()) {
+            return 0;
+        }
+
+        const auto body = ToOtlpJson(batch, settings_.serviceName);
+        auto &metrics = Metrics();
+        bool failed = false;
+
+        if (!settings_.filePath.empty()) {
+            std::ofstream file(settings_.filePath, std::ios::app);
+            file << body << '\n';
+            failed = !file.good();
+        }
+        if (httpClient_) {
+            const auto response = httpClient_->Post(settings_.collectorUrl, body,
+                                                    {"Content-Type: application/json"}, "", "",
+                                                    std::chrono::seconds(5));
+            if (!response.success || response.statusCode >= 300) {
+                LOG_WARNING << "Trace collector rejected " << batch.size() << " spans: "
+                        << (response.error.empty() ? std::to_string(response.statusCode) : response.error);
+                failed = true;
+            }
+        }
+
+        if (failed) {
+            metrics.exportErrors.Increment();
+            metrics.failed.Increment(batch.size());
+            return 0;
+        }
+        metrics.exported.Increment(batch.size());
+        return batch.size();
+    }
+
+    void Tracer::Run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            wake_.wait_for(lock, settings_.exportInterval, [this] { return stopping_; });
+            lock.unlock();
+            try {
+                ExportNow();
+            } catch (const std::exception &e) {
+                LOG_ERROR << "Trace export failed: " << e.what();
+            }
+            lock.lock();
+        }
+    }
+
+    std::string Tracer::ToOtlpJson(const std::vector<SpanData> &spans, const std::string_view serviceName) {
+        std::string out;
+        out.reserve(256 + spans.size() * 320);
+        out += R"({"resourceSpans":[{"resource":{"attributes":[{"key":"service.name","value":{"stringValue":)";
+        AppendJsonString(serviceName, out);
+        out += R"(}}]},"scopeSpans":[{"scope":{"name":"nuansa.trace"},"spans":[)";
+
+        for (size_t i = 0; i < spans.size(); ++i) {
+            const auto &span = spans[i];
+            if (i > 0) {
+                out += ',';
+            }
+            out += R"({"traceId":")";
+            AppendHex(out, span.traceId.data(), span.traceId.size());
+            out += R"(","spanId":")";
+            AppendSpanId(out, span.spanId);
+            out += '"';
+            if (span.parentSpanId != 0) {
+                out += R"(,"parentSpanId":")";
+                AppendSpanId(out, span.parentSpanId);
+                out += '"';
+            }
+            out += R"(,"name":)";
+            AppendJsonString(span.name, out);
+            // SPAN_KIND_SERVER for the frame that started the trace, INTERNAL below it
+            out += R"(,"kind":)";
+            out += span.root ? '2' : '1';
+            out += R"(,"startTimeUnixNano":")";
+            AppendNumber(out, span.startUnixNanos);
+            out += R"(","endTimeUnixNano":")";
+            AppendNumber(out, span.endUnixNanos);
+            out += '"';
+            if (span.correlationIdLength > 0) {
+                out += R"(,"attributes":[{"key":"nuansa.correlation_id","value":{"stringValue":)";
+                AppendJsonString(span.CorrelationId(), out);
+                out += R"(}}])";
+            }
+            // STATUS_CODE_ERROR or STATUS_CODE_UNSET
+            out += span.error ? R"(,"status":{"code":2}})" : R"(,"status":{}})";
+        }
+
+        out += "]}]}]}";
+        return out;
+    }
+}
@@ -2,7 +2,6 @@
 // Created by I Gede Panca Sutresna on 05/12/24.
 //
 #include "nuansa/utils/validation.h"
-#include "nuansa/utils/crypto/crypto_util.h"
 
 bool nuansa::utils::Validation::ValidateUsername(const std::string &username) {
 	// Username cannot be empty
@@ -22,13 +21,35 @@ bool nuansa::utils::Validation::ValidateUsername(const std::string &username) {
 }
 
 bool nuansa::utils::Validation::ValidateEmail(const std::string &email) {
-	if (email.empty()) {
+	// Accepts exactly what [a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,} matches, without a regex
+	const auto isAlpha = [](const char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); };
+	const auto isAlnum = [&](const char c) { return isAlpha(c) || (c >= '0' && c <= '9'); };
+
+	const auto at = email.find('@');
+	if (at == 0 || at == std::string::npos) {
 		return false;
 	}
 
-	// Basic email format validation
-	const std::regex emailRegex(R"([a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,})");
-	return std::regex_match(email, emailRegex);
+	for (size_t i = 0; i < at; ++i) {
+		const char c = email[i];
+		if (!isAlnum(c) && c != '.' && c != '_' && c != '%' && c != '+' && c != '-') {
+			return false;
+		}
+	}
+
+	for (size_t i = at + 1; i < email.size(); ++i) {
+		const char c = email[i];
+		if (!isAlnum(c) && c != '.' && c != '-') {
+			return false;
+		}
+	}
+
+	// The top-level domain is what follows the last dot: two or more letters, with a non-empty name before it
+	const auto lastDot = email.rfind('.');
+	if (lastDot == std::string::npos || lastDot <= at + 1 || email.size() - lastDot - 1 < 2) {
+		return false;
+	}
+	return std::all_of(email.begin() + static_cast<std::ptrdiff_t>(lastDot) + 1, email.end(), isAlpha);
 }
 
 
@@ -53,8 +74,6 @@ bool nuansa::utils::Validation::ValidatePassword(const std::string &password) {
 
 	LOG_DEBUG << "Password complexity: " << (hasUpper ? "upper" : "") << (hasLower ? "lower" : "") << (
 		         hasDigit ? "digit" : "") << (hasSpecial ? "special" : "");
-	std::string hashedPassword = nuansa::utils::crypto::CryptoUtil::HashPassword(password, "");
-	LOG_DEBUG << "Hashed password: " << hashedPassword;
 
 	return hasUpper && hasLower && hasDigit && hasSpecial;
 }
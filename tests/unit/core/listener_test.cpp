@@ -0,0 +1,128 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/core/listener.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using nuansa::core::IoMode;
+using nuansa::core::Listener;
+using nuansa::core::ListenerSettings;
+using namespace std::chrono_literals;
+
+namespace {
+    // Records which IO thread accepted each connection; declared after the Listener so the sockets go first
+    struct Accepted {
+        void Add(boost::asio::ip::tcp::socket socket) {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+            sockets.push_back(std::move(socket));
+            changed.notify_all();
+        }
+
+        bool WaitFor(const size_t count) {
+            std::unique_lock<std::mutex> lock(mutex);
+            return changed.wait_for(lock, 5s, [&] { return sockets.size() >= count; });
+        }
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::set<std::thread::id> threads;
+        std::vector<boost::asio::ip::tcp::socket> sockets;
+    };
+
+    std::vector<boost::asio::ip::tcp::socket> Connect(boost::asio::io_context &io, const uint16_t port,
+                                                      const size_t count) {
+        std::vector<boost::asio::ip::tcp::socket> clients;
+        for (size_t i = 0; i < count; ++i) {
+            clients.emplace_back(io).connect({boost::asio::ip::address_v4::loopback(), port});
+        }
+        return clients;
+    }
+}
+
+TEST(ListenerTest, SharedModeRunsEveryThreadOnOneAcceptor) {
+    Listener listener(ListenerSettings{.host = "127.0.0.1", .threads = 3});
+    Accepted accepted;
+    listener.Start([&accepted](boost::asio::ip::tcp::socket socket) { accepted.Add(std::move(socket)); });
+    EXPECT_EQ(listener.ThreadCount(), 3u);
+    ASSERT_NE(listener.GetPort(), 0);
+
+    boost::asio::io_context io;
+    const auto clients = Connect(io, listener.GetPort(), 8);
+    EXPECT_TRUE(accepted.WaitFor(8));
+    listener.Stop();
+}
+
+TEST(ListenerTest, PerCoreAcceptorsShareThePortAndSpreadConnections) {
+    Listener listener(ListenerSettings{.host = "127.0.0.1", .mode = IoMode::PerCore, .threads = 2});
+    Accepted accepted;
+    listener.Start([&accepted](boost::asio::ip::tcp::socket socket) {
+        // The connection stays on the context of the thread that accepted it
+        EXPECT_TRUE(socket.get_executor().target<boost::asio::io_context::executor_type>()
+            ->running_in_this_thread());
+        accepted.Add(std::move(socket));
+    });
+
+    // Different source ports hash to both acceptors; all landing on one is a 2^-63 chance
+    boost::asio::io_context io;
+    const auto clients = Connect(io, listener.GetPort(), 64);
+    ASSERT_TRUE(accepted.WaitFor(64));
+    listener.Stop();
+    EXPECT_EQ(accepted.threads.size(), 2u);
+}
+
+TEST(ListenerTest, StopAcceptingRefusesNewConnections) {
+    Listener listener(ListenerSettings{.host = "127.0.0.1", .mode = IoMode::PerCore, .threads = 2});
+    Accepted accepted;
+    listener.Start([&accepted](boost::asio::ip::tcp::socket socket) { accepted.Add(std::move(socket)); });
+    const auto port = listener.GetPort();
+
+    boost::asio::io_context io;
+    const auto before = Connect(io, port, 1);
+    ASSERT_TRUE(accepted.WaitFor(1));
+
+    listener.StopAccepting();
+    boost::system::error_code ec;
+    for (const auto deadline = std::chrono::steady_clock::now() + 5s;
+         !ec && std::chrono::steady_clock::now() < deadline;) {
+        boost::asio::ip::tcp::socket client(io);
+        client.connect({boost::asio::ip::address_v4::loopback(), port}, ec);
+        std::this_thread::sleep_for(10ms);
+    }
+    EXPECT_EQ(ec, boost::asio::error::connection_refused);
+    listener.Stop();
+}
+
+#ifdef __linux__
+TEST(ListenerTest, PinnedThreadsRunOnTheirCpu) {
+    // The only thread goes to the first CPU this process is allowed on, not necessarily CPU 0
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    int expected = 0;
+    while (!CPU_ISSET(expected, &allowed)) {
+        ++expected;
+    }
+
+    std::promise<std::optional<int> > cpu;
+    Listener listener(ListenerSettings{
+        .host = "127.0.0.1", .mode = IoMode::PerCore, .threads = 1, .pinThreads = true
+    });
+    listener.Start([&cpu, expected](boost::asio::ip::tcp::socket) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        sched_getaffinity(0, sizeof(set), &set);
+        cpu.set_value(CPU_COUNT(&set) == 1 && CPU_ISSET(expected, &set) ? std::optional<int>(expected) : std::nullopt);
+    });
+
+    boost::asio::io_context io;
+    const auto client = Connect(io, listener.GetPort(), 1);
+    auto pinned = cpu.get_future();
+    ASSERT_EQ(pinned.wait_for(5s), std::future_status::ready);
+    EXPECT_EQ(pinned.get(), expected);
+    listener.Stop();
+}
+#endif
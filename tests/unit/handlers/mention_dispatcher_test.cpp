@@ -0,0 +1,236 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/handler/mention_dispatcher.h"
+#include "nuansa/handler/websocket_server.h"
+#include "nuansa/services/chat/in_memory_mention_inbox.h"
+#include "nuansa/services/user/in_memory_user_service.h"
+#include "utils/loopback_websocket.h"
+
+using nuansa::handler::MentionDispatcher;
+using nuansa::handler::MentionDispatcherSettings;
+using nuansa::handler::WebSocketClient;
+using nuansa::handler::WebSocketServer;
+using nuansa::messages::Message;
+using nuansa::services::chat::InboxMention;
+using nuansa::services::chat::InMemoryMentionInbox;
+using nuansa::services::user::InMemoryUserService;
+using nuansa::tests::utils::LoopbackConnection;
+using nuansa::tests::utils::MakeClient;
+
+namespace {
+    Message MakeMessage(const std::string &id, const std::string &sender, const std::string &content,
+                        std::vector<std::string> mentions, const std::time_t timestamp = 1700000000) {
+        Message message;
+        message.id = id;
+        message.sender = sender;
+        message.content = content;
+        message.mentions = std::move(mentions);
+        message.timestamp = timestamp;
+        return message;
+    }
+
+    // Everyone the tests mention except "example", which only appears after an email's @
+    InMemoryUserService &Users() {
+        static InMemoryUserService users;
+        static const bool seeded = [] {
+            for (const auto *name: {"alice", "bob", "carol", "dave", "erin"}) {
+                users.CreateUser(nuansa::models::User(name, std::string(name) + "@example.com", "hash", "", ""));
+            }
+            return true;
+        }();
+        (void) seeded;
+        return users;
+    }
+
+    // Writer thread effectively idle, so tests decide when batches are written
+    MentionDispatcherSettings ManualFlush(InMemoryMentionInbox &inbox) {
+        return MentionDispatcherSettings{
+            .batchSize = 1000,
+            .flushInterval = std::chrono::hours(1),
+            .deliveryThreads = 1,
+            .inbox = &inbox,
+            .users = &Users()
+        };
+    }
+}
+
+TEST(MentionDispatcherTest, ResolveRecipientsDedupesAndSkipsTheSender) {
+    const auto message = MakeMessage("m1", "alice", "", {"carol", "bob", "alice", "carol", "", "dave"});
+
+    EXPECT_EQ(MentionDispatcher::ResolveRecipients(message, 10),
+              (std::vector<std::string_view>{"bob", "carol", "dave"}));
+    EXPECT_EQ(MentionDispatcher::ResolveRecipients(message, 2), (std::vector<std::string_view>{"bob", "carol"}));
+}
+
+TEST(MentionDispatcherTest, ExcerptKeepsWholeCharacters) {
+    EXPECT_EQ(MentionDispatcher::Excerpt("hello", 10), "hello");
+    EXPECT_EQ(MentionDispatcher::Excerpt("hello", 3), "hel");
+    // "é" is two bytes; cutting after its first byte backs off to before it
+    EXPECT_EQ(MentionDispatcher::Excerpt("caf\xC3\xA9!", 4), "caf");
+    EXPECT_EQ(MentionDispatcher::Excerpt("caf\xC3\xA9!", 5), "caf\xC3\xA9");
+}
+
+TEST(WebSocketServerTest, RemoveClientLeavesANewerLoginAlone) {
+    WebSocketServer server;
+    const auto first = MakeClient("bob");
+    const auto second = MakeClient("bob");
+    server.AddClient("bob", first);
+    server.AddClient("bob", second);
+    server.AddClient("dave", MakeClient("dave"));
+
+    EXPECT_FALSE(server.RemoveClient("bob", first));
+    EXPECT_EQ(server.FindClient("bob"), second);
+
+    const auto found = server.FindClients({"alice", "bob", "carol", "dave"});
+    ASSERT_EQ(found.size(), 2u);
+    EXPECT_EQ(found[0].first, "bob");
+    EXPECT_EQ(found[1].first, "dave");
+
+    EXPECT_TRUE(server.RemoveClient("bob", second));
+    EXPECT_FALSE(server.IsOnline("bob"));
+    EXPECT_EQ(server.ClientCount(), 1u);
+}
+
+TEST(WebSocketClientTest, QueueFrameAsksForOneFlushAndDropsAfterAFailedWrite) {
+    const auto client = MakeClient("bob");
+    const auto frame = std::make_shared<const std::string>("{}");
+
+    EXPECT_EQ(client->QueueFrame(frame), WebSocketClient::QueueResult::NeedsFlush);
+    EXPECT_EQ(client->QueueFrame(frame), WebSocketClient::QueueResult::Queued);
+
+    // No socket, so the first write fails and the connection stops accepting frames
+    EXPECT_EQ(client->FlushOutbound(), 0u);
+    EXPECT_EQ(client->QueueFrame(frame), WebSocketClient::QueueResult::Dropped);
+}
+
+TEST(MentionDispatcherTest, OfflineMentionsWaitForTheirBatch) {
+    InMemoryMentionInbox inbox;
+    MentionDispatcher dispatcher;
+    dispatcher.Configure(ManualFlush(inbox));
+    const WebSocketServer server;
+
+    const auto result = dispatcher.Dispatch(
+        MakeMessage("m1", "alice", "hi @bob @carol @bob", {"bob", "carol", "bob", "alice"}), server);
+    EXPECT_EQ(result.online, 0u);
+    EXPECT_EQ(result.offline, 2u);
+    EXPECT_EQ(dispatcher.PendingInboxEntries(), 2u);
+    EXPECT_EQ(inbox.Size(), 0u);
+
+    EXPECT_EQ(dispatcher.FlushInbox(), 2u);
+    EXPECT_EQ(inbox.Size(), 2u);
+
+    const auto stored = inbox.Take("bob", 10);
+    ASSERT_EQ(stored.size(), 1u);
+    EXPECT_EQ(stored[0].messageId, "m1");
+    EXPECT_EQ(stored[0].sender, "alice");
+    EXPECT_EQ(stored[0].excerpt, "hi @bob @carol @bob");
+}
+
+TEST(MentionDispatcherTest, NamesThatAreNotUsersAreNeverStored) {
+    InMemoryMentionInbox inbox;
+    MentionDispatcher dispatcher;
+    dispatcher.Configure(ManualFlush(inbox));
+
+    dispatcher.Dispatch(MakeMessage("m1", "alice", "mail bob@example.com", {"bob", "example"}), WebSocketServer{});
+    EXPECT_EQ(dispatcher.FlushInbox(), 1u);
+    EXPECT_EQ(inbox.Recipients(), 1u);
+    EXPECT_TRUE(inbox.Take("example", 10).empty());
+}
+
+TEST(InMemoryMentionInboxTest, CapsEntriesPerUserAndUsersWithAnInbox) {
+    InMemoryMentionInbox inbox(2);
+    EXPECT_TRUE(inbox.Append({
+                    InboxMention{"bob", "m1", "alice", "", 100},
+                    InboxMention{"bob", "m2", "alice", "", 200},
+                    InboxMention{"bob", "m3", "alice", "", 300},
+                    InboxMention{"carol", "m3", "alice", "", 300}
+                }, 2));
+    EXPECT_FALSE(inbox.Append({InboxMention{"dave", "m4", "alice", "", 400}}, 2));
+    EXPECT_EQ(inbox.Recipients(), 2u);
+
+    const auto bob = inbox.Take("bob", 10);
+    ASSERT_EQ(bob.size(), 2u);
+    EXPECT_EQ(bob[0].messageId, "m2");
+    EXPECT_EQ(bob[1].messageId, "m3");
+
+    // Taking bob's inbox frees a place
+    EXPECT_TRUE(inbox.Append({InboxMention{"dave", "m4", "alice", "", 400}}, 2));
+}
+
+TEST(MentionDispatcherTest, FullBatchIsWrittenByTheBackgroundThread) {
+    InMemoryMentionInbox inbox;
+    MentionDispatcher dispatcher;
+    auto settings = ManualFlush(inbox);
+    settings.batchSize = 2;
+    dispatcher.Configure(settings);
+
+    dispatcher.Dispatch(MakeMessage("m1", "alice", "", {"bob", "carol"}), WebSocketServer{});
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (inbox.Size() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(inbox.Size(), 2u);
+}
+
+TEST(MentionDispatcherTest, MentionsAfterShutdownAreStoredImmediately) {
+    InMemoryMentionInbox inbox;
+    MentionDispatcher dispatcher;
+    dispatcher.Configure(ManualFlush(inbox));
+    dispatcher.Shutdown();
+
+    dispatcher.Dispatch(MakeMessage("m1", "alice", "", {"bob"}), WebSocketServer{});
+    EXPECT_EQ(dispatcher.PendingInboxEntries(), 0u);
+    EXPECT_EQ(inbox.Size(), 1u);
+}
+
+TEST(MentionDispatcherTest, OnlineRecipientGetsTheNotificationFrame) {
+    InMemoryMentionInbox inbox;
+    MentionDispatcher dispatcher;
+    dispatcher.Configure(ManualFlush(inbox));
+
+    LoopbackConnection connection;
+    WebSocketServer server;
+    server.AddClient("bob", MakeClient("bob", connection.server));
+
+    const auto result = dispatcher.Dispatch(
+        MakeMessage("m1", "alice", "ping @bob and @carol", {"bob", "carol"}), server);
+    EXPECT_EQ(result.online, 1u);
+    EXPECT_EQ(result.offline, 1u);
+
+    const auto frame = connection.Read();
+    EXPECT_EQ(frame["type"], "mention");
+    EXPECT_EQ(frame["messageId"], "m1");
+    EXPECT_EQ(frame["sender"], "alice");
+    EXPECT_EQ(frame["content"], "ping @bob and @carol");
+}
+
+TEST(MentionDispatcherTest, LoginDeliversStoredAndBufferedMentionsInOneFrame) {
+    InMemoryMentionInbox inbox;
+    MentionDispatcher dispatcher;
+    auto settings = ManualFlush(inbox);
+    settings.inboxLimit = 2;
+    settings.excerptBytes = 5;
+    dispatcher.Configure(settings);
+
+    // Oldest already stored, two newer ones still waiting for their batch
+    inbox.Append({InboxMention{"bob", "m1", "alice", "first", 100}}, 2);
+    dispatcher.Dispatch(MakeMessage("m2", "carol", "second message", {"bob"}, 200), WebSocketServer{});
+    dispatcher.Dispatch(MakeMessage("m3", "dave", "third", {"bob", "erin"}, 300), WebSocketServer{});
+
+    LoopbackConnection connection;
+    EXPECT_EQ(dispatcher.DeliverInbox(MakeClient("bob", connection.server)), 2u);
+
+    const auto frame = connection.Read();
+    EXPECT_EQ(frame["type"], "mention_inbox");
+    EXPECT_EQ(frame["count"], 2);
+    ASSERT_EQ(frame["mentions"].size(), 2u);
+    EXPECT_EQ(frame["mentions"][0]["messageId"], "m2");
+    EXPECT_EQ(frame["mentions"][0]["excerpt"], "secon");
+    EXPECT_EQ(frame["mentions"][1]["messageId"], "m3");
+
+    // Bob's inbox is empty now; erin's entry is still buffered
+    EXPECT_TRUE(inbox.Take("bob", 10).empty());
+    EXPECT_EQ(dispatcher.PendingInboxEntries(), 1u);
+}
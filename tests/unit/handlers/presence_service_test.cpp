@@ -0,0 +1,139 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/handler/presence_service.h"
+#include "utils/loopback_websocket.h"
+
+using nuansa::handler::PresenceService;
+using nuansa::handler::PresenceSettings;
+using nuansa::handler::WebSocketClient;
+using nuansa::tests::utils::LoopbackConnection;
+using nuansa::tests::utils::MakeClient;
+
+namespace {
+    // Deltas go out only when a test calls Flush
+    PresenceSettings ManualFlush(std::string defaultRoom = "lobby") {
+        return PresenceSettings{.defaultRoom = std::move(defaultRoom), .window = std::chrono::hours(1)};
+    }
+
+    std::vector<std::string> Names(const nlohmann::json &list) {
+        auto names = list.get<std::vector<std::string> >();
+        std::ranges::sort(names);
+        return names;
+    }
+}
+
+TEST(PresenceServiceTest, RoomNamesAreShortAndPlain) {
+    EXPECT_TRUE(PresenceService::IsValidRoomName("dev-ops_2.eu"));
+    EXPECT_FALSE(PresenceService::IsValidRoomName(""));
+    EXPECT_FALSE(PresenceService::IsValidRoomName("has space"));
+    EXPECT_FALSE(PresenceService::IsValidRoomName(std::string(65, 'r')));
+}
+
+TEST(PresenceServiceTest, SnapshotThenOneCoalescedDeltaPerWindow) {
+    // Declared first so the service lets go of the connections before their io_context goes away
+    LoopbackConnection alice;
+    LoopbackConnection bob;
+    PresenceService presence;
+    presence.Configure(ManualFlush());
+
+    presence.Connect(MakeClient("alice", alice.server));
+    auto frame = alice.Read();
+    EXPECT_EQ(frame["type"], "presence_snapshot");
+    EXPECT_EQ(frame["scope"], "room:lobby");
+    EXPECT_EQ(frame["version"], 0);
+    EXPECT_EQ(Names(frame["online"]), std::vector<std::string>{"alice"});
+
+    EXPECT_EQ(presence.Flush(), 1u);
+    frame = alice.Read();
+    EXPECT_EQ(frame["type"], "presence_delta");
+    EXPECT_EQ(frame["version"], 1);
+
+    // Carol comes and goes within the window, so only bob shows up
+    presence.Connect(MakeClient("bob", bob.server));
+    const auto carol = MakeClient("carol");
+    presence.Connect(carol);
+    presence.Disconnect(carol);
+
+    EXPECT_EQ(presence.Flush(), 1u);
+    frame = alice.Read();
+    EXPECT_EQ(frame["type"], "presence_delta");
+    EXPECT_EQ(frame["version"], 2);
+    EXPECT_EQ(Names(frame["online"]), std::vector<std::string>{"bob"});
+    EXPECT_TRUE(frame["offline"].empty());
+
+    // Bob's snapshot already had the state the delta brings him to
+    frame = bob.Read();
+    EXPECT_EQ(frame["type"], "presence_snapshot");
+    EXPECT_EQ(frame["version"], 1);
+    EXPECT_EQ(Names(frame["online"]), (std::vector<std::string>{"alice", "bob"}));
+    EXPECT_EQ(bob.Read()["version"], 2);
+
+    // Nothing changed since
+    EXPECT_EQ(presence.Flush(), 0u);
+}
+
+TEST(PresenceServiceTest, ContactListSeesOnlyItsContacts) {
+    LoopbackConnection alice;
+    PresenceService presence;
+    presence.Configure(ManualFlush(""));
+
+    const auto aliceClient = MakeClient("alice", alice.server);
+    presence.Connect(aliceClient);
+    presence.SetContacts(aliceClient, {"bob", "alice", "bob"});
+
+    auto frame = alice.Read();
+    EXPECT_EQ(frame["scope"], "contacts");
+    EXPECT_EQ(frame["version"], 1);
+    EXPECT_TRUE(frame["online"].empty());
+
+    const auto bob = MakeClient("bob");
+    presence.Connect(bob);
+    presence.Connect(MakeClient("dave"));
+    EXPECT_EQ(presence.Flush(), 1u);
+    frame = alice.Read();
+    EXPECT_EQ(frame["type"], "presence_delta");
+    EXPECT_EQ(frame["version"], 2);
+    EXPECT_EQ(Names(frame["online"]), std::vector<std::string>{"bob"});
+
+    presence.Disconnect(bob);
+    EXPECT_EQ(presence.Flush(), 1u);
+    frame = alice.Read();
+    EXPECT_EQ(frame["version"], 3);
+    EXPECT_EQ(Names(frame["offline"]), std::vector<std::string>{"bob"});
+}
+
+TEST(PresenceServiceTest, StaleConnectionCannotTakeTheUserOffline) {
+    PresenceService presence;
+    presence.Configure(ManualFlush());
+
+    const auto first = MakeClient("bob");
+    const auto second = MakeClient("bob");
+    presence.Connect(first);
+    presence.Connect(second);
+
+    presence.Disconnect(first);
+    EXPECT_TRUE(presence.IsOnline("bob"));
+
+    presence.Disconnect(second);
+    EXPECT_FALSE(presence.IsOnline("bob"));
+}
+
+TEST(PresenceServiceTest, JoinRoomsSkipsInvalidNamesAndRespectsTheLimit) {
+    PresenceService presence;
+    auto settings = ManualFlush("");
+    settings.maxRoomsPerUser = 2;
+    presence.Configure(settings);
+
+    const auto alice = MakeClient("alice");
+    presence.Connect(alice);
+
+    EXPECT_EQ(presence.JoinRooms(alice, {"bad room", "dev", "dev", "ops", "qa"}),
+              (std::vector<std::string>{"dev", "dev", "ops"}));
+
+    presence.LeaveRooms(alice, {"dev"});
+    EXPECT_EQ(presence.JoinRooms(alice, {"qa"}), std::vector<std::string>{"qa"});
+
+    // Not the user's connection
+    EXPECT_TRUE(presence.JoinRooms(MakeClient("alice"), {"dev"}).empty());
+}
@@ -0,0 +1,104 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/handler/session_drainer.h"
+#include "utils/loopback_websocket.h"
+
+using nuansa::handler::DrainSettings;
+using nuansa::handler::SessionDrainer;
+using nuansa::handler::WebSocketClient;
+using nuansa::tests::utils::LoopbackConnection;
+using namespace std::chrono_literals;
+
+namespace {
+    // Reads like a session thread until the connection ends, registered with the drainer meanwhile
+    struct Session {
+        explicit Session(SessionDrainer &drainer)
+            : client(std::make_shared<WebSocketClient>("id", connection.server)) {
+            drainer.Register(client);
+            reader = std::thread([this, &drainer] {
+                beast::flat_buffer buffer;
+                boost::system::error_code ec;
+                while (!ec) {
+                    connection.server->read(buffer, ec);
+                    buffer.consume(buffer.size());
+                }
+                drainer.Unregister(client);
+            });
+        }
+
+        ~Session() {
+            reader.join();
+        }
+
+        LoopbackConnection connection;
+        std::shared_ptr<WebSocketClient> client;
+        std::thread reader;
+    };
+}
+
+TEST(SessionDrainerTest, ReconnectMessageCarriesTheDelay) {
+    const auto message = nlohmann::json::parse(SessionDrainer::BuildReconnectMessage(1500ms));
+    EXPECT_EQ(message["type"], "reconnect");
+    EXPECT_EQ(message["reason"], "server_shutdown");
+    EXPECT_EQ(message["retryAfterMs"], 1500);
+}
+
+TEST(SessionDrainerTest, SessionsOpenedWhileDrainingCloseRightAway) {
+    SessionDrainer drainer;
+    EXPECT_EQ(drainer.Drain(DrainSettings{.window = 10s, .grace = 10s}), 0u);
+    EXPECT_TRUE(drainer.IsDraining());
+
+    const auto client = std::make_shared<WebSocketClient>("late", nullptr);
+    drainer.Register(client);
+    EXPECT_TRUE(client->CloseRequested());
+    drainer.Unregister(client);
+}
+
+TEST(SessionDrainerTest, HintsAreStaggeredAndEndEarlyWhenClientsLeave) {
+    SessionDrainer drainer;
+    Session first(drainer);
+    Session second(drainer);
+    ASSERT_EQ(drainer.ActiveSessions(), 2u);
+
+    // Well-behaved clients: read the hint, then close
+    std::vector<SessionDrainer::Clock::time_point> hinted(2);
+    std::vector<nlohmann::json> hints(2);
+    std::vector<std::thread> peers;
+    for (auto *session: {&first, &second}) {
+        const auto index = peers.size();
+        peers.emplace_back([session, index, &hinted, &hints] {
+            beast::flat_buffer buffer;
+            session->connection.peer.read(buffer);
+            hinted[index] = SessionDrainer::Clock::now();
+            hints[index] = nlohmann::json::parse(beast::buffers_to_string(buffer.data()));
+            session->connection.peer.close(websocket::close_code::normal);
+        });
+    }
+
+    const auto start = SessionDrainer::Clock::now();
+    EXPECT_EQ(drainer.Drain(DrainSettings{.window = 200ms, .grace = 10s, .reconnectJitter = 50ms}), 0u);
+    const auto elapsed = SessionDrainer::Clock::now() - start;
+    for (auto &peer: peers) {
+        peer.join();
+    }
+
+    EXPECT_LT(elapsed, 5s);
+    EXPECT_GE(std::ranges::max(hinted) - start, 90ms);
+    for (const auto &hint: hints) {
+        EXPECT_EQ(hint["type"], "reconnect");
+        EXPECT_LE(hint["retryAfterMs"].get<int64_t>(), 50);
+    }
+    EXPECT_TRUE(first.client->CloseRequested());
+    EXPECT_EQ(drainer.ActiveSessions(), 0u);
+}
+
+TEST(SessionDrainerTest, ClientsThatStayAreCutOffAfterTheGrace) {
+    SessionDrainer drainer;
+    Session idle(drainer);
+
+    const auto start = SessionDrainer::Clock::now();
+    EXPECT_EQ(drainer.Drain(DrainSettings{.window = 50ms, .grace = 100ms}), 0u);
+    EXPECT_GE(SessionDrainer::Clock::now() - start, 150ms);
+    EXPECT_EQ(drainer.ActiveSessions(), 0u);
+}
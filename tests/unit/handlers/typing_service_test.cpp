@@ -0,0 +1,149 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/handler/typing_service.h"
+#include "utils/loopback_websocket.h"
+
+using nuansa::handler::PresenceService;
+using nuansa::handler::PresenceSettings;
+using nuansa::handler::TypingEvent;
+using nuansa::handler::TypingResult;
+using nuansa::handler::TypingService;
+using nuansa::handler::TypingSettings;
+using nuansa::handler::WebSocketClient;
+using nuansa::tests::utils::LoopbackConnection;
+using nuansa::tests::utils::MakeClient;
+using namespace std::chrono_literals;
+
+namespace {
+    TypingEvent InRoom(const std::string &room, const bool typing) {
+        return TypingEvent{.room = room, .typing = typing};
+    }
+
+    // Everyone online shares the "dev" room; bob's connection can be read
+    class TypingServiceTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            presence.Configure(PresenceSettings{.defaultRoom = "dev", .window = 1h});
+            alice = MakeClient("alice");
+            presence.Connect(alice);
+            presence.Connect(MakeClient("bob", bob.server));
+            bob.Read(); // Room snapshot
+
+            Configure(TypingSettings{});
+        }
+
+        void Configure(TypingSettings settings) {
+            settings.window = 100ms;
+            settings.timeout = 1s;
+            settings.presence = &presence;
+            typing.Configure(settings);
+        }
+
+        // Ahead of the clock so the background flush never acts on these events
+        const TypingService::Clock::time_point t0 = TypingService::Clock::now() + 1h;
+
+        LoopbackConnection bob;
+        PresenceService presence;
+        TypingService typing;
+        std::shared_ptr<WebSocketClient> alice;
+    };
+}
+
+TEST(TypingFrameTest, ReadsTopLevelFieldsInAnyOrder) {
+    auto event = TypingService::ParseFrame(R"({"type":"typing","room":"dev","isTyping":true})");
+    ASSERT_TRUE(event.has_value());
+    EXPECT_EQ(event->room, "dev");
+    EXPECT_TRUE(event->recipient.empty());
+    EXPECT_TRUE(event->typing);
+
+    event = TypingService::ParseFrame(
+        R"({"isTyping":false,"meta":{"room":"x","isTyping":[1]},"recipient":"bob","type":"typing"})");
+    ASSERT_TRUE(event.has_value());
+    EXPECT_TRUE(event->room.empty());
+    EXPECT_EQ(event->recipient, "bob");
+    EXPECT_FALSE(event->typing);
+}
+
+TEST(TypingFrameTest, LeavesOtherFramesToTheStateMachine) {
+    EXPECT_FALSE(TypingService::ParseFrame(R"({"type":"new","content":"still typing..."})"));
+    EXPECT_FALSE(TypingService::ParseFrame(R"({"type":{"typing":1}})"));
+    EXPECT_FALSE(TypingService::ParseFrame(R"(["typing"])"));
+    EXPECT_FALSE(TypingService::ParseFrame(R"("typing")"));
+    EXPECT_FALSE(TypingService::ParseFrame(R"({"type":"typing","room":"dev")"));
+}
+
+TEST(TypingFrameTest, MalformedEventHasNoScope) {
+    for (const auto *frame: {R"({"type":"typing","room":5,"isTyping":true})",
+                             R"({"type":"typing","room":"dev"})",
+                             R"({"type":"typing","room":"dev","isTyping":"yes"})"}) {
+        const auto event = TypingService::ParseFrame(frame);
+        ASSERT_TRUE(event.has_value()) << frame;
+        EXPECT_TRUE(event->room.empty() && event->recipient.empty()) << frame;
+    }
+}
+
+TEST(TypingFrameTest, BuildsValidJson) {
+    const auto frame = nlohmann::json::parse(TypingService::BuildFrame("a\"b\\c\n", "dev", true));
+    EXPECT_EQ(frame["type"], "typing");
+    EXPECT_EQ(frame["username"], "a\"b\\c\n");
+    EXPECT_EQ(frame["room"], "dev");
+    EXPECT_EQ(frame["isTyping"], true);
+
+    EXPECT_FALSE(nlohmann::json::parse(TypingService::BuildFrame("bob", "", false)).contains("room"));
+}
+
+TEST_F(TypingServiceTest, RepeatsAreDroppedAndChangesWaitForTheWindow) {
+    EXPECT_EQ(typing.Publish(alice, InRoom("dev", true), t0), TypingResult::Sent);
+    EXPECT_EQ(bob.Read(), nlohmann::json::parse(R"({"type":"typing","username":"alice","room":"dev","isTyping":true})"));
+
+    EXPECT_EQ(typing.Publish(alice, InRoom("dev", true), t0 + 10ms), TypingResult::Duplicate);
+    EXPECT_EQ(typing.Publish(alice, InRoom("dev", false), t0 + 20ms), TypingResult::Held);
+    // Back to what bob already saw, so the held change is gone
+    EXPECT_EQ(typing.Publish(alice, InRoom("dev", true), t0 + 30ms), TypingResult::Duplicate);
+    EXPECT_EQ(typing.Publish(alice, InRoom("dev", false), t0 + 40ms), TypingResult::Held);
+
+    EXPECT_EQ(typing.Flush(t0 + 50ms), 0u);
+    EXPECT_EQ(typing.Flush(t0 + 100ms), 1u);
+    EXPECT_EQ(bob.Read()["isTyping"], false);
+
+    EXPECT_EQ(typing.Flush(t0 + 300ms), 0u);
+    EXPECT_EQ(typing.Publish(alice, InRoom("dev", true), t0 + 300ms), TypingResult::Sent);
+    EXPECT_EQ(bob.Read()["isTyping"], true);
+}
+
+TEST_F(TypingServiceTest, DirectIndicatorStopsAfterTheTimeout) {
+    EXPECT_EQ(typing.Publish(alice, TypingEvent{.recipient = "bob", .typing = true}, t0), TypingResult::Sent);
+    auto frame = bob.Read();
+    EXPECT_EQ(frame["username"], "alice");
+    EXPECT_FALSE(frame.contains("room"));
+
+    EXPECT_EQ(typing.Flush(t0 + 999ms), 0u);
+    EXPECT_EQ(typing.Flush(t0 + 1s), 1u);
+    frame = bob.Read();
+    EXPECT_EQ(frame["isTyping"], false);
+    EXPECT_FALSE(frame.contains("room"));
+}
+
+TEST_F(TypingServiceTest, DisconnectStopsTyping) {
+    EXPECT_EQ(typing.Publish(alice, InRoom("dev", true), t0), TypingResult::Sent);
+    EXPECT_EQ(bob.Read()["isTyping"], true);
+
+    typing.Disconnect("alice");
+    const auto frame = bob.Read();
+    EXPECT_EQ(frame["room"], "dev");
+    EXPECT_EQ(frame["isTyping"], false);
+}
+
+TEST_F(TypingServiceTest, RejectsEventsWithoutAnAudience) {
+    EXPECT_EQ(typing.Publish(alice, InRoom("ops", true), t0), TypingResult::Rejected);
+    EXPECT_EQ(typing.Publish(alice, InRoom("bad room", true), t0), TypingResult::Rejected);
+    EXPECT_EQ(typing.Publish(alice, TypingEvent{.recipient = "carol", .typing = true}, t0), TypingResult::Rejected);
+    EXPECT_EQ(typing.Publish(alice, TypingEvent{.recipient = "alice", .typing = true}, t0), TypingResult::Rejected);
+    EXPECT_EQ(typing.Publish(alice, TypingEvent{.room = "dev", .recipient = "bob", .typing = true}, t0),
+              TypingResult::Rejected);
+
+    presence.Connect(MakeClient("carol"));
+    Configure(TypingSettings{.maxRoomPeers = 1});
+    EXPECT_EQ(typing.Publish(alice, InRoom("dev", true), t0), TypingResult::Rejected);
+}
@@ -207,4 +207,15 @@ namespace App {
 	//     EXPECT_EQ(msg->content, "Original content");
 	//     EXPECT_FALSE(msg->isDeleted);
 	// }
+
+	TEST(WebSocketHandlerTest, ValidateRejectsMissingOrNonStringContent) {
+		using nuansa::handler::WebSocketHandler;
+
+		EXPECT_NO_THROW(WebSocketHandler::ValidateMessageFormat(json{{"type", "new"}, {"content", "Hello @user1!"}}));
+		EXPECT_THROW(WebSocketHandler::ValidateMessageFormat(json{{"type", "new"}}), std::invalid_argument);
+		EXPECT_THROW(WebSocketHandler::ValidateMessageFormat(json{{"type", "new"}, {"content", 42}}),
+		             std::invalid_argument);
+		EXPECT_THROW(WebSocketHandler::ValidateMessageFormat(json{{"type", "edit"}, {"id", "m1"}, {"content", nullptr}}),
+		             std::invalid_argument);
+	}
 } // namespace App
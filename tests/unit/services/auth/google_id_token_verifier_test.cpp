@@ -0,0 +1,197 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include <openssl/core_names.h>
+#include <openssl/rsa.h>
+#include "nuansa/services/auth/google_id_token_verifier.h"
+#include "utils/local_http_server.h"
+
+using nuansa::services::auth::GoogleIdTokenVerifier;
+using nuansa::services::auth::GoogleIdTokenVerifierSettings;
+using nuansa::tests::utils::LocalHttpServer;
+
+namespace {
+    std::string Base64Url(const std::string &data) {
+        std::string encoded(4 * ((data.size() + 2) / 3), '\0');
+        encoded.resize(EVP_EncodeBlock(reinterpret_cast<unsigned char *>(encoded.data()),
+                                       reinterpret_cast<const unsigned char *>(data.data()),
+                                       static_cast<int>(data.size())));
+        encoded.erase(encoded.find_last_not_of('=') + 1);
+        for (auto &c: encoded) {
+            if (c == '+') c = '-';
+            else if (c == '/') c = '_';
+        }
+        return encoded;
+    }
+
+    // RSA key pair standing in for one of Google's signing keys
+    class SigningKey {
+    public:
+        explicit SigningKey(std::string kid)
+            : kid_(std::move(kid)),
+              key_(EVP_RSA_gen(2048), EVP_PKEY_free) {
+        }
+
+        nlohmann::json Jwk() const {
+            return {
+                {"kty", "RSA"}, {"alg", "RS256"}, {"use", "sig"}, {"kid", kid_},
+                {"n", Base64Url(BigNumber(OSSL_PKEY_PARAM_RSA_N))},
+                {"e", Base64Url(BigNumber(OSSL_PKEY_PARAM_RSA_E))}
+            };
+        }
+
+        std::string Sign(const nlohmann::json &claims, const std::string &alg = "RS256") const {
+            const auto signingInput = Base64Url(nlohmann::json{{"alg", alg}, {"kid", kid_}, {"typ", "JWT"}}.dump()) +
+                                      "." + Base64Url(claims.dump());
+
+            const std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+            size_t length = 0;
+            EVP_DigestSignInit(ctx.get(), nullptr, EVP_sha256(), nullptr, key_.get());
+            EVP_DigestSign(ctx.get(), nullptr, &length,
+                           reinterpret_cast<const unsigned char *>(signingInput.data()), signingInput.size());
+            std::string signature(length, '\0');
+            EVP_DigestSign(ctx.get(), reinterpret_cast<unsigned char *>(signature.data()), &length,
+                           reinterpret_cast<const unsigned char *>(signingInput.data()), signingInput.size());
+            signature.resize(length);
+
+            return signingInput + "." + Base64Url(signature);
+        }
+
+    private:
+        std::string BigNumber(const char *name) const {
+            BIGNUM *value = nullptr;
+            EVP_PKEY_get_bn_param(key_.get(), name, &value);
+            std::string bytes(BN_num_bytes(value), '\0');
+            BN_bn2bin(value, reinterpret_cast<unsigned char *>(bytes.data()));
+            BN_free(value);
+            return bytes;
+        }
+
+        std::string kid_;
+        std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> key_;
+    };
+
+    nlohmann::json Claims() {
+        return {
+            {"iss", "https://accounts.google.com"},
+            {"aud", "client-id"},
+            {"sub", "1234567890"},
+            {"email", "user@example.com"},
+            {"email_verified", true},
+            {"exp", 4102444800}
+        };
+    }
+}
+
+class GoogleIdTokenVerifierTest : public ::testing::Test {
+protected:
+    GoogleIdTokenVerifierTest()
+        : current_("current"),
+          rotated_("rotated"),
+          server_([this](const LocalHttpServer::Request &, LocalHttpServer::Response &response) {
+              nlohmann::json keys = nlohmann::json::array({current_.Jwk()});
+              if (rotatedPublished_) {
+                  keys.push_back(rotated_.Jwk());
+              }
+              response.set(boost::beast::http::field::cache_control, "public, max-age=3600, must-revalidate");
+              response.set(boost::beast::http::field::content_type, "application/json");
+              response.body() = nlohmann::json{{"keys", keys}}.dump();
+          }) {
+    }
+
+    std::unique_ptr<GoogleIdTokenVerifier> MakeVerifier() {
+        auto verifier = std::make_unique<GoogleIdTokenVerifier>(GoogleIdTokenVerifierSettings{
+                                                                    .jwksUrl = server_.Url("/certs"),
+                                                                    .minRefreshInterval = std::chrono::seconds(0)
+                                                                }, client_);
+        WaitFor([&] { return verifier->HasKeys(); });
+        return verifier;
+    }
+
+    static void WaitFor(const std::function<bool()> &condition) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!condition() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        ASSERT_TRUE(condition());
+    }
+
+    SigningKey current_;
+    SigningKey rotated_;
+    std::atomic<bool> rotatedPublished_{false};
+    LocalHttpServer server_;
+    nuansa::utils::HttpClient client_;
+};
+
+TEST_F(GoogleIdTokenVerifierTest, VerifiesTokenSignedWithPublishedKey) {
+    const auto verifier = MakeVerifier();
+    EXPECT_EQ(verifier->KeyCount(), 1u);
+
+    const auto claims = verifier->Verify(current_.Sign(Claims()));
+    ASSERT_TRUE(claims.has_value());
+    EXPECT_EQ((*claims)["sub"], "1234567890");
+    EXPECT_EQ((*claims)["aud"], "client-id");
+}
+
+TEST_F(GoogleIdTokenVerifierTest, VerifyDoesNotTouchTheNetwork) {
+    const auto verifier = MakeVerifier();
+    const auto requests = server_.Requests();
+
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_TRUE(verifier->Verify(current_.Sign(Claims())).has_value());
+    }
+    EXPECT_EQ(server_.Requests(), requests);
+}
+
+TEST_F(GoogleIdTokenVerifierTest, RejectsTamperedOrMalformedTokens) {
+    const auto verifier = MakeVerifier();
+    const auto token = current_.Sign(Claims());
+
+    // Swap in a different payload under the original signature
+    auto forgedClaims = Claims();
+    forgedClaims["sub"] = "attacker";
+    const auto firstDot = token.find('.');
+    const auto secondDot = token.find('.', firstDot + 1);
+    const auto forged = token.substr(0, firstDot + 1) + Base64Url(forgedClaims.dump()) + token.substr(secondDot);
+    EXPECT_FALSE(verifier->Verify(forged).has_value());
+
+    EXPECT_FALSE(verifier->Verify(current_.Sign(Claims(), "none")).has_value());
+    EXPECT_FALSE(verifier->Verify("not-a-jwt").has_value());
+    EXPECT_FALSE(verifier->Verify("a.b.c.d").has_value());
+    EXPECT_FALSE(verifier->Verify("").has_value());
+}
+
+TEST_F(GoogleIdTokenVerifierTest, UnknownKeyIdTriggersRefresh) {
+    const auto verifier = MakeVerifier();
+    const auto token = rotated_.Sign(Claims());
+
+    // Google rotates keys: the new kid is unknown until the JWKS is fetched again
+    rotatedPublished_ = true;
+    EXPECT_FALSE(verifier->Verify(token).has_value());
+
+    WaitFor([&] { return verifier->KeyCount() == 2; });
+    EXPECT_TRUE(verifier->Verify(token).has_value());
+}
+
+TEST_F(GoogleIdTokenVerifierTest, NoKeysUntilJwksIsReachable) {
+    GoogleIdTokenVerifier verifier(GoogleIdTokenVerifierSettings{
+                                       .jwksUrl = server_.Url("/certs").replace(0, 4, "nope"),
+                                       .fetchTimeout = std::chrono::milliseconds(200)
+                                   }, client_);
+
+    EXPECT_FALSE(verifier.Refresh());
+    EXPECT_FALSE(verifier.HasKeys());
+    EXPECT_FALSE(verifier.Verify(current_.Sign(Claims())).has_value());
+}
+
+TEST(GoogleIdTokenVerifierMaxAgeTest, ParsesCacheControlHeader) {
+    using std::chrono::seconds;
+
+    EXPECT_EQ(GoogleIdTokenVerifier::ParseMaxAge({
+                  "HTTP/1.1 200 OK\r\n",
+                  "Cache-Control: public, max-age=19204, must-revalidate, no-transform\r\n"
+              }), seconds(19204));
+    EXPECT_EQ(GoogleIdTokenVerifier::ParseMaxAge({"cache-control: max-age=60\r\n"}), seconds(60));
+    EXPECT_FALSE(GoogleIdTokenVerifier::ParseMaxAge({"Cache-Control: no-cache\r\n"}).has_value());
+    EXPECT_FALSE(GoogleIdTokenVerifier::ParseMaxAge({"Expires: Mon, 01 Jan 2024 00:00:00 GMT\r\n"}).has_value());
+}
@@ -0,0 +1,205 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/services/storage/storage_registry.h"
+#include "nuansa/services/token/in_memory_token_repository.h"
+#include "nuansa/services/user/in_memory_user_service.h"
+#include "nuansa/utils/container/concurrent_hash_map.h"
+
+using nuansa::models::User;
+using nuansa::services::storage::StorageBackend;
+using nuansa::services::storage::StorageRegistry;
+using nuansa::services::token::InMemoryTokenRepository;
+using nuansa::services::token::TokenService;
+using nuansa::services::user::InMemoryUserService;
+using nuansa::utils::container::ConcurrentHashMap;
+
+namespace {
+    User MakeUser(const std::string &username, const std::string &email) {
+        return User(username, email, "$scrypt$hash", "", "");
+    }
+
+    TokenService::Token MakeToken(const std::string &tokenId, const std::time_t expiry) {
+        TokenService::Token token;
+        token.token_id = tokenId;
+        token.expiry = expiry;
+        token.signature = "signature-" + tokenId;
+        return token;
+    }
+}
+
+TEST(ConcurrentHashMapTest, InsertKeepsTheFirstValue) {
+    ConcurrentHashMap<std::string, int> map(4);
+    EXPECT_TRUE(map.Insert("a", 1));
+    EXPECT_FALSE(map.Insert("a", 2));
+    EXPECT_EQ(map.Find("a"), 1);
+
+    map.InsertOrAssign("a", 3);
+    EXPECT_EQ(map.Find("a"), 3);
+    EXPECT_EQ(map.Erase("a"), 3);
+    EXPECT_FALSE(map.Find("a"));
+}
+
+TEST(ConcurrentHashMapTest, UpdatesAreAtomicAcrossThreads) {
+    ConcurrentHashMap<int, int> map(8);
+    constexpr int KEYS = 16;
+    constexpr int PER_THREAD = 5000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&map] {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                map.Upsert(i % KEYS, [](int &count) { ++count; });
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    int total = 0;
+    map.ForEach([&total](int, const int count) { total += count; });
+    EXPECT_EQ(total, 4 * PER_THREAD);
+    EXPECT_EQ(map.Size(), static_cast<size_t>(KEYS));
+
+    EXPECT_EQ(map.EraseIf([](const int key, int) { return key % 2 == 0; }), static_cast<size_t>(KEYS / 2));
+    EXPECT_EQ(map.Size(), static_cast<size_t>(KEYS / 2));
+}
+
+TEST(InMemoryUserServiceTest, UsernameAndEmailAreUnique) {
+    InMemoryUserService users;
+    EXPECT_TRUE(users.CreateUser(MakeUser("alice", "alice@example.com")));
+    EXPECT_FALSE(users.CreateUser(MakeUser("alice", "other@example.com")));
+    EXPECT_FALSE(users.CreateUser(MakeUser("other", "alice@example.com")));
+
+    EXPECT_TRUE(users.IsUsernameTaken("alice"));
+    EXPECT_TRUE(users.IsEmailTaken("alice@example.com"));
+    EXPECT_FALSE(users.IsEmailTaken("other@example.com"));
+    EXPECT_TRUE(users.UserExists("alice"));
+    EXPECT_TRUE(users.UserExists("alice@example.com"));
+    EXPECT_EQ(users.GetUserByEmail("alice@example.com")->GetUsername(), "alice");
+    EXPECT_EQ(users.Size(), 1u);
+}
+
+TEST(InMemoryUserServiceTest, EmailChangeMovesTheIndex) {
+    InMemoryUserService users;
+    ASSERT_TRUE(users.CreateUser(MakeUser("alice", "alice@example.com")));
+    ASSERT_TRUE(users.CreateUser(MakeUser("bob", "bob@example.com")));
+
+    EXPECT_FALSE(users.UpdateUserEmail("alice", "bob@example.com"));
+    EXPECT_FALSE(users.UpdateUserEmail("alice", "not-an-email"));
+    EXPECT_FALSE(users.UpdateUserEmail("nobody", "nobody@example.com"));
+
+    ASSERT_TRUE(users.UpdateUserEmail("alice", "alice@example.org"));
+    EXPECT_FALSE(users.GetUserByEmail("alice@example.com"));
+    EXPECT_FALSE(users.IsEmailTaken("alice@example.com"));
+    EXPECT_EQ(users.GetUserByEmail("alice@example.org")->GetUsername(), "alice");
+    EXPECT_EQ(users.GetUserByUsername("alice")->GetPasswordHash(), "$scrypt$hash");
+
+    // The old address is free again
+    EXPECT_TRUE(users.CreateUser(MakeUser("carol", "alice@example.com")));
+}
+
+TEST(InMemoryUserServiceTest, DeleteFreesBothIdentifiers) {
+    InMemoryUserService users;
+    ASSERT_TRUE(users.CreateUser(MakeUser("alice", "alice@example.com")));
+
+    EXPECT_TRUE(users.DeleteUser("alice"));
+    EXPECT_FALSE(users.DeleteUser("alice"));
+    EXPECT_FALSE(users.UserExists("alice"));
+    EXPECT_FALSE(users.UserExists("alice@example.com"));
+    EXPECT_TRUE(users.CreateUser(MakeUser("alice", "alice@example.com")));
+}
+
+TEST(InMemoryUserServiceTest, ConcurrentRegistrationsHaveOneWinnerPerIdentity) {
+    InMemoryUserService users;
+    constexpr int IDENTITIES = 200;
+    std::atomic<int> created{0};
+
+    // Every thread races for the same usernames; half of them reuse another identity's email
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&users, &created, t] {
+            for (int i = 0; i < IDENTITIES; ++i) {
+                const auto email = "user" + std::to_string(t % 2 == 0 ? i : (i + 1) % IDENTITIES) + "@example.com";
+                if (users.CreateUser(MakeUser("user" + std::to_string(i), email))) {
+                    created.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(static_cast<size_t>(created.load()), users.Size());
+    std::unordered_set<std::string> emails;
+    for (int i = 0; i < IDENTITIES; ++i) {
+        if (const auto user = users.GetUserByUsername("user" + std::to_string(i))) {
+            EXPECT_TRUE(emails.insert(user->GetEmail()).second) << user->GetEmail() << " used twice";
+            EXPECT_EQ(users.GetUserByEmail(user->GetEmail())->GetUsername(), user->GetUsername());
+        }
+    }
+}
+
+TEST(InMemoryTokenRepositoryTest, TracksRevocationAndExpiry) {
+    InMemoryTokenRepository tokens;
+    const auto now = std::time(nullptr);
+
+    ASSERT_TRUE(tokens.SaveToken(MakeToken("live", now + 3600), "alice", "access"));
+    ASSERT_TRUE(tokens.SaveToken(MakeToken("expired", now - 1), "alice", "access"));
+    EXPECT_FALSE(tokens.SaveToken(MakeToken("live", now + 60), "bob", "access"));
+
+    EXPECT_TRUE(tokens.IsTokenActive("live"));
+    EXPECT_TRUE(tokens.IsTokenValid("live"));
+    EXPECT_EQ(tokens.GetUserIdFromToken("live"), "alice");
+    EXPECT_EQ(tokens.GetTokenExpiry("live"), now + 3600);
+    EXPECT_EQ(tokens.GetToken("live")->signature, "signature-live");
+
+    EXPECT_FALSE(tokens.IsTokenActive("expired"));
+    EXPECT_FALSE(tokens.GetUserIdFromToken("expired"));
+    EXPECT_FALSE(tokens.IsTokenActive("missing"));
+    EXPECT_FALSE(tokens.IsTokenRevoked("missing"));
+
+    EXPECT_TRUE(tokens.RevokeToken("live"));
+    EXPECT_FALSE(tokens.RevokeToken("live"));
+    EXPECT_TRUE(tokens.IsTokenRevoked("live"));
+    EXPECT_FALSE(tokens.IsTokenActive("live"));
+    EXPECT_FALSE(tokens.GetToken("live"));
+}
+
+TEST(InMemoryTokenRepositoryTest, CleanupDropsExpiredTokensAndUserIndex) {
+    InMemoryTokenRepository tokens;
+    const auto now = std::time(nullptr);
+
+    ASSERT_TRUE(tokens.SaveToken(MakeToken("a1", now + 3600), "alice", "access"));
+    ASSERT_TRUE(tokens.SaveToken(MakeToken("a2", now - 10), "alice", "refresh"));
+    ASSERT_TRUE(tokens.SaveToken(MakeToken("b1", now - 10), "bob", "access"));
+
+    ASSERT_EQ(tokens.GetActiveTokensForUser("alice").size(), 1u);
+    EXPECT_TRUE(tokens.CleanupExpiredTokens());
+    EXPECT_EQ(tokens.Size(), 1u);
+    EXPECT_TRUE(tokens.GetActiveTokensForUser("bob").empty());
+
+    EXPECT_TRUE(tokens.RevokeAllTokensForUser("alice"));
+    EXPECT_TRUE(tokens.GetActiveTokensForUser("alice").empty());
+    EXPECT_TRUE(tokens.IsTokenRevoked("a1"));
+}
+
+TEST(StorageRegistryTest, SelectsTheConfiguredBackend) {
+    EXPECT_EQ(nuansa::services::storage::ParseStorageBackend("memory"), StorageBackend::InMemory);
+    EXPECT_EQ(nuansa::services::storage::ParseStorageBackend("postgres"), StorageBackend::Postgres);
+    EXPECT_FALSE(nuansa::services::storage::ParseStorageBackend("sqlite"));
+
+    auto &storage = StorageRegistry::GetInstance();
+    storage.Select(StorageBackend::InMemory);
+    EXPECT_EQ(&storage.Users(), &InMemoryUserService::GetInstance());
+    EXPECT_EQ(&storage.Tokens(), &InMemoryTokenRepository::GetInstance());
+
+    ASSERT_TRUE(storage.Users().CreateUser(MakeUser("registry-user", "registry-user@example.com")));
+    EXPECT_TRUE(InMemoryUserService::GetInstance().IsUsernameTaken("registry-user"));
+    InMemoryUserService::GetInstance().Clear();
+
+    storage.Select(StorageBackend::Postgres);
+    EXPECT_EQ(storage.GetBackend(), StorageBackend::Postgres);
+}
@@ -52,12 +52,12 @@ protected:
             connectionPool.Shutdown();
             connectionPool.Initialize(connectionString, testConfig.pool_size);
 
-            // Initialize UserService
-            auto &userService = nuansa::services::user::UserService::GetInstance();
-            userService.Initialize();
-
             // Clean existing test data
             CleanupTestData();
+
+            // Initialize UserService after cleanup so its caches and filters reflect the empty table
+            auto &userService = nuansa::services::user::UserService::GetInstance();
+            userService.Initialize();
         } catch (const std::exception &e) {
             BOOST_LOG_TRIVIAL(error) << "Test setup failed: " << e.what();
             throw;
@@ -0,0 +1,88 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/utils/cache/counting_bloom_filter.h"
+
+using nuansa::utils::cache::CountingBloomFilter;
+using nuansa::utils::cache::CountingBloomFilterSettings;
+
+TEST(CountingBloomFilterTest, EmptyFilterContainsNothing) {
+    const CountingBloomFilter filter(CountingBloomFilterSettings{.expectedItems = 1000});
+
+    EXPECT_FALSE(filter.MightContain("alice"));
+    EXPECT_FALSE(filter.MightContain(""));
+    EXPECT_EQ(filter.ItemCount(), 0u);
+}
+
+TEST(CountingBloomFilterTest, AddedItemsAreAlwaysReported) {
+    CountingBloomFilter filter(CountingBloomFilterSettings{.expectedItems = 10000});
+    for (int i = 0; i < 10000; ++i) {
+        filter.Add("user" + std::to_string(i));
+    }
+
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_TRUE(filter.MightContain("user" + std::to_string(i))) << i;
+    }
+    EXPECT_EQ(filter.ItemCount(), 10000u);
+}
+
+TEST(CountingBloomFilterTest, FalsePositiveRateNearTarget) {
+    CountingBloomFilter filter(CountingBloomFilterSettings{.expectedItems = 10000, .falsePositiveRate = 0.01});
+    for (int i = 0; i < 10000; ++i) {
+        filter.Add("member" + std::to_string(i));
+    }
+
+    int falsePositives = 0;
+    for (int i = 0; i < 100000; ++i) {
+        falsePositives += filter.MightContain("stranger" + std::to_string(i)) ? 1 : 0;
+    }
+
+    // Allow generous slack over the 1% target to keep the test deterministic across hash implementations
+    EXPECT_LT(falsePositives, 3000);
+}
+
+TEST(CountingBloomFilterTest, RemoveClearsItemWithoutAffectingOthers) {
+    CountingBloomFilter filter(CountingBloomFilterSettings{.expectedItems = 1000});
+    filter.Add("alice@example.com");
+    filter.Add("bob@example.com");
+
+    filter.Remove("alice@example.com");
+
+    EXPECT_FALSE(filter.MightContain("alice@example.com"));
+    EXPECT_TRUE(filter.MightContain("bob@example.com"));
+    EXPECT_EQ(filter.ItemCount(), 1u);
+}
+
+TEST(CountingBloomFilterTest, DuplicateAddsNeedMatchingRemoves) {
+    CountingBloomFilter filter(CountingBloomFilterSettings{.expectedItems = 1000});
+    filter.Add("carol");
+    filter.Add("carol");
+
+    filter.Remove("carol");
+    EXPECT_TRUE(filter.MightContain("carol"));
+
+    filter.Remove("carol");
+    EXPECT_FALSE(filter.MightContain("carol"));
+}
+
+TEST(CountingBloomFilterTest, ConcurrentAddsAreNotLost) {
+    CountingBloomFilter filter(CountingBloomFilterSettings{.expectedItems = 40000});
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&filter, t] {
+            for (int i = 0; i < 10000; ++i) {
+                filter.Add(std::to_string(t) + ":" + std::to_string(i));
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    for (int t = 0; t < 4; ++t) {
+        for (int i = 0; i < 10000; ++i) {
+            ASSERT_TRUE(filter.MightContain(std::to_string(t) + ":" + std::to_string(i)));
+        }
+    }
+}
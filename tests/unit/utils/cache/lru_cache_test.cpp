@@ -0,0 +1,119 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/utils/cache/lru_cache.h"
+
+using nuansa::utils::cache::LruCache;
+using nuansa::utils::cache::LruCacheSettings;
+
+class LruCacheTest : public ::testing::Test {
+protected:
+    static LruCacheSettings SingleShard(const size_t capacity) {
+        return LruCacheSettings{
+            .capacity = capacity,
+            .shardCount = 1,
+            .positiveTtl = std::chrono::minutes(5),
+            .negativeTtl = std::chrono::seconds(5)
+        };
+    }
+};
+
+TEST_F(LruCacheTest, MissOnEmptyCache) {
+    LruCache<std::string, int> cache(SingleShard(4));
+
+    const auto result = cache.Get("missing");
+    EXPECT_FALSE(result.hit);
+    EXPECT_FALSE(result.value.has_value());
+}
+
+TEST_F(LruCacheTest, PositiveEntryIsReturned) {
+    LruCache<std::string, int> cache(SingleShard(4));
+    cache.Put("alice", 42);
+
+    const auto result = cache.Get("alice");
+    EXPECT_TRUE(result.hit);
+    ASSERT_TRUE(result.value.has_value());
+    EXPECT_EQ(*result.value, 42);
+}
+
+TEST_F(LruCacheTest, NegativeEntryIsHitWithoutValue) {
+    LruCache<std::string, int> cache(SingleShard(4));
+    cache.PutNegative("ghost");
+
+    const auto result = cache.Get("ghost");
+    EXPECT_TRUE(result.hit);
+    EXPECT_FALSE(result.value.has_value());
+}
+
+TEST_F(LruCacheTest, PutOverwritesNegativeEntry) {
+    LruCache<std::string, int> cache(SingleShard(4));
+    cache.PutNegative("bob");
+    cache.Put("bob", 7);
+
+    const auto result = cache.Get("bob");
+    ASSERT_TRUE(result.value.has_value());
+    EXPECT_EQ(*result.value, 7);
+    EXPECT_EQ(cache.Size(), 1u);
+}
+
+TEST_F(LruCacheTest, ExpiredEntryIsMiss) {
+    LruCache<std::string, int> cache(SingleShard(4));
+    cache.Put("short", 1, std::chrono::milliseconds(10));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+    EXPECT_FALSE(cache.Get("short").hit);
+    EXPECT_EQ(cache.Size(), 0u);
+}
+
+TEST_F(LruCacheTest, EvictsLeastRecentlyUsed) {
+    LruCache<std::string, int> cache(SingleShard(2));
+    cache.Put("a", 1);
+    cache.Put("b", 2);
+
+    // Touch "a" so that "b" becomes the eviction candidate
+    EXPECT_TRUE(cache.Get("a").hit);
+    cache.Put("c", 3);
+
+    EXPECT_TRUE(cache.Get("a").hit);
+    EXPECT_FALSE(cache.Get("b").hit);
+    EXPECT_TRUE(cache.Get("c").hit);
+    EXPECT_EQ(cache.Size(), 2u);
+}
+
+TEST_F(LruCacheTest, EraseAndClear) {
+    LruCache<std::string, int> cache(SingleShard(8));
+    cache.Put("a", 1);
+    cache.Put("b", 2);
+
+    cache.Erase("a");
+    EXPECT_FALSE(cache.Get("a").hit);
+    EXPECT_TRUE(cache.Get("b").hit);
+
+    cache.Clear();
+    EXPECT_EQ(cache.Size(), 0u);
+}
+
+TEST_F(LruCacheTest, ConcurrentAccessStaysBounded) {
+    LruCache<int, int> cache(LruCacheSettings{.capacity = 256, .shardCount = 8});
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&cache, t] {
+            for (int i = 0; i < 5000; ++i) {
+                const int key = (t * 5000 + i) % 1024;
+                if (i % 3 == 0) {
+                    cache.PutNegative(key);
+                } else {
+                    cache.Put(key, i);
+                }
+                cache.Get(key);
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    EXPECT_LE(cache.Size(), 256u);
+}
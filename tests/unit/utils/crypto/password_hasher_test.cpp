@@ -0,0 +1,126 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/config/config.h"
+#include "nuansa/utils/crypto/crypto_util.h"
+#include "nuansa/utils/crypto/password_hasher.h"
+
+using nuansa::utils::crypto::PasswordHasher;
+
+class PasswordHasherTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        // Keep the calibrated cost minimal so the suite stays fast
+        nuansa::config::Config::GetInstance().SetSecurityConfig(nuansa::config::SecurityConfig{
+            .kdfWorkers = 2,
+            .kdfQueueSize = 16,
+            .kdfTargetMs = 1,
+            .kdfMinLogN = 10,
+            .kdfMaxLogN = 10
+        });
+    }
+
+    static PasswordHasher &Hasher() { return PasswordHasher::GetInstance(); }
+};
+
+TEST_F(PasswordHasherTest, HashUsesVersionedScryptFormat) {
+    const auto hash = Hasher().Hash("Correct-Horse-1");
+
+    EXPECT_TRUE(hash.starts_with("$scrypt$ln=10,r=8,p=1$")) << hash;
+    EXPECT_NE(hash, Hasher().Hash("Correct-Horse-1")); // Fresh salt every time
+}
+
+TEST_F(PasswordHasherTest, VerifiesCurrentFormat) {
+    const auto hash = Hasher().Hash("Correct-Horse-1");
+
+    const auto good = Hasher().Verify("Correct-Horse-1", "", hash);
+    EXPECT_TRUE(good.matches);
+    EXPECT_FALSE(good.needsRehash);
+
+    const auto bad = Hasher().Verify("Wrong-Horse-1", "", hash);
+    EXPECT_FALSE(bad.matches);
+    EXPECT_FALSE(bad.needsRehash);
+}
+
+TEST_F(PasswordHasherTest, WeakerScryptCostNeedsRehash) {
+    // Build a hash the way an earlier, cheaper configuration (ln=4) would have
+    const std::string password = "Correct-Horse-1";
+    const std::string salt = "0123456789abcdef";
+    unsigned char key[32];
+    ASSERT_EQ(EVP_PBE_scrypt(password.data(), password.size(),
+                  reinterpret_cast<const unsigned char *>(salt.data()), salt.size(),
+                  16, 8, 1, 0, key, sizeof(key)), 1);
+
+    const auto encode = [](const unsigned char *data, const size_t length) {
+        std::string encoded(4 * ((length + 2) / 3), '\0');
+        encoded.resize(EVP_EncodeBlock(reinterpret_cast<unsigned char *>(encoded.data()), data,
+                                       static_cast<int>(length)));
+        encoded.erase(encoded.find_last_not_of('=') + 1);
+        return encoded;
+    };
+    const auto weak = "$scrypt$ln=4,r=8,p=1$" +
+                      encode(reinterpret_cast<const unsigned char *>(salt.data()), salt.size()) + "$" +
+                      encode(key, sizeof(key));
+
+    const auto result = Hasher().Verify(password, "", weak);
+    EXPECT_TRUE(result.matches);
+    EXPECT_TRUE(result.needsRehash);
+
+    // A malformed hash never matches
+    EXPECT_FALSE(Hasher().Verify(password, "", "$scrypt$ln=x$abc$def").matches);
+}
+
+TEST_F(PasswordHasherTest, VerifiesLegacySha256AndRequestsRehash) {
+    const std::string salt = "legacysalt";
+    const auto legacy = nuansa::utils::crypto::CryptoUtil::HashPassword("Correct-Horse-1", salt);
+
+    const auto result = Hasher().Verify("Correct-Horse-1", salt, legacy);
+    EXPECT_TRUE(result.matches);
+    EXPECT_TRUE(result.needsRehash);
+
+    EXPECT_FALSE(Hasher().Verify("Wrong-Horse-1", salt, legacy).matches);
+}
+
+TEST_F(PasswordHasherTest, VerifiesLegacyPbkdf2AndRequestsRehash) {
+    const std::vector<unsigned char> salt = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+    std::vector<unsigned char> key(32);
+    const std::string password = "Correct-Horse-1";
+    ASSERT_EQ(PKCS5_PBKDF2_HMAC(password.c_str(), static_cast<int>(password.size()), salt.data(),
+                  static_cast<int>(salt.size()), 1000, EVP_sha256(), static_cast<int>(key.size()), key.data()), 1);
+
+    std::ostringstream legacy;
+    legacy << "1000$" << std::hex << std::setfill('0');
+    for (const auto byte: salt) legacy << std::setw(2) << static_cast<int>(byte);
+    legacy << "$";
+    for (const auto byte: key) legacy << std::setw(2) << static_cast<int>(byte);
+
+    const auto result = Hasher().Verify(password, "", legacy.str());
+    EXPECT_TRUE(result.matches);
+    EXPECT_TRUE(result.needsRehash);
+
+    EXPECT_FALSE(Hasher().Verify("Wrong-Horse-1", "", legacy.str()).matches);
+}
+
+TEST_F(PasswordHasherTest, EmptyStoredHashNeverMatches) {
+    EXPECT_FALSE(Hasher().Verify("", "", "").matches);
+    EXPECT_FALSE(Hasher().Verify("anything", "", "").matches);
+}
+
+TEST_F(PasswordHasherTest, AsyncVerifyCompletesOnExecutor) {
+    const auto hash = Hasher().Hash("Correct-Horse-1");
+
+    boost::asio::io_context ioc;
+    std::optional<bool> matches;
+    Hasher().AsyncVerify("Correct-Horse-1", "", hash, ioc.get_executor(),
+                         [&](const std::exception_ptr &error, const nuansa::utils::crypto::PasswordVerification &result) {
+                             EXPECT_FALSE(error);
+                             matches = result.matches;
+                         });
+
+    // The completion is posted to ioc, so run until it arrives
+    while (!matches) {
+        ioc.run_for(std::chrono::milliseconds(10));
+        ioc.restart();
+    }
+    EXPECT_TRUE(*matches);
+}
@@ -0,0 +1,119 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/utils/http_client.h"
+#include "utils/local_http_server.h"
+
+using nuansa::utils::HttpClient;
+using nuansa::utils::HttpClientSettings;
+
+namespace {
+    using nuansa::tests::utils::LocalHttpServer;
+
+    class LocalServer : public LocalHttpServer {
+    public:
+        LocalServer()
+            : LocalHttpServer([](const Request &request, Response &response) {
+                if (request.target() == "/hello") {
+                    response.body() = "hello";
+                } else if (request.target() == "/echo") {
+                    response.body() = request.body();
+                } else if (request.target() == "/slow") {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+                    response.body() = "slow";
+                } else {
+                    response.result(boost::beast::http::status::not_found);
+                }
+            }) {
+        }
+    };
+}
+
+TEST(HttpClientTest, GetReturnsBody) {
+    LocalServer server;
+    HttpClient client;
+
+    const auto response = client.Get(server.Url("/hello"));
+    EXPECT_TRUE(response.success) << response.error;
+    EXPECT_EQ(response.statusCode, 200);
+    EXPECT_EQ(response.body, "hello");
+    EXPECT_FALSE(response.headers.empty());
+}
+
+TEST(HttpClientTest, PostSendsBody) {
+    LocalServer server;
+    HttpClient client;
+
+    const auto response = client.Post(server.Url("/echo"), "{\"a\":1}", {"Content-Type: application/json"});
+    EXPECT_TRUE(response.success) << response.error;
+    EXPECT_EQ(response.body, "{\"a\":1}");
+}
+
+TEST(HttpClientTest, NonSuccessStatusIsReported) {
+    LocalServer server;
+    HttpClient client;
+
+    const auto response = client.Get(server.Url("/missing"));
+    EXPECT_FALSE(response.success);
+    EXPECT_EQ(response.statusCode, 404);
+}
+
+TEST(HttpClientTest, PerRequestTimeoutFailsFast) {
+    LocalServer server;
+    HttpClient client;
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto response = client.Get(server.Url("/slow"), {}, std::chrono::milliseconds(50));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_FALSE(response.success);
+    EXPECT_EQ(response.statusCode, 0);
+    EXPECT_FALSE(response.error.empty());
+    EXPECT_TRUE(response.timedOut);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(250));
+}
+
+TEST(HttpClientTest, RequestsRunConcurrentlyOnOneThread) {
+    LocalServer server;
+    HttpClient client;
+
+    // Sequentially these would take 16 * 300ms
+    constexpr int requests = 16;
+    std::vector<std::future<HttpClient::Response> > futures;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < requests; ++i) {
+        futures.push_back(client.Perform(HttpClient::Request{.url = server.Url("/slow")}));
+    }
+    for (auto &future: futures) {
+        const auto response = future.get();
+        EXPECT_TRUE(response.success) << response.error;
+        EXPECT_EQ(response.body, "slow");
+    }
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(300 * requests / 2));
+}
+
+TEST(HttpClientTest, ReusesKeepAliveConnections) {
+    LocalServer server;
+    HttpClient client;
+
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(client.Get(server.Url("/hello")).success);
+    }
+    EXPECT_EQ(server.Connections(), 1);
+}
+
+TEST(HttpClientTest, AsyncCallbackAndShutdownWithTransferInFlight) {
+    LocalServer server;
+    std::promise<HttpClient::Response> done;
+    {
+        HttpClient client(HttpClientSettings{.maxConnectionsPerHost = 4});
+        client.AsyncGet(server.Url("/slow"), {}, std::nullopt, [&done](HttpClient::Response response) {
+            done.set_value(std::move(response));
+        });
+        // Destroying the client aborts the transfer and still completes the callback
+    }
+
+    const auto response = done.get_future().get();
+    EXPECT_FALSE(response.success);
+}
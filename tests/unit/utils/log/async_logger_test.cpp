@@ -0,0 +1,111 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/utils/log/async_logger.h"
+
+using nuansa::utils::log::AsyncLogger;
+using nuansa::utils::log::Level;
+using nuansa::utils::log::LogRecord;
+using nuansa::utils::log::LogSink;
+
+namespace {
+    class CaptureSink final : public LogSink {
+    public:
+        void Write(const LogRecord &record) override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            lines_.emplace_back(record.Text());
+        }
+
+        std::vector<std::string> Lines() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return lines_;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::vector<std::string> lines_;
+    };
+
+    int evaluated = 0;
+
+    int CountEvaluation() {
+        return ++evaluated;
+    }
+}
+
+class AsyncLoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sink_ = std::make_shared<CaptureSink>();
+        AsyncLogger::GetInstance().SetSinks({sink_});
+        AsyncLogger::SetLevel(Level::Info);
+    }
+
+    void TearDown() override {
+        AsyncLogger::GetInstance().Flush();
+        AsyncLogger::GetInstance().SetSinks({std::make_shared<nuansa::utils::log::ConsoleLogSink>()});
+    }
+
+    std::shared_ptr<CaptureSink> sink_;
+};
+
+TEST_F(AsyncLoggerTest, FormatsArgumentsIntoRecord) {
+    LOG_INFO << "pool size " << 8 << ", ratio " << 0.5 << ", name " << std::string("main");
+    AsyncLogger::GetInstance().Flush();
+
+    const auto lines = sink_->Lines();
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0], "pool size 8, ratio 0.5, name main");
+}
+
+TEST_F(AsyncLoggerTest, DisabledLevelSkipsArgumentEvaluation) {
+    evaluated = 0;
+    LOG_DEBUG << "never " << CountEvaluation();
+    LOG_INFO << "always " << CountEvaluation();
+    AsyncLogger::GetInstance().Flush();
+
+    EXPECT_EQ(evaluated, 1);
+    const auto lines = sink_->Lines();
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0], "always 1");
+}
+
+TEST_F(AsyncLoggerTest, LongMessagesAreTruncated) {
+    const auto before = AsyncLogger::GetInstance().GetStats().truncated;
+    LOG_WARNING << std::string(LogRecord::MAX_TEXT * 2, 'x');
+    AsyncLogger::GetInstance().Flush();
+
+    const auto lines = sink_->Lines();
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0].size(), LogRecord::MAX_TEXT);
+    EXPECT_EQ(AsyncLogger::GetInstance().GetStats().truncated, before + 1);
+}
+
+TEST_F(AsyncLoggerTest, RecordsFromManyThreadsAllArriveOrAreCounted) {
+    constexpr int threads = 4;
+    constexpr int perThread = 500;
+    const auto before = AsyncLogger::GetInstance().GetStats();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([t] {
+            for (int i = 0; i < perThread; ++i) {
+                LOG_INFO << "thread " << t << " record " << i;
+            }
+        });
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+    AsyncLogger::GetInstance().Flush();
+
+    const auto after = AsyncLogger::GetInstance().GetStats();
+    const auto dropped = after.dropped - before.dropped;
+    size_t records = 0;
+    for (const auto &line: sink_->Lines()) {
+        if (line.starts_with("thread ")) {
+            ++records;
+        }
+    }
+    EXPECT_EQ(records + dropped, static_cast<size_t>(threads * perThread));
+}
@@ -0,0 +1,151 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/utils/log/rotating_file_sink.h"
+
+using nuansa::utils::log::Level;
+using nuansa::utils::log::LogFormat;
+using nuansa::utils::log::LogRecord;
+using nuansa::utils::log::RotatingFileSink;
+using nuansa::utils::log::RotatingFileSinkSettings;
+
+namespace {
+    LogRecord MakeRecord(const std::string_view text) {
+        LogRecord record;
+        record.time = std::chrono::system_clock::now();
+        record.file = "handler.cpp";
+        record.function = "HandleSession";
+        record.line = 42;
+        record.level = Level::Info;
+        record.length = static_cast<uint16_t>(text.size());
+        std::memcpy(record.text, text.data(), text.size());
+        return record;
+    }
+
+    std::string ReadFile(const std::filesystem::path &path) {
+        std::ifstream file(path);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+}
+
+class RotatingFileSinkTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory_ = std::filesystem::temp_directory_path() /
+                     ("rotating_file_sink_test_" + std::to_string(::getpid()) + "_" +
+                      ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove_all(directory_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory_);
+    }
+
+    std::vector<std::string> RotatedFiles() const {
+        std::vector<std::string> names;
+        for (const auto &entry: std::filesystem::directory_iterator(directory_)) {
+            if (const auto name = entry.path().filename().string(); name != "server.log") {
+                names.push_back(name);
+            }
+        }
+        std::ranges::sort(names);
+        return names;
+    }
+
+    std::filesystem::path directory_;
+};
+
+TEST_F(RotatingFileSinkTest, BuffersUntilFlush) {
+    RotatingFileSink sink(RotatingFileSinkSettings{.path = directory_ / "server.log", .compressRotated = false});
+
+    sink.Write(MakeRecord("first"));
+    EXPECT_TRUE(ReadFile(directory_ / "server.log").empty());
+
+    sink.Flush();
+    const auto contents = ReadFile(directory_ / "server.log");
+    EXPECT_NE(contents.find("[info] [handler.cpp:42 HandleSession] first\n"), std::string::npos);
+}
+
+TEST_F(RotatingFileSinkTest, WritesJsonLines) {
+    RotatingFileSink sink(RotatingFileSinkSettings{
+        .path = directory_ / "server.log", .format = LogFormat::Json, .compressRotated = false
+    });
+
+    sink.Write(MakeRecord("say \"hi\"\n"));
+    sink.Flush();
+
+    const auto contents = ReadFile(directory_ / "server.log");
+    ASSERT_FALSE(contents.empty());
+    EXPECT_EQ(contents.back(), '\n');
+    const auto json = nlohmann::json::parse(contents);
+    EXPECT_EQ(json["level"], "info");
+    EXPECT_EQ(json["line"], 42);
+    EXPECT_EQ(json["func"], "HandleSession");
+    EXPECT_EQ(json["msg"], "say \"hi\"\n");
+}
+
+TEST_F(RotatingFileSinkTest, RotatesBySizeAndKeepsNewestSegments) {
+    RotatingFileSink sink(RotatingFileSinkSettings{
+        .path = directory_ / "server.log",
+        .maxFileBytes = 200,
+        .maxRotatedFiles = 2,
+        .compressRotated = false
+    });
+
+    for (int i = 0; i < 20; ++i) {
+        sink.Write(MakeRecord("record " + std::to_string(i)));
+    }
+    sink.Flush();
+
+    EXPECT_GE(sink.GetRotationCount(), 3u);
+    EXPECT_EQ(RotatedFiles().size(), 2u);
+    EXPECT_LT(std::filesystem::file_size(directory_ / "server.log"), 200u);
+    // The current file continues where the newest segment stopped
+    EXPECT_NE(ReadFile(directory_ / RotatedFiles().back()).find("record"), std::string::npos);
+}
+
+TEST_F(RotatingFileSinkTest, CompressesRotatedSegments) {
+    RotatingFileSink sink(RotatingFileSinkSettings{
+        .path = directory_ / "server.log",
+        .maxFileBytes = 200,
+        .maxRotatedFiles = 10,
+        .compressRotated = true
+    });
+
+    for (int i = 0; i < 5; ++i) {
+        sink.Write(MakeRecord("record " + std::to_string(i)));
+    }
+    sink.WaitForCompression();
+
+    const auto rotated = RotatedFiles();
+    ASSERT_FALSE(rotated.empty());
+    for (const auto &name: rotated) {
+        EXPECT_TRUE(name.ends_with(".gz")) << name;
+    }
+}
+
+TEST_F(RotatingFileSinkTest, DropsRecordsWhileTheFileCannotBeReopened) {
+    RotatingFileSink sink(RotatingFileSinkSettings{
+        .path = directory_ / "server.log",
+        .maxFileBytes = 200,
+        .compressRotated = false,
+        .reopenBackoff = std::chrono::milliseconds(50)
+    });
+
+    // With the directory gone the rotation can neither rename nor reopen the file
+    std::filesystem::remove_all(directory_);
+    for (int i = 0; i < 20; ++i) {
+        sink.Write(MakeRecord("record " + std::to_string(i)));
+    }
+    sink.Flush();
+    EXPECT_EQ(sink.GetRotationCount(), 1u);
+    const auto dropped = sink.GetDroppedCount();
+    EXPECT_GT(dropped, 10u);
+
+    std::filesystem::create_directories(directory_);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    sink.Write(MakeRecord("after"));
+    sink.Flush();
+    EXPECT_EQ(sink.GetDroppedCount(), dropped);
+    EXPECT_NE(ReadFile(directory_ / "server.log").find("after"), std::string::npos);
+}
@@ -0,0 +1,137 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/utils/metrics/metrics.h"
+#include "nuansa/utils/metrics/metrics_server.h"
+
+using nuansa::utils::metrics::Histogram;
+using nuansa::utils::metrics::MetricsRegistry;
+using nuansa::utils::metrics::MetricsServer;
+using nuansa::utils::metrics::MetricsServerSettings;
+using nuansa::utils::metrics::MetricType;
+
+TEST(HistogramTest, BucketsAreContiguousAndBounded) {
+    for (uint64_t value = 0; value < 100000; ++value) {
+        const auto index = Histogram::BucketIndex(value);
+        ASSERT_LT(value, Histogram::BucketUpperBound(index)) << value;
+        if (index > 0) {
+            ASSERT_GE(value, Histogram::BucketUpperBound(index - 1)) << value;
+        }
+    }
+    EXPECT_EQ(Histogram::BucketIndex(std::numeric_limits<uint64_t>::max()), Histogram::BUCKETS - 1);
+}
+
+TEST(HistogramTest, PercentilesStayWithinBucketError) {
+    Histogram histogram;
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram.Record(value);
+    }
+
+    EXPECT_EQ(histogram.Count(), 1000u);
+    EXPECT_EQ(histogram.Sum(), 500500u);
+    const auto p50 = histogram.Percentile(0.5);
+    const auto p99 = histogram.Percentile(0.99);
+    EXPECT_GE(p50, 500u);
+    EXPECT_LE(p50, 500u * 9 / 8 + 1);
+    EXPECT_GE(p99, 990u);
+    EXPECT_LE(p99, 990u * 9 / 8 + 1);
+}
+
+TEST(MetricsRegistryTest, CountersSumAcrossThreads) {
+    MetricsRegistry registry;
+    auto &counter = registry.GetCounter("test_events_total", "Events");
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < 10000; ++i) {
+                counter.Increment();
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter.Value(), 80000u);
+    EXPECT_EQ(&registry.GetCounter("test_events_total", "Events"), &counter);
+}
+
+TEST(MetricsRegistryTest, RejectsTypeMismatch) {
+    MetricsRegistry registry;
+    registry.GetCounter("test_value", "Value");
+    EXPECT_THROW(registry.GetGauge("test_value", "Value"), std::invalid_argument);
+}
+
+TEST(MetricsRegistryTest, RendersPrometheusText) {
+    MetricsRegistry registry;
+    registry.GetCounter("test_requests_total", "Requests", {{"type", "chat"}}).Increment(3);
+    registry.GetGauge("test_sessions", "Sessions").Set(7);
+    registry.RegisterCallback("test_limit", "Limit", MetricType::Gauge, {}, [] { return 12.5; });
+    auto &latency = registry.GetHistogram("test_latency_seconds", "Latency", {}, 1e-6);
+    latency.Record(3);
+    latency.Record(1000);
+
+    const auto text = registry.RenderPrometheus();
+    EXPECT_NE(text.find("# TYPE test_requests_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("test_requests_total{type=\"chat\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("test_sessions 7\n"), std::string::npos);
+    EXPECT_NE(text.find("test_limit 12.5\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_latency_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{le=\"3e-06\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{le=\"+Inf\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_count 2\n"), std::string::npos);
+}
+
+TEST(MetricsRegistryTest, HistogramBucketsAreInclusiveAndFixed) {
+    MetricsRegistry registry;
+    auto &sizes = registry.GetHistogram("test_size_bytes", "Size");
+    const auto empty = registry.RenderPrometheus();
+    EXPECT_NE(empty.find("test_size_bytes_bucket{le=\"0\"} 0\n"), std::string::npos);
+    EXPECT_NE(empty.find("test_size_bytes_bucket{le=\"1099511627775\"} 0\n"), std::string::npos);
+
+    // 1023 is the last value of the le="1023" bucket, 1024 the first one past it
+    sizes.Record(1023);
+    sizes.Record(1024);
+    const auto text = registry.RenderPrometheus();
+    EXPECT_NE(text.find("test_size_bytes_bucket{le=\"511\"} 0\n"), std::string::npos);
+    EXPECT_NE(text.find("test_size_bytes_bucket{le=\"1023\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_size_bytes_bucket{le=\"2047\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("test_size_bytes_bucket{le=\"+Inf\"} 2\n"), std::string::npos);
+
+    const auto lines = [](const std::string &rendered) {
+        return std::count(rendered.begin(), rendered.end(), '\n');
+    };
+    EXPECT_EQ(lines(text), lines(empty));
+}
+
+TEST(MetricsServerTest, ServesMetricsOverHttp) {
+    MetricsRegistry registry;
+    registry.GetCounter("test_scrapes_total", "Scrapes").Increment();
+
+    MetricsServer server(registry, MetricsServerSettings{.host = "127.0.0.1", .port = 0});
+    server.Start();
+
+    const auto get = [&server](const std::string &target) {
+        boost::asio::io_context ioc;
+        boost::beast::tcp_stream stream(ioc);
+        stream.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"),
+                                                      server.GetPort()));
+        boost::beast::http::request<boost::beast::http::empty_body> request{
+            boost::beast::http::verb::get, target, 11
+        };
+        boost::beast::http::write(stream, request);
+
+        boost::beast::flat_buffer buffer;
+        boost::beast::http::response<boost::beast::http::string_body> response;
+        boost::beast::http::read(stream, buffer, response);
+        return response;
+    };
+
+    const auto metrics = get("/metrics");
+    EXPECT_EQ(metrics.result(), boost::beast::http::status::ok);
+    EXPECT_NE(metrics.body().find("test_scrapes_total 1\n"), std::string::npos);
+
+    EXPECT_EQ(get("/other").result(), boost::beast::http::status::not_found);
+    server.Stop();
+}
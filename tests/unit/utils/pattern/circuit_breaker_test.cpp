@@ -0,0 +1,228 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/utils/pattern/circuit_breaker.h"
+
+using nuansa::utils::pattern::CircuitBreaker;
+using nuansa::utils::pattern::CircuitBreakerRegistry;
+using nuansa::utils::pattern::CircuitBreakerSettings;
+using nuansa::utils::exception::CircuitBreakerOpenException;
+using nuansa::utils::exception::CircuitBreakerTimeoutException;
+namespace breakers = nuansa::utils::pattern::breakers;
+
+namespace {
+    CircuitBreakerSettings TestSettings() {
+        return CircuitBreakerSettings{
+            .failureThreshold = 3,
+            .successThreshold = 2,
+            .resetTimeout = std::chrono::milliseconds(50),
+            .failureRateThreshold = 0.5,
+            .window = std::chrono::seconds(10),
+            .bucketCount = 10
+        };
+    }
+
+    void Fail(CircuitBreaker &breaker, const int times) {
+        for (int i = 0; i < times; ++i) breaker.RecordFailure();
+    }
+
+    void Succeed(CircuitBreaker &breaker, const int times) {
+        for (int i = 0; i < times; ++i) breaker.RecordSuccess();
+    }
+}
+
+TEST(CircuitBreakerTest, OpensWhenFailureRateCrossesThreshold) {
+    CircuitBreaker breaker(TestSettings(), "test");
+
+    // 3 of 13 calls failing is below the 50% rate
+    Succeed(breaker, 10);
+    Fail(breaker, 3);
+    EXPECT_EQ(breaker.GetState(), CircuitBreaker::State::CLOSED);
+
+    // 10 of 20 reaches it
+    Fail(breaker, 7);
+    EXPECT_EQ(breaker.GetState(), CircuitBreaker::State::OPEN);
+    EXPECT_FALSE(breaker.AllowRequest());
+}
+
+TEST(CircuitBreakerTest, NeedsMinimumFailuresBeforeOpening) {
+    CircuitBreaker breaker(TestSettings(), "test");
+
+    // A 100% failure rate over two calls is not enough evidence
+    Fail(breaker, 2);
+    EXPECT_EQ(breaker.GetState(), CircuitBreaker::State::CLOSED);
+
+    Fail(breaker, 1);
+    EXPECT_EQ(breaker.GetState(), CircuitBreaker::State::OPEN);
+}
+
+TEST(CircuitBreakerTest, OldFailuresSlideOutOfTheWindow) {
+    auto settings = TestSettings();
+    settings.window = std::chrono::milliseconds(200);
+    settings.bucketCount = 4;
+    CircuitBreaker breaker(settings, "test");
+
+    Fail(breaker, 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    Fail(breaker, 2);
+    EXPECT_EQ(breaker.GetState(), CircuitBreaker::State::CLOSED);
+    EXPECT_EQ(breaker.GetMetrics().windowFailures, 2u);
+    EXPECT_EQ(breaker.GetMetrics().failedCalls, 4u);
+}
+
+TEST(CircuitBreakerTest, HalfOpenProbesCloseTheCircuit) {
+    CircuitBreaker breaker(TestSettings(), "test");
+    Fail(breaker, 3);
+    ASSERT_EQ(breaker.GetState(), CircuitBreaker::State::OPEN);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+
+    // successThreshold probes are admitted, the rest still fail fast
+    EXPECT_TRUE(breaker.AllowRequest());
+    EXPECT_EQ(breaker.GetState(), CircuitBreaker::State::HALF_OPEN);
+    EXPECT_TRUE(breaker.AllowRequest());
+    EXPECT_FALSE(breaker.AllowRequest());
+
+    Succeed(breaker, 2);
+    EXPECT_EQ(breaker.GetState(), CircuitBreaker::State::CLOSED);
+
+    // The failures from before the outage no longer count
+    Fail(breaker, 1);
+    EXPECT_EQ(breaker.GetState(), CircuitBreaker::State::CLOSED);
+}
+
+TEST(CircuitBreakerTest, HalfOpenFailureReopens) {
+    CircuitBreaker breaker(TestSettings(), "test");
+    Fail(breaker, 3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+
+    ASSERT_TRUE(breaker.AllowRequest());
+    breaker.RecordFailure();
+    EXPECT_EQ(breaker.GetState(), CircuitBreaker::State::OPEN);
+    EXPECT_FALSE(breaker.AllowRequest());
+}
+
+TEST(CircuitBreakerTest, ExecuteFailsFastWhileOpen) {
+    CircuitBreaker breaker(TestSettings(), "test");
+
+    EXPECT_EQ(breaker.Execute([] { return 7; }), 7);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_ANY_THROW(breaker.Execute([]() -> int { throw std::runtime_error("db down"); }));
+    }
+
+    int calls = 0;
+    EXPECT_THROW(breaker.Execute([&] { ++calls; }), CircuitBreakerOpenException);
+    EXPECT_EQ(calls, 0);
+
+    const auto metrics = breaker.GetMetrics();
+    EXPECT_EQ(metrics.totalCalls, 4u);
+    EXPECT_EQ(metrics.successfulCalls, 1u);
+    EXPECT_EQ(metrics.failedCalls, 3u);
+    EXPECT_EQ(metrics.rejectedCalls, 1u);
+    EXPECT_EQ(metrics.state, CircuitBreaker::State::OPEN);
+}
+
+TEST(CircuitBreakerTest, ConcurrentOutcomesAreAllCounted) {
+    auto settings = TestSettings();
+    settings.failureThreshold = 1000000;
+    CircuitBreaker breaker(settings, "test");
+
+    constexpr int threads = 8;
+    constexpr int perThread = 10000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&breaker, t] {
+            for (int i = 0; i < perThread; ++i) {
+                (t % 2 == 0) ? breaker.RecordSuccess() : breaker.RecordFailure();
+            }
+        });
+    }
+    for (auto &worker: workers) worker.join();
+
+    const auto metrics = breaker.GetMetrics();
+    EXPECT_EQ(metrics.windowSuccesses, threads / 2 * perThread);
+    EXPECT_EQ(metrics.windowFailures, threads / 2 * perThread);
+    EXPECT_EQ(metrics.totalCalls, threads * perThread);
+}
+
+TEST(CircuitBreakerRegistryTest, NamedInstancesAreIndependentAndConfigurable) {
+    auto &registry = CircuitBreakerRegistry::GetInstance();
+    auto githubSettings = TestSettings();
+    githubSettings.failureThreshold = 1;
+    registry.Configure(TestSettings(), {{breakers::GITHUB, githubSettings}});
+
+    auto &github = registry.Get(breakers::GITHUB);
+    auto &google = registry.Get(breakers::GOOGLE);
+    EXPECT_EQ(&github, &registry.Get(breakers::GITHUB));
+    EXPECT_EQ(&CircuitBreaker::GetInstance(), &registry.Get(breakers::PRIMARY_DB));
+    EXPECT_EQ(github.GetSettings().failureThreshold, 1u);
+    EXPECT_EQ(google.GetSettings().failureThreshold, 3u);
+
+    github.RecordFailure();
+    EXPECT_TRUE(github.IsOpen());
+    EXPECT_FALSE(google.IsOpen());
+
+    const auto metrics = registry.GetMetrics();
+    EXPECT_TRUE(std::ranges::any_of(metrics, [](const auto &entry) {
+        return entry.first == breakers::GITHUB && entry.second.state == CircuitBreaker::State::OPEN;
+    }));
+}
+
+TEST(CircuitBreakerRegistryTest, ConfigureLeavesBreakersInUseAlone) {
+    auto &registry = CircuitBreakerRegistry::GetInstance();
+    registry.Configure(TestSettings());
+    auto &breaker = registry.Get("in_use");
+    breaker.RecordFailure();
+
+    auto looser = TestSettings();
+    looser.failureThreshold = 100;
+    looser.bucketCount = 3;
+    registry.Configure(looser);
+
+    EXPECT_EQ(breaker.GetSettings().failureThreshold, 3u);
+    EXPECT_EQ(breaker.GetSettings().bucketCount, TestSettings().bucketCount);
+    EXPECT_EQ(breaker.GetMetrics().windowFailures, 1u);
+    EXPECT_EQ(registry.Get("created_later").GetSettings().failureThreshold, 100u);
+}
+
+TEST(CircuitBreakerTest, ExecuteWithTimeoutRunsOnCallerThreadWithDeadline) {
+    auto settings = TestSettings();
+    settings.timeout = std::chrono::seconds(1);
+    CircuitBreaker breaker(settings, "test");
+
+    const auto caller = std::this_thread::get_id();
+    const auto result = breaker.ExecuteWithTimeout([&](const auto deadline) {
+        EXPECT_EQ(std::this_thread::get_id(), caller);
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        EXPECT_GT(remaining, std::chrono::milliseconds(900));
+        EXPECT_LE(remaining, std::chrono::seconds(1));
+        return 42;
+    });
+
+    EXPECT_EQ(result, 42);
+    EXPECT_EQ(breaker.GetMetrics().successfulCalls, 1u);
+    EXPECT_EQ(breaker.GetMetrics().timeouts, 0u);
+}
+
+TEST(CircuitBreakerTest, ExecuteWithTimeoutCountsTimeouts) {
+    auto settings = TestSettings();
+    settings.timeout = std::chrono::seconds(0);
+    CircuitBreaker breaker(settings, "test");
+
+    // The callee gave up at the deadline
+    EXPECT_THROW(breaker.ExecuteWithTimeout([](auto) -> int {
+                     throw CircuitBreakerTimeoutException("query cancelled");
+                 }), CircuitBreakerTimeoutException);
+
+    // The callee finished, but only after the deadline
+    EXPECT_EQ(breaker.ExecuteWithTimeout([](auto) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        return 1;
+    }), 1);
+
+    const auto metrics = breaker.GetMetrics();
+    EXPECT_EQ(metrics.timeouts, 2u);
+    EXPECT_EQ(metrics.failedCalls, 2u);
+    EXPECT_EQ(metrics.successfulCalls, 0u);
+}
@@ -0,0 +1,134 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/utils/pattern/concurrency_limiter.h"
+
+using nuansa::utils::pattern::ConcurrencyLimiter;
+using nuansa::utils::pattern::ConcurrencyLimiterSettings;
+using std::chrono::milliseconds;
+
+namespace {
+    ConcurrencyLimiterSettings TestSettings(const size_t initialLimit = 20) {
+        return ConcurrencyLimiterSettings{
+            .initialLimit = initialLimit,
+            .minLimit = 2,
+            .maxLimit = 100
+        };
+    }
+
+    // Reports samples as if the limiter were fully used
+    void Feed(ConcurrencyLimiter &limiter, const milliseconds latency, const int samples) {
+        for (int i = 0; i < samples; ++i) {
+            limiter.OnSample(latency, limiter.Limit(), false);
+        }
+    }
+}
+
+TEST(ConcurrencyLimiterTest, ShedsBeyondTheLimit) {
+    ConcurrencyLimiter limiter(TestSettings(3));
+
+    std::vector<ConcurrencyLimiter::Permit> permits;
+    for (int i = 0; i < 3; ++i) {
+        auto permit = limiter.TryAcquire();
+        ASSERT_TRUE(permit.has_value());
+        permits.push_back(std::move(*permit));
+    }
+    EXPECT_EQ(limiter.InFlight(), 3u);
+    EXPECT_FALSE(limiter.TryAcquire().has_value());
+    EXPECT_EQ(limiter.Rejected(), 1u);
+
+    // Releasing without a sample frees the slot and leaves the limit alone
+    permits.pop_back();
+    EXPECT_EQ(limiter.InFlight(), 2u);
+    EXPECT_TRUE(limiter.TryAcquire().has_value());
+    EXPECT_EQ(limiter.Limit(), 3u);
+}
+
+TEST(ConcurrencyLimiterTest, GrowsWhileLatencyIsStable) {
+    ConcurrencyLimiter limiter(TestSettings());
+
+    Feed(limiter, milliseconds(10), 50);
+    EXPECT_GT(limiter.Limit(), 20u);
+
+    Feed(limiter, milliseconds(10), 1000);
+    EXPECT_EQ(limiter.Limit(), 100u);
+}
+
+TEST(ConcurrencyLimiterTest, DoesNotGrowWhenUnderused) {
+    ConcurrencyLimiter limiter(TestSettings());
+
+    for (int i = 0; i < 100; ++i) {
+        limiter.OnSample(milliseconds(10), 1, false);
+    }
+    EXPECT_EQ(limiter.Limit(), 20u);
+}
+
+TEST(ConcurrencyLimiterTest, ShrinksWhenLatencyRises) {
+    ConcurrencyLimiter limiter(TestSettings());
+    Feed(limiter, milliseconds(10), 200);
+    const auto healthy = limiter.Limit();
+
+    // The database slows down tenfold
+    Feed(limiter, milliseconds(100), 20);
+    EXPECT_LT(limiter.Limit(), healthy / 2);
+    EXPECT_GE(limiter.Limit(), 2u);
+}
+
+TEST(ConcurrencyLimiterTest, DroppedRequestsBackOffMultiplicatively) {
+    ConcurrencyLimiter limiter(TestSettings(50));
+
+    limiter.OnSample(milliseconds(10), 50, true);
+    EXPECT_EQ(limiter.Limit(), 45u);
+
+    for (int i = 0; i < 100; ++i) {
+        limiter.OnSample(milliseconds(10), 50, true);
+    }
+    EXPECT_EQ(limiter.Limit(), 2u);
+}
+
+TEST(ConcurrencyLimiterTest, RetryAfterFollowsObservedLatency) {
+    ConcurrencyLimiter limiter(TestSettings());
+    EXPECT_EQ(limiter.RetryAfter(), milliseconds(50));
+
+    Feed(limiter, milliseconds(400), 10);
+    EXPECT_EQ(limiter.RetryAfter(), milliseconds(400));
+}
+
+TEST(ConcurrencyLimiterTest, PermitsReportLatency) {
+    ConcurrencyLimiter limiter(TestSettings(1));
+
+    auto permit = limiter.TryAcquire();
+    ASSERT_TRUE(permit.has_value());
+    std::this_thread::sleep_for(milliseconds(60));
+    permit->Success();
+
+    EXPECT_EQ(limiter.InFlight(), 0u);
+    EXPECT_GE(limiter.RetryAfter(), milliseconds(60));
+}
+
+TEST(ConcurrencyLimiterTest, NeverExceedsLimitUnderContention) {
+    ConcurrencyLimiter limiter(TestSettings(8));
+    std::atomic<size_t> current{0};
+    std::atomic<size_t> peak{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 16; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 2000; ++i) {
+                if (auto permit = limiter.TryAcquire()) {
+                    const auto now = ++current;
+                    size_t seen = peak.load();
+                    while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+                    }
+                    --current;
+                }
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    EXPECT_LE(peak.load(), 8u);
+    EXPECT_EQ(limiter.InFlight(), 0u);
+}
@@ -0,0 +1,80 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/utils/pattern/deadline_watchdog.h"
+
+using nuansa::utils::pattern::DeadlineWatchdog;
+using Clock = DeadlineWatchdog::Clock;
+
+TEST(DeadlineWatchdogTest, FiresWhenDeadlinePasses) {
+    DeadlineWatchdog watchdog;
+    std::promise<std::thread::id> fired;
+
+    const auto armed = watchdog.Arm(Clock::now() + std::chrono::milliseconds(20), [&] {
+        fired.set_value(std::this_thread::get_id());
+    });
+
+    auto future = fired.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_NE(future.get(), std::this_thread::get_id());
+    EXPECT_TRUE(armed.Expired());
+    EXPECT_EQ(watchdog.Pending(), 0u);
+}
+
+TEST(DeadlineWatchdogTest, DisarmedDeadlineNeverFires) {
+    DeadlineWatchdog watchdog;
+    std::atomic<bool> fired{false};
+
+    {
+        const auto armed = watchdog.Arm(Clock::now() + std::chrono::milliseconds(30), [&] { fired = true; });
+        EXPECT_EQ(watchdog.Pending(), 1u);
+    }
+
+    EXPECT_EQ(watchdog.Pending(), 0u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_FALSE(fired);
+}
+
+TEST(DeadlineWatchdogTest, FiresInDeadlineOrderOnOneThread) {
+    DeadlineWatchdog watchdog;
+    std::mutex mutex;
+    std::vector<int> order;
+    std::set<std::thread::id> threads;
+    const auto record = [&](const int value) {
+        return [&, value] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(value);
+            threads.insert(std::this_thread::get_id());
+        };
+    };
+
+    const auto now = Clock::now();
+    std::vector<DeadlineWatchdog::Registration> armed;
+    armed.push_back(watchdog.Arm(now + std::chrono::milliseconds(60), record(3)));
+    armed.push_back(watchdog.Arm(now + std::chrono::milliseconds(20), record(1)));
+    armed.push_back(watchdog.Arm(now + std::chrono::milliseconds(40), record(2)));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(threads.size(), 1u);
+}
+
+TEST(DeadlineWatchdogTest, DisarmWaitsForRunningCallback) {
+    DeadlineWatchdog watchdog;
+    std::atomic<bool> started{false};
+    std::atomic<bool> finished{false};
+
+    auto armed = watchdog.Arm(Clock::now(), [&] {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+    });
+
+    while (!started) {
+        std::this_thread::yield();
+    }
+    // Whatever the callback touches must stay valid until Disarm returns
+    armed.Disarm();
+    EXPECT_TRUE(finished);
+}
@@ -0,0 +1,94 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include <future>
+#include "nuansa/utils/pattern/single_flight.h"
+
+using nuansa::utils::pattern::SingleFlight;
+
+TEST(SingleFlightTest, ConcurrentCallersShareOneExecution) {
+    SingleFlight<std::string, int> flights;
+    std::atomic<int> executions{0};
+
+    std::promise<void> release;
+    auto gate = release.get_future().share();
+    std::promise<void> started;
+    auto leader = std::async(std::launch::async, [&] {
+        return flights.Do("token", [&] {
+            ++executions;
+            started.set_value();
+            gate.wait();
+            return 42;
+        });
+    });
+    started.get_future().wait();
+
+    std::vector<std::future<int> > followers;
+    for (int i = 0; i < 8; ++i) {
+        followers.push_back(std::async(std::launch::async, [&] {
+            return flights.Do("token", [&] {
+                ++executions;
+                return -1;
+            });
+        }));
+    }
+
+    // Wait until every follower has joined the in-flight call
+    while (flights.SharedCount() < followers.size()) {
+        std::this_thread::yield();
+    }
+    release.set_value();
+
+    EXPECT_EQ(leader.get(), 42);
+    for (auto &follower: followers) {
+        EXPECT_EQ(follower.get(), 42);
+    }
+    EXPECT_EQ(executions.load(), 1);
+    EXPECT_EQ(flights.InFlight(), 0u);
+}
+
+TEST(SingleFlightTest, FinishedCallsAreNotRemembered) {
+    SingleFlight<std::string, int> flights;
+    int executions = 0;
+
+    EXPECT_EQ(flights.Do("token", [&] { return ++executions; }), 1);
+    EXPECT_EQ(flights.Do("token", [&] { return ++executions; }), 2);
+}
+
+TEST(SingleFlightTest, DifferentKeysRunIndependently) {
+    SingleFlight<std::string, std::string> flights;
+
+    EXPECT_EQ(flights.Do("a", [] { return std::string("first"); }), "first");
+    EXPECT_EQ(flights.Do("b", [] { return std::string("second"); }), "second");
+    EXPECT_EQ(flights.SharedCount(), 0u);
+}
+
+TEST(SingleFlightTest, ExceptionsReachEveryWaiterAndClearTheKey) {
+    SingleFlight<std::string, int> flights;
+
+    std::promise<void> release;
+    auto gate = release.get_future().share();
+    std::promise<void> started;
+    auto leader = std::async(std::launch::async, [&] {
+        return flights.Do("token", [&]() -> int {
+            started.set_value();
+            gate.wait();
+            throw std::runtime_error("provider unavailable");
+        });
+    });
+    started.get_future().wait();
+
+    auto follower = std::async(std::launch::async, [&] {
+        return flights.Do("token", [] { return 0; });
+    });
+    while (flights.SharedCount() < 1) {
+        std::this_thread::yield();
+    }
+    release.set_value();
+
+    EXPECT_THROW(leader.get(), std::runtime_error);
+    EXPECT_THROW(follower.get(), std::runtime_error);
+
+    // The failure is not sticky
+    EXPECT_EQ(flights.Do("token", [] { return 7; }), 7);
+}
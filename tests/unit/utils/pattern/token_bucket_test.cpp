@@ -0,0 +1,136 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/utils/pattern/token_bucket.h"
+#include "nuansa/handler/websocket_client.h"
+
+using nuansa::handler::ClientRateLimits;
+using nuansa::handler::WebSocketClient;
+using nuansa::utils::pattern::TokenBucket;
+using nuansa::utils::pattern::TokenBucketSettings;
+using nuansa::utils::pattern::TokenBucketTable;
+using nuansa::utils::pattern::TokenBucketTableSettings;
+using std::chrono::milliseconds;
+
+TEST(TokenBucketTest, AllowsBurstThenRefillsAtRate) {
+    const auto start = TokenBucket::Clock::now();
+    TokenBucket bucket(TokenBucketSettings{.ratePerSecond = 10, .burst = 3}, start);
+
+    EXPECT_TRUE(bucket.TryConsume(1, start));
+    EXPECT_TRUE(bucket.TryConsume(1, start));
+    EXPECT_TRUE(bucket.TryConsume(1, start));
+    EXPECT_FALSE(bucket.TryConsume(1, start));
+
+    // 10 per second: one token every 100ms
+    EXPECT_FALSE(bucket.TryConsume(1, start + milliseconds(50)));
+    EXPECT_TRUE(bucket.TryConsume(1, start + milliseconds(100)));
+    EXPECT_FALSE(bucket.TryConsume(1, start + milliseconds(100)));
+}
+
+TEST(TokenBucketTest, NeverHoldsMoreThanBurst) {
+    const auto start = TokenBucket::Clock::now();
+    TokenBucket bucket(TokenBucketSettings{.ratePerSecond = 100, .burst = 5}, start);
+
+    const auto later = start + std::chrono::hours(1);
+    EXPECT_DOUBLE_EQ(bucket.Available(later), 5.0);
+    EXPECT_TRUE(bucket.IsFull(later));
+    EXPECT_TRUE(bucket.TryConsume(5, later));
+    EXPECT_FALSE(bucket.TryConsume(1, later));
+}
+
+TEST(TokenBucketTest, WeightedCostsForByteRates) {
+    const auto start = TokenBucket::Clock::now();
+    TokenBucket bucket(TokenBucketSettings{.ratePerSecond = 1000, .burst = 4096}, start);
+
+    EXPECT_TRUE(bucket.TryConsume(4000, start));
+    EXPECT_FALSE(bucket.TryConsume(200, start));
+    EXPECT_TRUE(bucket.TryConsume(200, start + milliseconds(200)));
+    // A failed attempt spends nothing
+    EXPECT_NEAR(bucket.Available(start + milliseconds(200)), 96, 1e-6);
+}
+
+TEST(TokenBucketTest, FrameRefusedForSizeKeepsMessageBudget) {
+    // Refills are slow enough not to matter while the test runs
+    WebSocketClient client("id", nullptr, ClientRateLimits{
+                               .messages = {.ratePerSecond = 0.001, .burst = 2},
+                               .bytes = {.ratePerSecond = 0.001, .burst = 100}
+                           });
+
+    EXPECT_FALSE(client.AllowFrame(500));
+    EXPECT_FALSE(client.AllowFrame(500));
+    EXPECT_TRUE(client.AllowFrame(60));
+    EXPECT_TRUE(client.AllowFrame(40));
+    EXPECT_FALSE(client.AllowFrame(0));
+}
+
+TEST(TokenBucketTableTest, KeysAreLimitedIndependently) {
+    TokenBucketTable table(TokenBucketTableSettings{.bucket = {.ratePerSecond = 1, .burst = 2}});
+    const auto now = TokenBucketTable::Clock::now();
+
+    EXPECT_TRUE(table.TryConsume("10.0.0.1", 1, now));
+    EXPECT_TRUE(table.TryConsume("10.0.0.1", 1, now));
+    EXPECT_FALSE(table.TryConsume("10.0.0.1", 1, now));
+
+    EXPECT_TRUE(table.TryConsume("10.0.0.2", 1, now));
+    EXPECT_EQ(table.Size(), 2u);
+}
+
+TEST(TokenBucketTableTest, CompactionDropsRefilledBuckets) {
+    TokenBucketTable table(TokenBucketTableSettings{
+        .bucket = {.ratePerSecond = 1, .burst = 2},
+        .shardCount = 4,
+        .compactionInterval = std::chrono::seconds(10)
+    });
+    const auto start = TokenBucketTable::Clock::now();
+
+    for (int i = 0; i < 100; ++i) {
+        table.TryConsume("client-" + std::to_string(i), 1, start);
+    }
+    EXPECT_EQ(table.Size(), 100u);
+
+    // Still refilling: nothing can be dropped yet
+    table.Compact(start + milliseconds(500));
+    EXPECT_EQ(table.Size(), 100u);
+
+    // Full again, so they carry no state and are dropped
+    table.Compact(start + std::chrono::seconds(2));
+    EXPECT_EQ(table.Size(), 0u);
+}
+
+TEST(TokenBucketTableTest, CompactsLazilyOnUse) {
+    TokenBucketTable table(TokenBucketTableSettings{
+        .bucket = {.ratePerSecond = 1, .burst = 1},
+        .shardCount = 1,
+        .compactionInterval = std::chrono::seconds(5)
+    });
+    const auto start = TokenBucketTable::Clock::now();
+
+    table.TryConsume("a", 1, start);
+    table.TryConsume("b", 1, start);
+    EXPECT_EQ(table.Size(), 2u);
+
+    // The next access after the interval sweeps the shard first
+    table.TryConsume("c", 1, start + std::chrono::seconds(30));
+    EXPECT_EQ(table.Size(), 1u);
+}
+
+TEST(TokenBucketTableTest, ConcurrentConsumersNeverOverspend) {
+    TokenBucketTable table(TokenBucketTableSettings{.bucket = {.ratePerSecond = 0.001, .burst = 1000}});
+    std::atomic<int> granted{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 500; ++i) {
+                if (table.TryConsume("shared")) {
+                    ++granted;
+                }
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(granted.load(), 1000);
+}
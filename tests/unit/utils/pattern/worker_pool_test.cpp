@@ -0,0 +1,61 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include <future>
+#include "nuansa/utils/pattern/worker_pool.h"
+
+using nuansa::utils::pattern::WorkerPool;
+using nuansa::utils::pattern::WorkerPoolSettings;
+using nuansa::utils::exception::WorkerPoolRejectedException;
+
+TEST(WorkerPoolTest, SubmitReturnsResult) {
+    WorkerPool pool(WorkerPoolSettings{.name = "test", .threadCount = 2, .queueCapacity = 8});
+
+    auto future = pool.Submit([] { return 21 * 2; });
+    EXPECT_EQ(future.get(), 42);
+}
+
+TEST(WorkerPoolTest, SubmitPropagatesExceptions) {
+    WorkerPool pool(WorkerPoolSettings{.name = "test", .threadCount = 1, .queueCapacity = 8});
+
+    auto future = pool.Submit([]() -> int { throw std::runtime_error("boom"); });
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST(WorkerPoolTest, RejectsWhenQueueIsFull) {
+    WorkerPool pool(WorkerPoolSettings{.name = "test", .threadCount = 1, .queueCapacity = 2});
+
+    // Park the only worker so queued tasks stay queued
+    std::promise<void> release;
+    auto gate = release.get_future().share();
+    std::promise<void> started;
+    auto blocker = pool.Submit([gate, &started] {
+        started.set_value();
+        gate.wait();
+    });
+    started.get_future().wait();
+
+    auto first = pool.Submit([] { return 1; });
+    auto second = pool.Submit([] { return 2; });
+    EXPECT_THROW(pool.Submit([] { return 3; }), WorkerPoolRejectedException);
+    EXPECT_FALSE(pool.TryPost([] {}));
+    EXPECT_EQ(pool.RejectedCount(), 2u);
+
+    release.set_value();
+    blocker.get();
+    EXPECT_EQ(first.get(), 1);
+    EXPECT_EQ(second.get(), 2);
+}
+
+TEST(WorkerPoolTest, ShutdownDrainsQueuedWork) {
+    std::atomic<int> completed{0};
+    {
+        WorkerPool pool(WorkerPoolSettings{.name = "test", .threadCount = 2, .queueCapacity = 64});
+        for (int i = 0; i < 50; ++i) {
+            ASSERT_TRUE(pool.TryPost([&completed] { completed.fetch_add(1); }));
+        }
+        pool.Shutdown();
+        EXPECT_FALSE(pool.TryPost([] {}));
+    }
+    EXPECT_EQ(completed.load(), 50);
+}
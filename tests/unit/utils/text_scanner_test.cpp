@@ -0,0 +1,93 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/utils/text_scanner.h"
+#include "nuansa/utils/validation.h"
+
+using nuansa::utils::TextScanner;
+using nuansa::utils::Validation;
+
+namespace {
+    // The implementations the scanners replaced; they define the expected answers
+    std::vector<std::string> RegexMentions(const std::string &content) {
+        static const std::regex pattern("@(\\w+)");
+        std::vector<std::string> mentions;
+        for (auto it = std::sregex_iterator(content.begin(), content.end(), pattern); it != std::sregex_iterator();
+             ++it) {
+            mentions.push_back((*it)[1].str());
+        }
+        return mentions;
+    }
+
+    bool RegexEmail(const std::string &email) {
+        static const std::regex pattern(R"([a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,})");
+        return std::regex_match(email, pattern);
+    }
+
+    std::string RandomText(std::mt19937 &rng, const std::string_view alphabet, const size_t maxLength) {
+        std::uniform_int_distribution<size_t> length(0, maxLength);
+        std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+        std::string text(length(rng), ' ');
+        for (auto &c: text) {
+            c = alphabet[pick(rng)];
+        }
+        return text;
+    }
+}
+
+TEST(TextScannerTest, FindsMentionsAsViewsIntoTheContent) {
+    const std::string content = "Hello @user1 and @user2! How are you @user3?";
+    const auto mentions = TextScanner::FindMentions(content);
+
+    ASSERT_EQ(mentions.size(), 3u);
+    EXPECT_EQ(mentions[0], "user1");
+    EXPECT_EQ(mentions[1], "user2");
+    EXPECT_EQ(mentions[2], "user3");
+    EXPECT_EQ(mentions[0].data(), content.data() + 7);
+}
+
+TEST(TextScannerTest, HandlesEdgeCases) {
+    EXPECT_TRUE(TextScanner::FindMentions("").empty());
+    EXPECT_TRUE(TextScanner::FindMentions("no mentions here").empty());
+    EXPECT_TRUE(TextScanner::FindMentions("@ @! trailing @").empty());
+
+    const auto adjacent = TextScanner::FindMentions("@@a@b_c mail@host.com @_");
+    ASSERT_EQ(adjacent.size(), 4u);
+    EXPECT_EQ(adjacent[0], "a");
+    EXPECT_EQ(adjacent[1], "b_c");
+    EXPECT_EQ(adjacent[2], "host");
+    EXPECT_EQ(adjacent[3], "_");
+}
+
+TEST(TextScannerTest, MatchesTheRegexOnRandomText) {
+    std::mt19937 rng(42);
+    for (int i = 0; i < 5000; ++i) {
+        const auto content = RandomText(rng, "@@ab_Z9 .!-\xc3\xa9", 64);
+        const auto expected = RegexMentions(content);
+        const auto actual = TextScanner::FindMentions(content);
+        ASSERT_EQ(std::vector<std::string>(actual.begin(), actual.end()), expected) << content;
+    }
+}
+
+TEST(ValidationTest, ValidatesEmails) {
+    EXPECT_TRUE(Validation::ValidateEmail("first.last+tag@mail.example.co.id"));
+    EXPECT_TRUE(Validation::ValidateEmail("a@b.cd"));
+    EXPECT_TRUE(Validation::ValidateEmail("a@b..cd"));
+
+    EXPECT_FALSE(Validation::ValidateEmail(""));
+    EXPECT_FALSE(Validation::ValidateEmail("first.last.example.com"));
+    EXPECT_FALSE(Validation::ValidateEmail("@example.com"));
+    EXPECT_FALSE(Validation::ValidateEmail("a@.com"));
+    EXPECT_FALSE(Validation::ValidateEmail("a@example.c"));
+    EXPECT_FALSE(Validation::ValidateEmail("a@example.c0m"));
+    EXPECT_FALSE(Validation::ValidateEmail("a@b@example.com"));
+    EXPECT_FALSE(Validation::ValidateEmail("a b@example.com"));
+}
+
+TEST(ValidationTest, EmailMatchesTheRegexOnRandomText) {
+    std::mt19937 rng(7);
+    for (int i = 0; i < 20000; ++i) {
+        const auto email = RandomText(rng, "ab9._%+-@@..Zq ", 16);
+        ASSERT_EQ(Validation::ValidateEmail(email), RegexEmail(email)) << email;
+    }
+}
@@ -0,0 +1,209 @@
+#include "nuansa/utils/pch.h"
+
+#include <gtest/gtest.h>
+#include "nuansa/utils/trace/tracer.h"
+#include "nuansa/utils/metrics/metrics.h"
+
+using nuansa::utils::metrics::MetricsRegistry;
+using nuansa::utils::trace::Span;
+using nuansa::utils::trace::SpanBuffer;
+using nuansa::utils::trace::SpanData;
+using nuansa::utils::trace::Tracer;
+using nuansa::utils::trace::TracerSettings;
+using nuansa::utils::trace::TraceScope;
+
+namespace {
+    std::filesystem::path TracePath() {
+        return std::filesystem::temp_directory_path() / ("nuansa_tracer_test_" + std::to_string(::getpid()) + ".jsonl");
+    }
+
+    std::string ReadAll(const std::filesystem::path &path) {
+        std::ifstream file(path);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    void Configure(const double sampleRate) {
+        std::filesystem::remove(TracePath());
+        Tracer::GetInstance().Configure(TracerSettings{
+            .sampleRate = sampleRate,
+            .bufferCapacity = 1024,
+            .exportInterval = std::chrono::hours(1),
+            .filePath = TracePath().string()
+        });
+    }
+}
+
+TEST(SpanBufferTest, RefusesSpansWhenFull) {
+    SpanBuffer buffer(3);
+    ASSERT_EQ(buffer.Capacity(), 4u);
+
+    SpanData span;
+    for (uint64_t i = 1; i <= 4; ++i) {
+        span.spanId = i;
+        EXPECT_TRUE(buffer.TryPush(span));
+    }
+    EXPECT_FALSE(buffer.TryPush(span));
+
+    for (uint64_t i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(buffer.TryPop(span));
+        EXPECT_EQ(span.spanId, i);
+    }
+    EXPECT_FALSE(buffer.TryPop(span));
+}
+
+TEST(SpanBufferTest, DeliversEverySpanAcrossThreads) {
+    SpanBuffer buffer(256);
+    constexpr uint64_t PER_PRODUCER = 20000;
+    std::atomic<uint64_t> consumedSum{0};
+    std::atomic<uint64_t> consumedCount{0};
+
+    std::vector<std::thread> threads;
+    for (uint64_t producer = 0; producer < 4; ++producer) {
+        threads.emplace_back([&buffer, producer] {
+            SpanData span;
+            for (uint64_t i = 1; i <= PER_PRODUCER; ++i) {
+                span.spanId = producer * PER_PRODUCER + i;
+                while (!buffer.TryPush(span)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int consumer = 0; consumer < 2; ++consumer) {
+        threads.emplace_back([&] {
+            SpanData span;
+            while (consumedCount.load() < 4 * PER_PRODUCER) {
+                if (buffer.TryPop(span)) {
+                    consumedSum += span.spanId;
+                    ++consumedCount;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    constexpr uint64_t TOTAL = 4 * PER_PRODUCER;
+    EXPECT_EQ(consumedCount.load(), TOTAL);
+    EXPECT_EQ(consumedSum.load(), TOTAL * (TOTAL + 1) / 2);
+}
+
+TEST(TracerTest, NestsSpansUnderTheFrameAndStampsCorrelationId) {
+    Configure(1.0);
+    {
+        TraceScope trace("websocket.frame");
+        EXPECT_TRUE(trace.IsSampled());
+        {
+            Span parse("parse");
+        }
+        trace.SetCorrelationId("req-42");
+        Span dispatch("dispatch");
+        {
+            Span query("db.query");
+            query.SetError();
+        }
+    }
+    EXPECT_EQ(Tracer::GetInstance().ExportNow(), 4u);
+    Tracer::GetInstance().Shutdown();
+
+    const auto body = ReadAll(TracePath());
+    EXPECT_NE(body.find(R"({"resourceSpans":[{"resource":{"attributes":[{"key":"service.name")"), std::string::npos);
+    EXPECT_NE(body.find(R"("name":"websocket.frame","kind":2)"), std::string::npos);
+    EXPECT_NE(body.find(R"("name":"db.query","kind":1)"), std::string::npos);
+    EXPECT_NE(body.find(R"("status":{"code":2})"), std::string::npos);
+    // parse ended before the id was known; the other three carry it
+    size_t stamped = 0;
+    for (auto at = body.find("req-42"); at != std::string::npos; at = body.find("req-42", at + 1)) {
+        ++stamped;
+    }
+    EXPECT_EQ(stamped, 3u);
+    std::filesystem::remove(TracePath());
+}
+
+TEST(TracerTest, UnsampledTracesRecordNothing) {
+    Configure(0.0);
+    {
+        TraceScope trace("websocket.frame");
+        EXPECT_FALSE(trace.IsSampled());
+        Span span("parse");
+        EXPECT_FALSE(span.IsRecording());
+    }
+    EXPECT_EQ(Tracer::GetInstance().ExportNow(), 0u);
+    Tracer::GetInstance().Shutdown();
+
+    // Spans outside any trace are ignored as well
+    Span orphan("db.acquire");
+    EXPECT_FALSE(orphan.IsRecording());
+}
+
+TEST(TracerTest, BatchesTheCollectorRefusesAreNotCountedAsExported) {
+    // A port that was just released refuses the connection
+    boost::asio::io_context io;
+    boost::asio::ip::tcp::acceptor acceptor(io, {boost::asio::ip::address_v4::loopback(), 0});
+    const auto port = acceptor.local_endpoint().port();
+    acceptor.close();
+
+    Tracer::GetInstance().Configure(TracerSettings{
+        .sampleRate = 1.0,
+        .exportInterval = std::chrono::hours(1),
+        .collectorUrl = "http://127.0.0.1:" + std::to_string(port) + "/v1/traces"
+    });
+    auto &registry = MetricsRegistry::GetInstance();
+    auto &exported = registry.GetCounter("nuansa_trace_spans_exported_total", "Spans written by the exporter");
+    auto &failed = registry.GetCounter("nuansa_trace_spans_failed_total",
+                                       "Spans lost because the file or collector did not accept them");
+    const auto exportedBefore = exported.Value();
+    const auto failedBefore = failed.Value();
+    {
+        TraceScope trace("websocket.frame");
+        Span parse("parse");
+    }
+    EXPECT_EQ(Tracer::GetInstance().ExportNow(), 0u);
+    Tracer::GetInstance().Shutdown();
+
+    EXPECT_EQ(exported.Value(), exportedBefore);
+    EXPECT_EQ(failed.Value(), failedBefore + 2);
+}
+
+TEST(TracerTest, ReconfiguringWhileSpansEndKeepsTheBuffer) {
+    Configure(1.0);
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; ++t) {
+        threads.emplace_back([&done] {
+            while (!done.load()) {
+                TraceScope trace("websocket.frame");
+                Span parse("parse");
+            }
+        });
+    }
+    for (int i = 0; i < 5; ++i) {
+        Configure(1.0);
+    }
+    done = true;
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    Tracer::GetInstance().Shutdown();
+    std::filesystem::remove(TracePath());
+}
+
+TEST(TracerTest, RendersIdsAsOtlpHex) {
+    SpanData span;
+    span.traceId = {0x0a, 0xf7, 0x65, 0x19, 0x16, 0xcd, 0x43, 0xdd, 0x84, 0x48, 0xeb, 0x21, 0x1c, 0x80, 0x31, 0x9c};
+    span.spanId = 0xb7ad6b7169203331ull;
+    span.parentSpanId = 0x00f067aa0ba902b7ull;
+    span.name = "kdf.verify";
+    span.startUnixNanos = 1544712660000000000;
+    span.endUnixNanos = 1544712661000000000;
+
+    const auto json = Tracer::ToOtlpJson({span}, "nuansa");
+    EXPECT_NE(json.find(R"("traceId":"0af7651916cd43dd8448eb211c80319c")"), std::string::npos);
+    EXPECT_NE(json.find(R"("spanId":"b7ad6b7169203331")"), std::string::npos);
+    EXPECT_NE(json.find(R"("parentSpanId":"00f067aa0ba902b7")"), std::string::npos);
+    EXPECT_NE(json.find(R"("startTimeUnixNano":"1544712660000000000")"), std::string::npos);
+    EXPECT_EQ(json.find("attributes\":[{\"key\":\"nuansa.correlation_id"), std::string::npos);
+}
@@ -0,0 +1,90 @@
+#ifndef NUANSA_TESTS_UTILS_LOCAL_HTTP_SERVER_H
+#define NUANSA_TESTS_UTILS_LOCAL_HTTP_SERVER_H
+
+#include "nuansa/utils/pch.h"
+
+namespace nuansa::tests::utils {
+    // Minimal keep-alive HTTP server on a loopback port, one thread per connection
+    class LocalHttpServer {
+    public:
+        using Request = boost::beast::http::request<boost::beast::http::string_body>;
+        using Response = boost::beast::http::response<boost::beast::http::string_body>;
+        using Handler = std::function<void(const Request &, Response &)>;
+
+        explicit LocalHttpServer(Handler handler)
+            : handler_(std::move(handler)),
+              acceptor_(ioc_, boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0)) {
+            acceptThread_ = std::thread([this] { AcceptLoop(); });
+        }
+
+        ~LocalHttpServer() {
+            stopping_ = true;
+            // close() alone does not wake a thread blocked in accept()
+            ::shutdown(acceptor_.native_handle(), SHUT_RDWR);
+            boost::system::error_code ec;
+            acceptor_.close(ec);
+            acceptThread_.join();
+            for (auto &thread: connectionThreads_) {
+                thread.join();
+            }
+        }
+
+        std::string Url(const std::string &path) const {
+            return "http://127.0.0.1:" + std::to_string(acceptor_.local_endpoint().port()) + path;
+        }
+
+        int Connections() const { return connections_.load(); }
+
+        int Requests() const { return requests_.load(); }
+
+    private:
+        void AcceptLoop() {
+            while (!stopping_) {
+                boost::asio::ip::tcp::socket socket(ioc_);
+                boost::system::error_code ec;
+                acceptor_.accept(socket, ec);
+                if (ec) {
+                    return;
+                }
+                ++connections_;
+                connectionThreads_.emplace_back([this, socket = std::move(socket)]() mutable {
+                    Serve(std::move(socket));
+                });
+            }
+        }
+
+        void Serve(boost::asio::ip::tcp::socket socket) {
+            boost::beast::flat_buffer buffer;
+            boost::system::error_code ec;
+            while (!stopping_) {
+                Request request;
+                boost::beast::http::read(socket, buffer, request, ec);
+                if (ec) {
+                    return;
+                }
+                ++requests_;
+
+                Response response{boost::beast::http::status::ok, request.version()};
+                response.keep_alive(request.keep_alive());
+                handler_(request, response);
+                response.prepare_payload();
+
+                boost::beast::http::write(socket, response, ec);
+                if (ec || !response.keep_alive()) {
+                    return;
+                }
+            }
+        }
+
+        Handler handler_;
+        boost::asio::io_context ioc_;
+        boost::asio::ip::tcp::acceptor acceptor_;
+        std::atomic<bool> stopping_{false};
+        std::atomic<int> connections_{0};
+        std::atomic<int> requests_{0};
+        std::thread acceptThread_;
+        std::vector<std::thread> connectionThreads_;
+    };
+}
+
+#endif //NUANSA_TESTS_UTILS_LOCAL_HTTP_SERVER_H
@@ -0,0 +1,45 @@
+#ifndef NUANSA_TESTS_UTILS_LOOPBACK_WEBSOCKET_H
+#define NUANSA_TESTS_UTILS_LOOPBACK_WEBSOCKET_H
+
+#include "nuansa/utils/pch.h"
+#include "nuansa/handler/websocket_client.h"
+
+namespace nuansa::tests::utils {
+    // A server-side stream for WebSocketClient and the peer on the other end, over a loopback socket.
+    // Objects that hold the server stream have to let go of it before the connection is destroyed.
+    struct LoopbackConnection {
+        LoopbackConnection() : peer(io) {
+            tcp::acceptor acceptor(io, tcp::endpoint(net::ip::address_v4::loopback(), 0));
+            server = std::make_shared<websocket::stream<tcp::socket> >(io);
+
+            std::thread accepting([&] {
+                acceptor.accept(server->next_layer());
+                server->accept();
+            });
+            peer.next_layer().connect(acceptor.local_endpoint());
+            peer.handshake("127.0.0.1", "/");
+            accepting.join();
+        }
+
+        // The next frame the client was sent
+        nlohmann::json Read() {
+            beast::flat_buffer buffer;
+            peer.read(buffer);
+            return nlohmann::json::parse(beast::buffers_to_string(buffer.data()));
+        }
+
+        net::io_context io;
+        std::shared_ptr<websocket::stream<tcp::socket> > server;
+        websocket::stream<tcp::socket> peer;
+    };
+
+    // An authenticated client; without a stream nothing can be written to it
+    inline std::shared_ptr<handler::WebSocketClient> MakeClient(
+        const std::string &username, const std::shared_ptr<websocket::stream<tcp::socket> > &ws = nullptr) {
+        auto client = std::make_shared<handler::WebSocketClient>("id-" + username, ws);
+        client->username = username;
+        return client;
+    }
+}
+
+#endif //NUANSA_TESTS_UTILS_LOOPBACK_WEBSOCKET_H
@@ -0,0 +1,567 @@
+#include "nuansa/utils/pch.h"
+
+#include "load_generator.h"
+
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+namespace net = boost::asio;
+
+using nuansa::utils::common::MESSAGE_BODY;
+using nuansa::utils::common::MESSAGE_HEADER;
+
+namespace nuansa::tools::loadgen {
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        // Registration is only ever a setup step, so it has no Operation of its own
+        constexpr int REGISTER = -1;
+
+        constexpr std::array<std::string_view, OPERATION_COUNT> OPERATION_NAMES{
+            "login", "message", "broadcast", "dm"
+        };
+
+        uint64_t Micros(const Clock::duration duration) {
+            return static_cast<uint64_t>(std::max<int64_t>(
+                0, std::chrono::duration_cast<std::chrono::microseconds>(duration).count()));
+        }
+
+        double Seconds(const Clock::duration duration) {
+            return std::chrono::duration<double>(duration).count();
+        }
+
+        nlohmann::json Summarize(const utils::metrics::Histogram &histogram) {
+            const auto millis = [&histogram](const double q) {
+                return static_cast<double>(histogram.Percentile(q)) / 1000.0;
+            };
+            const auto count = histogram.Count();
+            return {
+                {"count", count},
+                {"mean", count == 0 ? 0.0 : static_cast<double>(histogram.Sum()) / static_cast<double>(count) / 1000.0},
+                {"p50", millis(0.5)},
+                {"p90", millis(0.9)},
+                {"p99", millis(0.99)},
+                {"p999", millis(0.999)},
+                {"max", millis(1.0)}
+            };
+        }
+    }
+
+    std::string_view OperationName(const Operation operation) {
+        return OPERATION_NAMES[static_cast<size_t>(operation)];
+    }
+
+    std::array<double, OPERATION_COUNT> ParseMix(const std::string &mix) {
+        std::array<double, OPERATION_COUNT> weights{};
+        std::istringstream input(mix);
+        std::string entry;
+        while (std::getline(input, entry, ',')) {
+            const auto separator = entry.find('=');
+            if (separator == std::string::npos) {
+                throw std::invalid_argument("Mix entry without a weight: " + entry);
+            }
+            const auto name = entry.substr(0, separator);
+            const auto found = std::ranges::find(OPERATION_NAMES, name);
+            if (found == OPERATION_NAMES.end()) {
+                throw std::invalid_argument("Unknown operation in mix: " + name);
+            }
+            const auto weight = std::stod(entry.substr(separator + 1));
+            if (weight < 0) {
+                throw std::invalid_argument("Mix weights cannot be negative: " + entry);
+            }
+            weights[found - OPERATION_NAMES.begin()] = weight;
+        }
+        if (std::ranges::all_of(weights, [](const double weight) { return weight == 0; })) {
+            throw std::invalid_argument("Mix needs at least one operation with a positive weight");
+        }
+        return weights;
+    }
+
+    // One client: connects, runs its setup steps, then its share of the workload until stopped
+    class LoadGenerator::Connection : public std::enable_shared_from_this<Connection> {
+    public:
+        Connection(net::io_context &ioc, const LoadGeneratorSettings &settings, Stats &stats, const size_t index)
+            : settings_(settings),
+              stats_(stats),
+              index_(index),
+              username_(settings.userPrefix + std::to_string(index)),
+              strand_(net::make_strand(ioc)),
+              resolver_(strand_),
+              ws_(strand_),
+              scheduleTimer_(strand_),
+              replyTimer_(strand_),
+              random_(index * 0x9E3779B97F4A7C15ull + 1),
+              pick_(settings.mix.begin(), settings.mix.end()),
+              period_(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(
+                  static_cast<double>(settings.connections) / settings.messageRate))),
+              content_(settings.messageBytes, 'x') {
+        }
+
+        void Start() {
+            ++stats_.connectAttempts;
+            connectStart_ = Clock::now();
+            resolver_.async_resolve(settings_.host, std::to_string(settings_.port),
+                                    [self = shared_from_this()](const beast::error_code &ec,
+                                                                const net::ip::tcp::resolver::results_type &results) {
+                                        if (ec) {
+                                            return self->FailConnect();
+                                        }
+                                        self->Connect(results);
+                                    });
+        }
+
+        // Connected or given up; safe from any thread
+        bool IsSettled() const { return connectDone_.load(); }
+
+        // Safe from any thread
+        void Stop() {
+            net::post(strand_, [self = shared_from_this()] {
+                self->stopping_ = true;
+                self->scheduleTimer_.cancel();
+                self->replyTimer_.cancel();
+                self->CloseIfIdle();
+            });
+        }
+
+    private:
+        enum class Step {
+            Register,
+            Login,
+            Workload
+        };
+
+        struct Deferred {
+            int kind{0};
+            Clock::time_point due;
+        };
+
+        struct Pending {
+            bool active{false};
+            bool expectReply{false};
+            int kind{0}; // Operation index or REGISTER
+            Clock::time_point due;
+            uint64_t sequence{0};
+        };
+
+        void Connect(const net::ip::tcp::resolver::results_type &results) {
+            beast::get_lowest_layer(ws_).expires_after(settings_.replyTimeout);
+            beast::get_lowest_layer(ws_).async_connect(
+                results, [self = shared_from_this()](const beast::error_code &ec,
+                                                     const net::ip::tcp::endpoint &) {
+                    if (ec) {
+                        return self->FailConnect();
+                    }
+                    // A frame and its trailing ping are two small writes; Nagle would hold the ping back
+                    beast::error_code ignored;
+                    beast::get_lowest_layer(self->ws_).socket().set_option(net::ip::tcp::no_delay(true), ignored);
+                    self->Handshake();
+                });
+        }
+
+        void Handshake() {
+            ws_.async_handshake(settings_.host + ":" + std::to_string(settings_.port), "/",
+                                [self = shared_from_this()](const beast::error_code &ec) {
+                                    if (ec) {
+                                        return self->FailConnect();
+                                    }
+                                    self->OnConnected();
+                                });
+        }
+
+        void FailConnect() {
+            ++stats_.connectFailures;
+            connectDone_ = true;
+        }
+
+        void OnConnected() {
+            ++stats_.connected;
+            connectDone_ = true;
+            stats_.connectLatency.Record(Micros(Clock::now() - connectStart_));
+
+            beast::get_lowest_layer(ws_).expires_never();
+            ws_.set_option(websocket::stream_base::timeout::suggested(beast::role_type::client));
+            ws_.text(true);
+            ws_.control_callback([this](const websocket::frame_type kind, const beast::string_view payload) {
+                if (kind == websocket::frame_type::pong) {
+                    OnPong(payload);
+                }
+            });
+
+            Read();
+            if (settings_.registerUsers) {
+                Issue(REGISTER, Clock::now());
+            } else {
+                Advance();
+            }
+        }
+
+        void Read() {
+            ws_.async_read(buffer_, [self = shared_from_this()](const beast::error_code &ec, std::size_t) {
+                if (ec) {
+                    if (!self->stopping_) {
+                        ++self->stats_.disconnects;
+                        self->stopping_ = true;
+                        self->scheduleTimer_.cancel();
+                        self->replyTimer_.cancel();
+                    }
+                    return;
+                }
+                ++self->stats_.received;
+                self->OnFrame(beast::buffers_to_string(self->buffer_.data()));
+                self->buffer_.consume(self->buffer_.size());
+                self->Read();
+            });
+        }
+
+        // Moves through the setup steps, then keeps the workload schedule going
+        void Advance() {
+            if (stopping_) {
+                return;
+            }
+            if (step_ == Step::Register) {
+                step_ = Step::Login;
+                if (settings_.login) {
+                    Issue(static_cast<int>(Operation::Login), Clock::now());
+                    return;
+                }
+            }
+            if (step_ == Step::Login) {
+                step_ = Step::Workload;
+                // Spread connections over the period so they don't send in lockstep
+                std::uniform_int_distribution<Clock::rep> offset(0, std::max<Clock::rep>(period_.count() - 1, 0));
+                next_ = Clock::now() + Clock::duration(offset(random_));
+            }
+
+            const auto due = next_;
+            next_ += period_;
+            if (due <= Clock::now()) {
+                Issue(pick_(random_), due);
+                return;
+            }
+            scheduleTimer_.expires_at(due);
+            scheduleTimer_.async_wait([self = shared_from_this(), due](const beast::error_code &ec) {
+                if (!ec && !self->stopping_) {
+                    self->Issue(self->pick_(self->random_), due);
+                }
+            });
+        }
+
+        void Issue(const int kind, const Clock::time_point due) {
+            // The reply can beat the completion of our own write; only one write may be in flight
+            if (writing_) {
+                deferred_ = Deferred{.kind = kind, .due = due};
+                return;
+            }
+
+            const bool expectReply = kind == REGISTER || kind == static_cast<int>(Operation::Login);
+            pending_ = Pending{
+                .active = true,
+                .expectReply = expectReply,
+                .kind = kind,
+                .due = due,
+                .sequence = ++sequence_
+            };
+            frame_ = BuildFrame(kind);
+            ++stats_.sent;
+
+            replyTimer_.expires_after(settings_.replyTimeout);
+            replyTimer_.async_wait([self = shared_from_this(), sequence = sequence_](const beast::error_code &ec) {
+                if (!ec) {
+                    self->OnTimeout(sequence);
+                }
+            });
+
+            writing_ = true;
+            ws_.async_write(net::buffer(frame_), [self = shared_from_this(), expectReply, sequence = sequence_](
+                        const beast::error_code &ec, std::size_t) {
+                                if (ec) {
+                                    return self->WriteDone(ec);
+                                }
+                                if (expectReply || self->stopping_) {
+                                    return self->WriteDone({});
+                                }
+                                self->pingPayload_ = std::to_string(sequence);
+                                self->ws_.async_ping(websocket::ping_data(self->pingPayload_.c_str()),
+                                                     [self](const beast::error_code &pingError) {
+                                                         self->WriteDone(pingError);
+                                                     });
+                            });
+        }
+
+        void WriteDone(const beast::error_code &ec) {
+            writing_ = false;
+            if (ec) {
+                return Fail();
+            }
+            if (deferred_ && !stopping_) {
+                const auto next = *deferred_;
+                deferred_.reset();
+                return Issue(next.kind, next.due);
+            }
+            CloseIfIdle();
+        }
+
+        void OnFrame(const std::string_view text) {
+            // Anything else is a notification caused by another connection
+            if (pending_.active && pending_.expectReply &&
+                (text.find("\"success\":") != std::string_view::npos ||
+                 text.find("\"error\"") != std::string_view::npos)) {
+                Complete(text.find("\"success\":true") != std::string_view::npos);
+            }
+        }
+
+        void OnPong(const beast::string_view payload) {
+            if (pending_.active && !pending_.expectReply && payload == pingPayload_ &&
+                pingPayload_ == std::to_string(pending_.sequence)) {
+                Complete(true);
+            }
+        }
+
+        void OnTimeout(const uint64_t sequence) {
+            if (!pending_.active || pending_.sequence != sequence) {
+                return;
+            }
+            ++stats_.timeouts;
+            pending_.active = false;
+            Advance();
+        }
+
+        void Complete(const bool success) {
+            replyTimer_.cancel();
+            pending_.active = false;
+            if (pending_.kind != REGISTER) {
+                const auto elapsed = Micros(Clock::now() - pending_.due);
+                stats_.latency[pending_.kind].Record(elapsed);
+                stats_.allLatency.Record(elapsed);
+                ++stats_.completed;
+                if (pending_.kind == static_cast<int>(Operation::Login) && !success) {
+                    ++stats_.loginFailures;
+                }
+            }
+            Advance();
+        }
+
+        void Fail() {
+            if (stopping_) {
+                return;
+            }
+            ++stats_.errors;
+            stopping_ = true;
+            scheduleTimer_.cancel();
+            replyTimer_.cancel();
+            beast::error_code ignored;
+            beast::get_lowest_layer(ws_).socket().close(ignored);
+        }
+
+        // A close frame is a write, so it waits for the frame or ping in flight
+        void CloseIfIdle() {
+            if (!stopping_ || writing_ || closing_ || !ws_.is_open()) {
+                return;
+            }
+            closing_ = true;
+            ws_.async_close(websocket::close_code::normal, [self = shared_from_this()](const beast::error_code &) {
+            });
+        }
+
+        std::string BuildFrame(const int kind) {
+            const auto id = username_ + "-" + std::to_string(sequence_);
+            nlohmann::json frame = {
+                {
+                    MESSAGE_HEADER, {
+                        {utils::common::MESSAGE_HEADER_VERSION, "1.0"},
+                        {utils::common::MESSAGE_HEADER_MESSAGE_ID, id},
+                        {utils::common::MESSAGE_HEADER_CORRELATION_ID, id},
+                        {utils::common::MESSAGE_HEADER_SENDER, username_},
+                        {utils::common::MESSAGE_HEADER_TIMESTAMP, std::time(nullptr)}
+                    }
+                }
+            };
+            auto &header = frame[MESSAGE_HEADER];
+
+            if (kind == REGISTER) {
+                header[utils::common::MESSAGE_HEADER_MESSAGE_TYPE] = "register";
+                frame[MESSAGE_BODY] = {
+                    {"username", username_},
+                    {"email", username_ + "@loadgen.invalid"},
+                    {"password", settings_.password}
+                };
+                return frame.dump();
+            }
+
+            switch (static_cast<Operation>(kind)) {
+                case Operation::Login:
+                    header[utils::common::MESSAGE_HEADER_MESSAGE_TYPE] = "login";
+                    frame["username"] = username_;
+                    frame["password"] = settings_.password;
+                    break;
+
+                case Operation::Message:
+                    header[utils::common::MESSAGE_HEADER_MESSAGE_TYPE] = "new";
+                    frame["type"] = "new";
+                    frame["content"] = content_;
+                    break;
+
+                case Operation::Broadcast: {
+                    std::string content;
+                    for (size_t i = 0; i < settings_.broadcastFanout; ++i) {
+                        content += "@" + OtherUser() + " ";
+                    }
+                    header[utils::common::MESSAGE_HEADER_MESSAGE_TYPE] = "new";
+                    frame["type"] = "new";
+                    frame["content"] = content + content_;
+                    break;
+                }
+
+                case Operation::DirectMessage:
+                    header[utils::common::MESSAGE_HEADER_MESSAGE_TYPE] = "direct_message";
+                    frame["type"] = "direct_message";
+                    frame["recipient"] = OtherUser();
+                    frame["content"] = content_;
+                    break;
+            }
+            return frame.dump();
+        }
+
+        std::string OtherUser() {
+            if (settings_.connections < 2) {
+                return username_;
+            }
+            std::uniform_int_distribution<size_t> pick(0, settings_.connections - 2);
+            auto other = pick(random_);
+            if (other >= index_) {
+                ++other;
+            }
+            return settings_.userPrefix + std::to_string(other);
+        }
+
+        const LoadGeneratorSettings &settings_;
+        Stats &stats_;
+        const size_t index_;
+        const std::string username_;
+
+        net::strand<net::io_context::executor_type> strand_;
+        net::ip::tcp::resolver resolver_;
+        websocket::stream<beast::tcp_stream> ws_;
+        net::steady_timer scheduleTimer_;
+        net::steady_timer replyTimer_;
+        beast::flat_buffer buffer_;
+
+        std::mt19937_64 random_;
+        std::discrete_distribution<int> pick_;
+        const Clock::duration period_;
+        const std::string content_;
+
+        Clock::time_point connectStart_;
+        Clock::time_point next_;
+        Step step_{Step::Register};
+        Pending pending_;
+        std::optional<Deferred> deferred_;
+        uint64_t sequence_{0};
+        std::string frame_;
+        std::string pingPayload_;
+        bool writing_{false};
+        bool closing_{false};
+        bool stopping_{false};
+        std::atomic<bool> connectDone_{false};
+    };
+
+    LoadGenerator::LoadGenerator(LoadGeneratorSettings settings)
+        : settings_(std::move(settings)) {
+        if (settings_.connections == 0 || settings_.connectRate <= 0 || settings_.messageRate <= 0) {
+            throw std::invalid_argument("connections, connect rate and message rate must be positive");
+        }
+    }
+
+    LoadGenerator::~LoadGenerator() {
+        ioc_.stop();
+        for (auto &thread: threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    nlohmann::json LoadGenerator::Run() {
+        auto work = net::make_work_guard(ioc_);
+        for (size_t i = 0; i < settings_.threads; ++i) {
+            threads_.emplace_back([this] { ioc_.run(); });
+        }
+
+        // Ramp up at connectRate; the workload of early connections already runs meanwhile
+        const auto start = Clock::now();
+        const auto connectInterval = std::chrono::duration<double>(1.0 / settings_.connectRate);
+        connections_.reserve(settings_.connections);
+        for (size_t i = 0; i < settings_.connections; ++i) {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(connectInterval * i));
+            connections_.push_back(std::make_shared<Connection>(ioc_, settings_, stats_, i));
+            connections_.back()->Start();
+        }
+        const auto connectDeadline = Clock::now() + settings_.replyTimeout;
+        while (Clock::now() < connectDeadline &&
+               !std::ranges::all_of(connections_, [](const auto &connection) { return connection->IsSettled(); })) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        const auto rampEnd = Clock::now();
+        std::cerr << "Connected " << stats_.connected << "/" << settings_.connections << " in "
+                << Seconds(rampEnd - start) << "s, running workload for " << settings_.duration.count() << "s"
+                << std::endl;
+
+        // Only operations completed inside the window count towards the rate
+        const auto completedBefore = stats_.completed.load();
+        std::this_thread::sleep_for(settings_.duration);
+        const auto workloadEnd = Clock::now();
+        const auto completed = stats_.completed.load() - completedBefore;
+
+        for (const auto &connection: connections_) {
+            connection->Stop();
+        }
+        // Give close handshakes a moment, then abandon whatever is left
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        work.reset();
+        ioc_.stop();
+        for (auto &thread: threads_) {
+            thread.join();
+        }
+        threads_.clear();
+
+        auto report = BuildReport(rampEnd - start, workloadEnd - rampEnd);
+        report["messages"]["perSecond"] = static_cast<double>(completed) / Seconds(workloadEnd - rampEnd);
+        return report;
+    }
+
+    nlohmann::json LoadGenerator::BuildReport(const Clock::duration rampUp, const Clock::duration workload) const {
+        nlohmann::json latency = {{"all", Summarize(stats_.allLatency)}};
+        for (size_t i = 0; i < OPERATION_COUNT; ++i) {
+            if (settings_.mix[i] > 0 || (i == static_cast<size_t>(Operation::Login) && settings_.login)) {
+                latency[std::string(OPERATION_NAMES[i])] = Summarize(stats_.latency[i]);
+            }
+        }
+
+        return {
+            {"target", "ws://" + settings_.host + ":" + std::to_string(settings_.port)},
+            {"rampUpSeconds", Seconds(rampUp)},
+            {"durationSeconds", Seconds(workload)},
+            {
+                "connections", {
+                    {"requested", settings_.connections},
+                    {"established", stats_.connected.load()},
+                    {"failed", stats_.connectFailures.load()},
+                    {"disconnected", stats_.disconnects.load()},
+                    {"perSecond", static_cast<double>(stats_.connected.load()) / Seconds(rampUp)},
+                    {"latencyMs", Summarize(stats_.connectLatency)}
+                }
+            },
+            {
+                "messages", {
+                    {"targetPerSecond", settings_.messageRate},
+                    {"sent", stats_.sent.load()},
+                    {"completed", stats_.completed.load()},
+                    {"received", stats_.received.load()},
+                    {"timeouts", stats_.timeouts.load()},
+                    {"errors", stats_.errors.load()},
+                    {"loginFailures", stats_.loginFailures.load()}
+                }
+            },
+            {"latencyMs", latency}
+        };
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef NUANSA_TOOLS_LOADGEN_LOAD_GENERATOR_H
+#define NUANSA_TOOLS_LOADGEN_LOAD_GENERATOR_H
+
+#include "nuansa/utils/pch.h"
+#include "nuansa/utils/metrics/metrics.h"
+
+namespace nuansa::tools::loadgen {
+    enum class Operation {
+        Login,
+        Message, // "new" chat message
+        Broadcast, // "new" chat message mentioning other load users, so the server fans it out
+        DirectMessage
+    };
+
+    inline constexpr size_t OPERATION_COUNT = 4;
+
+    std::string_view OperationName(Operation operation);
+
+    // Parses "login=1,message=8,broadcast=1,dm=2" into relative weights; throws std::invalid_argument
+    std::array<double, OPERATION_COUNT> ParseMix(const std::string &mix);
+
+    struct LoadGeneratorSettings {
+        std::string host{"127.0.0.1"};
+        uint16_t port{9090};
+        size_t connections{100};
+        double connectRate{200.0}; // New connections per second while ramping up
+        double messageRate{1000.0}; // Workload frames per second over all connections
+        std::chrono::seconds duration{30}; // Workload time after the last connection is up
+        std::chrono::milliseconds replyTimeout{5000};
+        std::array<double, OPERATION_COUNT> mix{1.0, 14.0, 2.0, 3.0}; // Weights, indexed by Operation
+        size_t broadcastFanout{3}; // Users mentioned by a Broadcast
+        size_t messageBytes{64}; // Chat content length
+        std::string userPrefix{"loadgen"}; // Connection i is user <prefix><i>
+        std::string password{"Loadgen-Passw0rd"};
+        bool registerUsers{false}; // Register each user before logging in; "already exists" is fine
+        bool login{true}; // Log each connection in before its workload starts
+        size_t threads{std::max(1u, std::thread::hardware_concurrency())};
+    };
+
+    /**
+     * @brief Drives a running server over many WebSocket connections and measures it
+     *
+     * Connections are opened at connectRate, optionally register and log in,
+     * then send a weighted mix of operations at messageRate in total. Each
+     * connection keeps one operation in flight and follows a fixed schedule,
+     * and latency is taken from when an operation was due rather than when it
+     * went out, so a stalled server shows up in the percentiles instead of
+     * silently lowering the send rate.
+     *
+     * Login and registration are timed to their reply. Chat frames get no
+     * reply, so each one is followed by a ping: the server reads frames in
+     * order and only answers the ping once it has handled the frame before it.
+     *
+     * Usage example:
+     * @code
+     * LoadGenerator generator(LoadGeneratorSettings{.connections = 500, .messageRate = 5000});
+     * std::cout << generator.Run().dump(2) << std::endl;
+     * @endcode
+     */
+    class LoadGenerator {
+    public:
+        explicit LoadGenerator(LoadGeneratorSettings settings);
+
+        ~LoadGenerator();
+
+        LoadGenerator(const LoadGenerator &) = delete;
+
+        LoadGenerator &operator=(const LoadGenerator &) = delete;
+
+        // Blocks for the ramp-up plus duration and returns the report
+        nlohmann::json Run();
+
+        struct Stats {
+            std::atomic<uint64_t> connectAttempts{0};
+            std::atomic<uint64_t> connected{0};
+            std::atomic<uint64_t> connectFailures{0};
+            std::atomic<uint64_t> disconnects{0};
+            std::atomic<uint64_t> loginFailures{0};
+            std::atomic<uint64_t> sent{0};
+            std::atomic<uint64_t> completed{0};
+            std::atomic<uint64_t> received{0};
+            std::atomic<uint64_t> timeouts{0};
+            std::atomic<uint64_t> errors{0};
+            utils::metrics::Histogram connectLatency; // Microseconds, TCP connect to handshake done
+            std::array<utils::metrics::Histogram, OPERATION_COUNT> latency; // Microseconds, by Operation
+            utils::metrics::Histogram allLatency; // Microseconds, every operation
+        };
+
+    private:
+        class Connection;
+
+        nlohmann::json BuildReport(std::chrono::steady_clock::duration rampUp,
+                                   std::chrono::steady_clock::duration workload) const;
+
+        LoadGeneratorSettings settings_;
+        Stats stats_;
+        boost::asio::io_context ioc_;
+        std::vector<std::shared_ptr<Connection> > connections_;
+        std::vector<std::thread> threads_;
+    };
+}
+
+#endif //NUANSA_TOOLS_LOADGEN_LOAD_GENERATOR_H
@@ -0,0 +1,109 @@
+#include "nuansa/utils/pch.h"
+
+#include "load_generator.h"
+
+namespace po = boost::program_options;
+
+using nuansa::tools::loadgen::LoadGenerator;
+using nuansa::tools::loadgen::LoadGeneratorSettings;
+
+// Exit codes: 0 within limits, 1 bad arguments or run failure, 2 a --max-* limit was exceeded
+int main(const int argc, char *argv[]) {
+    LoadGeneratorSettings settings;
+    std::string mix;
+    std::string output;
+    uint32_t durationSeconds = 0;
+    uint32_t replyTimeoutMs = 0;
+    double maxP99Ms = 0;
+    double maxErrorRate = 0;
+
+    po::options_description descriptions("nuansa_loadgen options");
+    descriptions.add_options()
+            ("help,h", "Display this help message")
+            ("host", po::value<std::string>(&settings.host)->default_value(settings.host), "Server address")
+            ("port,p", po::value<uint16_t>(&settings.port)->default_value(settings.port), "Server WebSocket port")
+            ("connections,n", po::value<size_t>(&settings.connections)->default_value(settings.connections),
+             "Concurrent WebSocket connections")
+            ("connect-rate", po::value<double>(&settings.connectRate)->default_value(settings.connectRate),
+             "New connections per second while ramping up")
+            ("rate,r", po::value<double>(&settings.messageRate)->default_value(settings.messageRate),
+             "Workload frames per second over all connections")
+            ("duration,d", po::value<uint32_t>(&durationSeconds)->default_value(30),
+             "Seconds of workload after the ramp-up")
+            ("mix", po::value<std::string>(&mix)->default_value("login=1,message=14,broadcast=2,dm=3"),
+             "Operation weights: login, message, broadcast, dm")
+            ("fanout", po::value<size_t>(&settings.broadcastFanout)->default_value(settings.broadcastFanout),
+             "Users mentioned by each broadcast")
+            ("message-bytes", po::value<size_t>(&settings.messageBytes)->default_value(settings.messageBytes),
+             "Chat content length")
+            ("user-prefix", po::value<std::string>(&settings.userPrefix)->default_value(settings.userPrefix),
+             "Connection i logs in as <prefix><i>")
+            ("password", po::value<std::string>(&settings.password)->default_value(settings.password),
+             "Password of every load user")
+            ("register", po::bool_switch(&settings.registerUsers), "Register the load users before logging in")
+            ("no-login", "Skip the initial login of each connection")
+            ("timeout-ms", po::value<uint32_t>(&replyTimeoutMs)->default_value(5000),
+             "Connect and reply timeout")
+            ("threads", po::value<size_t>(&settings.threads)->default_value(settings.threads), "Client I/O threads")
+            ("output,o", po::value<std::string>(&output), "Write the JSON report here instead of stdout")
+            ("max-p99-ms", po::value<double>(&maxP99Ms), "Exit with 2 when the overall p99 is above this")
+            ("max-error-rate", po::value<double>(&maxErrorRate),
+             "Exit with 2 when timeouts plus errors exceed this share of sent frames");
+
+    po::variables_map variables;
+    try {
+        po::store(po::parse_command_line(argc, argv, descriptions), variables);
+        po::notify(variables);
+        if (variables.contains("help")) {
+            std::cout << descriptions << std::endl;
+            return 0;
+        }
+        settings.mix = nuansa::tools::loadgen::ParseMix(mix);
+        settings.login = !variables.contains("no-login");
+        settings.duration = std::chrono::seconds(durationSeconds);
+        settings.replyTimeout = std::chrono::milliseconds(replyTimeoutMs);
+    } catch (const std::exception &e) {
+        std::cerr << "Error parsing command line options: " << e.what() << std::endl;
+        std::cerr << descriptions << std::endl;
+        return 1;
+    }
+
+    nlohmann::json report;
+    try {
+        LoadGenerator generator(settings);
+        report = generator.Run();
+    } catch (const std::exception &e) {
+        std::cerr << "Load run failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (output.empty()) {
+        std::cout << report.dump(2) << std::endl;
+    } else {
+        std::ofstream file(output);
+        file << report.dump(2) << std::endl;
+        if (!file) {
+            std::cerr << "Failed to write report to " << output << std::endl;
+            return 1;
+        }
+    }
+
+    int status = 0;
+    if (variables.contains("max-p99-ms")) {
+        if (const auto p99 = report["latencyMs"]["all"]["p99"].get<double>(); p99 > maxP99Ms) {
+            std::cerr << "p99 latency " << p99 << "ms is above the limit of " << maxP99Ms << "ms" << std::endl;
+            status = 2;
+        }
+    }
+    if (variables.contains("max-error-rate")) {
+        const auto &messages = report["messages"];
+        const auto sent = std::max<uint64_t>(messages["sent"].get<uint64_t>(), 1);
+        const auto failed = messages["timeouts"].get<uint64_t>() + messages["errors"].get<uint64_t>() +
+                            report["connections"]["failed"].get<uint64_t>();
+        if (const auto rate = static_cast<double>(failed) / static_cast<double>(sent); rate > maxErrorRate) {
+            std::cerr << "Error rate " << rate << " is above the limit of " << maxErrorRate << std::endl;
+            status = 2;
+        }
+    }
+    return status;
+}